@@ -5,8 +5,26 @@ Window {
     height: 480
     visible: true
     title: qsTr("Hello World")
+
+    required property TelemetryModel telemetry
+    required property QtObject history // TelemetryStore，绘图时调用 downsample
+
     Rectangle {
         anchors.fill: parent
         color: "red"
+
+        Column {
+            anchors.centerIn: parent
+            Text {
+                text: qsTr("Roll %1  Pitch %2  Yaw %3")
+                      .arg((telemetry.values["ATTITUDE.roll"] || 0).toFixed(2))
+                      .arg((telemetry.values["ATTITUDE.pitch"] || 0).toFixed(2))
+                      .arg((telemetry.values["ATTITUDE.yaw"] || 0).toFixed(2))
+            }
+            Text {
+                text: qsTr("Coalesced %1 / %2 updates").arg(telemetry.lastFrameCoalesced)
+                                                        .arg(telemetry.lastFrameUpdates)
+            }
+        }
     }
 }
@@ -0,0 +1,209 @@
+﻿/**************************************************************************
+ *   文件名	：commhelperd.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：CommHelper 无界面版本，只依赖 QtCore/QtNetwork
+ *   使用说明 ：CommHelperd -c commhelperd.json [--record file.tlog] [--metrics file]
+ *             按配置文件创建连接并加入路由，可选记录 tlog 和输出统计；
+ *             SIGINT/SIGTERM 时断开全部连接并关闭日志后退出；
+ *             --check 启动全部连接后输出启动用时和常驻内存并立即退出
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+
+#include "linkconfigloader.h"
+#include "linkinterface.h"
+#include "linkiothreadpool.h"
+#include "linkmetricsexporter.h"
+#include "linkreconnectscheduler.h"
+#include "mavlinkrouter.h"
+#include "tlogrecorder.h"
+
+namespace {
+/// 输出重连用时统计，每次连接建立和退出时调用
+void logReconnectStatistics()
+{
+    const auto stats = LinkReconnectScheduler::instance()->statistics();
+    if (stats.attempts == 0) {
+        return;
+    }
+    qInfo().noquote() << QString("reconnect: %1 reconnects, last %2 ms, average %3 ms, max %4 ms; "
+                                 "%5 attempts, %6 timeouts, %7 deferred, %8 pending, %9 in flight")
+                             .arg(stats.reconnects)
+                             .arg(stats.lastMs)
+                             .arg(stats.averageMs, 0, 'f', 1)
+                             .arg(stats.maxMs)
+                             .arg(stats.attempts)
+                             .arg(stats.timeouts)
+                             .arg(stats.deferred)
+                             .arg(stats.pending)
+                             .arg(stats.inFlight);
+}
+
+/// 当前常驻内存（KiB），读取失败或非 Linux 平台返回 -1
+qint64 residentKiB()
+{
+#ifdef Q_OS_LINUX
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    // 形如 "VmRSS:	    5432 kB"
+    for (QByteArray line = status.readLine(); !line.isEmpty(); line = status.readLine()) {
+        if (line.startsWith("VmRSS:")) {
+            return line.mid(6).trimmed().split(' ').value(0).toLongLong();
+        }
+    }
+#endif
+    return -1;
+}
+} // namespace
+
+#ifdef Q_OS_UNIX
+#include <QSocketNotifier>
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+int signalFds[2] = {-1, -1};
+
+void onSignal(int)
+{
+    // 信号处理函数中只写管道，退出放到事件循环中完成
+    char c = 1;
+    ssize_t ret = ::write(signalFds[0], &c, sizeof(c));
+    Q_UNUSED(ret);
+}
+
+void installSignalHandlers(QCoreApplication *app)
+{
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, signalFds) != 0) {
+        return;
+    }
+    auto notifier = new QSocketNotifier(signalFds[1], QSocketNotifier::Read, app);
+    QObject::connect(notifier, &QSocketNotifier::activated, app, [notifier]() {
+        notifier->setEnabled(false);
+        char c;
+        ssize_t ret = ::read(signalFds[1], &c, sizeof(c));
+        Q_UNUSED(ret);
+        QCoreApplication::quit();
+    });
+
+    struct sigaction action = {};
+    action.sa_handler = onSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+}
+} // namespace
+#endif
+
+int main(int argc, char *argv[])
+{
+    QElapsedTimer startup;
+    startup.start();
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("CommHelperd");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("CommHelper headless MAVLink relay");
+    parser.addHelpOption();
+    QCommandLineOption configOption({"c", "config"}, "Link configuration file.", "file", "commhelperd.json");
+    QCommandLineOption recordOption("record", "Record all links to a tlog file.", "file");
+    QCommandLineOption metricsOption("metrics", "Write link metrics to a file.", "file");
+    QCommandLineOption noForwardOption("no-forward", "Parse and record only, do not route between links.");
+    QCommandLineOption checkOption("check", "Load the configuration, start all links, report startup time and exit.");
+    parser.addOptions({configOption, recordOption, metricsOption, noForwardOption, checkOption});
+    parser.process(app);
+
+    LinkConfigLoader loader;
+    if (!loader.load(parser.value(configOption))) {
+        qCritical().noquote() << loader.errorString();
+        return 1;
+    }
+
+    MavlinkRouter router;
+    router.setForwarding(loader.forwarding() && !parser.isSet(noForwardOption));
+
+    TlogRecorder recorder;
+    QObject::connect(&recorder, &TlogRecorder::recordError, [](const QString &error) {
+        qWarning().noquote() << "record:" << error;
+    });
+    const QString recordPath = parser.isSet(recordOption) ? parser.value(recordOption) : loader.recordPath();
+    if (!recordPath.isEmpty() && !recorder.open(recordPath)) {
+        return 1; // recordError 已输出原因
+    }
+
+    LinkMetricsExporter exporter;
+    exporter.setFileName(parser.isSet(metricsOption) ? parser.value(metricsOption) : loader.metricsFile());
+    exporter.setFormat(loader.metricsFormat());
+    QObject::connect(&exporter, &LinkMetricsExporter::exportError, [](const QString &error) {
+        qWarning().noquote() << "metrics:" << error;
+    });
+
+    QVector<LinkInterface *> links;
+    for (const auto &description : loader.links()) {
+        LinkInterface *link = LinkConfigLoader::createLink(description);
+        const QString name = description.name;
+        QObject::connect(link, &LinkInterface::linkError, [name](const QString &title, const QString &error) {
+            qWarning().noquote() << name << title << error;
+        });
+        QObject::connect(link, &LinkInterface::connected, [name]() {
+            qInfo().noquote() << name << "connected";
+            logReconnectStatistics();
+        });
+        QObject::connect(link, &LinkInterface::disconnected, [name]() { qInfo().noquote() << name << "disconnected"; });
+
+        router.addLink(link);
+        if (recorder.isOpen()) {
+            recorder.attach(link);
+        }
+        exporter.addLink(link, name);
+        links.append(link);
+    }
+    exporter.start(loader.metricsInterval());
+
+    for (auto link : std::as_const(links)) {
+        link->connectLink();
+    }
+    // 启动用时从进入 main 算起，不含动态库加载
+    qInfo().noquote() << QString("%1 links running, started in %2 ms, RSS %3 KiB")
+                             .arg(links.size())
+                             .arg(double(startup.nsecsElapsed()) / 1e6, 0, 'f', 2)
+                             .arg(residentKiB());
+
+#ifdef Q_OS_UNIX
+    installSignalHandlers(&app);
+#endif
+    // --check 时不进入事件循环，直接走关闭流程，用于校验配置和测量启动开销
+    const int ret = parser.isSet(checkOption) ? 0 : app.exec();
+
+    logReconnectStatistics();
+    exporter.stop();
+    for (auto link : std::as_const(links)) {
+        link->disconnectLink();
+        router.removeLink(link);
+        recorder.detach(link);
+    }
+    recorder.close();
+    // socket 已在各自的 I/O 线程中 deleteLater，先停掉线程让这些事件执行完，
+    // 之后不会再有线程处理连接的事件，再在主线程中析构连接
+    LinkIoThreadPool::instance()->shutdown();
+    qDeleteAll(links);
+    return ret;
+}
@@ -0,0 +1,241 @@
+﻿/**************************************************************************
+ *   文件名	：ftpclient.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "ftpclient.h"
+#include "mavlinkdispatcher.h"
+#include "mavlinkencoder.h"
+
+#include <string.h>
+
+using namespace MavlinkFtp;
+
+namespace {
+constexpr int kPollMs = 10;
+constexpr qint64 kProgressUs = 100000;
+constexpr int kResultHistory = 64; // 保留的已结束下载统计
+} // namespace
+
+FtpClient::FtpClient(MavlinkEncoder *encoder, QObject *parent)
+    : QObject(parent)
+    , m_encoder(encoder)
+{
+    m_clock.start();
+    connect(&m_timer, &QTimer::timeout, this, &FtpClient::poll);
+}
+
+void FtpClient::attach(MavlinkDispatcher *dispatcher)
+{
+    dispatcher->on<mavlink_file_transfer_protocol_t>(
+        [this](const mavlink_file_transfer_protocol_t &message, const mavlink_message_t &frame) {
+            received(message, frame);
+        });
+}
+
+int FtpClient::download(LinkInterface *link,
+                        uint8_t systemId,
+                        uint8_t componentId,
+                        const QString &remotePath,
+                        const QString &fileName)
+{
+    QSharedPointer<Transfer> transfer(new Transfer());
+    transfer->id = m_nextId++;
+    transfer->link = link;
+    transfer->systemId = systemId;
+    transfer->componentId = componentId;
+    transfer->download.reset(new FtpDownload(remotePath, fileName));
+    Transfer *t = transfer.data();
+    transfer->download->setSender([this, t](Payload &request, bool resend) { send(t, request, resend); });
+    m_transfers.append(transfer);
+
+    startQueued();
+    if (!m_timer.isActive()) {
+        m_timer.start(kPollMs);
+    }
+    return transfer->id;
+}
+
+void FtpClient::cancel(int id)
+{
+    for (int i = 0; i < m_transfers.size(); ++i) {
+        if (m_transfers.at(i)->id == id) {
+            FtpDownload *download = m_transfers.at(i)->download.data();
+            if (download->state() == FtpDownload::Idle) {
+                // 还在排队，没有会话需要关闭
+                m_transfers.removeAt(i);
+                emit downloadFinished(id, false, QStringLiteral("canceled"));
+                return;
+            }
+            download->cancel(now());
+            finished(i);
+            startQueued();
+            return;
+        }
+    }
+}
+
+bool FtpClient::resetSessions(LinkInterface *link, uint8_t systemId, uint8_t componentId)
+{
+    Transfer transfer{0, link, systemId, componentId, {}};
+    Payload request;
+    memset(&request, 0, kHeaderSize);
+    request.opcode = ResetSessions;
+    send(&transfer, request, false);
+    return link != nullptr;
+}
+
+FtpDownload::Statistics FtpClient::statistics(int id) const
+{
+    for (const auto &transfer : m_transfers) {
+        if (transfer->id == id) {
+            return transfer->download->statistics();
+        }
+    }
+    return m_results.value(id);
+}
+
+void FtpClient::send(Transfer *transfer, Payload &request, bool resend)
+{
+    if (!resend) {
+        request.seqNumber = m_sequence++;
+    }
+    if (transfer->link.isNull()) {
+        return;
+    }
+    mavlink_file_transfer_protocol_t message;
+    message.target_network = 0;
+    message.target_system = transfer->systemId;
+    message.target_component = transfer->componentId;
+    memcpy(message.payload, &request, kHeaderSize + request.size);
+    // 只写有效部分，其余由编码器补零
+    m_encoder->send(transfer->link.data(),
+                    MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL,
+                    &message,
+                    3 + kHeaderSize + request.size);
+}
+
+void FtpClient::received(const mavlink_file_transfer_protocol_t &message, const mavlink_message_t &frame)
+{
+    if (message.target_system != m_encoder->systemId()) {
+        return;
+    }
+    const auto &reply = *reinterpret_cast<const Payload *>(message.payload);
+    for (int i = 0; i < m_transfers.size(); ++i) {
+        Transfer *transfer = m_transfers.at(i).data();
+        FtpDownload *download = transfer->download.data();
+        if (transfer->systemId != frame.sysid || transfer->componentId != frame.compid
+            || !download->accepts(reply)) {
+            continue;
+        }
+        download->received(reply, now());
+        if (finished(i)) {
+            startQueued();
+        }
+        return;
+    }
+}
+
+bool FtpClient::finished(int index)
+{
+    const auto transfer = m_transfers.at(index);
+    const FtpDownload *download = transfer->download.data();
+    if (download->isActive() || download->state() == FtpDownload::Idle) {
+        return false;
+    }
+
+    const bool busy = download->statistics().error == NoSessionsAvailable;
+    if (busy) {
+        // 其它会话结束后重试，并把该飞控的并发数限制为当前打开的会话数
+        int open = 0;
+        for (const auto &other : std::as_const(m_transfers)) {
+            if (other != transfer && other->download->isActive() && other->systemId == transfer->systemId
+                && other->componentId == transfer->componentId) {
+                ++open;
+            }
+        }
+        if (open > 0) {
+            m_sessionLimits.insert(key(transfer->systemId, transfer->componentId), open);
+            transfer->download.reset(new FtpDownload(download->remotePath(), download->fileName()));
+            Transfer *t = transfer.data();
+            transfer->download->setSender([this, t](Payload &request, bool resend) { send(t, request, resend); });
+            return false;
+        }
+    }
+
+    m_transfers.removeAt(index);
+    if (m_results.size() >= kResultHistory) {
+        m_results.erase(m_results.begin());
+    }
+    m_results.insert(transfer->id, download->statistics());
+    emit downloadProgress(transfer->id, download->statistics().received, download->statistics().size);
+    emit downloadFinished(transfer->id, download->state() == FtpDownload::Done, download->errorString());
+    return true;
+}
+
+void FtpClient::startQueued()
+{
+    QHash<quint16, int> open;
+    for (const auto &transfer : std::as_const(m_transfers)) {
+        if (transfer->download->isActive()) {
+            ++open[key(transfer->systemId, transfer->componentId)];
+        }
+    }
+    for (const auto &transfer : std::as_const(m_transfers)) {
+        if (transfer->download->state() != FtpDownload::Idle) {
+            continue;
+        }
+        const quint16 target = key(transfer->systemId, transfer->componentId);
+        if (open.value(target) < m_sessionLimits.value(target, m_maxSessions)) {
+            ++open[target];
+            transfer->download->start(now());
+        }
+    }
+}
+
+void FtpClient::poll()
+{
+    const qint64 current = now();
+    const bool report = current - m_lastProgress >= kProgressUs;
+    if (report) {
+        m_lastProgress = current;
+    }
+
+    bool changed = false;
+    for (int i = 0; i < m_transfers.size();) {
+        Transfer *transfer = m_transfers.at(i).data();
+        FtpDownload *download = transfer->download.data();
+        if (transfer->link.isNull() && download->isActive()) {
+            download->cancel(current); // 连接已析构
+        } else {
+            download->poll(current);
+        }
+        if (finished(i)) {
+            changed = true;
+            continue;
+        }
+        if (report && download->isActive() && download->statistics().received != transfer->reported) {
+            transfer->reported = download->statistics().received;
+            emit downloadProgress(transfer->id, transfer->reported, download->statistics().size);
+        }
+        ++i;
+    }
+    if (changed) {
+        startQueued();
+    }
+    if (m_transfers.isEmpty()) {
+        m_timer.stop();
+    }
+}
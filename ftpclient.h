@@ -0,0 +1,96 @@
+﻿/**************************************************************************
+ *   文件名	：ftpclient.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MAVLink FTP 客户端，用于从飞控下载日志等文件
+ *   使用说明 ：attach 到 MavlinkDispatcher 后调用 download 排队，同一飞控最多同时打开
+ *             maxSessions 个会话，其余排队等待；飞控回复没有空闲会话时自动降低并发数
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "ftpdownload.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QTimer>
+
+class LinkInterface;
+class MavlinkDispatcher;
+class MavlinkEncoder;
+
+class FtpClient : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FtpClient(MavlinkEncoder *encoder, QObject *parent = nullptr);
+
+    void attach(MavlinkDispatcher *dispatcher);
+
+    /// 同一飞控同时打开的会话数上限，默认 2
+    void setMaxSessions(int sessions) { m_maxSessions = qMax(1, sessions); }
+
+    /// 下载 remotePath 到本地 fileName，返回下载编号
+    int download(LinkInterface *link,
+                 uint8_t systemId,
+                 uint8_t componentId,
+                 const QString &remotePath,
+                 const QString &fileName);
+    void cancel(int id);
+    /// 关闭飞控上的全部会话，用于清理上次异常退出遗留的会话
+    bool resetSessions(LinkInterface *link, uint8_t systemId, uint8_t componentId = MAV_COMP_ID_AUTOPILOT1);
+
+    /// 正在进行或已结束的下载的统计，编号未知时返回空统计
+    FtpDownload::Statistics statistics(int id) const;
+
+signals:
+    /// 下载进度，每 100 毫秒最多一次
+    void downloadProgress(int id, qint64 received, qint64 size);
+    void downloadFinished(int id, bool ok, const QString &error);
+
+private:
+    struct Transfer
+    {
+        int id;
+        QPointer<LinkInterface> link;
+        uint8_t systemId;
+        uint8_t componentId;
+        QSharedPointer<FtpDownload> download;
+        qint64 reported = -1; // 上次报告进度时的字节数
+    };
+
+    static quint16 key(uint8_t systemId, uint8_t componentId) { return quint16(systemId << 8 | componentId); }
+
+    void send(Transfer *transfer, MavlinkFtp::Payload &request, bool resend);
+    void received(const mavlink_file_transfer_protocol_t &message, const mavlink_message_t &frame);
+    /// 结束的下载发出信号并移出列表，返回是否已结束
+    bool finished(int index);
+    /// 启动排队中的下载
+    void startQueued();
+    void poll();
+    qint64 now() const { return m_clock.nsecsElapsed() / 1000; }
+
+    MavlinkEncoder *m_encoder;
+    QList<QSharedPointer<Transfer>> m_transfers; // 按提交顺序，包括排队中的
+    QHash<int, FtpDownload::Statistics> m_results;
+    QHash<quint16, int> m_sessionLimits; // 飞控回复没有空闲会话后记下的并发数
+    int m_maxSessions = 2;
+    int m_nextId = 1;
+    quint16 m_sequence = 0;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_lastProgress = 0;
+};
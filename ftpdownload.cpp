@@ -0,0 +1,550 @@
+﻿/**************************************************************************
+ *   文件名	：ftpdownload.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "ftpdownload.h"
+
+#include <iterator>
+#include <string.h>
+
+using namespace MavlinkFtp;
+
+namespace {
+constexpr qint64 kInitialRtoUs = 1000000; // 没有往返时间样本时的超时
+constexpr qint64 kMinRtoUs = 20000;
+constexpr qint64 kMaxRtoUs = 5000000;
+constexpr qint64 kMinIdleUs = 50000; // 连续读取停止的最短判定时间
+constexpr double kHighLoss = 0.10;
+constexpr double kLowLoss = 0.02;
+constexpr int kChunkStep = 16;
+
+QString nakString(uint8_t error)
+{
+    switch (error) {
+    case FailErrno:
+        return QStringLiteral("remote I/O error");
+    case InvalidDataSize:
+        return QStringLiteral("invalid data size");
+    case InvalidSession:
+        return QStringLiteral("invalid session");
+    case NoSessionsAvailable:
+        return QStringLiteral("no sessions available");
+    case EndOfFile:
+        return QStringLiteral("end of file");
+    case UnknownCommand:
+        return QStringLiteral("unknown command");
+    case FileProtected:
+        return QStringLiteral("file protected");
+    case FileNotFound:
+        return QStringLiteral("file not found");
+    default:
+        return QStringLiteral("request failed");
+    }
+}
+} // namespace
+
+FtpDownload::FtpDownload(const QString &remotePath, const QString &fileName)
+    : m_remotePath(remotePath)
+    , m_file(fileName)
+{
+    memset(&m_request, 0, sizeof(m_request));
+}
+
+FtpDownload::~FtpDownload()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+    }
+}
+
+void FtpDownload::start(qint64 nowUs)
+{
+    m_stats = Statistics();
+    m_startedAt = nowUs;
+    m_chunk = kDataSize;
+    m_stats.chunkSize = m_chunk;
+    m_ranges.clear();
+    m_reads.clear();
+    m_bursting = false;
+    m_stalls = 0;
+    m_srtt = 0;
+    m_rttvar = 0;
+    m_state = Opening;
+
+    const QByteArray path = m_remotePath.toUtf8();
+    if (path.isEmpty() || path.size() > kDataSize) {
+        fail(QStringLiteral("invalid remote path"), nowUs);
+        return;
+    }
+    send(OpenFileRO, 0, int(path.size()), nowUs, path.constData());
+}
+
+void FtpDownload::cancel(qint64 nowUs)
+{
+    if (isActive()) {
+        fail(QStringLiteral("canceled"), nowUs);
+    }
+}
+
+bool FtpDownload::accepts(const Payload &reply) const
+{
+    if (m_state == Opening) {
+        return reply.reqOpcode == OpenFileRO && reply.seqNumber == uint16_t(m_request.seqNumber + 1);
+    }
+    return (m_state == Reading || m_state == Closing) && reply.session == m_session
+           && reply.reqOpcode != OpenFileRO;
+}
+
+void FtpDownload::received(const Payload &reply, qint64 nowUs)
+{
+    if (!isActive() || (reply.opcode != Ack && reply.opcode != Nak)) {
+        return;
+    }
+    const bool ack = reply.opcode == Ack;
+    const uint8_t error = reply.size > 0 ? reply.data[0] : uint8_t(Fail);
+
+    switch (reply.reqOpcode) {
+    case OpenFileRO:
+        if (m_state != Opening) {
+            return;
+        }
+        if (!ack) {
+            m_stats.error = error;
+            fail(nakString(error), nowUs);
+            return;
+        }
+        opened(reply, nowUs);
+        break;
+    case BurstReadFile:
+        if (m_state != Reading) {
+            return;
+        }
+        if (ack) {
+            burstData(reply, nowUs);
+        } else if (error == EndOfFile) {
+            // 部分实现以 EOF 结束连续读取而不设置 burstComplete
+            if (m_bursting) {
+                endBurst(false, nowUs);
+            }
+        } else {
+            m_stats.error = error;
+            fail(nakString(error), nowUs);
+        }
+        break;
+    case ReadFile:
+        if (m_state != Reading) {
+            return;
+        }
+        if (!ack) {
+            m_stats.error = error;
+            fail(nakString(error), nowUs);
+            return;
+        }
+        readData(reply, nowUs);
+        break;
+    case TerminateSession:
+        if (m_state == Closing) {
+            finish(Done, nowUs);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void FtpDownload::poll(qint64 nowUs)
+{
+    if (!isActive()) {
+        return;
+    }
+
+    if (m_waiting && nowUs - m_sentAt >= rto(m_tries)) {
+        ++m_stats.timeouts;
+        if (m_tries < kMaxTries) {
+            resend(nowUs);
+        } else if (m_state == Closing) {
+            finish(Done, nowUs); // 数据已完整，会话由飞控自行超时
+            return;
+        } else {
+            fail(QStringLiteral("timeout"), nowUs);
+            return;
+        }
+    }
+    if (m_state != Reading) {
+        return;
+    }
+
+    if (m_bursting && !m_waiting) {
+        // 包间隔的数倍内没有新数据，认为连续读取已中断
+        const qint64 idle = qMax(qMax(kMinIdleUs, m_gapUs * 8), rto(1));
+        if (nowUs - m_lastPacketAt >= idle) {
+            ++m_stats.timeouts;
+            endBurst(true, nowUs);
+            if (m_state != Reading) {
+                return;
+            }
+        }
+    }
+
+    QList<Read> expired;
+    for (auto it = m_reads.begin(); it != m_reads.end();) {
+        if (nowUs - it->sentAt >= rto(it->tries)) {
+            expired.append(*it);
+            it = m_reads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const Read &read : std::as_const(expired)) {
+        ++m_stats.timeouts;
+        if (read.tries >= kMaxTries) {
+            fail(QStringLiteral("timeout"), nowUs);
+            return;
+        }
+        sendRead(read.offset, read.size, read.tries + 1, nowUs);
+    }
+    next(nowUs);
+}
+
+void FtpDownload::send(Opcode opcode, quint32 offset, int size, qint64 nowUs, const void *data)
+{
+    memset(&m_request, 0, sizeof(m_request));
+    m_request.session = m_session;
+    m_request.opcode = opcode;
+    m_request.size = uint8_t(size);
+    m_request.offset = offset;
+    if (data) {
+        memcpy(m_request.data, data, size);
+    }
+    m_sentAt = nowUs;
+    m_tries = 1;
+    m_waiting = true;
+    m_send(m_request, false);
+}
+
+void FtpDownload::resend(qint64 nowUs)
+{
+    ++m_tries;
+    ++m_stats.retries;
+    m_sentAt = nowUs;
+    m_send(m_request, true);
+}
+
+void FtpDownload::sendRead(quint32 offset, quint32 size, int tries, qint64 nowUs)
+{
+    Payload request;
+    memset(&request, 0, kHeaderSize);
+    request.session = m_session;
+    request.opcode = ReadFile;
+    request.size = uint8_t(size);
+    request.offset = offset;
+    m_reads.append({offset, size, nowUs, tries});
+    ++m_stats.reads;
+    if (tries > 1) {
+        ++m_stats.retries;
+    }
+    m_send(request, false);
+}
+
+void FtpDownload::opened(const Payload &reply, qint64 nowUs)
+{
+    if (m_tries == 1) {
+        sampleRtt(nowUs - m_sentAt);
+    }
+    m_waiting = false;
+    m_session = reply.session;
+    m_size = 0;
+    if (reply.size >= sizeof(m_size)) {
+        memcpy(&m_size, reply.data, sizeof(m_size));
+    }
+    m_stats.size = m_size;
+    m_state = Reading; // 此后失败需要结束会话
+
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        fail(m_file.errorString(), nowUs);
+        return;
+    }
+    m_created = true;
+    if (m_size > 0) {
+        // 预先分配并映射，乱序到达的数据直接写到最终位置
+        if (!m_file.resize(m_size) || (m_map = m_file.map(0, m_size)) == nullptr) {
+            fail(m_file.errorString(), nowUs);
+            return;
+        }
+    }
+    next(nowUs);
+}
+
+void FtpDownload::burstData(const Payload &reply, qint64 nowUs)
+{
+    ++m_stats.packets;
+    const quint32 offset = reply.offset;
+    const int size = qMin<int>(reply.size, kDataSize);
+
+    // 上一次连续读取的迟到数据照常保存，但不计入本次的丢包统计
+    if (m_bursting) {
+        if (m_waiting) {
+            if (m_tries == 1) {
+                sampleRtt(nowUs - m_sentAt);
+            }
+            m_waiting = false;
+        } else {
+            const qint64 gap = nowUs - m_lastPacketAt;
+            m_gapUs = m_gapUs == 0 ? gap : (m_gapUs * 7 + gap) / 8;
+        }
+        m_lastPacketAt = nowUs;
+        if (offset > m_burstNext) {
+            ++m_stats.gaps;
+            m_burstLost += offset - m_burstNext;
+        }
+        m_burstGot += size;
+        m_burstNext = qMax(m_burstNext, offset + quint32(size));
+    }
+
+    if (store(offset, reply.data, size) == 0) {
+        ++m_stats.duplicates;
+    }
+    if (m_bursting && (reply.burstComplete || m_burstNext >= m_size)) {
+        endBurst(false, nowUs);
+    } else {
+        next(nowUs);
+    }
+}
+
+void FtpDownload::readData(const Payload &reply, qint64 nowUs)
+{
+    for (auto it = m_reads.begin(); it != m_reads.end(); ++it) {
+        if (it->offset == reply.offset) {
+            if (it->tries == 1) {
+                sampleRtt(nowUs - it->sentAt);
+            }
+            m_reads.erase(it);
+            break;
+        }
+    }
+    ++m_stats.packets;
+    if (store(reply.offset, reply.data, qMin<int>(reply.size, kDataSize)) == 0) {
+        ++m_stats.duplicates;
+    }
+    next(nowUs);
+}
+
+qint64 FtpDownload::store(quint32 offset, const uint8_t *data, int size)
+{
+    if (offset >= m_size || size <= 0) {
+        return 0;
+    }
+    const quint32 end = offset + qMin<quint32>(quint32(size), m_size - offset);
+    memcpy(m_map + offset, data, end - offset);
+
+    // 与相交或相邻的区间合并
+    quint32 begin = offset;
+    quint32 finish = end;
+    qint64 covered = 0;
+    auto it = m_ranges.upperBound(offset);
+    if (it != m_ranges.begin() && std::prev(it).value() >= offset) {
+        --it;
+    }
+    while (it != m_ranges.end() && it.key() <= end) {
+        const quint32 low = qMax(it.key(), offset);
+        const quint32 high = qMin(it.value(), end);
+        if (high > low) {
+            covered += high - low;
+        }
+        begin = qMin(begin, it.key());
+        finish = qMax(finish, it.value());
+        it = m_ranges.erase(it);
+    }
+    m_ranges.insert(begin, finish);
+
+    const qint64 added = qint64(end - offset) - covered;
+    m_stats.received += added;
+    return added;
+}
+
+bool FtpDownload::nextHole(quint32 from, quint32 *begin, quint32 *end) const
+{
+    quint32 position = from;
+    auto it = m_ranges.upperBound(from);
+    if (it != m_ranges.begin() && std::prev(it).value() > from) {
+        position = std::prev(it).value();
+    }
+    if (position >= m_size) {
+        return false;
+    }
+    *begin = position;
+    *end = it != m_ranges.end() ? it.key() : m_size;
+    return true;
+}
+
+quint32 FtpDownload::tailHole() const
+{
+    return m_ranges.isEmpty() ? 0 : qMin(std::prev(m_ranges.end()).value(), m_size);
+}
+
+void FtpDownload::startBurst(quint32 offset, qint64 nowUs)
+{
+    m_bursting = true;
+    m_burstNext = offset;
+    m_burstLost = 0;
+    m_burstGot = 0;
+    m_lastPacketAt = nowUs;
+    ++m_stats.bursts;
+    send(BurstReadFile, offset, m_chunk, nowUs);
+}
+
+void FtpDownload::endBurst(bool stalled, qint64 nowUs)
+{
+    m_bursting = false;
+    m_waiting = false;
+    if (stalled && m_burstGot == 0) {
+        if (++m_stalls >= kMaxTries) {
+            fail(QStringLiteral("timeout"), nowUs);
+            return;
+        }
+    } else {
+        m_stalls = 0;
+    }
+
+    // 误码造成的丢包随帧长增加，丢包多时减小每包长度，丢包少时逐步恢复
+    const qint64 total = m_burstLost + m_burstGot;
+    if (total > 0) {
+        m_stats.loss = double(m_burstLost) / double(total);
+        if (m_stats.loss > kHighLoss) {
+            m_chunk = qMax(kMinChunk, m_chunk * 3 / 4);
+        } else if (m_stats.loss < kLowLoss) {
+            m_chunk = qMin(int(kDataSize), m_chunk + kChunkStep);
+        }
+        m_stats.chunkSize = m_chunk;
+    }
+    next(nowUs);
+}
+
+void FtpDownload::next(qint64 nowUs)
+{
+    if (m_state != Reading || m_waiting) {
+        return;
+    }
+    if (m_stats.received >= m_size) {
+        close(nowUs);
+        return;
+    }
+
+    if (m_bursting) {
+        // 连续读取按偏移顺序发送，已越过的空缺就是丢失的数据，可以立即补读
+        fillReads(m_burstNext, nowUs);
+        return;
+    }
+    const quint32 tail = tailHole();
+    if (m_size - tail > quint32(kReadWindow * m_chunk)) {
+        startBurst(tail, nowUs);
+        fillReads(tail, nowUs);
+    } else {
+        fillReads(m_size, nowUs);
+    }
+}
+
+void FtpDownload::fillReads(quint32 limit, qint64 nowUs)
+{
+    quint32 position = 0;
+    quint32 begin;
+    quint32 end;
+    while (m_reads.size() < kReadWindow && nextHole(position, &begin, &end) && begin < limit) {
+        end = qMin(end, limit);
+        bool busy = false;
+        for (const Read &read : std::as_const(m_reads)) {
+            if (read.offset <= begin && begin < read.offset + read.size) {
+                position = read.offset + read.size; // 跳过在途的部分
+                busy = true;
+                break;
+            }
+        }
+        if (busy) {
+            continue;
+        }
+
+        quint32 size = qMin(quint32(m_chunk), end - begin);
+        for (const Read &read : std::as_const(m_reads)) {
+            if (read.offset > begin && read.offset < begin + size) {
+                size = read.offset - begin;
+            }
+        }
+        sendRead(begin, size, 1, nowUs);
+        position = begin + size;
+    }
+}
+
+void FtpDownload::close(qint64 nowUs)
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    m_file.close();
+    m_reads.clear();
+    m_state = Closing;
+    send(TerminateSession, 0, 0, nowUs);
+}
+
+void FtpDownload::sampleRtt(qint64 sampleUs)
+{
+    sampleUs = qMax<qint64>(sampleUs, 1);
+    if (m_srtt == 0) {
+        m_srtt = sampleUs;
+        m_rttvar = sampleUs / 2;
+    } else {
+        const qint64 delta = sampleUs > m_srtt ? sampleUs - m_srtt : m_srtt - sampleUs;
+        m_rttvar = (m_rttvar * 3 + delta) / 4;
+        m_srtt = (m_srtt * 7 + sampleUs) / 8;
+    }
+    m_stats.srttUs = m_srtt;
+}
+
+qint64 FtpDownload::rto(int tries) const
+{
+    const qint64 base = m_srtt == 0 ? kInitialRtoUs : qMax(kMinRtoUs, m_srtt + 4 * m_rttvar);
+    return qMin(base << qBound(0, tries - 1, 4), kMaxRtoUs);
+}
+
+void FtpDownload::finish(State state, qint64 nowUs)
+{
+    m_state = state;
+    m_stats.elapsedUs = nowUs - m_startedAt;
+    if (m_stats.elapsedUs > 0) {
+        m_stats.bytesPerSecond = double(m_stats.received) * 1e6 / double(m_stats.elapsedUs);
+    }
+    m_reads.clear();
+    m_bursting = false;
+    m_waiting = false;
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    m_file.close();
+}
+
+void FtpDownload::fail(const QString &error, qint64 nowUs)
+{
+    if (m_state == Reading) {
+        // 会话已打开，通知飞控释放；不等待回应
+        send(TerminateSession, 0, 0, nowUs);
+    }
+    m_errorString = error;
+    finish(Failed, nowUs);
+    if (m_created) {
+        m_file.remove();
+    }
+}
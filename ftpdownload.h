@@ -0,0 +1,161 @@
+﻿/**************************************************************************
+ *   文件名	：ftpdownload.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：通过 MAVLink FTP 下载一个文件，与收发方式无关
+ *   使用说明 ：OpenFileRO 得知文件大小后预先分配并映射输出文件，BurstReadFile 连续读取，
+ *             乱序到达的数据直接写入映射中的对应位置；连续读取结束后剩下的空缺较少时用
+ *             并发的 ReadFile 补齐，较多时从第一个空缺处重新连续读取。每包的数据长度按
+ *             观测到的丢包率调整。时间由调用方传入（微秒）
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "mavlinkftp.h"
+
+#include <QFile>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+#include <functional>
+
+class FtpDownload
+{
+public:
+    enum State {
+        Idle,
+        Opening,
+        Reading,
+        Closing,
+        Done,
+        Failed
+    };
+
+    struct Statistics
+    {
+        qint64 size = 0;
+        qint64 received = 0;   // 已写入文件的字节数
+        quint64 packets = 0;   // 收到的数据包
+        quint64 duplicates = 0; // 数据已有的包
+        quint64 gaps = 0;      // 连续读取中检测到的丢包区间
+        quint64 bursts = 0;    // 发出的 BurstReadFile
+        quint64 reads = 0;     // 发出的 ReadFile
+        quint64 retries = 0;
+        quint64 timeouts = 0;
+        qint64 elapsedUs = 0;
+        double bytesPerSecond = 0;
+        double loss = 0;       // 最近一次连续读取的丢包率
+        int chunkSize = 0;     // 当前每包请求的数据长度
+        qint64 srttUs = 0;
+        uint8_t error = MavlinkFtp::ErrorNone; // 失败时飞控返回的错误码
+    };
+
+    /// 发送请求；resend 为 false 时由调用方填写新的 seqNumber，为 true 时保持原序号重发
+    using Sender = std::function<void(MavlinkFtp::Payload &request, bool resend)>;
+
+    static constexpr int kMaxTries = 6;
+    static constexpr int kMinChunk = 64;
+    static constexpr int kReadWindow = 4; // 同时在途的 ReadFile，飞控的请求队列通常很短
+
+    FtpDownload(const QString &remotePath, const QString &fileName);
+    ~FtpDownload();
+
+    FtpDownload(const FtpDownload &) = delete;
+    FtpDownload &operator=(const FtpDownload &) = delete;
+
+    void setSender(Sender send) { m_send = std::move(send); }
+
+    void start(qint64 nowUs);
+    /// 结束会话，已写入的文件被删除
+    void cancel(qint64 nowUs);
+
+    /// 回应是否属于本次下载：打开前按序号匹配，打开后按会话号匹配
+    bool accepts(const MavlinkFtp::Payload &reply) const;
+    void received(const MavlinkFtp::Payload &reply, qint64 nowUs);
+    /// 处理超时
+    void poll(qint64 nowUs);
+
+    State state() const { return m_state; }
+    bool isActive() const { return m_state == Opening || m_state == Reading || m_state == Closing; }
+    const QString &remotePath() const { return m_remotePath; }
+    QString fileName() const { return m_file.fileName(); }
+    const QString &errorString() const { return m_errorString; }
+    const Statistics &statistics() const { return m_stats; }
+
+private:
+    struct Read
+    {
+        quint32 offset;
+        quint32 size;
+        qint64 sentAt;
+        int tries;
+    };
+
+    void send(MavlinkFtp::Opcode opcode, quint32 offset, int size, qint64 nowUs, const void *data = nullptr);
+    void resend(qint64 nowUs);
+    void sendRead(quint32 offset, quint32 size, int tries, qint64 nowUs);
+    void opened(const MavlinkFtp::Payload &reply, qint64 nowUs);
+    void burstData(const MavlinkFtp::Payload &reply, qint64 nowUs);
+    void readData(const MavlinkFtp::Payload &reply, qint64 nowUs);
+    /// 写入映射并记录区间，返回新增的字节数
+    qint64 store(quint32 offset, const uint8_t *data, int size);
+    /// from 之后的第一个空缺 [begin, end)，没有空缺时返回 false
+    bool nextHole(quint32 from, quint32 *begin, quint32 *end) const;
+    /// 延伸到文件末尾的空缺的起点，末尾已收到时返回 m_size
+    quint32 tailHole() const;
+    void startBurst(quint32 offset, qint64 nowUs);
+    void endBurst(bool stalled, qint64 nowUs);
+    /// 决定下一步：结束、连续读取文件末尾，或补读中间的空缺
+    void next(qint64 nowUs);
+    void fillReads(quint32 limit, qint64 nowUs);
+    void close(qint64 nowUs);
+    void sampleRtt(qint64 sampleUs);
+    qint64 rto(int tries) const;
+    void finish(State state, qint64 nowUs);
+    void fail(const QString &error, qint64 nowUs);
+
+    Sender m_send;
+    QString m_remotePath;
+    QFile m_file;
+    uchar *m_map = nullptr;
+
+    State m_state = Idle;
+    Statistics m_stats;
+    QString m_errorString;
+    bool m_created = false; // 输出文件由本次下载创建，失败时删除
+    qint64 m_startedAt = 0;
+    uint8_t m_session = 0;
+    quint32 m_size = 0;
+    QMap<quint32, quint32> m_ranges; // 已收到的区间 [key, value)，互不相邻
+
+    // 等待回应的单个请求（打开、开始连续读取、结束会话）
+    MavlinkFtp::Payload m_request;
+    qint64 m_sentAt = 0;
+    int m_tries = 0;
+    bool m_waiting = false;
+
+    // 连续读取
+    bool m_bursting = false;
+    quint32 m_burstNext = 0;   // 下一包应有的偏移
+    qint64 m_lastPacketAt = 0;
+    qint64 m_gapUs = 0;        // 包间隔的平均值
+    qint64 m_burstLost = 0;
+    qint64 m_burstGot = 0;
+    int m_stalls = 0;          // 连续几次连续读取中途停止且没有新数据
+    int m_chunk = MavlinkFtp::kDataSize;
+
+    QList<Read> m_reads;
+
+    qint64 m_srtt = 0;
+    qint64 m_rttvar = 0;
+};
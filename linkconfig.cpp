@@ -31,3 +31,17 @@ void LinkConfig::setInterval(quint32 newInterval)
     m_interval = newInterval;
     emit intervalChanged();
 }
+
+LinkConfig::IoThreadMode LinkConfig::ioThreadMode() const
+{
+    return m_ioThreadMode;
+}
+
+void LinkConfig::setIoThreadMode(IoThreadMode newIoThreadMode)
+{
+    if (m_ioThreadMode == newIoThreadMode) {
+        return;
+    }
+    m_ioThreadMode = newIoThreadMode;
+    emit ioThreadModeChanged();
+}
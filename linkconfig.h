@@ -7,8 +7,18 @@ class LinkConfig : public QObject
     Q_OBJECT
 public:
     explicit LinkConfig(QObject *parent = nullptr);
+
+    /// 连接收发所在的线程
+    enum IoThreadMode {
+        GuiThread,       // 调用 connectLink 的线程（一般为界面线程）
+        DedicatedThread, // 每个连接独占一个 I/O 线程
+        SharedPool       // 与其它连接共用 LinkIoThreadPool 中的线程
+    };
+    Q_ENUM(IoThreadMode)
+
     Q_PROPERTY(bool autoConnect READ autoConnect WRITE setAutoConnect NOTIFY autoConnectChanged FINAL)
     Q_PROPERTY(quint32 interval READ interval WRITE setInterval NOTIFY intervalChanged FINAL)
+    Q_PROPERTY(IoThreadMode ioThreadMode READ ioThreadMode WRITE setIoThreadMode NOTIFY ioThreadModeChanged FINAL)
 
     bool autoConnect() const;
     void setAutoConnect(bool newAutoConnect);
@@ -16,12 +26,18 @@ public:
     quint32 interval() const;
     void setInterval(quint32 newInterval);
 
+    IoThreadMode ioThreadMode() const;
+    void setIoThreadMode(IoThreadMode newIoThreadMode);
+
 signals:
     void autoConnectChanged();
 
     void intervalChanged();
 
+    void ioThreadModeChanged();
+
 private:
     bool m_autoConnect = false;
     quint32 m_interval = 3000;
+    IoThreadMode m_ioThreadMode = SharedPool;
 };
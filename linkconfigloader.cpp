@@ -0,0 +1,158 @@
+﻿/**************************************************************************
+ *   文件名	：linkconfigloader.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "linkconfigloader.h"
+#include "linkreplay.h"
+#include "linktcp.h"
+#include "linkudp.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaProperty>
+#include <QScopedPointer>
+#include <QSet>
+
+bool LinkConfigLoader::load(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_error = QString("%1: %2").arg(path, file.errorString());
+        return false;
+    }
+    if (!parse(file.readAll())) {
+        m_error = QString("%1: %2").arg(path, m_error);
+        return false;
+    }
+    return true;
+}
+
+bool LinkConfigLoader::parse(const QByteArray &json)
+{
+    m_links.clear();
+    m_error.clear();
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+    if (document.isNull()) {
+        m_error = parseError.errorString();
+        return false;
+    }
+    const QJsonObject root = document.object();
+
+    QSet<QString> names;
+    const QJsonArray links = root.value("links").toArray();
+    for (const auto &value : links) {
+        const QJsonObject object = value.toObject();
+        LinkDescription description;
+        description.type = object.value("type").toString().toLower();
+        description.name = object.value("name").toString();
+        if (description.name.isEmpty()) {
+            description.name = QString("%1%2").arg(description.type).arg(m_links.size());
+        }
+        if (names.contains(description.name)) {
+            m_error = QString("duplicate link name \"%1\"").arg(description.name);
+            return false;
+        }
+        names.insert(description.name);
+
+        description.properties = object.toVariantMap();
+        description.properties.remove("type");
+        description.properties.remove("name");
+
+        // 先试建一次，配置错误在启动时就报告
+        QString error;
+        QScopedPointer<LinkInterface> probe(createLink(description, &error));
+        if (probe.isNull()) {
+            m_error = QString("link \"%1\": %2").arg(description.name, error);
+            return false;
+        }
+        m_links.append(description);
+    }
+
+    m_forwarding = root.value("forwarding").toBool(true);
+    m_recordPath = root.value("record").toString();
+
+    const QJsonObject metrics = root.value("metrics").toObject();
+    m_metricsFile = metrics.value("file").toString();
+    m_metricsInterval = metrics.value("interval").toInt(1000);
+    const QString format = metrics.value("format").toString("prometheus").toLower();
+    if (format == "prometheus") {
+        m_metricsFormat = LinkMetricsExporter::PrometheusFormat;
+    } else if (format == "json") {
+        m_metricsFormat = LinkMetricsExporter::JsonFormat;
+    } else {
+        m_error = QString("unknown metrics format \"%1\"").arg(format);
+        return false;
+    }
+    return true;
+}
+
+LinkInterface *LinkConfigLoader::createLink(const LinkDescription &description, QString *error)
+{
+    QSharedPointer<LinkConfig> config(createConfig(description.type));
+    if (config.isNull()) {
+        if (error) {
+            *error = QString("unknown link type \"%1\"").arg(description.type);
+        }
+        return nullptr;
+    }
+
+    const QMetaObject *meta = config->metaObject();
+    for (auto it = description.properties.cbegin(); it != description.properties.cend(); ++it) {
+        const int index = meta->indexOfProperty(it.key().toUtf8().constData());
+        // setProperty 对未声明的属性会建立动态属性，这里要求必须是声明过的属性
+        if (index < 0 || !meta->property(index).isWritable()
+            || !config->setProperty(it.key().toUtf8().constData(), it.value())) {
+            if (error) {
+                *error = QString("invalid property \"%1\"").arg(it.key());
+            }
+            return nullptr;
+        }
+    }
+
+    LinkInterface *link = createInterface(description.type);
+    link->setObjectName(description.name);
+    link->setConfig(config);
+    return link;
+}
+
+LinkConfig *LinkConfigLoader::createConfig(const QString &type)
+{
+    if (type == "tcp") {
+        return new LinkTcpConfig();
+    }
+    if (type == "udp") {
+        return new LinkUdpConfig();
+    }
+    if (type == "replay") {
+        return new LinkReplayConfig();
+    }
+    return nullptr;
+}
+
+LinkInterface *LinkConfigLoader::createInterface(const QString &type)
+{
+    if (type == "tcp") {
+        return new LinkTcp();
+    }
+    if (type == "udp") {
+        return new LinkUdp();
+    }
+    return new LinkReplay();
+}
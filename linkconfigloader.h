@@ -0,0 +1,80 @@
+﻿/**************************************************************************
+ *   文件名	：linkconfigloader.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：从 JSON 文件读取连接配置并创建连接
+ *   使用说明 ：文件格式：
+ *             {
+ *               "links": [
+ *                 {"name": "fc",  "type": "udp", "localPort": 14550},
+ *                 {"name": "gcs", "type": "tcp", "ip": "10.0.0.2", "port": 5760,
+ *                  "autoConnect": true, "interval": 1000, "ioThreadMode": "DedicatedThread"},
+ *                 {"name": "log", "type": "replay", "fileName": "a.tlog", "speed": 0}
+ *               ],
+ *               "forwarding": true,
+ *               "record": "/var/log/commhelper/flight.tlog",
+ *               "metrics": {"file": "/run/commhelper.prom", "format": "prometheus", "interval": 1000}
+ *             }
+ *             type 之外的键按名字写入对应 LinkConfig 子类的 Q_PROPERTY，未知的键视为错误
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "linkmetricsexporter.h"
+
+#include <QSharedPointer>
+#include <QString>
+#include <QVariantMap>
+#include <QVector>
+
+class LinkConfig;
+class LinkInterface;
+
+class LinkConfigLoader
+{
+public:
+    struct LinkDescription
+    {
+        QString name;
+        QString type; // tcp、udp、replay
+        QVariantMap properties;
+    };
+
+    /// 读取并检查配置文件，失败时 errorString 给出原因
+    bool load(const QString &path);
+    bool parse(const QByteArray &json);
+    QString errorString() const { return m_error; }
+
+    const QVector<LinkDescription> &links() const { return m_links; }
+    bool forwarding() const { return m_forwarding; }
+    /// tlog 记录路径，为空时不记录
+    QString recordPath() const { return m_recordPath; }
+    /// 统计输出文件，为空时不输出
+    QString metricsFile() const { return m_metricsFile; }
+    LinkMetricsExporter::Format metricsFormat() const { return m_metricsFormat; }
+    int metricsInterval() const { return m_metricsInterval; }
+
+    /// 按描述创建连接（尚未 connectLink），调用方负责析构；失败时返回 nullptr 并设置 error
+    static LinkInterface *createLink(const LinkDescription &description, QString *error = nullptr);
+
+private:
+    static LinkConfig *createConfig(const QString &type);
+    static LinkInterface *createInterface(const QString &type);
+
+    QVector<LinkDescription> m_links;
+    bool m_forwarding = true;
+    QString m_recordPath;
+    QString m_metricsFile;
+    LinkMetricsExporter::Format m_metricsFormat = LinkMetricsExporter::PrometheusFormat;
+    int m_metricsInterval = 1000;
+    QString m_error;
+};
@@ -16,10 +16,163 @@
  *
  ***************************************************************************/
 #include "linkinterface.h"
+#include "linkconfig.h"
+#include "linkiothreadpool.h"
 
-LinkInterface::LinkInterface() {}
+namespace {
+constexpr int kSendRingSize = 256 * 1024; // 每个连接的发送队列大小
+constexpr int kFlushBatch = 64;           // 每次从队列中取出的帧数
+constexpr int kRxSlots = 8;               // 接收缓冲区个数
+constexpr int kRxSlotSize = 64 * 1024;    // 接收缓冲区初始容量
+} // namespace
 
-void LinkInterface::writeBytesThreadSafe(const QByteArray &byte)
+LinkInterface::LinkInterface()
+    : m_sendRing(kSendRingSize)
+    , m_rxPool(kRxSlots, kRxSlotSize)
 {
-    writeData(byte);
+    // 直接连接，在发出信号的线程中计数
+    connect(this, &LinkInterface::connected, this, [this]() { m_metrics.connected(); }, Qt::DirectConnection);
+    connect(this, &LinkInterface::disconnected, this, [this]() { m_metrics.disconnected(); }, Qt::DirectConnection);
+}
+
+LinkInterface::~LinkInterface()
+{
+    if (m_ioThread == nullptr) {
+        return;
+    }
+    if (m_ownsIoThread) {
+        if (QThread::currentThread() == m_ioThread) {
+            // 通过 deleteLater 在自身 I/O 线程中析构，等线程退出后再回收
+            QObject::connect(m_ioThread, &QThread::finished, m_ioThread, &QObject::deleteLater);
+            m_ioThread->quit();
+        } else {
+            m_ioThread->quit();
+            m_ioThread->wait();
+            delete m_ioThread;
+        }
+    } else {
+        LinkIoThreadPool::instance()->release(m_ioThread);
+    }
+}
+
+void LinkInterface::writeBytesThreadSafe(const char *bytes, int len)
+{
+    if (!m_sendRing.push(bytes, len)) {
+        return;
+    }
+    scheduleFlush();
+}
+
+void LinkInterface::commitBytes(char *data, int size)
+{
+    m_sendRing.commit(data, size);
+    scheduleFlush();
+}
+
+void LinkInterface::scheduleFlush()
+{
+    // 已安排但尚未开始的刷新会带走这次写入，不必重复唤醒
+    if (!m_flushScheduled.exchange(true)) {
+        wakeIoThread();
+    }
+}
+
+void LinkInterface::wakeIoThread()
+{
+    QMetaObject::invokeMethod(this, [this]() { flushSendQueue(); }, Qt::QueuedConnection);
+}
+
+void LinkInterface::flushStarted()
+{
+    m_flushScheduled.exchange(false);
+}
+
+void LinkInterface::flushSendQueue()
+{
+    flushStarted();
+
+    LinkSendRing::Span spans[kFlushBatch];
+    m_txBuffer.resize(0);
+    int count;
+    while ((count = m_sendRing.peek(spans, kFlushBatch)) > 0) {
+        for (int i = 0; i < count; ++i) {
+            m_txBuffer.append(spans[i].data, spans[i].size);
+        }
+        m_sendRing.release();
+    }
+    if (!m_txBuffer.isEmpty()) {
+        const qint64 written = qint64(writeData(m_txBuffer));
+        if (written > 0) {
+            m_metrics.sent(written);
+        }
+    }
+}
+
+void LinkInterface::emitReceiveData(const QByteArray &data)
+{
+    m_metrics.received(data.size());
+    emit receiveData(this, data);
+}
+
+LinkMetricsSnapshot LinkInterface::metricsSnapshot() const
+{
+    LinkMetricsSnapshot snapshot = m_metrics.snapshot();
+    snapshot.queueDepth = m_sendRing.depth();
+    snapshot.queueDrops = m_sendRing.drops();
+    snapshot.queueHighWater = m_sendRing.highWaterBytes();
+    snapshot.rxAllocations = m_rxPool.allocations();
+    return snapshot;
+}
+
+QVariantMap LinkInterface::metricsMap()
+{
+    const LinkMetricsSnapshot snapshot = metricsSnapshot();
+    const QVariantMap map = snapshot.toVariantMap(m_lastMetrics.timestampNs ? &m_lastMetrics : nullptr);
+    m_lastMetrics = snapshot;
+    return map;
+}
+
+void LinkInterface::clearSendQueue()
+{
+    LinkSendRing::Span spans[kFlushBatch];
+    while (m_sendRing.peek(spans, kFlushBatch) > 0) {
+        m_sendRing.release();
+    }
+}
+
+void LinkInterface::detachIoThread(const std::function<void()> &teardown)
+{
+    QThread *caller = QThread::currentThread();
+    invokeInLinkThread(
+        [this, caller, &teardown]() {
+            teardown();
+            // moveToThread 只能在所属线程中调用，线程已停止时留在原处
+            if (QThread::currentThread() == thread() && thread() != caller) {
+                moveToThread(caller);
+            }
+        },
+        true);
+}
+
+void LinkInterface::attachIoThread()
+{
+    if (m_ioThread || m_config.isNull()) {
+        return;
+    }
+
+    switch (m_config->ioThreadMode()) {
+    case LinkConfig::GuiThread:
+        return;
+    case LinkConfig::DedicatedThread:
+        m_ioThread = new QThread();
+        m_ioThread->setObjectName(metaObject()->className());
+        m_ioThread->start();
+        m_ownsIoThread = true;
+        break;
+    case LinkConfig::SharedPool:
+        m_ioThread = LinkIoThreadPool::instance()->acquire();
+        m_ownsIoThread = false;
+        break;
+    }
+    moveToThread(m_ioThread);
 }
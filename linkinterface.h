@@ -19,7 +19,14 @@
 #pragma once
 #include <QObject>
 #include <QSharedPointer>
+#include <QThread>
 // #include "linkconfig.h"
+#include "linkmetrics.h"
+#include "linkrxpool.h"
+#include "linksendring.h"
+
+#include <atomic>
+#include <functional>
 
 class LinkConfig;
 
@@ -28,6 +35,7 @@ class LinkInterface : public QObject
     Q_OBJECT
 public:
     LinkInterface();
+    ~LinkInterface();
 
     /// 打开连接，具备断线后自动重连功能， 直到close调用后停止重连
     virtual bool connectLink() = 0;
@@ -36,18 +44,84 @@ public:
     /// 返回连接状态
     virtual bool isConnected() const = 0;
 
-    void writeBytesThreadSafe(const char *bytes, int len)
+    /// 任意线程可调用：写入无锁发送队列，由连接的 I/O 线程合并发送，队列满时丢弃
+    void writeBytesThreadSafe(const char *bytes, int len);
+    void writeBytesThreadSafe(const QByteArray &byte)
     {
-        writeBytesThreadSafe(QByteArray(bytes, len));
+        writeBytesThreadSafe(byte.constData(), int(byte.size()));
     }
-    void writeBytesThreadSafe(const QByteArray &byte);
+    /// 任意线程可调用：在发送队列中申请 size 字节直接写入，队列满时返回 nullptr。
+    /// 每次成功的申请都必须调用 commitBytes，包括写入失败的情况（此时 size 传 0）；
+    /// 提交之前同一队列中后申请的数据也不会发出
+    char *claimBytes(int size) { return m_sendRing.claim(size); }
+    /// 提交 claimBytes 得到的空间，size 可小于申请的大小，size <= 0 时放弃这段空间
+    void commitBytes(char *data, int size);
+
+    /// 发送队列中尚未发出的帧数
+    quint64 sendQueueDepth() const { return m_sendRing.depth(); }
+    /// 发送队列满被丢弃的帧数
+    quint64 sendQueueDrops() const { return m_sendRing.drops(); }
+    /// 发送队列占用字节数的历史最大值
+    qint64 sendQueueHighWater() const { return m_sendRing.highWaterBytes(); }
+
+    /// 接收路径累计的内存申请次数
+    quint64 rxAllocations() const { return m_rxPool.allocations(); }
+    /// 接收路径最近每秒的内存申请次数，正常情况下应接近 0
+    double rxAllocationsPerSecond() const { return m_rxPool.allocationsPerSecond(); }
+
+    /// 吞吐、错误和延迟统计，解析错误和分发延迟由路由填写
+    LinkMetrics &metrics() { return m_metrics; }
+    const LinkMetrics &metrics() const { return m_metrics; }
+    /// 任意线程可调用：统计快照，含发送队列状态
+    LinkMetricsSnapshot metricsSnapshot() const;
+    /// 供 QML 定时轮询，附带与上一次调用之间的每秒速率，只在界面线程中调用
+    Q_INVOKABLE QVariantMap metricsMap();
 
     void setConfig(QSharedPointer<LinkConfig> config) { m_config = config; }
     QSharedPointer<LinkConfig> getConfig() const { return m_config; }
 
 protected:
+    /// 只在连接所属线程中调用
     virtual quint64 writeData(const QByteArray &data) = 0;
 
+    /// 通知 I/O 线程发送队列中有新数据，默认向连接所属线程投递一次 flushSendQueue
+    virtual void wakeIoThread();
+    /// I/O 线程中调用：取空发送队列，合并为一次 writeData
+    void flushSendQueue();
+    /// 自行消费发送队列的子类在开始取数据前调用，之后写入的数据会再次唤醒
+    void flushStarted();
+    /// 丢弃发送队列中的全部数据，调用时不能有其它消费者
+    void clearSendQueue();
+    LinkSendRing &sendRing() { return m_sendRing; }
+    /// I/O 线程中调用：计入接收统计后发出 receiveData
+    void emitReceiveData(const QByteArray &data);
+    /// I/O 线程中读取数据使用的缓冲区池
+    LinkRxBufferPool &rxPool() { return m_rxPool; }
+
+    /// 按配置的 IoThreadMode 把连接移到 I/O 线程，之后创建的 socket、定时器都在该线程中运行，
+    /// 必须在连接当前所属线程中调用，重复调用无副作用
+    void attachIoThread();
+
+    /// 析构前调用：在 I/O 线程中执行 teardown（关闭、回收 socket 等），再把连接移回调用线程，
+    /// 之后 I/O 线程不会再执行该连接的事件，可以在调用线程中安全析构
+    void detachIoThread(const std::function<void()> &teardown);
+
+    /// 在连接所属线程中执行 func，wait 为 true 时阻塞等待执行完成。
+    /// 所属线程已停止时没有事件循环，阻塞投递会一直等下去，直接在当前线程中执行
+    template<typename Func>
+    void invokeInLinkThread(Func &&func, bool wait = false)
+    {
+        QThread *linkThread = thread();
+        if (QThread::currentThread() == linkThread
+            || (wait && (linkThread == nullptr || !linkThread->isRunning()))) {
+            func();
+        } else {
+            QMetaObject::invokeMethod(this,
+                                      std::forward<Func>(func),
+                                      wait ? Qt::BlockingQueuedConnection : Qt::QueuedConnection);
+        }
+    }
+
 signals:
     void receiveData(const LinkInterface *link, const QByteArray &data);
     void sendData(const QByteArray &data);
@@ -60,5 +134,18 @@ signals:
     void linkError(const QString &title, const QString &error);
 
 private:
+    /// 写入发送队列后调用，必要时唤醒 I/O 线程
+    void scheduleFlush();
+
     QSharedPointer<LinkConfig> m_config;
+    QThread *m_ioThread = nullptr;
+    bool m_ownsIoThread = false;
+
+    LinkSendRing m_sendRing;
+    std::atomic_bool m_flushScheduled{false};
+    QByteArray m_txBuffer; // 合并发送用，只在 I/O 线程中访问
+    LinkRxBufferPool m_rxPool;
+
+    LinkMetrics m_metrics;
+    LinkMetricsSnapshot m_lastMetrics; // metricsMap 计算速率用
 };
@@ -0,0 +1,99 @@
+﻿/**************************************************************************
+ *   文件名	：linkiothreadpool.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "linkiothreadpool.h"
+
+#include <QGlobalStatic>
+#include <QMutexLocker>
+#include <QThread>
+
+Q_GLOBAL_STATIC(LinkIoThreadPool, linkIoThreadPool)
+
+LinkIoThreadPool::LinkIoThreadPool()
+    : m_maxThreads(qBound(1, QThread::idealThreadCount(), 4))
+{}
+
+LinkIoThreadPool::~LinkIoThreadPool()
+{
+    shutdown();
+}
+
+void LinkIoThreadPool::shutdown()
+{
+    // 等待时不持锁，线程退出前析构的连接还会调用 release
+    QList<QThread *> threads;
+    {
+        QMutexLocker l(&m_mutex);
+        threads.swap(m_threads);
+        m_loads.clear();
+    }
+    for (auto thread : std::as_const(threads)) {
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+}
+
+LinkIoThreadPool *LinkIoThreadPool::instance()
+{
+    return linkIoThreadPool();
+}
+
+void LinkIoThreadPool::setMaxThreads(int count)
+{
+    QMutexLocker l(&m_mutex);
+    m_maxThreads = qMax(1, count);
+}
+
+int LinkIoThreadPool::maxThreads() const
+{
+    QMutexLocker l(&m_mutex);
+    return m_maxThreads;
+}
+
+QThread *LinkIoThreadPool::acquire()
+{
+    QMutexLocker l(&m_mutex);
+    int index = -1;
+    for (int i = 0; i < m_loads.size(); ++i) {
+        if (index < 0 || m_loads[i] < m_loads[index]) {
+            index = i;
+        }
+    }
+
+    // 已有线程都在忙且未到上限时新建一个
+    if (index < 0 || (m_loads[index] > 0 && m_threads.size() < m_maxThreads)) {
+        auto thread = new QThread();
+        thread->setObjectName(QString("LinkIo%1").arg(m_threads.size()));
+        thread->start();
+        m_threads.append(thread);
+        m_loads.append(0);
+        index = m_threads.size() - 1;
+    }
+
+    m_loads[index]++;
+    return m_threads[index];
+}
+
+void LinkIoThreadPool::release(QThread *thread)
+{
+    QMutexLocker l(&m_mutex);
+    auto index = m_threads.indexOf(thread);
+    if (index >= 0 && m_loads[index] > 0) {
+        m_loads[index]--;
+    }
+}
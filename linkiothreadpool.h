@@ -0,0 +1,50 @@
+﻿/**************************************************************************
+ *   文件名	：linkiothreadpool.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：连接共享的 I/O 线程池
+ *   使用说明 ：多个连接可共用少量 I/O 线程，acquire 返回当前负载最小的线程，
+ *             连接销毁时 release
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include <QList>
+#include <QMutex>
+
+class QThread;
+
+class LinkIoThreadPool
+{
+public:
+    LinkIoThreadPool();
+    ~LinkIoThreadPool();
+    static LinkIoThreadPool *instance();
+
+    /// 线程数量上限，默认按 CPU 核数，最多 4 个
+    void setMaxThreads(int count);
+    int maxThreads() const;
+
+    /// 取得一个负载最小的 I/O 线程，不足上限时新建
+    QThread *acquire();
+    /// 归还 acquire 取得的线程
+    void release(QThread *thread);
+    /// 停止并回收全部线程，线程退出前会处理完其中的 deleteLater。
+    /// 之后仍挂在这些线程上的连接不再有事件循环，可以在任意线程中析构
+    void shutdown();
+
+private:
+    mutable QMutex m_mutex;
+    QList<QThread *> m_threads;
+    QList<int> m_loads; // 与 m_threads 一一对应，记录挂载的连接数
+    int m_maxThreads;
+};
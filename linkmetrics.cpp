@@ -0,0 +1,295 @@
+﻿/**************************************************************************
+ *   文件名	：linkmetrics.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "linkmetrics.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <chrono>
+
+namespace {
+int bucketOf(quint64 us)
+{
+    if (us == 0) {
+        return 0;
+    }
+    // 第 i 个桶为 [2^(i-1), 2^i)，即 us 的有效位数
+    const int bits = 64 - qCountLeadingZeroBits(us);
+    return qMin(bits, LinkMetricsSnapshot::kLatencyBuckets - 1);
+}
+
+double perSecond(quint64 current, quint64 previous, qint64 elapsedNs)
+{
+    if (elapsedNs <= 0 || current < previous) {
+        return 0;
+    }
+    return double(current - previous) * 1e9 / double(elapsedNs);
+}
+
+/// 每个连接一个样本的指标，输出时按此顺序逐个指标成组
+struct PrometheusMetric
+{
+    const char *name;
+    const char *type;
+    quint64 (*value)(const LinkMetricsSnapshot &s);
+};
+
+const PrometheusMetric kPrometheusMetrics[] = {
+    {"rx_bytes_total", "counter", [](const LinkMetricsSnapshot &s) { return s.rxBytes; }},
+    {"rx_chunks_total", "counter", [](const LinkMetricsSnapshot &s) { return s.rxChunks; }},
+    {"rx_frames_total", "counter", [](const LinkMetricsSnapshot &s) { return s.rxFrames; }},
+    {"tx_bytes_total", "counter", [](const LinkMetricsSnapshot &s) { return s.txBytes; }},
+    {"tx_drops_total", "counter", [](const LinkMetricsSnapshot &s) { return s.txDrops; }},
+    {"parse_errors_total", "counter", [](const LinkMetricsSnapshot &s) { return s.parseErrors; }},
+    {"crc_errors_total", "counter", [](const LinkMetricsSnapshot &s) { return s.crcErrors; }},
+    {"reconnects_total", "counter", [](const LinkMetricsSnapshot &s) { return s.reconnects(); }},
+    {"send_queue_depth", "gauge", [](const LinkMetricsSnapshot &s) { return s.queueDepth; }},
+    {"send_queue_drops_total", "counter", [](const LinkMetricsSnapshot &s) { return s.queueDrops; }},
+    {"send_queue_high_water_bytes", "gauge", [](const LinkMetricsSnapshot &s) { return quint64(s.queueHighWater); }},
+    {"rx_allocations_total", "counter", [](const LinkMetricsSnapshot &s) { return s.rxAllocations; }},
+};
+} // namespace
+
+LinkMetrics::LinkMetrics()
+{
+    for (auto &stamp : m_stamps) {
+        stamp.store(0, std::memory_order_relaxed);
+    }
+    for (auto &bucket : m_latencyBuckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+qint64 LinkMetrics::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void LinkMetrics::received(qsizetype bytes)
+{
+    // 只有连接的 I/O 线程写入，序号不需要原子自增
+    const quint64 seq = m_rxChunks.load(std::memory_order_relaxed);
+    m_stamps[seq % kStampSlots].store(now(), std::memory_order_relaxed);
+    m_rxBytes.fetch_add(quint64(bytes), std::memory_order_relaxed);
+    m_rxChunks.store(seq + 1, std::memory_order_release);
+}
+
+void LinkMetrics::syncDispatch()
+{
+    m_dispatchedChunks.store(m_rxChunks.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+void LinkMetrics::dispatched()
+{
+    const quint64 emitted = m_rxChunks.load(std::memory_order_acquire);
+    quint64 seq = m_dispatchedChunks.load(std::memory_order_relaxed);
+    if (seq >= emitted) {
+        // 接收方在 syncDispatch 之前已经收到数据，对齐到最新的接收块
+        if (emitted == 0) {
+            return;
+        }
+        seq = emitted - 1;
+    }
+    m_dispatchedChunks.store(seq + 1, std::memory_order_relaxed);
+    if (emitted - seq > kStampSlots) {
+        return; // 该接收块的时刻已被覆盖
+    }
+
+    const qint64 stamp = m_stamps[seq % kStampSlots].load(std::memory_order_relaxed);
+    // 读取期间 I/O 线程可能又绕回覆盖了这一格
+    if (m_rxChunks.load(std::memory_order_acquire) - seq > kStampSlots) {
+        return;
+    }
+    const qint64 elapsed = now() - stamp;
+    recordLatency(elapsed > 0 ? quint64(elapsed) / 1000 : 0);
+}
+
+void LinkMetrics::parsed(quint64 frames, quint64 parseErrors, quint64 crcErrors)
+{
+    if (frames) {
+        m_rxFrames.fetch_add(frames, std::memory_order_relaxed);
+    }
+    if (parseErrors) {
+        m_parseErrors.fetch_add(parseErrors, std::memory_order_relaxed);
+    }
+    if (crcErrors) {
+        m_crcErrors.fetch_add(crcErrors, std::memory_order_relaxed);
+    }
+}
+
+void LinkMetrics::recordLatency(quint64 us)
+{
+    m_latencyBuckets[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+    m_latencySumUs.fetch_add(us, std::memory_order_relaxed);
+    m_latencyCount.fetch_add(1, std::memory_order_relaxed);
+    // 只有分发线程写入
+    if (us > m_latencyMaxUs.load(std::memory_order_relaxed)) {
+        m_latencyMaxUs.store(us, std::memory_order_relaxed);
+    }
+}
+
+LinkMetricsSnapshot LinkMetrics::snapshot() const
+{
+    LinkMetricsSnapshot s;
+    s.timestampNs = now();
+    s.rxBytes = m_rxBytes.load(std::memory_order_relaxed);
+    s.rxChunks = m_rxChunks.load(std::memory_order_relaxed);
+    s.rxFrames = m_rxFrames.load(std::memory_order_relaxed);
+    s.txBytes = m_txBytes.load(std::memory_order_relaxed);
+    s.txDrops = m_txDrops.load(std::memory_order_relaxed);
+    s.parseErrors = m_parseErrors.load(std::memory_order_relaxed);
+    s.crcErrors = m_crcErrors.load(std::memory_order_relaxed);
+    s.connects = m_connects.load(std::memory_order_relaxed);
+    s.disconnects = m_disconnects.load(std::memory_order_relaxed);
+    s.latencyCount = m_latencyCount.load(std::memory_order_relaxed);
+    s.latencySumUs = m_latencySumUs.load(std::memory_order_relaxed);
+    s.latencyMaxUs = m_latencyMaxUs.load(std::memory_order_relaxed);
+    for (int i = 0; i < LinkMetricsSnapshot::kLatencyBuckets; ++i) {
+        s.latencyBuckets[i] = m_latencyBuckets[i].load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+qint64 LinkMetricsSnapshot::bucketUpperUs(int i)
+{
+    return i >= kLatencyBuckets - 1 ? -1 : qint64(1) << i;
+}
+
+double LinkMetricsSnapshot::latencyPercentileUs(double p) const
+{
+    // 桶计数与 latencyCount 不是同一时刻读取的，以桶为准
+    quint64 total = 0;
+    for (auto count : latencyBuckets) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    const quint64 rank = qMax<quint64>(1, quint64(qBound(0.0, p, 1.0) * double(total) + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < kLatencyBuckets; ++i) {
+        seen += latencyBuckets[i];
+        if (seen >= rank) {
+            const qint64 upper = bucketUpperUs(i);
+            return upper < 0 ? double(latencyMaxUs) : double(qMin<quint64>(upper, latencyMaxUs));
+        }
+    }
+    return double(latencyMaxUs);
+}
+
+double LinkMetricsSnapshot::rxBytesPerSecond(const LinkMetricsSnapshot &previous) const
+{
+    return perSecond(rxBytes, previous.rxBytes, timestampNs - previous.timestampNs);
+}
+
+double LinkMetricsSnapshot::txBytesPerSecond(const LinkMetricsSnapshot &previous) const
+{
+    return perSecond(txBytes, previous.txBytes, timestampNs - previous.timestampNs);
+}
+
+double LinkMetricsSnapshot::rxFramesPerSecond(const LinkMetricsSnapshot &previous) const
+{
+    return perSecond(rxFrames, previous.rxFrames, timestampNs - previous.timestampNs);
+}
+
+QVariantMap LinkMetricsSnapshot::toVariantMap(const LinkMetricsSnapshot *previous) const
+{
+    QVariantMap map;
+    map.insert("rxBytes", rxBytes);
+    map.insert("rxChunks", rxChunks);
+    map.insert("rxFrames", rxFrames);
+    map.insert("txBytes", txBytes);
+    map.insert("txDrops", txDrops);
+    map.insert("parseErrors", parseErrors);
+    map.insert("crcErrors", crcErrors);
+    map.insert("reconnects", reconnects());
+    map.insert("queueDepth", queueDepth);
+    map.insert("queueDrops", queueDrops);
+    map.insert("queueHighWater", queueHighWater);
+    map.insert("rxAllocations", rxAllocations);
+    map.insert("latencyCount", latencyCount);
+    map.insert("latencyAvgUs", latencyCount ? double(latencySumUs) / double(latencyCount) : 0.0);
+    map.insert("latencyP50Us", latencyPercentileUs(0.5));
+    map.insert("latencyP99Us", latencyPercentileUs(0.99));
+    map.insert("latencyMaxUs", latencyMaxUs);
+    if (previous) {
+        map.insert("rxBytesPerSecond", rxBytesPerSecond(*previous));
+        map.insert("txBytesPerSecond", txBytesPerSecond(*previous));
+        map.insert("rxFramesPerSecond", rxFramesPerSecond(*previous));
+    }
+    return map;
+}
+
+QString LinkMetricsSnapshot::toPrometheus(const QStringList &names, const QVector<LinkMetricsSnapshot> &snapshots)
+{
+    QStringList labels;
+    for (const QString &name : names) {
+        QString label = name;
+        labels.append(label.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n"));
+    }
+
+    // 同一指标的 TYPE 行和全部连接的样本连续输出，不能按连接交错
+    QString text;
+    for (const auto &metric : kPrometheusMetrics) {
+        text += QString("# TYPE commhelper_link_%1 %2\n").arg(QLatin1String(metric.name), QLatin1String(metric.type));
+        for (int i = 0; i < snapshots.size(); ++i) {
+            text += QString("commhelper_link_%1{link=\"%2\"} %3\n")
+                        .arg(QLatin1String(metric.name), labels[i])
+                        .arg(metric.value(snapshots[i]));
+        }
+    }
+
+    // 直方图按秒输出，桶为累计值
+    text += "# HELP commhelper_link_dispatch_latency_seconds Time from receiveData to the router.\n"
+            "# TYPE commhelper_link_dispatch_latency_seconds histogram\n";
+    for (int i = 0; i < snapshots.size(); ++i) {
+        const LinkMetricsSnapshot &s = snapshots[i];
+        quint64 cumulative = 0;
+        for (int bucket = 0; bucket < kLatencyBuckets; ++bucket) {
+            cumulative += s.latencyBuckets[bucket];
+            const qint64 upper = bucketUpperUs(bucket);
+            const QString le = upper < 0 ? QString("+Inf") : QString::number(double(upper) / 1e6, 'g', 10);
+            text += QString("commhelper_link_dispatch_latency_seconds_bucket{link=\"%1\",le=\"%2\"} %3\n")
+                        .arg(labels[i], le)
+                        .arg(cumulative);
+        }
+        text += QString("commhelper_link_dispatch_latency_seconds_sum{link=\"%1\"} %2\n")
+                    .arg(labels[i])
+                    .arg(double(s.latencySumUs) / 1e6, 0, 'g', 10);
+        text += QString("commhelper_link_dispatch_latency_seconds_count{link=\"%1\"} %2\n")
+                    .arg(labels[i])
+                    .arg(cumulative);
+    }
+    return text;
+}
+
+QByteArray LinkMetricsSnapshot::toJson(const QString &name) const
+{
+    QJsonObject object = QJsonObject::fromVariantMap(toVariantMap());
+    object.insert("link", name);
+    QJsonArray buckets;
+    for (auto count : latencyBuckets) {
+        buckets.append(double(count));
+    }
+    object.insert("latencyBuckets", buckets);
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
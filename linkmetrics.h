@@ -0,0 +1,132 @@
+﻿/**************************************************************************
+ *   文件名	：linkmetrics.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：连接的吞吐、错误和延迟统计
+ *   使用说明 ：各计数器由 I/O 线程和路由线程用 relaxed 原子操作累加，不加锁；
+ *             snapshot 随时可在任意线程中调用，取得一份一致性要求不高的快照。
+ *             接收到分发的延迟按 2 的幂微秒分桶，每个接收块记录一次
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+#include <QtGlobal>
+
+#include <atomic>
+
+/// LinkMetrics 在某一时刻的取值，累计量之外的速率由两次快照相减得到
+struct LinkMetricsSnapshot
+{
+    /// 延迟直方图桶数，第 i 个桶为 [2^(i-1), 2^i) 微秒，第 0 个桶为不足 1 微秒，最后一个桶不设上限
+    static constexpr int kLatencyBuckets = 24;
+
+    qint64 timestampNs = 0; // 单调时钟
+
+    quint64 rxBytes = 0;
+    quint64 rxChunks = 0; // receiveData 信号次数
+    quint64 rxFrames = 0;
+    quint64 txBytes = 0;
+    quint64 txDrops = 0; // 发送失败而丢弃的报文数
+    quint64 parseErrors = 0;
+    quint64 crcErrors = 0;
+
+    quint64 connects = 0;
+    quint64 disconnects = 0;
+
+    quint64 queueDepth = 0;
+    quint64 queueDrops = 0;
+    qint64 queueHighWater = 0;
+    quint64 rxAllocations = 0;
+
+    quint64 latencyCount = 0;
+    quint64 latencySumUs = 0;
+    quint64 latencyMaxUs = 0;
+    quint64 latencyBuckets[kLatencyBuckets] = {};
+
+    /// 首次连接之后的重连次数
+    quint64 reconnects() const { return connects > 0 ? connects - 1 : 0; }
+    /// 按直方图估算的延迟分位数（微秒），取所在桶的上界，p 取 0~1
+    double latencyPercentileUs(double p) const;
+    /// 第 i 个桶的上界（微秒），最后一个桶返回 -1
+    static qint64 bucketUpperUs(int i);
+
+    /// 相对 previous 的每秒速率，previous 为空或时间未前进时返回 0
+    double rxBytesPerSecond(const LinkMetricsSnapshot &previous) const;
+    double txBytesPerSecond(const LinkMetricsSnapshot &previous) const;
+    double rxFramesPerSecond(const LinkMetricsSnapshot &previous) const;
+
+    /// 供 QML 使用的字段表，给出 previous 时附带 *PerSecond 速率
+    QVariantMap toVariantMap(const LinkMetricsSnapshot *previous = nullptr) const;
+    /// 多个连接的 Prometheus 文本，names[i] 为 snapshots[i] 的 link 标签；
+    /// 按指标成组输出，每组是 TYPE 行加全部连接的样本
+    static QString toPrometheus(const QStringList &names, const QVector<LinkMetricsSnapshot> &snapshots);
+    /// 单个连接的 JSON 对象
+    QByteArray toJson(const QString &name) const;
+};
+
+class LinkMetrics
+{
+public:
+    LinkMetrics();
+
+    LinkMetrics(const LinkMetrics &) = delete;
+    LinkMetrics &operator=(const LinkMetrics &) = delete;
+
+    /// I/O 线程：发出一个接收块之前调用，记录字节数和接收时刻
+    void received(qsizetype bytes);
+    /// I/O 线程：写出 bytes 字节
+    void sent(qsizetype bytes) { m_txBytes.fetch_add(quint64(bytes), std::memory_order_relaxed); }
+    /// I/O 线程：count 个报文发送失败被丢弃
+    void sendDropped(quint64 count) { m_txDrops.fetch_add(count, std::memory_order_relaxed); }
+    void connected() { m_connects.fetch_add(1, std::memory_order_relaxed); }
+    void disconnected() { m_disconnects.fetch_add(1, std::memory_order_relaxed); }
+
+    /// 分发线程：开始处理下一个接收块时调用，记录接收到分发的延迟。
+    /// 接收块按发出顺序到达，只能有一个接收方调用
+    void dispatched();
+    /// 分发线程：接收方开始接收时调用，之前发出的接收块不再计入延迟
+    void syncDispatch();
+    /// 分发线程：解析结果
+    void parsed(quint64 frames, quint64 parseErrors, quint64 crcErrors);
+
+    /// 任意线程：读取全部计数器，发送队列相关字段由 LinkInterface 填写
+    LinkMetricsSnapshot snapshot() const;
+
+    /// 单调时钟，纳秒
+    static qint64 now();
+
+private:
+    static constexpr int kStampSlots = 256; // 接收时刻环形表，分发落后超过此数的接收块不计延迟
+
+    void recordLatency(quint64 us);
+
+    alignas(64) std::atomic<quint64> m_rxBytes{0};
+    std::atomic<quint64> m_rxChunks{0};
+    std::atomic<quint64> m_txBytes{0};
+    std::atomic<quint64> m_txDrops{0};
+    std::atomic<quint64> m_connects{0};
+    std::atomic<quint64> m_disconnects{0};
+    std::atomic<qint64> m_stamps[kStampSlots];
+
+    alignas(64) std::atomic<quint64> m_dispatchedChunks{0}; // 只由分发线程修改
+    std::atomic<quint64> m_rxFrames{0};
+    std::atomic<quint64> m_parseErrors{0};
+    std::atomic<quint64> m_crcErrors{0};
+    std::atomic<quint64> m_latencyCount{0};
+    std::atomic<quint64> m_latencySumUs{0};
+    std::atomic<quint64> m_latencyMaxUs{0};
+    std::atomic<quint64> m_latencyBuckets[LinkMetricsSnapshot::kLatencyBuckets];
+};
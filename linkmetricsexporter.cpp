@@ -0,0 +1,139 @@
+﻿/**************************************************************************
+ *   文件名	：linkmetricsexporter.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "linkmetricsexporter.h"
+#include "linkinterface.h"
+#include "linkreconnectscheduler.h"
+
+#include <QSaveFile>
+
+namespace {
+/// 全部连接共用的重连调度器统计，只在 Prometheus 格式中输出
+QByteArray reconnectPrometheus()
+{
+    const auto stats = LinkReconnectScheduler::instance()->statistics();
+    return QString("# TYPE commhelper_reconnect_total counter\n"
+                   "commhelper_reconnect_total %1\n"
+                   "# TYPE commhelper_reconnect_attempts_total counter\n"
+                   "commhelper_reconnect_attempts_total %2\n"
+                   "# TYPE commhelper_reconnect_timeouts_total counter\n"
+                   "commhelper_reconnect_timeouts_total %3\n"
+                   "# TYPE commhelper_reconnect_deferred_total counter\n"
+                   "commhelper_reconnect_deferred_total %4\n"
+                   "# HELP commhelper_reconnect_seconds Time from disconnect to reconnect.\n"
+                   "# TYPE commhelper_reconnect_seconds gauge\n"
+                   "commhelper_reconnect_seconds{stat=\"last\"} %5\n"
+                   "commhelper_reconnect_seconds{stat=\"average\"} %6\n"
+                   "commhelper_reconnect_seconds{stat=\"max\"} %7\n"
+                   "# TYPE commhelper_reconnect_pending gauge\n"
+                   "commhelper_reconnect_pending %8\n"
+                   "# TYPE commhelper_reconnect_in_flight gauge\n"
+                   "commhelper_reconnect_in_flight %9\n")
+        .arg(stats.reconnects)
+        .arg(stats.attempts)
+        .arg(stats.timeouts)
+        .arg(stats.deferred)
+        .arg(stats.lastMs / 1000.0)
+        .arg(stats.averageMs / 1000.0)
+        .arg(stats.maxMs / 1000.0)
+        .arg(stats.pending)
+        .arg(stats.inFlight)
+        .toUtf8();
+}
+} // namespace
+
+LinkMetricsExporter::LinkMetricsExporter(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_timer, &QTimer::timeout, this, &LinkMetricsExporter::writeNow);
+}
+
+void LinkMetricsExporter::addLink(LinkInterface *link, const QString &name)
+{
+    if (link == nullptr) {
+        return;
+    }
+    for (auto &entry : m_links) {
+        if (entry.link == link) {
+            entry.name = name;
+            return;
+        }
+    }
+    m_links.append({link, name});
+}
+
+void LinkMetricsExporter::removeLink(LinkInterface *link)
+{
+    m_links.removeIf([link](const Entry &entry) { return entry.link == link; });
+}
+
+bool LinkMetricsExporter::start(int intervalMs)
+{
+    if (m_fileName.isEmpty()) {
+        return false;
+    }
+    m_timer.start(qMax(1, intervalMs));
+    return true;
+}
+
+void LinkMetricsExporter::stop()
+{
+    m_timer.stop();
+}
+
+QByteArray LinkMetricsExporter::render() const
+{
+    QStringList names;
+    QVector<LinkMetricsSnapshot> snapshots;
+    for (const auto &entry : m_links) {
+        if (entry.link.isNull()) {
+            continue; // 连接已析构
+        }
+        names.append(entry.name);
+        snapshots.append(entry.link->metricsSnapshot());
+    }
+
+    if (m_format == PrometheusFormat) {
+        return LinkMetricsSnapshot::toPrometheus(names, snapshots).toUtf8() + reconnectPrometheus();
+    }
+
+    QByteArray out = "[";
+    for (int i = 0; i < snapshots.size(); ++i) {
+        if (i > 0) {
+            out += ',';
+        }
+        out += snapshots[i].toJson(names[i]);
+    }
+    out += "]\n";
+    return out;
+}
+
+bool LinkMetricsExporter::writeNow()
+{
+    // 先写临时文件再整体替换，读取方不会看到写了一半的内容
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        emit exportError(file.errorString());
+        return false;
+    }
+    file.write(render());
+    if (!file.commit()) {
+        emit exportError(file.errorString());
+        return false;
+    }
+    return true;
+}
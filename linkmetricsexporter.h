@@ -0,0 +1,75 @@
+﻿/**************************************************************************
+ *   文件名	：linkmetricsexporter.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：定时把各连接的统计写到本地文件
+ *   使用说明 ：addLink 登记连接和名称，start 后每隔 interval 毫秒把全部连接的快照
+ *             以 Prometheus 文本或 JSON 格式整体替换写入文件（QSaveFile），
+ *             可供 node_exporter 的 textfile 收集器或命令行工具读取；Prometheus 格式
+ *             另外输出重连调度器的统计（重连用时、尝试次数、等待数）
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "linkmetrics.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+
+class LinkInterface;
+
+class LinkMetricsExporter : public QObject
+{
+    Q_OBJECT
+public:
+    enum Format {
+        PrometheusFormat,
+        JsonFormat // 一个 JSON 数组，每个元素为一个连接
+    };
+    Q_ENUM(Format)
+
+    explicit LinkMetricsExporter(QObject *parent = nullptr);
+
+    void addLink(LinkInterface *link, const QString &name);
+    void removeLink(LinkInterface *link);
+
+    void setFileName(const QString &fileName) { m_fileName = fileName; }
+    QString fileName() const { return m_fileName; }
+    void setFormat(Format format) { m_format = format; }
+    Format format() const { return m_format; }
+
+    /// 开始定时写出，文件名为空时不启动
+    bool start(int intervalMs = 1000);
+    void stop();
+
+    /// 当前全部连接的统计文本
+    QByteArray render() const;
+    /// 立即写出一次
+    bool writeNow();
+
+signals:
+    void exportError(const QString &error);
+
+private:
+    struct Entry
+    {
+        QPointer<LinkInterface> link;
+        QString name;
+    };
+
+    QVector<Entry> m_links;
+    QString m_fileName;
+    Format m_format = PrometheusFormat;
+    QTimer m_timer;
+};
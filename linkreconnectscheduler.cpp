@@ -0,0 +1,302 @@
+﻿/**************************************************************************
+ *   文件名	：linkreconnectscheduler.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "linkreconnectscheduler.h"
+#include "linkinterface.h"
+
+#include <QGlobalStatic>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <QThread>
+
+#include <algorithm>
+
+Q_GLOBAL_STATIC(LinkReconnectScheduler, linkReconnectScheduler)
+
+LinkReconnectScheduler::LinkReconnectScheduler()
+    : m_wheel(kSlots)
+{
+    m_clock.start();
+}
+
+LinkReconnectScheduler::~LinkReconnectScheduler()
+{
+    {
+        QMutexLocker l(&m_mutex);
+        m_shouldExit = true;
+        m_wake.wakeAll();
+    }
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+LinkReconnectScheduler *LinkReconnectScheduler::instance()
+{
+    return linkReconnectScheduler();
+}
+
+void LinkReconnectScheduler::setMaxInFlight(int count)
+{
+    QMutexLocker l(&m_mutex);
+    m_maxInFlight = qMax(1, count);
+    launch();
+}
+
+int LinkReconnectScheduler::maxInFlight() const
+{
+    QMutexLocker l(&m_mutex);
+    return m_maxInFlight;
+}
+
+void LinkReconnectScheduler::setMaxBackoff(int ms)
+{
+    QMutexLocker l(&m_mutex);
+    m_maxBackoffMs = qMax(kTickMs, ms);
+}
+
+void LinkReconnectScheduler::setAttemptTimeout(int ms)
+{
+    QMutexLocker l(&m_mutex);
+    m_attemptTimeoutMs = qMax(kTickMs, ms);
+}
+
+void LinkReconnectScheduler::connectNow(LinkInterface *link, Attempt attempt)
+{
+    QMutexLocker l(&m_mutex);
+    if (link == nullptr || m_entries.contains(link)) {
+        return;
+    }
+    ensureThread();
+
+    Entry &entry = m_entries[link];
+    entry.link = link;
+    entry.attempt = std::move(attempt);
+    entry.reconnect = false;
+    entry.downSince = m_clock.elapsed();
+    entry.state = Ready;
+    if (m_running.size() >= m_maxInFlight) {
+        ++m_stats.deferred;
+    }
+    m_ready.append(link);
+    launch();
+    m_wake.wakeOne();
+}
+
+void LinkReconnectScheduler::schedule(LinkInterface *link, int baseMs, Attempt attempt)
+{
+    QMutexLocker l(&m_mutex);
+    if (link == nullptr) {
+        return;
+    }
+    auto it = m_entries.find(link);
+    if (it != m_entries.end() && it->state != Idle) {
+        return; // 已在等待或尝试中
+    }
+    ensureThread();
+
+    if (it == m_entries.end()) {
+        it = m_entries.insert(link, Entry());
+        it->link = link;
+        it->downSince = m_clock.elapsed();
+    }
+    it->attempt = std::move(attempt);
+    it->baseMs = qMax(kTickMs, baseMs);
+    arm(link, *it);
+    m_wake.wakeOne();
+}
+
+void LinkReconnectScheduler::finished(LinkInterface *link, bool ok)
+{
+    QMutexLocker l(&m_mutex);
+    auto it = m_entries.find(link);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    if (ok) {
+        if (it->reconnect) {
+            const qint64 elapsed = m_clock.elapsed() - it->downSince;
+            ++m_stats.reconnects;
+            m_stats.lastMs = elapsed;
+            m_stats.maxMs = qMax(m_stats.maxMs, elapsed);
+            m_totalMs += elapsed;
+            m_stats.averageMs = double(m_totalMs) / double(m_stats.reconnects);
+        }
+        unlink(link, *it);
+        m_entries.erase(it);
+    } else if (it->state == InFlight) {
+        m_running.removeOne(link);
+        it->state = Idle;
+        it->reconnect = true;
+        ++it->failures;
+    }
+    launch();
+}
+
+void LinkReconnectScheduler::cancel(LinkInterface *link)
+{
+    QMutexLocker l(&m_mutex);
+    auto it = m_entries.find(link);
+    if (it == m_entries.end()) {
+        return;
+    }
+    unlink(link, *it);
+    m_entries.erase(it);
+    launch();
+}
+
+LinkReconnectScheduler::Statistics LinkReconnectScheduler::statistics() const
+{
+    QMutexLocker l(&m_mutex);
+    Statistics stats = m_stats;
+    stats.inFlight = int(m_running.size());
+    // 失败后尚未 schedule 的连接不算等待中
+    for (const auto &entry : m_entries) {
+        if (entry.state == Waiting || entry.state == Ready) {
+            ++stats.pending;
+        }
+    }
+    return stats;
+}
+
+bool LinkReconnectScheduler::isIdle() const
+{
+    return std::all_of(m_entries.cbegin(), m_entries.cend(), [](const Entry &entry) {
+        return entry.state == Idle;
+    });
+}
+
+void LinkReconnectScheduler::ensureThread()
+{
+    // 没有需要计时的连接时线程不计时，重新开始前把刻度对齐到当前时间
+    if (isIdle()) {
+        m_ticks = m_clock.elapsed() / kTickMs;
+    }
+    if (m_thread == nullptr) {
+        m_thread = QThread::create([this]() { run(); });
+        m_thread->setObjectName("LinkReconnect");
+        m_thread->start();
+    }
+}
+
+void LinkReconnectScheduler::arm(LinkInterface *link, Entry &entry)
+{
+    // 等抖动：在退避间隔的后一半中随机取值，避免大量连接同时重连
+    const qint64 backoff = qMin<qint64>(m_maxBackoffMs, qint64(entry.baseMs) << qMin(entry.failures, 20));
+    const qint64 delay = backoff / 2 + qint64(QRandomGenerator::global()->bounded(quint64(backoff / 2 + 1)));
+    const qint64 ticks = qMax<qint64>(1, (delay + kTickMs - 1) / kTickMs);
+
+    entry.state = Waiting;
+    entry.slot = int((m_ticks + ticks) % kSlots);
+    entry.rounds = int(ticks / kSlots);
+    m_wheel[entry.slot].append(link);
+}
+
+void LinkReconnectScheduler::unlink(LinkInterface *link, Entry &entry)
+{
+    switch (entry.state) {
+    case Idle:
+        break;
+    case Waiting:
+        m_wheel[entry.slot].removeOne(link);
+        break;
+    case Ready:
+        m_ready.removeOne(link);
+        break;
+    case InFlight:
+        m_running.removeOne(link);
+        break;
+    }
+    entry.state = Idle;
+    entry.slot = -1;
+}
+
+void LinkReconnectScheduler::launch()
+{
+    while (!m_ready.isEmpty() && m_running.size() < m_maxInFlight) {
+        LinkInterface *link = m_ready.takeFirst();
+        auto it = m_entries.find(link);
+        if (it == m_entries.end()) {
+            continue;
+        }
+        if (it->link.isNull()) {
+            m_entries.erase(it); // 连接已析构却没有 cancel
+            continue;
+        }
+        it->state = InFlight;
+        it->deadline = m_ticks + (m_attemptTimeoutMs + kTickMs - 1) / kTickMs;
+        m_running.append(link);
+        ++m_stats.attempts;
+        // 在连接所属线程中执行，连接析构后事件会被丢弃
+        QMetaObject::invokeMethod(it->link.data(), it->attempt, Qt::QueuedConnection);
+    }
+}
+
+void LinkReconnectScheduler::tick()
+{
+    auto &bucket = m_wheel[int(m_ticks % kSlots)];
+    for (int i = 0; i < bucket.size();) {
+        Entry &entry = m_entries[bucket[i]];
+        if (entry.rounds > 0) {
+            --entry.rounds;
+            ++i;
+            continue;
+        }
+        entry.state = Ready;
+        entry.slot = -1;
+        if (m_running.size() >= m_maxInFlight) {
+            ++m_stats.deferred;
+        }
+        m_ready.append(bucket.takeAt(i));
+    }
+
+    // 迟迟没有结果的尝试按失败处理，重连函数负责放弃仍在进行的连接
+    for (int i = 0; i < m_running.size();) {
+        LinkInterface *link = m_running[i];
+        Entry &entry = m_entries[link];
+        if (entry.deadline > m_ticks) {
+            ++i;
+            continue;
+        }
+        m_running.removeAt(i);
+        ++m_stats.timeouts;
+        ++entry.failures;
+        entry.reconnect = true;
+        arm(link, entry);
+    }
+
+    ++m_ticks;
+}
+
+void LinkReconnectScheduler::run()
+{
+    QMutexLocker l(&m_mutex);
+    while (!m_shouldExit) {
+        if (isIdle()) {
+            m_wake.wait(&m_mutex);
+            continue;
+        }
+        m_wake.wait(&m_mutex, kTickMs);
+        const qint64 due = m_clock.elapsed() / kTickMs;
+        while (m_ticks < due) {
+            tick();
+        }
+        launch();
+    }
+}
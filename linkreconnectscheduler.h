@@ -0,0 +1,135 @@
+﻿/**************************************************************************
+ *   文件名	：linkreconnectscheduler.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：全部连接共用的重连调度器
+ *   使用说明 ：连接断开后调用 schedule 登记，调度器在独立线程中用哈希时间轮计时，
+ *             到期后在连接所属线程中执行重连函数；间隔按指数退避并加随机抖动，
+ *             同时进行中的连接尝试不超过 maxInFlight 个，超出的排队等待。
+ *             每次尝试结束（成功或失败）都要调用 finished 归还名额；失败后不再重连的
+ *             连接调用 cancel 清除记录，否则调度器会一直保留它
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QPointer>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <functional>
+
+class LinkInterface;
+class QThread;
+
+class LinkReconnectScheduler
+{
+public:
+    using Attempt = std::function<void()>;
+
+    /// 重连统计，用时从连接断开（首次 schedule）算到 finished(link, true)
+    struct Statistics
+    {
+        quint64 attempts = 0;   // 发起的连接尝试次数
+        quint64 reconnects = 0; // 成功重连次数
+        quint64 timeouts = 0;   // 超过 attemptTimeout 仍未结束的尝试
+        quint64 deferred = 0;   // 因并发上限推迟的尝试
+        qint64 lastMs = 0;
+        qint64 maxMs = 0;
+        double averageMs = 0;
+        int pending = 0;  // 等待重连和等待名额的连接数
+        int inFlight = 0; // 进行中的连接尝试数
+    };
+
+    LinkReconnectScheduler();
+    ~LinkReconnectScheduler();
+    static LinkReconnectScheduler *instance();
+
+    /// 同时进行的连接尝试上限，默认 16
+    void setMaxInFlight(int count);
+    int maxInFlight() const;
+    /// 退避间隔上限，默认 60 秒
+    void setMaxBackoff(int ms);
+    /// 一次尝试的最长时间，超过后按失败处理并重新安排，默认 15 秒
+    void setAttemptTimeout(int ms);
+
+    /// 任意线程可调用：立即排队尝试连接，同样受并发上限约束
+    void connectNow(LinkInterface *link, Attempt attempt);
+    /// 任意线程可调用：第 n 次失败后等待 baseMs * 2^n（不超过退避上限）的一半到全部之间的随机时间，
+    /// 再在连接所属线程中执行 attempt。已在等待或尝试中时忽略
+    void schedule(LinkInterface *link, int baseMs, Attempt attempt);
+    /// 连接所属线程中调用：一次尝试结束，ok 为 true 时清除退避状态并计入重连用时；
+    /// 失败时保留退避状态，随后应调用 schedule 重试或 cancel 放弃
+    void finished(LinkInterface *link, bool ok);
+    /// 停止该连接的重连并清除退避状态，连接析构前必须调用
+    void cancel(LinkInterface *link);
+
+    Statistics statistics() const;
+
+private:
+    enum State {
+        Idle,    // 尝试失败，等待连接再次 schedule
+        Waiting, // 在时间轮中
+        Ready,   // 已到期，等待并发名额
+        InFlight
+    };
+
+    struct Entry
+    {
+        QPointer<LinkInterface> link;
+        Attempt attempt;
+        State state = Idle;
+        int baseMs = 0;
+        int failures = 0;
+        bool reconnect = true; // connectNow 发起的首次连接不计入重连统计
+        qint64 downSince = 0;  // 断开时刻，m_clock 毫秒
+        qint64 deadline = 0;  // InFlight 时的超时时刻（时间轮刻度）
+        int rounds = 0;       // Waiting 时还需转过的圈数
+        int slot = -1;
+    };
+
+    static constexpr int kSlots = 512;
+    static constexpr int kTickMs = 20;
+
+    /// 以下函数调用时持有 m_mutex
+    /// 没有需要计时的连接，Idle 的连接只在 finished 和随后的 schedule 之间短暂存在
+    bool isIdle() const;
+    void ensureThread();
+    void arm(LinkInterface *link, Entry &entry);
+    void unlink(LinkInterface *link, Entry &entry);
+    void launch();
+    void tick();
+
+    void run();
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wake;
+    QThread *m_thread = nullptr;
+    bool m_shouldExit = false;
+    QElapsedTimer m_clock;
+    qint64 m_ticks = 0; // 已处理的刻度数
+
+    QHash<LinkInterface *, Entry> m_entries;
+    QVector<QList<LinkInterface *>> m_wheel;
+    QList<LinkInterface *> m_ready;   // 按到期先后排队
+    QList<LinkInterface *> m_running; // 进行中的尝试
+
+    int m_maxInFlight = 16;
+    int m_maxBackoffMs = 60000;
+    int m_attemptTimeoutMs = 15000;
+
+    Statistics m_stats;
+    qint64 m_totalMs = 0;
+};
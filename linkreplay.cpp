@@ -0,0 +1,230 @@
+﻿/**************************************************************************
+ *   文件名	：linkreplay.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "linkreplay.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <string.h>
+
+namespace {
+constexpr qint64 kMaxSleepUs = 50 * 1000; // 长时间等待分段进行，及时响应退出
+constexpr qint64 kSpinUs = 200;           // 小于该值的等待不再休眠，保证时间精度
+constexpr int kBatchBytes = 64 * 1024;    // 尽快回放时每次 receiveData 的数据量
+constexpr int kBatchSlots = 8;            // 接收方最多积压的批次数
+constexpr quint64 kBatchWaitUs = 200;     // 批次缓冲区都被占用时的等待间隔
+} // namespace
+
+QString replaytitle = QObject::tr("Replay Link Error");
+
+LinkReplay::LinkReplay() {}
+
+LinkReplay::~LinkReplay()
+{
+    disconnectLink();
+}
+
+bool LinkReplay::connectLink()
+{
+    if (m_thread) {
+        if (m_isConnected) {
+            return true;
+        }
+        // 非循环播放已结束，回收线程后重新开始
+        disconnectLink();
+    }
+
+    auto replayConfig = qobject_cast<LinkReplayConfig *>(getConfig().data());
+    if (replayConfig == nullptr) {
+        emit linkError(replaytitle, tr("no config"));
+        return false;
+    }
+    // 发出的数据都是拷贝，重新映射不影响尚未处理的接收方
+    if (!m_reader.open(replayConfig->fileName())) {
+        emit linkError(replaytitle, m_reader.errorString());
+        return false;
+    }
+
+    m_shouldExit = false;
+    // 在启动线程前置位，回放结束时由回放线程清除
+    m_isConnected = true;
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->setObjectName("LinkReplay");
+    m_thread->start();
+    return true;
+}
+
+void LinkReplay::disconnectLink()
+{
+    if (m_thread == nullptr) {
+        return;
+    }
+    m_shouldExit = true;
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    clearSendQueue();
+}
+
+bool LinkReplay::isConnected() const
+{
+    return m_isConnected;
+}
+
+quint64 LinkReplay::writeData(const QByteArray &data)
+{
+    // 发送队列照常由 flushSendQueue 取空，数据在这里丢弃
+    return data.size();
+}
+
+void LinkReplay::run()
+{
+    auto replayConfig = qobject_cast<LinkReplayConfig *>(getConfig().data());
+    if (replayConfig == nullptr) {
+        m_isConnected = false;
+        return;
+    }
+
+    emit connected();
+
+    QElapsedTimer clock;
+    TlogReader::Frame frame;
+    while (!m_shouldExit) {
+        // 每一轮重新读取配置，倍速修改在下一轮生效
+        const double speed = replayConfig->speed();
+        const bool realtime = speed > 0;
+        clock.start();
+        qint64 offset = 0;
+        quint64 base = 0;
+        bool first = true;
+        QByteArray *batch = nullptr;
+        while (!m_shouldExit && m_reader.frameAt(offset, &frame)) {
+            if (first) {
+                base = frame.timestamp;
+                first = false;
+            }
+            if (realtime && frame.timestamp > base) {
+                // 日志时间换算为播放时间，时间戳回退的帧立即发出
+                const qint64 due = qint64(double(frame.timestamp - base) / speed);
+                qint64 remain;
+                while (!m_shouldExit && (remain = due - clock.nsecsElapsed() / 1000) > 0) {
+                    if (remain > kSpinUs) {
+                        QThread::usleep(quint64(qMin(remain - kSpinUs, kMaxSleepUs)));
+                    }
+                }
+            }
+            if (realtime) {
+                auto &buffer = rxPool().acquire(frame.size);
+                memcpy(buffer.data(), frame.data, size_t(frame.size));
+                emitReceiveData(buffer);
+            } else {
+                // 合并多帧后发出，减少排队事件
+                if (batch == nullptr && (batch = acquireBatch()) == nullptr) {
+                    break;
+                }
+                batch->append(frame.data, frame.size);
+                if (batch->size() >= kBatchBytes) {
+                    emitReceiveData(*batch);
+                    batch = nullptr;
+                }
+            }
+            m_frames.fetch_add(1, std::memory_order_relaxed);
+            m_bytes.fetch_add(quint64(frame.size), std::memory_order_relaxed);
+            offset = frame.next;
+        }
+        if (batch != nullptr && !batch->isEmpty()) {
+            emitReceiveData(*batch);
+        }
+        if (m_shouldExit) {
+            break;
+        }
+        m_loops.fetch_add(1, std::memory_order_relaxed);
+        if (!replayConfig->loop() || m_reader.frameCount() == 0) {
+            break;
+        }
+    }
+
+    m_isConnected = false;
+    emit disconnected();
+}
+
+QByteArray *LinkReplay::acquireBatch()
+{
+    if (m_batches.isEmpty()) {
+        m_batches.resize(kBatchSlots);
+        for (auto &batch : m_batches) {
+            batch.reserve(kBatchBytes + 512);
+        }
+    }
+    while (!m_shouldExit) {
+        // 引用计数回到 1 说明接收方已处理完这一批，以此作为回压
+        for (int i = 0; i < m_batches.size(); ++i) {
+            auto &batch = m_batches[m_nextBatch];
+            m_nextBatch = (m_nextBatch + 1) % m_batches.size();
+            if (batch.isDetached()) {
+                batch.resize(0);
+                return &batch;
+            }
+        }
+        QThread::usleep(kBatchWaitUs);
+    }
+    return nullptr;
+}
+
+QString LinkReplayConfig::fileName() const
+{
+    return m_fileName;
+}
+
+void LinkReplayConfig::setFileName(const QString &newFileName)
+{
+    if (m_fileName == newFileName) {
+        return;
+    }
+    m_fileName = newFileName;
+    emit fileNameChanged();
+}
+
+double LinkReplayConfig::speed() const
+{
+    return m_speed;
+}
+
+void LinkReplayConfig::setSpeed(double newSpeed)
+{
+    newSpeed = qMax(0.0, newSpeed);
+    if (qFuzzyCompare(m_speed + 1, newSpeed + 1)) {
+        return;
+    }
+    m_speed = newSpeed;
+    emit speedChanged();
+}
+
+bool LinkReplayConfig::loop() const
+{
+    return m_loop;
+}
+
+void LinkReplayConfig::setLoop(bool newLoop)
+{
+    if (m_loop == newLoop) {
+        return;
+    }
+    m_loop = newLoop;
+    emit loopChanged();
+}
@@ -0,0 +1,102 @@
+﻿/**************************************************************************
+ *   文件名	：linkreplay.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：回放 tlog 日志的连接，用于在没有网络的情况下压测接收链路
+ *   使用说明 ：日志整体内存映射，发出的数据拷贝到复用的缓冲区中，排队的接收方
+ *             不会引用映射内存。speed 为 1 时按原始时间逐帧回放，为 N 时 N 倍速；
+ *             为 0 时尽快回放，多帧合并为一次 receiveData，接收方未释放的批次
+ *             达到上限时回放线程等待；loop 为 true 时循环播放
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "linkconfig.h"
+#include "linkinterface.h"
+#include "tlogreader.h"
+
+#include <atomic>
+
+class QThread;
+
+class LinkReplayConfig : public LinkConfig
+{
+    Q_OBJECT
+public:
+    LinkReplayConfig() {}
+    Q_PROPERTY(QString fileName READ fileName WRITE setFileName NOTIFY fileNameChanged FINAL)
+    Q_PROPERTY(double speed READ speed WRITE setSpeed NOTIFY speedChanged FINAL)
+    Q_PROPERTY(bool loop READ loop WRITE setLoop NOTIFY loopChanged FINAL)
+
+    /// tlog 日志路径
+    QString fileName() const;
+    void setFileName(const QString &newFileName);
+    /// 回放倍速，0 表示尽快回放
+    double speed() const;
+    void setSpeed(double newSpeed);
+    /// 播放结束后从头开始
+    bool loop() const;
+    void setLoop(bool newLoop);
+
+signals:
+    void fileNameChanged();
+
+    void speedChanged();
+
+    void loopChanged();
+
+private:
+    QString m_fileName;
+    double m_speed = 1.0;
+    bool m_loop = false;
+};
+
+class LinkReplay : public LinkInterface
+{
+    Q_OBJECT
+public:
+    LinkReplay();
+    ~LinkReplay();
+
+    // LinkInterface interface
+public:
+    bool connectLink() override;
+    void disconnectLink() override;
+    bool isConnected() const override;
+
+    /// 已回放的帧数和字节数，循环播放时累计
+    quint64 replayedFrames() const { return m_frames.load(std::memory_order_relaxed); }
+    quint64 replayedBytes() const { return m_bytes.load(std::memory_order_relaxed); }
+    /// 已完成的完整播放次数
+    quint64 loops() const { return m_loops.load(std::memory_order_relaxed); }
+
+protected:
+    /// 回放连接没有对端，写入的数据直接丢弃
+    quint64 writeData(const QByteArray &data) override;
+
+private:
+    void run(); // 回放线程运行函数
+    /// 取得一块接收方已全部释放的批次缓冲区，都被占用时等待，退出时返回 nullptr
+    QByteArray *acquireBatch();
+
+private:
+    QThread *m_thread = nullptr;
+    QList<QByteArray> m_batches; // 尽快回放时的批次缓冲区，只在回放线程中使用
+    int m_nextBatch = 0;
+    TlogReader m_reader;
+    std::atomic_bool m_isConnected{false};
+    std::atomic_bool m_shouldExit{false};
+
+    std::atomic<quint64> m_frames{0};
+    std::atomic<quint64> m_bytes{0};
+    std::atomic<quint64> m_loops{0};
+};
@@ -0,0 +1,67 @@
+﻿/**************************************************************************
+ *   文件名	：linkrxpool.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "linkrxpool.h"
+
+namespace {
+constexpr qint64 kRateWindowMs = 1000;
+} // namespace
+
+LinkRxBufferPool::LinkRxBufferPool(int slots, int slotSize)
+{
+    m_slots.resize(qMax(1, slots));
+    for (auto &slot : m_slots) {
+        slot.reserve(slotSize);
+    }
+    m_window.start();
+}
+
+QByteArray &LinkRxBufferPool::acquire(qsizetype size)
+{
+    // 轮询查找引用计数已回到 1 的缓冲区，即接收方已全部释放
+    for (int i = 0; i < m_slots.size(); ++i) {
+        auto &slot = m_slots[m_next];
+        m_next = (m_next + 1) % m_slots.size();
+        if (!slot.isDetached()) {
+            continue;
+        }
+        const bool grow = slot.capacity() < size;
+        slot.resize(size);
+        updateStatistics(grow);
+        return slot;
+    }
+
+    // 接收方处理太慢，池已耗尽，退化为临时申请
+    m_overflow = QByteArray();
+    m_overflow.resize(size);
+    updateStatistics(true);
+    return m_overflow;
+}
+
+void LinkRxBufferPool::updateStatistics(bool allocated)
+{
+    if (allocated) {
+        m_allocations.fetch_add(1, std::memory_order_relaxed);
+        ++m_windowAllocations;
+    }
+    const qint64 elapsed = m_window.elapsed();
+    if (elapsed >= kRateWindowMs) {
+        m_rate.store(m_windowAllocations * 1000.0 / elapsed, std::memory_order_relaxed);
+        m_windowAllocations = 0;
+        m_window.restart();
+    }
+}
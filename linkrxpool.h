@@ -0,0 +1,54 @@
+﻿/**************************************************************************
+ *   文件名	：linkrxpool.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：接收缓冲区池，复用预分配的 QByteArray，避免每次读取都申请内存
+ *   使用说明 ：I/O 线程 acquire 一块缓冲区读入数据后通过 receiveData 发出；
+ *             接收方拿到的是隐式共享的视图，持有期间数据保持有效，
+ *             所有副本释放后该缓冲区自动回到池中
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+
+#include <atomic>
+
+class LinkRxBufferPool
+{
+public:
+    /// slots 为预分配的缓冲区个数，slotSize 为每块初始容量
+    LinkRxBufferPool(int slots, int slotSize);
+
+    /// 只在 I/O 线程中调用：取得一块无人引用的缓冲区并 resize 为 size，
+    /// 返回的引用在下一次 acquire 之前有效
+    QByteArray &acquire(qsizetype size);
+
+    /// 累计的内存申请次数（含预分配之后的扩容和池耗尽时的临时申请）
+    quint64 allocations() const { return m_allocations.load(std::memory_order_relaxed); }
+    /// 最近一个统计窗口（约 1 秒）内每秒的内存申请次数
+    double allocationsPerSecond() const { return m_rate.load(std::memory_order_relaxed); }
+
+private:
+    void updateStatistics(bool allocated);
+
+    QList<QByteArray> m_slots;
+    QByteArray m_overflow; // 所有缓冲区都被占用时的临时缓冲区
+    int m_next = 0;
+
+    QElapsedTimer m_window;
+    quint64 m_windowAllocations = 0;
+    std::atomic<quint64> m_allocations{0};
+    std::atomic<double> m_rate{0};
+};
@@ -0,0 +1,168 @@
+﻿/**************************************************************************
+ *   文件名	：linksendring.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "linksendring.h"
+
+#include <string.h>
+
+namespace {
+qint64 alignRecord(qint64 size)
+{
+    return (size + 7) & ~qint64(7);
+}
+} // namespace
+
+LinkSendRing::LinkSendRing(int capacity)
+{
+    qint64 size = 64;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    m_capacity = size;
+    m_mask = size - 1;
+    // 全部清零：记录头 length 为 0 表示该位置尚未提交
+    m_buffer.reset(new quint64[size / sizeof(quint64)]());
+}
+
+LinkSendRing::Header *LinkSendRing::headerAt(qint64 position) const
+{
+    return reinterpret_cast<Header *>(reinterpret_cast<char *>(m_buffer.get())
+                                      + (position & m_mask));
+}
+
+char *LinkSendRing::claim(int size)
+{
+    const qint64 span = alignRecord(kHeaderSize + size);
+    if (size <= 0 || span > m_capacity) {
+        m_drops.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    qint64 tail = m_tail.load(std::memory_order_relaxed);
+    qint64 padding;
+    qint64 used;
+    do {
+        const qint64 head = m_head.load(std::memory_order_acquire);
+        const qint64 toEnd = m_capacity - (tail & m_mask);
+        // 记录不跨越缓冲区末尾，放不下时用填充记录补齐到末尾
+        padding = span > toEnd ? toEnd : 0;
+        used = tail + padding + span - head;
+        if (used > m_capacity) {
+            m_drops.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    } while (!m_tail.compare_exchange_weak(tail,
+                                           tail + padding + span,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_relaxed));
+
+    if (padding > 0) {
+        Header *pad = headerAt(tail);
+        pad->span = qint32(padding);
+        pad->length.store(kPadding, std::memory_order_release);
+    }
+    Header *header = headerAt(tail + padding);
+    header->span = qint32(span);
+    updateHighWater(used);
+    return reinterpret_cast<char *>(header) + kHeaderSize;
+}
+
+void LinkSendRing::commit(char *data, int size)
+{
+    Header *header = reinterpret_cast<Header *>(data - kHeaderSize);
+    if (size <= 0) {
+        // 放弃申请的空间：改为填充记录由消费者跳过，长度留 0 会让后面的记录永远发不出去
+        header->length.store(kPadding, std::memory_order_release);
+        return;
+    }
+    header->length.store(size, std::memory_order_release);
+    m_committed.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool LinkSendRing::push(const char *data, int size)
+{
+    char *dst = claim(size);
+    if (dst == nullptr) {
+        return false;
+    }
+    memcpy(dst, data, size);
+    commit(dst, size);
+    return true;
+}
+
+int LinkSendRing::peek(Span *spans, int max)
+{
+    const qint64 head = m_head.load(std::memory_order_relaxed);
+    qint64 position = head;
+    int count = 0;
+    while (count < max && position - head < m_capacity) {
+        Header *header = headerAt(position);
+        const qint32 length = header->length.load(std::memory_order_acquire);
+        if (length == 0) {
+            break; // 尚未提交，保持先后顺序，后面的记录下次再取
+        }
+        if (length != kPadding) {
+            spans[count++] = {reinterpret_cast<const char *>(header) + kHeaderSize, length};
+        }
+        position += header->span;
+    }
+    m_peekEnd = position;
+    m_released = count;
+    return count;
+}
+
+void LinkSendRing::release()
+{
+    const qint64 head = m_head.load(std::memory_order_relaxed);
+    if (m_peekEnd == head) {
+        return;
+    }
+
+    // 清零已消费区域，生产者再次写入时 length 必须从 0 开始
+    char *base = reinterpret_cast<char *>(m_buffer.get());
+    const qint64 begin = head & m_mask;
+    const qint64 size = m_peekEnd - head;
+    const qint64 first = qMin(size, m_capacity - begin);
+    memset(base + begin, 0, first);
+    if (size > first) {
+        memset(base, 0, size - first);
+    }
+
+    m_consumed.fetch_add(m_released, std::memory_order_relaxed);
+    m_released = 0;
+    m_head.store(m_peekEnd, std::memory_order_release);
+}
+
+qint64 LinkSendRing::depthBytes() const
+{
+    return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_relaxed);
+}
+
+quint64 LinkSendRing::depth() const
+{
+    const quint64 consumed = m_consumed.load(std::memory_order_relaxed);
+    const quint64 committed = m_committed.load(std::memory_order_relaxed);
+    return committed > consumed ? committed - consumed : 0;
+}
+
+void LinkSendRing::updateHighWater(qint64 used)
+{
+    qint64 current = m_highWater.load(std::memory_order_relaxed);
+    while (used > current
+           && !m_highWater.compare_exchange_weak(current, used, std::memory_order_relaxed)) {
+    }
+}
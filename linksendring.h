@@ -0,0 +1,89 @@
+﻿/**************************************************************************
+ *   文件名	：linksendring.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：连接发送队列，多生产者单消费者的无锁字节环形缓冲区
+ *   使用说明 ：任意线程 claim 申请空间、写入后 commit；连接的 I/O 线程
+ *             peek 取出已提交的记录，发送完成后 release 归还空间
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <memory>
+
+class LinkSendRing
+{
+public:
+    /// 一条已提交的记录，在 release 之前有效
+    struct Span
+    {
+        const char *data;
+        int size;
+    };
+
+    /// capacity 向上取整为 2 的幂
+    explicit LinkSendRing(int capacity);
+
+    LinkSendRing(const LinkSendRing &) = delete;
+    LinkSendRing &operator=(const LinkSendRing &) = delete;
+
+    /// 生产者：申请 size 字节，空间不足时返回 nullptr 并计入丢弃数
+    char *claim(int size);
+    /// 生产者：提交 claim 得到的空间，size 可小于申请的大小，size <= 0 表示放弃这段空间
+    void commit(char *data, int size);
+    /// 生产者：申请、拷贝、提交一步完成
+    bool push(const char *data, int size);
+
+    /// 消费者：取出最多 max 条已提交记录，不释放空间
+    int peek(Span *spans, int max);
+    /// 消费者：释放上一次 peek 取出的全部记录
+    void release();
+
+    int capacity() const { return int(m_capacity); }
+    /// 未发送的字节数（含记录头）
+    qint64 depthBytes() const;
+    /// 未发送的记录数
+    quint64 depth() const;
+    /// 因空间不足丢弃的记录数
+    quint64 drops() const { return m_drops.load(std::memory_order_relaxed); }
+    /// 占用字节数的历史最大值
+    qint64 highWaterBytes() const { return m_highWater.load(std::memory_order_relaxed); }
+
+private:
+    struct Header
+    {
+        std::atomic<qint32> length; // 0 未提交，>0 已提交的数据长度，kPadding 为填充
+        qint32 span;                // 含记录头、8 字节对齐后的记录总长
+    };
+    static constexpr qint32 kPadding = -1;
+    static constexpr qint64 kHeaderSize = sizeof(Header);
+
+    Header *headerAt(qint64 position) const;
+    void updateHighWater(qint64 used);
+
+    std::unique_ptr<quint64[]> m_buffer; // 以 8 字节为单位分配，保证记录头对齐
+    qint64 m_capacity;
+    qint64 m_mask;
+
+    alignas(64) std::atomic<qint64> m_tail{0}; // 生产者竞争
+    alignas(64) std::atomic<qint64> m_head{0}; // 只由消费者修改
+    qint64 m_peekEnd = 0;
+    quint64 m_released = 0;
+
+    alignas(64) std::atomic<quint64> m_committed{0};
+    std::atomic<quint64> m_consumed{0};
+    std::atomic<quint64> m_drops{0};
+    std::atomic<qint64> m_highWater{0};
+};
@@ -16,35 +16,56 @@
  *
  ***************************************************************************/
 #include "linktcp.h"
+#include "linkreconnectscheduler.h"
 
 LinkTcp::LinkTcp() {}
 
+LinkTcp::~LinkTcp()
+{
+    // socket 在 I/O 线程中创建，也在 I/O 线程中关闭和回收，之后连接回到当前线程析构
+    detachIoThread([this]() { closeSocket(); });
+}
+
 bool LinkTcp::connectLink()
 {
-    asyncConnect();
+    // socket 在 I/O 线程中创建，读写不再占用界面线程的事件循环，重连由 LinkReconnectScheduler 统一调度
+    attachIoThread();
+    invokeInLinkThread([this]() { asyncConnect(); });
     return true;
 }
 
 void LinkTcp::disconnectLink()
 {
+    invokeInLinkThread(
+        [this]() {
+            if (closeSocket()) {
+                emit disconnected();
+            }
+        },
+        true);
+}
+
+bool LinkTcp::closeSocket()
+{
+    LinkReconnectScheduler::instance()->cancel(this);
     if (m_tcpSocket) {
+        // 先断开信号，避免 abort 触发 errorOccurred 再次启动重连
+        m_tcpSocket->disconnect(this);
         m_tcpSocket->abort();
         m_tcpSocket->close();
-        m_tcpSocket->deleteLater();
+        m_tcpSocket.take()->deleteLater();
     }
+    return m_isConnected.exchange(false);
 }
 
 bool LinkTcp::isConnected() const
 {
-    if (m_tcpSocket) {
-        return m_tcpSocket->state() == QAbstractSocket::ConnectedState;
-    }
-    return false;
+    return m_isConnected;
 }
 
 quint64 LinkTcp::writeData(const QByteArray &data)
 {
-    if (isConnected()) {
+    if (m_tcpSocket && m_tcpSocket->state() == QAbstractSocket::ConnectedState) {
         return m_tcpSocket->write(data);
     }
     return -1;
@@ -65,26 +86,19 @@ void LinkTcp::asyncConnect()
         return;
     }
 
-    //定时器，用于断线重连
-    m_reTime.reset(new QTimer());
-    connect(m_reTime.data(), &QTimer::timeout, this, [=]() {
-        m_tcpSocket->abort();
-        m_tcpSocket->close();
-        auto str = QString("%1:%2 ").arg(tcpConfig->address().toString()).arg(tcpConfig->port());
-        str = str + tr("connect timeout!");
-        emit linkError(tcptile, str);
-
-        m_tcpSocket->connectToHost(tcpConfig->address(), tcpConfig->port());
-    });
-
     m_tcpSocket.reset(new QTcpSocket());
     connect(m_tcpSocket.data(), &QTcpSocket::readyRead, this, [this]() {
         auto byte_size = m_tcpSocket->bytesAvailable();
         if (byte_size > 0) {
-            QByteArray buffer;
-            buffer.resize(byte_size);
-            m_tcpSocket->read(buffer.data(), buffer.size());
-            emit receiveData(this, buffer);
+            // 读入复用的缓冲区，接收方释放全部副本后该缓冲区回到池中
+            auto &buffer = rxPool().acquire(byte_size);
+            auto len = m_tcpSocket->read(buffer.data(), buffer.size());
+            if (len <= 0) {
+                buffer.resize(0);
+                return;
+            }
+            buffer.resize(len);
+            emitReceiveData(buffer);
         }
     });
 
@@ -92,8 +106,15 @@ void LinkTcp::asyncConnect()
             &QTcpSocket::errorOccurred,
             this,
             [=](QAbstractSocket::SocketError error) {
-                if (!m_reTime->isActive() && tcpConfig->autoConnect()) {
-                    m_reTime->start(tcpConfig->interval());
+                m_isConnected = false;
+                // 间隔和并发由全局调度器控制，interval 作为退避的初始间隔
+                auto scheduler = LinkReconnectScheduler::instance();
+                scheduler->finished(this, false);
+                if (tcpConfig->autoConnect()) {
+                    scheduler->schedule(this, int(tcpConfig->interval()), [this]() { reconnect(); });
+                } else {
+                    // 不自动重连，清除调度器中的记录
+                    scheduler->cancel(this);
                 }
 
                 if (m_tcpSocket) {
@@ -102,13 +123,34 @@ void LinkTcp::asyncConnect()
             });
 
     connect(m_tcpSocket.data(), &QTcpSocket::connected, this, [=]() {
+        m_isConnected = true;
+        LinkReconnectScheduler::instance()->finished(this, true);
         emit connected();
-        if (m_reTime->isActive()) {
-            m_reTime->stop();
-        }
     });
 
-    connect(m_tcpSocket.data(), &QTcpSocket::disconnected, this, &LinkTcp::disconnected);
+    connect(m_tcpSocket.data(), &QTcpSocket::disconnected, this, [this]() {
+        m_isConnected = false;
+        emit disconnected();
+    });
+    // 首次连接同样受调度器的并发上限约束
+    LinkReconnectScheduler::instance()->connectNow(this, [this]() { reconnect(); });
+}
+
+void LinkTcp::reconnect()
+{
+    auto tcpConfig = qobject_cast<LinkTcpConfig *>(getConfig().data());
+    if (!m_tcpSocket || tcpConfig == nullptr) {
+        LinkReconnectScheduler::instance()->cancel(this);
+        return;
+    }
+    if (m_tcpSocket->state() != QAbstractSocket::UnconnectedState) {
+        // 上一次尝试超时仍未结束
+        m_tcpSocket->abort();
+        m_tcpSocket->close();
+        auto str = QString("%1:%2 ").arg(tcpConfig->address().toString()).arg(tcpConfig->port());
+        str = str + tr("connect timeout!");
+        emit linkError(tcptile, str);
+    }
     m_tcpSocket->connectToHost(tcpConfig->address(), tcpConfig->port());
 }
 
@@ -22,7 +22,8 @@
 
 #include <QPointer>
 #include <QTcpSocket>
-#include <QTimer>
+
+#include <atomic>
 
 class LinkTcpConfig : public LinkConfig
 {
@@ -52,6 +53,7 @@ class LinkTcp : public LinkInterface
 {
 public:
     LinkTcp();
+    ~LinkTcp();
 
     // LinkInterface interface
 public:
@@ -63,9 +65,14 @@ protected:
     quint64 writeData(const QByteArray &data) override;
 
     void asyncConnect();
+    /// 由 LinkReconnectScheduler 在 I/O 线程中调用，放弃未完成的连接后重新连接
+    void reconnect();
+
+private:
+    /// I/O 线程中调用：停止重连并回收 socket，返回之前是否处于连接状态
+    bool closeSocket();
 
 private:
     QScopedPointer<QTcpSocket> m_tcpSocket;
-    QScopedPointer<QTimer> m_reTime;
-    //111
+    std::atomic_bool m_isConnected{false}; // 供其它线程查询，socket 本身只在 I/O 线程中访问
 };
@@ -1,7 +1,105 @@
+﻿/**************************************************************************
+ *   文件名	：linkudp.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
 #include "linkudp.h"
-#include <QUdpSocket>
+#include <QSemaphore>
 #include <QThread>
-#include <QMutexLocker>
+#include <QUdpSocket>
+#include <QVarLengthArray>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr int kBatchSize = 64;         // 单次 recvmmsg/sendmmsg 的最大报文数
+constexpr int kMaxBatchesPerWake = 8;  // 一次唤醒最多连续 recvmmsg 的次数
+constexpr int kDatagramSize = 4096;    // 单个接收槽位大小
+constexpr int kMaxRemotes = 16;        // 自动记录的对端数量上限
+#ifdef Q_OS_LINUX
+constexpr int kPollTimeoutMs = 100;    // 仅用于兜底检查退出标志
+constexpr int kSendRetryMs = 5;        // 发送缓冲区满时等待可写的时长
+constexpr int kMaxSendRetries = 3;     // 同一位置连续等待的次数，超过后丢弃该报文
+#else
+constexpr int kIdleWaitMs = 5;         // 无唤醒机制，靠短超时处理待发数据
+#endif
+
+#ifdef Q_OS_LINUX
+/// 同一对端的判断，只比较地址族、端口和地址
+bool sameSender(const sockaddr_storage &a, const sockaddr_storage &b)
+{
+    if (a.ss_family != b.ss_family) {
+        return false;
+    }
+    if (a.ss_family == AF_INET6) {
+        const auto &a6 = reinterpret_cast<const sockaddr_in6 &>(a);
+        const auto &b6 = reinterpret_cast<const sockaddr_in6 &>(b);
+        return a6.sin6_port == b6.sin6_port
+               && memcmp(&a6.sin6_addr, &b6.sin6_addr, sizeof(a6.sin6_addr)) == 0;
+    }
+    const auto &a4 = reinterpret_cast<const sockaddr_in &>(a);
+    const auto &b4 = reinterpret_cast<const sockaddr_in &>(b);
+    return a4.sin_port == b4.sin_port && a4.sin_addr.s_addr == b4.sin_addr.s_addr;
+}
+
+quint16 senderPort(const sockaddr_storage &addr)
+{
+    if (addr.ss_family == AF_INET6) {
+        return ntohs(reinterpret_cast<const sockaddr_in6 &>(addr).sin6_port);
+    }
+    return ntohs(reinterpret_cast<const sockaddr_in &>(addr).sin_port);
+}
+
+/// 按 socket 的地址族填写目标地址，双栈 socket 发往 IPv4 时使用映射地址，
+/// 地址族不匹配时返回 0
+socklen_t toSockaddr(const QHostAddress &address, quint16 port, int family, sockaddr_storage *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (family == AF_INET6) {
+        auto *addr = reinterpret_cast<sockaddr_in6 *>(out);
+        addr->sin6_family = AF_INET6;
+        addr->sin6_port = htons(port);
+        const Q_IPV6ADDR ip6 = address.toIPv6Address(); // IPv4 地址返回 ::ffff:a.b.c.d
+        memcpy(&addr->sin6_addr, ip6.c, sizeof(addr->sin6_addr));
+        addr->sin6_scope_id = address.scopeId().toUInt();
+        return sizeof(sockaddr_in6);
+    }
+    bool isIpv4 = false;
+    const quint32 ip4 = address.toIPv4Address(&isIpv4);
+    if (!isIpv4) {
+        return 0;
+    }
+    auto *addr = reinterpret_cast<sockaddr_in *>(out);
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(port);
+    addr->sin_addr.s_addr = htonl(ip4);
+    return sizeof(sockaddr_in);
+}
+#endif
+} // namespace
+
+QString udptitle = QObject::tr("UDP Link Error");
 
 LinkUdp::LinkUdp() : m_thread(nullptr),
                      m_isConnected(false),
@@ -11,15 +109,422 @@ LinkUdp::LinkUdp() : m_thread(nullptr),
 
 LinkUdp::~LinkUdp()
 {
+    disconnectLink();
+#ifdef Q_OS_LINUX
+    const int wakeFd = m_wakeFd.exchange(-1);
+    if (wakeFd >= 0) {
+        close(wakeFd);
+    }
+#endif
 }
 
+bool LinkUdp::connectLink()
+{
+    if (m_thread) {
+        if (!m_thread->isFinished()) {
+            return true;
+        }
+        disconnectLink(); // 收发线程因错误退出，回收后重新打开
+    }
+
+    auto udpConfig = qobject_cast<LinkUdpConfig *>(getConfig().data());
+    if (udpConfig == nullptr) {
+        emit linkError(udptitle, tr("no config"));
+        return false;
+    }
+
+#ifdef Q_OS_LINUX
+    // eventfd 在连接对象的整个生命周期内保留，其他线程随时可能调用 wakeIoThread
+    if (m_wakeFd.load() < 0) {
+        const int wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeFd < 0) {
+            emit linkError(udptitle, QString::fromLocal8Bit(strerror(errno)));
+            return false;
+        }
+        m_wakeFd.store(wakeFd);
+    }
+#endif
+
+    // socket 属于收发线程，在线程中绑定，等绑定结果出来后再返回
+    m_shouldExit = false;
+    QSemaphore bound;
+    QString bindError;
+    m_thread = QThread::create([this, &bound, &bindError]() { run(&bound, &bindError); });
+    m_thread->setObjectName("LinkUdp");
+    m_thread->start();
+    bound.acquire();
+
+    if (!bindError.isEmpty()) {
+        disconnectLink();
+        emit linkError(udptitle, bindError);
+        return false;
+    }
+    return true;
+}
+
+void LinkUdp::disconnectLink()
+{
+    if (m_thread == nullptr) {
+        return;
+    }
+    m_shouldExit = true;
+    wakeIoThread();
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    clearSendQueue();
+}
 
 bool LinkUdp::isConnected() const
 {
-    return true;
+    return m_isConnected;
+}
+
+quint64 LinkUdp::writeData(const QByteArray &data)
+{
+    if (!m_isConnected) {
+        return -1;
+    }
+    writeBytesThreadSafe(data);
+    return data.size();
+}
+
+void LinkUdp::wakeIoThread()
+{
+#ifdef Q_OS_LINUX
+    const int wakeFd = m_wakeFd.load();
+    if (wakeFd >= 0) {
+        quint64 one = 1;
+        ssize_t ret = write(wakeFd, &one, sizeof(one));
+        Q_UNUSED(ret);
+    }
+#endif
 }
 
+void LinkUdp::addRemote(const QHostAddress &address, quint16 port)
+{
+    for (const auto &remote : std::as_const(m_remotes)) {
+        if (remote.port == port && remote.address == address) {
+            return;
+        }
+    }
+    if (m_remotes.size() >= kMaxRemotes) {
+        m_remotes.removeFirst();
+    }
+    m_remotes.append({address, port});
+}
+
+void LinkUdp::run(QSemaphore *bound, QString *bindError)
+{
+    auto udpConfig = qobject_cast<LinkUdpConfig *>(getConfig().data());
+    if (udpConfig == nullptr) {
+        *bindError = tr("no config");
+        bound->release();
+        return;
+    }
+
+    // Any 在支持 IPv6 的系统上是双栈 socket，同时收发 IPv4 和 IPv6
+    QUdpSocket socket;
+    if (!socket.bind(QHostAddress::Any,
+                     udpConfig->localPort(),
+                     QAbstractSocket::ShareAddress | QAbstractSocket::ReuseAddressHint)) {
+        *bindError = socket.errorString();
+        bound->release();
+        return;
+    }
+
+    // 配置了目标地址时只发往目标，否则回复所有发来过数据的对端
+    m_learnRemote = udpConfig->port() == 0 || udpConfig->address().isNull();
+    m_remotes.clear();
+    if (!m_learnRemote) {
+        m_remotes.append({udpConfig->address(), quint16(udpConfig->port())});
+    }
+
+    m_isConnected = true;
+    bound->release(); // 之后不能再访问 bound 和 bindError
+    emit connected();
+
+#ifdef Q_OS_LINUX
+    const int fd = int(socket.socketDescriptor());
+    sockaddr_storage local;
+    socklen_t localLen = sizeof(local);
+    m_family = getsockname(fd, reinterpret_cast<sockaddr *>(&local), &localLen) == 0 ? local.ss_family
+                                                                                       : AF_INET;
+    const int wakeFd = m_wakeFd.load();
+    pollfd fds[2] = {{fd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+    while (!m_shouldExit) {
+        if (poll(fds, 2, kPollTimeoutMs) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            emit linkError(udptitle, QString::fromLocal8Bit(strerror(errno)));
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            quint64 count;
+            ssize_t ret = read(wakeFd, &count, sizeof(count));
+            Q_UNUSED(ret);
+        }
+        if (fds[0].revents & POLLIN) {
+            receiveBatch(fd);
+        }
+        sendBatch(fd);
+    }
+#else
+    while (!m_shouldExit) {
+        if (socket.waitForReadyRead(kIdleWaitMs)) {
+            receiveBatch(&socket);
+        }
+        sendBatch(&socket);
+    }
+#endif
+
+    m_isConnected = false;
+    emit disconnected();
+}
+
+#ifdef Q_OS_LINUX
+void LinkUdp::receiveBatch(int fd)
+{
+    mmsghdr msgs[kBatchSize];
+    iovec iovs[kBatchSize];
+    sockaddr_storage addrs[kBatchSize];
+
+    for (int round = 0; round < kMaxBatchesPerWake; ++round) {
+        // 直接收进池中的缓冲区，每次 recvmmsg 收到的报文合并为一个 receiveData 信号
+        auto &buffer = rxPool().acquire(kBatchSize * kDatagramSize);
+        char *base = buffer.data();
+        for (int i = 0; i < kBatchSize; ++i) {
+            iovs[i].iov_base = base + i * kDatagramSize;
+            iovs[i].iov_len = kDatagramSize;
+            memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        const int count = recvmmsg(fd, msgs, kBatchSize, MSG_DONTWAIT, nullptr);
+        if (count <= 0) {
+            buffer.resize(0);
+            break;
+        }
+
+        // 原地压紧各槽位中的报文
+        int total = 0;
+        for (int i = 0; i < count; ++i) {
+            const int len = qMin(int(msgs[i].msg_len), kDatagramSize);
+            if (total != i * kDatagramSize) {
+                memmove(base + total, base + i * kDatagramSize, len);
+            }
+            total += len;
+            // 同一对端的连续报文只记录一次
+            if (m_learnRemote && (i == 0 || !sameSender(addrs[i], addrs[i - 1]))) {
+                addRemote(QHostAddress(reinterpret_cast<const sockaddr *>(&addrs[i])),
+                          senderPort(addrs[i]));
+            }
+        }
+        buffer.resize(total);
+        emitReceiveData(buffer);
+
+        if (count < kBatchSize) {
+            break;
+        }
+    }
+}
+
+void LinkUdp::sendBatch(int fd)
+{
+    flushStarted();
+    if (m_remotes.isEmpty()) {
+        clearSendQueue(); // 还不知道对端，UDP 直接丢弃
+        return;
+    }
+
+    struct Target
+    {
+        sockaddr_storage addr;
+        socklen_t len;
+    };
+    QVarLengthArray<Target, kMaxRemotes> targets;
+    for (const auto &remote : std::as_const(m_remotes)) {
+        Target target;
+        target.len = toSockaddr(remote.address, remote.port, m_family, &target.addr);
+        if (target.len > 0) {
+            targets.append(target);
+        }
+    }
+    if (targets.isEmpty()) {
+        clearSendQueue(); // IPv4 socket 无法发往 IPv6 对端
+        return;
+    }
+
+    // 每帧一个报文，iovec 直接指向发送队列内存，release 之前不会被覆盖
+    const int framesPerBatch = qMax(1, kBatchSize / int(targets.size()));
+    LinkSendRing::Span spans[kBatchSize];
+    mmsghdr msgs[kBatchSize];
+    iovec iovs[kBatchSize];
+    int frames;
+    while ((frames = sendRing().peek(spans, framesPerBatch)) > 0) {
+        int count = 0;
+        for (int i = 0; i < frames; ++i) {
+            for (auto &target : targets) {
+                if (count == kBatchSize) {
+                    break;
+                }
+                iovs[count].iov_base = const_cast<char *>(spans[i].data);
+                iovs[count].iov_len = spans[i].size;
+                memset(&msgs[count].msg_hdr, 0, sizeof(msgs[count].msg_hdr));
+                msgs[count].msg_hdr.msg_name = &target.addr;
+                msgs[count].msg_hdr.msg_namelen = target.len;
+                msgs[count].msg_hdr.msg_iov = &iovs[count];
+                msgs[count].msg_hdr.msg_iovlen = 1;
+                ++count;
+            }
+        }
+
+        // sendmmsg 出错时只说明第一个未发出的报文失败：缓冲区满时等待可写后重试，
+        // 其他错误（如对端不可达）丢弃该报文并继续发送其余报文
+        qint64 bytes = 0;
+        quint64 dropped = 0;
+        int pos = 0;
+        int retries = 0;
+        while (pos < count) {
+            const int ret = sendmmsg(fd, msgs + pos, count - pos, 0);
+            if (ret > 0) {
+                for (int i = pos; i < pos + ret; ++i) {
+                    bytes += qint64(msgs[i].msg_len);
+                }
+                pos += ret;
+                retries = 0;
+                continue;
+            }
+            if (ret < 0 && errno == EINTR) {
+                continue;
+            }
+            const bool full = ret == 0 || errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS;
+            if (full && retries < kMaxSendRetries && !m_shouldExit) {
+                ++retries;
+                pollfd out = {fd, POLLOUT, 0};
+                poll(&out, 1, kSendRetryMs);
+                continue;
+            }
+            ++dropped;
+            ++pos;
+            retries = 0;
+        }
+        metrics().sent(bytes);
+        if (dropped > 0) {
+            metrics().sendDropped(dropped);
+        }
+        sendRing().release();
+    }
+}
+#else
+void LinkUdp::receiveBatch(QUdpSocket *socket)
+{
+    auto &buffer = rxPool().acquire(kBatchSize * kDatagramSize);
+    qint64 total = 0;
+    while (socket->hasPendingDatagrams()) {
+        const auto size = socket->pendingDatagramSize();
+        if (size < 0 || total + size > buffer.size()) {
+            break; // 剩下的留到下一轮
+        }
+        QHostAddress sender;
+        quint16 senderPort = 0;
+        const auto ret = socket->readDatagram(buffer.data() + total, size, &sender, &senderPort);
+        if (ret < 0) {
+            break;
+        }
+        total += ret;
+        if (m_learnRemote) {
+            addRemote(sender, senderPort);
+        }
+    }
+
+    buffer.resize(total);
+    if (total > 0) {
+        emitReceiveData(buffer);
+    }
+}
+
+void LinkUdp::sendBatch(QUdpSocket *socket)
+{
+    flushStarted();
+    LinkSendRing::Span spans[kBatchSize];
+    int frames;
+    while ((frames = sendRing().peek(spans, kBatchSize)) > 0) {
+        qint64 bytes = 0;
+        quint64 dropped = 0;
+        for (int i = 0; i < frames; ++i) {
+            for (const auto &remote : std::as_const(m_remotes)) {
+                const qint64 ret = socket->writeDatagram(spans[i].data, spans[i].size, remote.address, remote.port);
+                if (ret > 0) {
+                    bytes += ret;
+                } else {
+                    ++dropped;
+                }
+            }
+        }
+        metrics().sent(bytes);
+        if (dropped > 0) {
+            metrics().sendDropped(dropped);
+        }
+        sendRing().release();
+    }
+}
+#endif
+
+quint32 LinkUdpConfig::localPort() const
+{
+    return m_localPort;
+}
+
+void LinkUdpConfig::setLocalPort(quint32 newLocalPort)
+{
+    if (m_localPort == newLocalPort) {
+        return;
+    }
+    m_localPort = newLocalPort;
+    emit localPortChanged();
+}
+
+QString LinkUdpConfig::ip() const
+{
+    return m_address.toString();
+}
+
+void LinkUdpConfig::setIp(const QString &newIp)
+{
+    QHostAddress test;
+    if (test.setAddress(newIp)) {
+        setAddress(test);
+    }
+    emit ipChanged();
+}
+
+quint32 LinkUdpConfig::port() const
+{
+    return m_port;
+}
+
+void LinkUdpConfig::setPort(quint32 newPort)
+{
+    if (m_port == newPort) {
+        return;
+    }
+    m_port = newPort;
+    emit portChanged();
+}
+
+const QHostAddress LinkUdpConfig::address() const
+{
+    return m_address;
+}
 
-void LinkUdp::run()
+void LinkUdpConfig::setAddress(const QHostAddress &address)
 {
+    if (m_address != address) {
+        m_address = address;
+    }
 }
@@ -1,13 +1,66 @@
+﻿/**************************************************************************
+ *   文件名	：linkudp.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：UDP 连接，收发在独立线程中完成
+ *   使用说明 ：Linux 下使用 recvmmsg/sendmmsg 批量收发，每批报文只发出一个
+ *             receiveData 信号；其它平台退化为逐包收发
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
 #pragma once
 
 #include "linkconfig.h"
 #include "linkinterface.h"
 
+#include <QHostAddress>
+#include <QList>
+
+#include <atomic>
+
+class QSemaphore;
+class QThread;
+class QUdpSocket;
+
 class LinkUdpConfig : public LinkConfig
 {
     Q_OBJECT
 public:
     LinkUdpConfig() {}
+    Q_PROPERTY(quint32 localPort READ localPort WRITE setLocalPort NOTIFY localPortChanged FINAL)
+    Q_PROPERTY(QString ip READ ip WRITE setIp NOTIFY ipChanged FINAL)
+    Q_PROPERTY(quint32 port READ port WRITE setPort NOTIFY portChanged FINAL)
+
+    /// 本地监听端口
+    quint32 localPort() const;
+    void setLocalPort(quint32 newLocalPort);
+    /// 目标地址，为空时回复给最近发来数据的对端
+    QString ip() const;
+    void setIp(const QString &newIp);
+    quint32 port() const;
+    void setPort(quint32 newPort);
+    const QHostAddress address() const;
+    void setAddress(const QHostAddress &address);
+
+signals:
+    void localPortChanged();
+
+    void ipChanged();
+
+    void portChanged();
+
+private:
+    quint32 m_localPort = 14550;
+    QHostAddress m_address; // 目标地址
+    quint32 m_port = 0;
 };
 
 class LinkUdp : public LinkInterface
@@ -17,13 +70,44 @@ public:
     LinkUdp();
     ~LinkUdp();
 
-    virtual bool isConnected() const override;
+    // LinkInterface interface
+public:
+    bool connectLink() override;
+    void disconnectLink() override;
+    bool isConnected() const override;
+
+protected:
+    /// 只入队，真正的发送在收发线程中批量完成
+    quint64 writeData(const QByteArray &data) override;
+    /// 发送队列由收发线程自行消费，这里只需唤醒 poll
+    void wakeIoThread() override;
 
 private:
-    void run(); // 线程运行函数
+    struct Remote
+    {
+        QHostAddress address;
+        quint16 port;
+    };
+
+    /// 线程运行函数，绑定完成后释放 bound，绑定失败时把原因写入 bindError 并退出
+    void run(QSemaphore *bound, QString *bindError);
+    /// 收发线程中调用，记录对端地址
+    void addRemote(const QHostAddress &address, quint16 port);
+#ifdef Q_OS_LINUX
+    void receiveBatch(int fd);
+    void sendBatch(int fd);
+#else
+    void receiveBatch(QUdpSocket *socket);
+    void sendBatch(QUdpSocket *socket);
+#endif
 
 private:
     QThread *m_thread;
-    bool m_isConnected;
-    volatile bool m_shouldExit;
+    std::atomic_bool m_isConnected;
+    std::atomic_bool m_shouldExit;
+    std::atomic_int m_wakeFd{-1}; // 唤醒收发线程的 eventfd，首次连接时创建，析构时关闭
+    int m_family = 0; // socket 的地址族，只在收发线程中访问
+
+    QList<Remote> m_remotes; // 只在收发线程中访问
+    bool m_learnRemote = true;
 };
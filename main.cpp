@@ -15,14 +15,70 @@
  *   ======================================================================
  *
  ***************************************************************************/
+#include <QCommandLineParser>
+#include <QDebug>
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 
+#include "linkconfigloader.h"
+#include "linkinterface.h"
+#include "mavlinkdispatcher.h"
+#include "mavlinkrouter.h"
+#include "telemetrymodel.h"
+#include "telemetrystore.h"
+
+namespace {
+// 没有指定配置文件时监听 UDP 14550，与飞控和 SITL 的默认输出一致
+const char kDefaultLinks[] = R"({ "links": [ { "name": "udp", "type": "udp", "localPort": 14550 } ] })";
+} // namespace
+
 int main(int argc, char *argv[])
 {
     QGuiApplication app(argc, argv);
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption configOption({"c", "config"}, "Link configuration file (same format as CommHelperd).", "file");
+    parser.addOption(configOption);
+    parser.process(app);
+
+    LinkConfigLoader loader;
+    const bool loaded = parser.isSet(configOption) ? loader.load(parser.value(configOption))
+                                                   : loader.parse(kDefaultLinks);
+    if (!loaded) {
+        qCritical().noquote() << loader.errorString();
+        return 1;
+    }
+
+    MavlinkRouter router;
+    router.setForwarding(loader.forwarding());
+    MavlinkDispatcher dispatcher;
+    dispatcher.attach(&router);
+    TelemetryModel telemetry;
+    telemetry.attach(&dispatcher);
+    TelemetryStore history;
+    history.attach(&dispatcher);
+
+    // 处理函数注册完后再启动路由线程：解析、分发和入库都在路由线程中完成，
+    // 界面线程只处理 TelemetryModel 每帧发布一次的结果
+    router.startThread();
+
+    QVector<LinkInterface *> links;
+    for (const auto &description : loader.links()) {
+        QString error;
+        LinkInterface *link = LinkConfigLoader::createLink(description, &error);
+        if (link == nullptr) {
+            qWarning().noquote() << description.name << error;
+            continue;
+        }
+        router.addLink(link);
+        link->connectLink();
+        links.append(link);
+    }
+
     QQmlApplicationEngine engine;
+    engine.setInitialProperties({{"telemetry", QVariant::fromValue(&telemetry)},
+                                {"history", QVariant::fromValue(&history)}});
     QObject::connect(
         &engine,
         &QQmlApplicationEngine::objectCreationFailed,
@@ -32,5 +88,12 @@ int main(int argc, char *argv[])
     engine.loadFromModule("CommHelper", "Main");
     ///
 
-    return app.exec();
+    const int ret = app.exec();
+
+    for (auto link : std::as_const(links)) {
+        link->disconnectLink();
+        router.removeLink(link);
+    }
+    qDeleteAll(links);
+    return ret;
 }
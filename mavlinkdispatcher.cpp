@@ -0,0 +1,138 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinkdispatcher.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "mavlinkdispatcher.h"
+#include "mavlinkrouter.h"
+
+MavlinkDispatcher::MavlinkDispatcher(QObject *parent)
+    : QObject(parent)
+    , m_handlers(MavlinkMsgTable::kEntryCount)
+{}
+
+void MavlinkDispatcher::attach(MavlinkRouter *router)
+{
+    connect(router,
+            &MavlinkRouter::messageReceived,
+            this,
+            &MavlinkDispatcher::dispatch,
+            Qt::DirectConnection);
+}
+
+int MavlinkDispatcher::onMessage(uint32_t msgid, MessageHandler handler)
+{
+    const int slot = MavlinkMsgTable::indexOf(msgid);
+    if (slot < 0) {
+        return -1;
+    }
+    return addHandler(slot, std::move(handler));
+}
+
+int MavlinkDispatcher::onAny(MessageHandler handler)
+{
+    return addHandler(kAnySlot, std::move(handler));
+}
+
+int MavlinkDispatcher::addHandler(int slot, MessageHandler handler)
+{
+    if (!handler) {
+        return -1;
+    }
+    const int id = m_nextId++;
+    m_slots.insert(id, slot);
+    if (m_dispatching > 0) {
+        m_pending.append({slot, {id, std::move(handler)}});
+        return id;
+    }
+    auto &handlers = slot == kAnySlot ? m_anyHandlers : m_handlers[slot];
+    handlers.append({id, std::move(handler)});
+    return id;
+}
+
+void MavlinkDispatcher::remove(int id)
+{
+    auto it = m_slots.find(id);
+    if (it == m_slots.end()) {
+        return;
+    }
+    const int slot = it.value();
+    m_slots.erase(it);
+
+    for (auto &pending : m_pending) {
+        if (pending.second.id == id) {
+            pending.second.removed = true;
+        }
+    }
+    auto &handlers = slot == kAnySlot ? m_anyHandlers : m_handlers[slot];
+    for (auto &handler : handlers) {
+        if (handler.id == id) {
+            handler.removed = true;
+        }
+    }
+    m_removed = true;
+    if (m_dispatching == 0) {
+        compact();
+    }
+}
+
+void MavlinkDispatcher::compact()
+{
+    for (auto &pending : m_pending) {
+        if (!pending.second.removed) {
+            auto &handlers = pending.first == kAnySlot ? m_anyHandlers : m_handlers[pending.first];
+            handlers.append(std::move(pending.second));
+        }
+    }
+    m_pending.clear();
+
+    if (!m_removed) {
+        return;
+    }
+    m_removed = false;
+    auto isRemoved = [](const Handler &handler) { return handler.removed; };
+    m_anyHandlers.removeIf(isRemoved);
+    for (auto &handlers : m_handlers) {
+        handlers.removeIf(isRemoved);
+    }
+}
+
+void MavlinkDispatcher::dispatch(LinkInterface *link, const mavlink_message_t &message)
+{
+    ++m_dispatched;
+    const int slot = MavlinkMsgTable::indexOf(message.msgid);
+    const int count = slot < 0 ? 0 : int(m_handlers[slot].size());
+    if (count == 0 && m_anyHandlers.isEmpty()) {
+        ++m_unhandled;
+        return;
+    }
+
+    ++m_dispatching;
+    // 回调中注册的处理函数进入 m_pending，这里的数组不会扩容
+    for (int i = 0; i < count; ++i) {
+        const auto &handler = m_handlers[slot][i];
+        if (!handler.removed) {
+            handler.func(link, message);
+        }
+    }
+    for (const auto &handler : std::as_const(m_anyHandlers)) {
+        if (!handler.removed) {
+            handler.func(link, message);
+        }
+    }
+    if (--m_dispatching == 0 && (m_removed || !m_pending.isEmpty())) {
+        compact();
+    }
+}
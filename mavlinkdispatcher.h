@@ -0,0 +1,99 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinkdispatcher.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：按 msgid 分发 MAVLink 消息
+ *   使用说明 ：on<mavlink_attitude_t>(...) 注册带类型的回调，回调直接拿到
+ *             指向帧内负载的结构体引用，不经过 mavlink_msg_*_decode 拷贝。
+ *             处理函数按消息在方言中的下标存放在平铺表中，分发不经过 Qt 信号，
+ *             回调在调用 dispatch 的线程（挂到路由时为路由所在线程）中执行
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "mavlinkmessagetraits.h"
+
+#include <QHash>
+#include <QObject>
+#include <QVector>
+
+#include <functional>
+
+class LinkInterface;
+class MavlinkRouter;
+
+class MavlinkDispatcher : public QObject
+{
+    Q_OBJECT
+public:
+    using MessageHandler = std::function<void(LinkInterface *link, const mavlink_message_t &message)>;
+
+    explicit MavlinkDispatcher(QObject *parent = nullptr);
+
+    /// 接收路由解析出的全部消息
+    void attach(MavlinkRouter *router);
+
+    /// 注册类型 T 的处理函数 func(const T &payload, const mavlink_message_t &message)，
+    /// payload 直接指向 message 的负载，只在回调内有效。返回值用于 remove
+    template<typename T, typename Func>
+    int on(Func &&func)
+    {
+        // MAVLink 结构体按 1 字节对齐、字段为小端序，负载补零到最大长度后可直接按结构体访问
+        static_assert(!MAVLINK_NEED_BYTE_SWAP, "in-place payload views require a little-endian host");
+        static_assert(sizeof(T) <= MAVLINK_MAX_PAYLOAD_LEN, "payload larger than a MAVLink frame");
+        return onMessage(MavlinkMessageTraits<T>::id,
+                         [func = std::forward<Func>(func)](LinkInterface *, const mavlink_message_t &message) {
+                             func(*reinterpret_cast<const T *>(_MAV_PAYLOAD(&message)), message);
+                         });
+    }
+
+    /// 按 msgid 注册，方言中不存在该消息或 handler 为空时返回 -1
+    int onMessage(uint32_t msgid, MessageHandler handler);
+    /// 注册接收全部消息的处理函数
+    int onAny(MessageHandler handler);
+    /// 注销处理函数，可以在回调中调用
+    void remove(int id);
+
+    /// 分发一条消息
+    void dispatch(LinkInterface *link, const mavlink_message_t &message);
+
+    /// 已分发的消息数
+    quint64 dispatched() const { return m_dispatched; }
+    /// 没有任何处理函数的消息数
+    quint64 unhandled() const { return m_unhandled; }
+
+private:
+    struct Handler
+    {
+        int id;
+        MessageHandler func;
+        // 已注销，分发结束后在 compact 中析构。回调中注销自身时 func 仍在执行，不能直接清空
+        bool removed = false;
+    };
+    static constexpr int kAnySlot = -1;
+
+    int addHandler(int slot, MessageHandler handler);
+    void compact();
+
+    QVector<QVector<Handler>> m_handlers; // 下标为消息在方言中的下标
+    QVector<Handler> m_anyHandlers;
+    QHash<int, int> m_slots; // 处理函数 ID -> 所在下标
+    int m_nextId = 0;
+
+    // 分发期间注册的处理函数暂存，避免回调中扩容正在遍历的数组
+    int m_dispatching = 0;
+    QVector<QPair<int, Handler>> m_pending;
+    bool m_removed = false;
+
+    quint64 m_dispatched = 0;
+    quint64 m_unhandled = 0;
+};
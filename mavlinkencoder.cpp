@@ -0,0 +1,212 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinkencoder.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "mavlinkencoder.h"
+#include "linkinterface.h"
+#include "mavlinksignature.h"
+
+#include <string.h>
+
+MavlinkEncoder::MavlinkEncoder(uint8_t systemId, uint8_t componentId)
+    : m_systemId(systemId)
+    , m_componentId(componentId)
+{
+}
+
+void MavlinkEncoder::setSigning(mavlink_signing_t *signing)
+{
+    m_signing.store(signing, std::memory_order_release);
+}
+
+int MavlinkEncoder::maxFrameSize(const mavlink_msg_entry_t *entry) const
+{
+    if (entry == nullptr) {
+        return 0;
+    }
+    if (m_mavlink1) {
+        if (entry->msgid > 255) {
+            return 0;
+        }
+        return MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 + entry->min_msg_len + MAVLINK_NUM_CHECKSUM_BYTES;
+    }
+    return MAVLINK_NUM_HEADER_BYTES + entry->max_msg_len + MAVLINK_NUM_CHECKSUM_BYTES
+           + MAVLINK_SIGNATURE_BLOCK_LEN;
+}
+
+mavlink_signing_t *MavlinkEncoder::outgoingSigning(bool mavlink1) const
+{
+    mavlink_signing_t *signing = mavlink1 ? nullptr : m_signing.load(std::memory_order_acquire);
+    return signing && (signing->flags & MAVLINK_SIGNING_FLAG_SIGN_OUTGOING) ? signing : nullptr;
+}
+
+int MavlinkEncoder::encodeFrame(uint8_t *dst,
+                                const mavlink_msg_entry_t *entry,
+                                const void *payload,
+                                int length,
+                                mavlink_signing_t *signing)
+{
+    const uint32_t msgid = entry->msgid;
+    const uint8_t sequence = m_sequence.fetch_add(1, std::memory_order_relaxed);
+    const int headerLen = m_mavlink1 ? MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 : MAVLINK_NUM_HEADER_BYTES;
+    const int wireLen = m_mavlink1 ? entry->min_msg_len : entry->max_msg_len;
+
+    // 负载直接写到帧中的最终位置，短于线上长度的部分补零
+    uint8_t *body = dst + headerLen;
+    const int copied = qMin(length, wireLen);
+    memcpy(body, payload, copied);
+    if (copied < wireLen) {
+        memset(body + copied, 0, wireLen - copied);
+    }
+
+    uint8_t len = uint8_t(wireLen);
+    if (m_mavlink1) {
+        dst[0] = MAVLINK_STX_MAVLINK1;
+        dst[1] = len;
+        dst[2] = sequence;
+        dst[3] = m_systemId;
+        dst[4] = m_componentId;
+        dst[5] = uint8_t(msgid);
+    } else {
+        len = _mav_trim_payload(reinterpret_cast<const char *>(body), len);
+        dst[0] = MAVLINK_STX;
+        dst[1] = len;
+        dst[2] = 0;
+        dst[3] = 0;
+        dst[4] = sequence;
+        dst[5] = m_systemId;
+        dst[6] = m_componentId;
+        dst[7] = uint8_t(msgid);
+        dst[8] = uint8_t(msgid >> 8);
+        dst[9] = uint8_t(msgid >> 16);
+    }
+
+    return finishFrame(dst, entry, headerLen, len, m_mavlink1, signing);
+}
+
+int MavlinkEncoder::finishFrame(uint8_t *dst,
+                                const mavlink_msg_entry_t *entry,
+                                int headerLen,
+                                uint8_t len,
+                                bool mavlink1,
+                                mavlink_signing_t *signing)
+{
+    // 签名标志在 CRC 覆盖范围内，必须先于 CRC 确定
+    if (!mavlink1) {
+        dst[2] = signing ? MAVLINK_IFLAG_SIGNED : 0;
+    }
+
+    uint16_t crc = crc_calculate(dst + 1, uint16_t(headerLen - 1 + len));
+    crc_accumulate(entry->crc_extra, &crc);
+    uint8_t *ck = dst + headerLen + len;
+    ck[0] = uint8_t(crc & 0xFF);
+    ck[1] = uint8_t(crc >> 8);
+
+    int size = headerLen + len + MAVLINK_NUM_CHECKSUM_BYTES;
+    if (signing) {
+        size += MavlinkSignature::sign(signing, dst, size);
+    }
+    return size;
+}
+
+int MavlinkEncoder::encode(uint8_t *buffer, uint32_t msgid, const void *payload, int length)
+{
+    const mavlink_msg_entry_t *entry = mavlink_get_msg_entry(msgid);
+    if (maxFrameSize(entry) == 0) {
+        return 0;
+    }
+    mavlink_signing_t *signing = outgoingSigning(m_mavlink1);
+    QMutexLocker locker(signing ? &m_signingLock : nullptr);
+    return encodeFrame(buffer, entry, payload, length, signing);
+}
+
+bool MavlinkEncoder::send(LinkInterface *link, uint32_t msgid, const void *payload, int length)
+{
+    const mavlink_msg_entry_t *entry = mavlink_get_msg_entry(msgid);
+    const int maxSize = maxFrameSize(entry);
+    // 队列按申请顺序发出，签名时申请空间和取时间戳放在同一把锁内
+    mavlink_signing_t *signing = outgoingSigning(m_mavlink1);
+    char *dst = nullptr;
+    int size = 0;
+    {
+        QMutexLocker locker(signing ? &m_signingLock : nullptr);
+        dst = maxSize > 0 ? link->claimBytes(maxSize) : nullptr;
+        if (dst) {
+            size = encodeFrame(reinterpret_cast<uint8_t *>(dst), entry, payload, length, signing);
+        }
+    }
+    if (dst == nullptr) {
+        m_failed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    link->commitBytes(dst, size);
+    m_sent.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool MavlinkEncoder::sendEncoded(LinkInterface *link, const uint8_t *frame, int size)
+{
+    const bool mavlink1 = size > 0 && frame[0] == MAVLINK_STX_MAVLINK1;
+    const int headerLen = mavlink1 ? MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 : MAVLINK_NUM_HEADER_BYTES;
+    if (size < headerLen + MAVLINK_NUM_CHECKSUM_BYTES) {
+        m_failed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    const uint8_t len = frame[1];
+    const int bodySize = headerLen + len;
+    // 长度字节声明的负载和 CRC 必须都在 frame 内
+    if (size < bodySize + MAVLINK_NUM_CHECKSUM_BYTES) {
+        m_failed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    const uint32_t msgid = mavlink1 ? frame[5] : frame[7] | (uint32_t(frame[8]) << 8) | (uint32_t(frame[9]) << 16);
+    const mavlink_msg_entry_t *entry = mavlink_get_msg_entry(msgid);
+    mavlink_signing_t *signing = outgoingSigning(mavlink1);
+    char *dst = nullptr;
+    int frameSize = 0;
+    {
+        QMutexLocker locker(signing ? &m_signingLock : nullptr);
+        dst = entry ? link->claimBytes(bodySize + MAVLINK_NUM_CHECKSUM_BYTES + MAVLINK_SIGNATURE_BLOCK_LEN)
+                    : nullptr;
+        if (dst) {
+            // 帧头和负载整段复制，预编码帧中的签名（如果有）被丢弃后重新生成
+            uint8_t *out = reinterpret_cast<uint8_t *>(dst);
+            memcpy(out, frame, bodySize);
+            out[mavlink1 ? 2 : 4] = m_sequence.fetch_add(1, std::memory_order_relaxed);
+            frameSize = finishFrame(out, entry, headerLen, len, mavlink1, signing);
+        }
+    }
+    if (dst == nullptr) {
+        m_failed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    link->commitBytes(dst, frameSize);
+    m_sent.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool MavlinkEncoder::resend(LinkInterface *link, const mavlink_message_t &message)
+{
+    // mavlink_msg_to_send_buffer 写出的长度不超过帧头 + 负载 + CRC + 签名块
+    char *dst = link->claimBytes(MAVLINK_NUM_NON_PAYLOAD_BYTES + MAVLINK_SIGNATURE_BLOCK_LEN
+                                 + message.len);
+    if (dst == nullptr) {
+        return false;
+    }
+    const int size = mavlink_msg_to_send_buffer(reinterpret_cast<uint8_t *>(dst), &message);
+    link->commitBytes(dst, size);
+    return true;
+}
@@ -0,0 +1,106 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinkencoder.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MAVLink 发送编码，直接写入连接的发送队列
+ *   使用说明 ：在发送队列中申请一帧的最大长度，帧头、负载、CRC 和签名都原地写入，
+ *             按 MAVLink 2 规则裁掉负载末尾的零后以实际长度提交，中间不经过
+ *             mavlink_message_t、临时缓冲区或 QByteArray；负载结构体只拷贝一次
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "mavlinkmessagetraits.h"
+
+#include <QMutex>
+
+#include <atomic>
+
+class LinkInterface;
+
+class MavlinkEncoder
+{
+public:
+    explicit MavlinkEncoder(uint8_t systemId = 255, uint8_t componentId = MAV_COMP_ID_MISSIONPLANNER);
+
+    MavlinkEncoder(const MavlinkEncoder &) = delete;
+    MavlinkEncoder &operator=(const MavlinkEncoder &) = delete;
+
+    uint8_t systemId() const { return m_systemId; }
+    void setSystemId(uint8_t id) { m_systemId = id; }
+    uint8_t componentId() const { return m_componentId; }
+    void setComponentId(uint8_t id) { m_componentId = id; }
+
+    /// 按 MAVLink 1 编码，只能发送 msgid 小于 256 的消息，负载取最小长度
+    bool mavlink1() const { return m_mavlink1; }
+    void setMavlink1(bool mavlink1) { m_mavlink1 = mavlink1; }
+
+    /// 设置 SIGN_OUTGOING 时为发出的帧签名，签名时间戳由 signing 维护，nullptr 关闭签名
+    void setSigning(mavlink_signing_t *signing);
+
+    /// 任意线程可调用：编码 payload 并写入 link 的发送队列，队列满时返回 false
+    template<typename T>
+    bool send(LinkInterface *link, const T &payload)
+    {
+        static_assert(!MAVLINK_NEED_BYTE_SWAP, "payload structs are sent as-is on little-endian hosts");
+        static_assert(sizeof(T) <= MAVLINK_MAX_PAYLOAD_LEN, "payload larger than a MAVLink frame");
+        return send(link, MavlinkMessageTraits<T>::id, &payload, int(sizeof(T)));
+    }
+    /// 按 msgid 发送，payload 为线上字节序的负载，length 不足时补零；方言中不存在该消息时返回 false
+    bool send(LinkInterface *link, uint32_t msgid, const void *payload, int length);
+
+    /// 编码到 buffer，buffer 至少 MAVLINK_MAX_PACKET_LEN 字节，返回帧长，失败返回 0
+    int encode(uint8_t *buffer, uint32_t msgid, const void *payload, int length);
+
+    /// 发送 encode 预先编码好的帧：原样复制负载，只重写序号、签名标志和 CRC，需要时签名。
+    /// 同一帧可以反复发送，预编码时应关闭签名
+    bool sendEncoded(LinkInterface *link, const uint8_t *frame, int size);
+
+    /// 转发已解析的消息，帧头、负载和签名保持不变，直接写入 link 的发送队列
+    static bool resend(LinkInterface *link, const mavlink_message_t &message);
+
+    /// 已写入发送队列的帧数
+    quint64 sent() const { return m_sent.load(std::memory_order_relaxed); }
+    /// 因队列满或消息未知而未发出的帧数
+    quint64 failed() const { return m_failed.load(std::memory_order_relaxed); }
+
+private:
+    /// 编码后帧长的上限，用于在队列中申请空间，失败返回 0
+    int maxFrameSize(const mavlink_msg_entry_t *entry) const;
+    /// 需要为发出的 MAVLink 2 帧签名时返回签名配置，否则返回 nullptr
+    mavlink_signing_t *outgoingSigning(bool mavlink1) const;
+    /// signing 不为空时调用方须持有 m_signingLock
+    int encodeFrame(uint8_t *dst,
+                    const mavlink_msg_entry_t *entry,
+                    const void *payload,
+                    int length,
+                    mavlink_signing_t *signing);
+    /// 帧头和负载已写好，写入签名标志、CRC 和签名，返回帧长。signing 不为空时调用方须持有 m_signingLock
+    int finishFrame(uint8_t *dst,
+                    const mavlink_msg_entry_t *entry,
+                    int headerLen,
+                    uint8_t len,
+                    bool mavlink1,
+                    mavlink_signing_t *signing);
+
+    uint8_t m_systemId;
+    uint8_t m_componentId;
+    bool m_mavlink1 = false;
+    std::atomic<mavlink_signing_t *> m_signing{nullptr};
+    // 签名时在同一把锁内申请队列空间和递增时间戳，队列中帧的先后与时间戳一致，
+    // 否则多个线程同时发送时接收方会把时间戳较小的后一帧当作重放丢弃
+    QMutex m_signingLock;
+
+    std::atomic<uint8_t> m_sequence{0};
+    std::atomic<quint64> m_sent{0};
+    std::atomic<quint64> m_failed{0};
+};
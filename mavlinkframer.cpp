@@ -0,0 +1,304 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinkframer.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "mavlinkframer.h"
+#include "mavlinksignature.h"
+#include "mavlinksigningstreams.h"
+
+#include <string.h>
+
+namespace {
+constexpr qsizetype kHeaderLen = MAVLINK_NUM_HEADER_BYTES;               // 含 STX
+constexpr qsizetype kHeaderLen1 = MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1; // 含 STX
+} // namespace
+
+MavlinkFramer::MavlinkFramer()
+{
+    memset(&m_status, 0, sizeof(m_status));
+    memset(&m_rxmsg, 0, sizeof(m_rxmsg));
+    memset(&m_message, 0, sizeof(m_message));
+    m_frames.reserve(64);
+}
+
+void MavlinkFramer::reset()
+{
+    m_status.parse_state = MAVLINK_PARSE_STATE_IDLE;
+}
+
+void MavlinkFramer::setSigning(mavlink_signing_t *signing, mavlink_signing_streams_t *streams)
+{
+    m_signing = signing;
+    m_signingStreams = streams;
+    m_streams = nullptr;
+}
+
+void MavlinkFramer::setSigning(mavlink_signing_t *signing, MavlinkSigningStreams *streams)
+{
+    m_signing = signing;
+    m_signingStreams = nullptr;
+    m_streams = streams;
+}
+
+uint8_t MavlinkFramer::signingResult(const mavlink_message_t &msg, const uint8_t *frame)
+{
+    if (m_signing == nullptr) {
+        return MAVLINK_FRAMING_OK;
+    }
+
+    // 与 mavlink_frame_char_buffer 相同，回调收到的状态中带有签名配置
+    m_status.signing = m_signing;
+    m_status.signing_streams = m_signingStreams;
+    const auto acceptUnsigned = m_signing->accept_unsigned_callback;
+    bool ok;
+    if (msg.incompat_flags & MAVLINK_IFLAG_SIGNED) {
+        const bool matches = frame ? signatureMatches(frame)
+                                   : MavlinkSignature::signatureMatches(m_signing->secret_key, &msg);
+        ok = m_streams ? m_streams->accept(m_signing, &msg, matches)
+                       : MavlinkSignature::checkStream(m_signing, m_signingStreams, &msg, matches);
+        if (!ok && acceptUnsigned && acceptUnsigned(&m_status, msg.msgid)) {
+            ok = true;
+        }
+    } else {
+        ok = acceptUnsigned && acceptUnsigned(&m_status, msg.msgid);
+    }
+    m_status.signing = nullptr;
+    m_status.signing_streams = nullptr;
+    return ok ? MAVLINK_FRAMING_OK : MAVLINK_FRAMING_BAD_SIGNATURE;
+}
+
+bool MavlinkFramer::signatureMatches(const uint8_t *frame)
+{
+    while (m_signedNext < m_signedCount && m_signedFrames[m_signedNext] < frame) {
+        ++m_signedNext;
+    }
+    if (m_signedNext < m_signedCount && m_signedFrames[m_signedNext] == frame) {
+        return m_signedMatches[m_signedNext];
+    }
+
+    // 假定后面的数据都是完整的帧，逐帧向后跳。跳错的位置只会多算或少算几个签名，
+    // 实际解析到的签名帧不在表中时从该帧重新开始一批
+    m_signedCount = 0;
+    m_signedNext = 0;
+    const uint8_t *p = frame;
+    while (m_signedCount < kSignatureBatch && m_end - p >= kHeaderLen) {
+        if (*p != MAVLINK_STX) {
+            p = static_cast<const uint8_t *>(memchr(p, MAVLINK_STX, m_end - p));
+            if (p == nullptr || m_end - p < kHeaderLen) {
+                break;
+            }
+        }
+        const bool signature = p[2] & MAVLINK_IFLAG_SIGNED;
+        const qsizetype frameLen = kHeaderLen + p[1] + MAVLINK_NUM_CHECKSUM_BYTES
+                                   + (signature ? MAVLINK_SIGNATURE_BLOCK_LEN : 0);
+        if ((p[2] & ~MAVLINK_IFLAG_MASK) != 0 || m_end - p < frameLen) {
+            ++p;
+            continue;
+        }
+        if (signature) {
+            m_signedFrames[m_signedCount++] = p;
+        }
+        p += frameLen;
+    }
+    MavlinkSignature::verify(m_signing->secret_key, m_signedFrames, m_signedCount, m_signedMatches);
+    return m_signedMatches[0];
+}
+
+const QVector<mavlink_message_t> &MavlinkFramer::parse(const char *data, qsizetype size)
+{
+    m_frames.clear();
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(data);
+    const uint8_t *end = p + size;
+    m_nextStx = nullptr;
+    m_nextStx1 = nullptr;
+    m_end = end;
+    m_signedCount = 0;
+    m_signedNext = 0;
+
+    while (p < end) {
+        if (m_status.parse_state > MAVLINK_PARSE_STATE_IDLE) {
+            // 上一块遗留的半帧，或坏帧末尾恰好是 STX
+            p = parseBytes(p, end);
+            continue;
+        }
+
+        p = findStx(p, end);
+        if (p == end) {
+            break;
+        }
+
+        const bool mavlink1 = *p == MAVLINK_STX_MAVLINK1;
+        const qsizetype headerLen = mavlink1 ? kHeaderLen1 : kHeaderLen;
+        if (end - p < headerLen) {
+            p = parseBytes(p, end);
+            continue;
+        }
+
+        if (!mavlink1 && (p[2] & ~MAVLINK_IFLAG_MASK) != 0) {
+            // 与状态机一致：STX、LEN、INCOMPAT 三个字节被消耗
+            ++m_parseErrors;
+            p += 3;
+            continue;
+        }
+
+        const bool signature = !mavlink1 && (p[2] & MAVLINK_IFLAG_SIGNED);
+        const qsizetype frameLen = headerLen + p[1] + MAVLINK_NUM_CHECKSUM_BYTES
+                                   + (signature ? MAVLINK_SIGNATURE_BLOCK_LEN : 0);
+        if (end - p < frameLen) {
+            p = parseBytes(p, end);
+            continue;
+        }
+
+        p = parseFrame(p, frameLen, mavlink1);
+    }
+
+    return m_frames;
+}
+
+const uint8_t *MavlinkFramer::findStx(const uint8_t *p, const uint8_t *end)
+{
+    if (m_nextStx == nullptr || m_nextStx < p) {
+        auto found = static_cast<const uint8_t *>(memchr(p, MAVLINK_STX, end - p));
+        m_nextStx = found ? found : end;
+    }
+    if (m_nextStx1 == nullptr || m_nextStx1 < p) {
+        auto found = static_cast<const uint8_t *>(memchr(p, MAVLINK_STX_MAVLINK1, end - p));
+        m_nextStx1 = found ? found : end;
+    }
+    return qMin(m_nextStx, m_nextStx1);
+}
+
+const uint8_t *MavlinkFramer::parseFrame(const uint8_t *p, qsizetype frameLen, bool mavlink1)
+{
+    mavlink_message_t &msg = m_message;
+    const uint8_t len = p[1];
+    const qsizetype headerLen = mavlink1 ? kHeaderLen1 : kHeaderLen;
+
+    msg.magic = p[0];
+    msg.len = len;
+    if (mavlink1) {
+        m_status.flags |= MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+        msg.incompat_flags = 0;
+        msg.compat_flags = 0;
+        msg.seq = p[2];
+        msg.sysid = p[3];
+        msg.compid = p[4];
+        msg.msgid = p[5];
+    } else {
+        m_status.flags &= ~MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+        msg.incompat_flags = p[2];
+        msg.compat_flags = p[3];
+        msg.seq = p[4];
+        msg.sysid = p[5];
+        msg.compid = p[6];
+        msg.msgid = p[7] | (uint32_t(p[8]) << 8) | (uint32_t(p[9]) << 16);
+    }
+
+    // 头部（不含 STX）和负载在内存中连续，整段计算 CRC
+    const mavlink_msg_entry_t *e = mavlink_get_msg_entry(msg.msgid);
+    uint16_t crc = crc_calculate(p + 1, uint16_t(headerLen - 1 + len));
+    crc_accumulate(e ? e->crc_extra : 0, &crc);
+    msg.checksum = crc;
+
+    char *payload = _MAV_PAYLOAD_NON_CONST(&msg);
+    memcpy(payload, p + headerLen, len);
+    // 与状态机相同，短帧补零到最大长度
+    if (e && len < e->max_msg_len) {
+        memset(payload + len, 0, e->max_msg_len - len);
+    }
+    const uint8_t *ck = p + headerLen + len;
+    msg.ck[0] = ck[0];
+    msg.ck[1] = ck[1];
+
+    const bool crc_ok = ck[0] == (crc & 0xFF) && ck[1] == (crc >> 8);
+    const uint8_t *next = p + frameLen;
+    uint8_t result;
+    if (!crc_ok) {
+        // mavlink_parse_char 在 CRC 错误时立即放弃，签名部分按普通字节继续解析
+        result = MAVLINK_FRAMING_BAD_CRC;
+        ++m_crcErrors;
+        next = ck + MAVLINK_NUM_CHECKSUM_BYTES;
+    } else {
+        if (msg.incompat_flags & MAVLINK_IFLAG_SIGNED) {
+            memcpy(msg.signature, ck + 2, MAVLINK_SIGNATURE_BLOCK_LEN);
+        }
+        result = signingResult(msg, p);
+    }
+
+    if (result == MAVLINK_FRAMING_OK) {
+        m_status.current_rx_seq = msg.seq;
+        if (m_status.packet_rx_success_count == 0) {
+            m_status.packet_rx_drop_count = 0;
+        }
+        m_status.packet_rx_success_count++;
+        m_frames.append(msg);
+    } else {
+        ++m_parseErrors;
+        // mavlink_parse_char 在坏帧的最后一个字节为 STX 时直接进入 GOT_STX
+        if (next[-1] == MAVLINK_STX) {
+            m_status.parse_state = MAVLINK_PARSE_STATE_GOT_STX;
+            m_rxmsg.magic = msg.magic;
+            m_rxmsg.len = 0;
+            mavlink_start_checksum(&m_rxmsg);
+        }
+    }
+    return next;
+}
+
+const uint8_t *MavlinkFramer::parseBytes(const uint8_t *p, const uint8_t *end)
+{
+    mavlink_status_t r_status;
+    while (p < end) {
+        const uint8_t c = *p++;
+        const uint16_t successCount = m_status.packet_rx_success_count;
+        const uint16_t dropCount = m_status.packet_rx_drop_count;
+        const uint8_t rxSeq = m_status.current_rx_seq;
+        uint8_t result = mavlink_frame_char_buffer(&m_rxmsg, &m_status, c, &m_message, &r_status);
+        m_parseErrors += r_status.packet_rx_drop_count;
+
+        if (result == MAVLINK_FRAMING_OK && m_signing) {
+            // 状态机看不到签名配置，CRC 正确的帧在这里补做签名判定
+            result = signingResult(m_message, nullptr);
+            if (result != MAVLINK_FRAMING_OK) {
+                m_status.packet_rx_success_count = successCount;
+                m_status.packet_rx_drop_count = dropCount;
+                m_status.current_rx_seq = rxSeq;
+            }
+        }
+
+        if (result == MAVLINK_FRAMING_OK) {
+            m_frames.append(m_message);
+        } else if (result == MAVLINK_FRAMING_BAD_CRC || result == MAVLINK_FRAMING_BAD_SIGNATURE) {
+            // 以下与 mavlink_parse_char 的坏帧处理相同
+            ++m_parseErrors;
+            if (result == MAVLINK_FRAMING_BAD_CRC) {
+                ++m_crcErrors;
+            }
+            m_status.msg_received = MAVLINK_FRAMING_INCOMPLETE;
+            m_status.parse_state = MAVLINK_PARSE_STATE_IDLE;
+            if (c == MAVLINK_STX) {
+                m_status.parse_state = MAVLINK_PARSE_STATE_GOT_STX;
+                m_rxmsg.len = 0;
+                mavlink_start_checksum(&m_rxmsg);
+            }
+        }
+
+        if (m_status.parse_state <= MAVLINK_PARSE_STATE_IDLE) {
+            break;
+        }
+    }
+    return p;
+}
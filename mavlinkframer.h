@@ -0,0 +1,97 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinkframer.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：按数据块解析 MAVLink 帧
+ *   使用说明 ：parse 直接处理 receiveData 收到的整块数据：查找帧头、校验长度、
+ *             对连续内存整段计算 CRC，一次返回本块中的全部完整帧。
+ *             跨块的半帧交给 mavlink_frame_char_buffer 逐字节处理，
+ *             结果与逐字节调用 mavlink_parse_char 一致。开启签名校验时，
+ *             遇到签名帧先向后找出本块中的整帧签名帧，用 MavlinkSignature::verify
+ *             批量计算签名，时间戳检查仍按帧的先后进行
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "mavlinkprotocol.h"
+
+class MavlinkSigningStreams;
+
+#include <QByteArray>
+#include <QVector>
+
+class MavlinkFramer
+{
+public:
+    MavlinkFramer();
+
+    /// 解析一块数据，返回其中的完整帧，结果在下一次 parse 之前有效
+    const QVector<mavlink_message_t> &parse(const char *data, qsizetype size);
+    const QVector<mavlink_message_t> &parse(const QByteArray &data)
+    {
+        return parse(data.constData(), data.size());
+    }
+
+    /// 丢弃未完成的半帧，统计数据保留
+    void reset();
+
+    /// 配置签名校验，与 mavlink_status_t 中的 signing/signing_streams 含义相同
+    void setSigning(mavlink_signing_t *signing, mavlink_signing_streams_t *streams);
+    /// 同上，流状态使用 MavlinkSigningStreams，不限制流的数量
+    void setSigning(mavlink_signing_t *signing, MavlinkSigningStreams *streams);
+
+    /// 解析状态，字段含义与 mavlink_parse_char 使用的通道状态一致
+    const mavlink_status_t &status() const { return m_status; }
+    /// 解析错误总数，等于逐字节调用 mavlink_parse_char 时 packet_rx_drop_count 的累计值
+    quint64 parseErrors() const { return m_parseErrors; }
+    /// 其中 CRC 校验失败的帧数
+    quint64 crcErrors() const { return m_crcErrors; }
+    /// 成功解析的帧数
+    quint64 framesOk() const { return m_status.packet_rx_success_count; }
+
+private:
+    /// 逐字节解析，直到状态机回到空闲或数据耗尽，返回下一个未处理的字节
+    const uint8_t *parseBytes(const uint8_t *p, const uint8_t *end);
+    /// 查找下一个帧起始字节
+    const uint8_t *findStx(const uint8_t *p, const uint8_t *end);
+    /// 整帧在当前数据块内时直接解析，返回帧后的第一个字节
+    const uint8_t *parseFrame(const uint8_t *p, qsizetype frameLen, bool mavlink1);
+    /// CRC 正确的帧按签名配置判定，返回 MAVLINK_FRAMING_OK 或 MAVLINK_FRAMING_BAD_SIGNATURE。
+    /// frame 为帧在当前数据块中的起始位置，逐字节解析的帧为 nullptr
+    uint8_t signingResult(const mavlink_message_t &msg, const uint8_t *frame);
+    /// 当前数据块中 frame 处签名帧的签名比较结果，没有算过时从 frame 起批量计算
+    bool signatureMatches(const uint8_t *frame);
+
+    mavlink_status_t m_status;
+    mavlink_message_t m_rxmsg;   // 逐字节解析的半帧
+    mavlink_message_t m_message; // 整帧解析的临时结果
+    QVector<mavlink_message_t> m_frames;
+    quint64 m_parseErrors = 0;
+    quint64 m_crcErrors = 0;
+
+    // 签名配置不放进 m_status，库中的状态机不做签名判定，统一由 signingResult 处理
+    mavlink_signing_t *m_signing = nullptr;
+    mavlink_signing_streams_t *m_signingStreams = nullptr;
+    MavlinkSigningStreams *m_streams = nullptr;
+
+    // 两种帧头各自缓存的下一个位置，避免反复 memchr 造成平方复杂度
+    const uint8_t *m_nextStx = nullptr;
+    const uint8_t *m_nextStx1 = nullptr;
+    const uint8_t *m_end = nullptr; // 当前数据块的结尾
+
+    // 当前数据块中已批量计算过签名的帧，按位置升序
+    static constexpr int kSignatureBatch = 64;
+    const uint8_t *m_signedFrames[kSignatureBatch];
+    bool m_signedMatches[kSignatureBatch];
+    int m_signedCount = 0;
+    int m_signedNext = 0;
+};
@@ -0,0 +1,81 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinkftp.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MAVLink FTP 协议的负载格式和操作码
+ *   使用说明 ：FILE_TRANSFER_PROTOCOL 的 payload 字段按 FtpPayload 解释，定义见 https://mavlink.io/en/services/ftp.html
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "mavlinkprotocol.h"
+
+namespace MavlinkFtp {
+
+enum Opcode : uint8_t {
+    None = 0,
+    TerminateSession = 1,
+    ResetSessions = 2,
+    ListDirectory = 3,
+    OpenFileRO = 4,
+    ReadFile = 5,
+    CreateFile = 6,
+    WriteFile = 7,
+    RemoveFile = 8,
+    CreateDirectory = 9,
+    RemoveDirectory = 10,
+    OpenFileWO = 11,
+    TruncateFile = 12,
+    Rename = 13,
+    CalcFileCRC32 = 14,
+    BurstReadFile = 15,
+    Ack = 128,
+    Nak = 129
+};
+
+/// NAK 时 data[0] 的错误码，FailErrno 时 data[1] 为 errno
+enum Error : uint8_t {
+    ErrorNone = 0,
+    Fail = 1,
+    FailErrno = 2,
+    InvalidDataSize = 3,
+    InvalidSession = 4,
+    NoSessionsAvailable = 5,
+    EndOfFile = 6,
+    UnknownCommand = 7,
+    FileExists = 8,
+    FileProtected = 9,
+    FileNotFound = 10
+};
+
+inline constexpr int kDataSize = 239;
+
+#pragma pack(push, 1)
+struct Payload
+{
+    uint16_t seqNumber;    // 回应的序号为请求加一
+    uint8_t session;
+    uint8_t opcode;
+    uint8_t size;          // data 的有效长度
+    uint8_t reqOpcode;     // 回应对应的请求操作码
+    uint8_t burstComplete; // 连续读取的最后一包
+    uint8_t padding;
+    uint32_t offset;
+    uint8_t data[kDataSize];
+};
+#pragma pack(pop)
+
+inline constexpr int kHeaderSize = int(sizeof(Payload)) - kDataSize;
+
+static_assert(sizeof(Payload) == MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN, "FTP payload layout");
+
+} // namespace MavlinkFtp
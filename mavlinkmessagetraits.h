@@ -0,0 +1,1222 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinkmessagetraits.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MAVLink 消息结构体与 msgid 的对应关系
+ *   使用说明 ：MavlinkMessageTraits<mavlink_xxx_t>::id 为消息 ID，name 为消息名。
+ *             由 libs/mavlink 下各方言的 mavlink_msg_*.h 整理生成，
+ *             每项用 #ifdef 保护，当前方言中不存在的消息不会被定义
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "mavlinkprotocol.h"
+
+/// 未特化的类型不是 MAVLink 消息，使用时编译报错
+template<typename T>
+struct MavlinkMessageTraits;
+
+#define MAVLINK_MESSAGE_TRAITS(type, msgid, msgname) \
+    template<> \
+    struct MavlinkMessageTraits<type> \
+    { \
+        static constexpr uint32_t id = msgid; \
+        static constexpr const char *name = msgname; \
+    };
+
+#ifdef MAVLINK_MSG_ID_ACTUATOR_CONTROL_TARGET
+MAVLINK_MESSAGE_TRAITS(mavlink_actuator_control_target_t, MAVLINK_MSG_ID_ACTUATOR_CONTROL_TARGET, "ACTUATOR_CONTROL_TARGET")
+#endif
+#ifdef MAVLINK_MSG_ID_ACTUATOR_OUTPUT_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_actuator_output_status_t, MAVLINK_MSG_ID_ACTUATOR_OUTPUT_STATUS, "ACTUATOR_OUTPUT_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_ADAP_TUNING
+MAVLINK_MESSAGE_TRAITS(mavlink_adap_tuning_t, MAVLINK_MSG_ID_ADAP_TUNING, "ADAP_TUNING")
+#endif
+#ifdef MAVLINK_MSG_ID_ADSB_VEHICLE
+MAVLINK_MESSAGE_TRAITS(mavlink_adsb_vehicle_t, MAVLINK_MSG_ID_ADSB_VEHICLE, "ADSB_VEHICLE")
+#endif
+#ifdef MAVLINK_MSG_ID_AHRS2
+MAVLINK_MESSAGE_TRAITS(mavlink_ahrs2_t, MAVLINK_MSG_ID_AHRS2, "AHRS2")
+#endif
+#ifdef MAVLINK_MSG_ID_AHRS3
+MAVLINK_MESSAGE_TRAITS(mavlink_ahrs3_t, MAVLINK_MSG_ID_AHRS3, "AHRS3")
+#endif
+#ifdef MAVLINK_MSG_ID_AHRS
+MAVLINK_MESSAGE_TRAITS(mavlink_ahrs_t, MAVLINK_MSG_ID_AHRS, "AHRS")
+#endif
+#ifdef MAVLINK_MSG_ID_AIRLINK_AUTH_RESPONSE
+MAVLINK_MESSAGE_TRAITS(mavlink_airlink_auth_response_t, MAVLINK_MSG_ID_AIRLINK_AUTH_RESPONSE, "AIRLINK_AUTH_RESPONSE")
+#endif
+#ifdef MAVLINK_MSG_ID_AIRLINK_AUTH
+MAVLINK_MESSAGE_TRAITS(mavlink_airlink_auth_t, MAVLINK_MSG_ID_AIRLINK_AUTH, "AIRLINK_AUTH")
+#endif
+#ifdef MAVLINK_MSG_ID_AIRLINK_EYE_GS_HOLE_PUSH_REQUEST
+MAVLINK_MESSAGE_TRAITS(mavlink_airlink_eye_gs_hole_push_request_t, MAVLINK_MSG_ID_AIRLINK_EYE_GS_HOLE_PUSH_REQUEST, "AIRLINK_EYE_GS_HOLE_PUSH_REQUEST")
+#endif
+#ifdef MAVLINK_MSG_ID_AIRLINK_EYE_GS_HOLE_PUSH_RESPONSE
+MAVLINK_MESSAGE_TRAITS(mavlink_airlink_eye_gs_hole_push_response_t, MAVLINK_MSG_ID_AIRLINK_EYE_GS_HOLE_PUSH_RESPONSE, "AIRLINK_EYE_GS_HOLE_PUSH_RESPONSE")
+#endif
+#ifdef MAVLINK_MSG_ID_AIRLINK_EYE_HP
+MAVLINK_MESSAGE_TRAITS(mavlink_airlink_eye_hp_t, MAVLINK_MSG_ID_AIRLINK_EYE_HP, "AIRLINK_EYE_HP")
+#endif
+#ifdef MAVLINK_MSG_ID_AIRLINK_EYE_TURN_INIT
+MAVLINK_MESSAGE_TRAITS(mavlink_airlink_eye_turn_init_t, MAVLINK_MSG_ID_AIRLINK_EYE_TURN_INIT, "AIRLINK_EYE_TURN_INIT")
+#endif
+#ifdef MAVLINK_MSG_ID_AIRSPEED_AUTOCAL
+MAVLINK_MESSAGE_TRAITS(mavlink_airspeed_autocal_t, MAVLINK_MSG_ID_AIRSPEED_AUTOCAL, "AIRSPEED_AUTOCAL")
+#endif
+#ifdef MAVLINK_MSG_ID_AIRSPEED
+MAVLINK_MESSAGE_TRAITS(mavlink_airspeed_t, MAVLINK_MSG_ID_AIRSPEED, "AIRSPEED")
+#endif
+#ifdef MAVLINK_MSG_ID_AIRSPEEDS
+MAVLINK_MESSAGE_TRAITS(mavlink_airspeeds_t, MAVLINK_MSG_ID_AIRSPEEDS, "AIRSPEEDS")
+#endif
+#ifdef MAVLINK_MSG_ID_AIS_VESSEL
+MAVLINK_MESSAGE_TRAITS(mavlink_ais_vessel_t, MAVLINK_MSG_ID_AIS_VESSEL, "AIS_VESSEL")
+#endif
+#ifdef MAVLINK_MSG_ID_ALTITUDE
+MAVLINK_MESSAGE_TRAITS(mavlink_altitude_t, MAVLINK_MSG_ID_ALTITUDE, "ALTITUDE")
+#endif
+#ifdef MAVLINK_MSG_ID_ALTITUDES
+MAVLINK_MESSAGE_TRAITS(mavlink_altitudes_t, MAVLINK_MSG_ID_ALTITUDES, "ALTITUDES")
+#endif
+#ifdef MAVLINK_MSG_ID_AOA_SSA
+MAVLINK_MESSAGE_TRAITS(mavlink_aoa_ssa_t, MAVLINK_MSG_ID_AOA_SSA, "AOA_SSA")
+#endif
+#ifdef MAVLINK_MSG_ID_AP_ADC
+MAVLINK_MESSAGE_TRAITS(mavlink_ap_adc_t, MAVLINK_MSG_ID_AP_ADC, "AP_ADC")
+#endif
+#ifdef MAVLINK_MSG_ID_ARRAY_TEST_0
+MAVLINK_MESSAGE_TRAITS(mavlink_array_test_0_t, MAVLINK_MSG_ID_ARRAY_TEST_0, "ARRAY_TEST_0")
+#endif
+#ifdef MAVLINK_MSG_ID_ARRAY_TEST_1
+MAVLINK_MESSAGE_TRAITS(mavlink_array_test_1_t, MAVLINK_MSG_ID_ARRAY_TEST_1, "ARRAY_TEST_1")
+#endif
+#ifdef MAVLINK_MSG_ID_ARRAY_TEST_3
+MAVLINK_MESSAGE_TRAITS(mavlink_array_test_3_t, MAVLINK_MSG_ID_ARRAY_TEST_3, "ARRAY_TEST_3")
+#endif
+#ifdef MAVLINK_MSG_ID_ARRAY_TEST_4
+MAVLINK_MESSAGE_TRAITS(mavlink_array_test_4_t, MAVLINK_MSG_ID_ARRAY_TEST_4, "ARRAY_TEST_4")
+#endif
+#ifdef MAVLINK_MSG_ID_ARRAY_TEST_5
+MAVLINK_MESSAGE_TRAITS(mavlink_array_test_5_t, MAVLINK_MSG_ID_ARRAY_TEST_5, "ARRAY_TEST_5")
+#endif
+#ifdef MAVLINK_MSG_ID_ARRAY_TEST_6
+MAVLINK_MESSAGE_TRAITS(mavlink_array_test_6_t, MAVLINK_MSG_ID_ARRAY_TEST_6, "ARRAY_TEST_6")
+#endif
+#ifdef MAVLINK_MSG_ID_ARRAY_TEST_7
+MAVLINK_MESSAGE_TRAITS(mavlink_array_test_7_t, MAVLINK_MSG_ID_ARRAY_TEST_7, "ARRAY_TEST_7")
+#endif
+#ifdef MAVLINK_MSG_ID_ARRAY_TEST_8
+MAVLINK_MESSAGE_TRAITS(mavlink_array_test_8_t, MAVLINK_MSG_ID_ARRAY_TEST_8, "ARRAY_TEST_8")
+#endif
+#ifdef MAVLINK_MSG_ID_ASL_OBCTRL
+MAVLINK_MESSAGE_TRAITS(mavlink_asl_obctrl_t, MAVLINK_MSG_ID_ASL_OBCTRL, "ASL_OBCTRL")
+#endif
+#ifdef MAVLINK_MSG_ID_ASLCTRL_DATA
+MAVLINK_MESSAGE_TRAITS(mavlink_aslctrl_data_t, MAVLINK_MSG_ID_ASLCTRL_DATA, "ASLCTRL_DATA")
+#endif
+#ifdef MAVLINK_MSG_ID_ASLCTRL_DEBUG
+MAVLINK_MESSAGE_TRAITS(mavlink_aslctrl_debug_t, MAVLINK_MSG_ID_ASLCTRL_DEBUG, "ASLCTRL_DEBUG")
+#endif
+#ifdef MAVLINK_MSG_ID_ASLUAV_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_asluav_status_t, MAVLINK_MSG_ID_ASLUAV_STATUS, "ASLUAV_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_ATT_POS_MOCAP
+MAVLINK_MESSAGE_TRAITS(mavlink_att_pos_mocap_t, MAVLINK_MSG_ID_ATT_POS_MOCAP, "ATT_POS_MOCAP")
+#endif
+#ifdef MAVLINK_MSG_ID_ATTITUDE_QUATERNION_COV
+MAVLINK_MESSAGE_TRAITS(mavlink_attitude_quaternion_cov_t, MAVLINK_MSG_ID_ATTITUDE_QUATERNION_COV, "ATTITUDE_QUATERNION_COV")
+#endif
+#ifdef MAVLINK_MSG_ID_ATTITUDE_QUATERNION
+MAVLINK_MESSAGE_TRAITS(mavlink_attitude_quaternion_t, MAVLINK_MSG_ID_ATTITUDE_QUATERNION, "ATTITUDE_QUATERNION")
+#endif
+#ifdef MAVLINK_MSG_ID_ATTITUDE
+MAVLINK_MESSAGE_TRAITS(mavlink_attitude_t, MAVLINK_MSG_ID_ATTITUDE, "ATTITUDE")
+#endif
+#ifdef MAVLINK_MSG_ID_ATTITUDE_TARGET
+MAVLINK_MESSAGE_TRAITS(mavlink_attitude_target_t, MAVLINK_MSG_ID_ATTITUDE_TARGET, "ATTITUDE_TARGET")
+#endif
+#ifdef MAVLINK_MSG_ID_AUTH_KEY
+MAVLINK_MESSAGE_TRAITS(mavlink_auth_key_t, MAVLINK_MSG_ID_AUTH_KEY, "AUTH_KEY")
+#endif
+#ifdef MAVLINK_MSG_ID_AUTOPILOT_STATE_FOR_GIMBAL_DEVICE
+MAVLINK_MESSAGE_TRAITS(mavlink_autopilot_state_for_gimbal_device_t, MAVLINK_MSG_ID_AUTOPILOT_STATE_FOR_GIMBAL_DEVICE, "AUTOPILOT_STATE_FOR_GIMBAL_DEVICE")
+#endif
+#ifdef MAVLINK_MSG_ID_AUTOPILOT_VERSION_REQUEST
+MAVLINK_MESSAGE_TRAITS(mavlink_autopilot_version_request_t, MAVLINK_MSG_ID_AUTOPILOT_VERSION_REQUEST, "AUTOPILOT_VERSION_REQUEST")
+#endif
+#ifdef MAVLINK_MSG_ID_AUTOPILOT_VERSION
+MAVLINK_MESSAGE_TRAITS(mavlink_autopilot_version_t, MAVLINK_MSG_ID_AUTOPILOT_VERSION, "AUTOPILOT_VERSION")
+#endif
+#ifdef MAVLINK_MSG_ID_AVAILABLE_MODES_MONITOR
+MAVLINK_MESSAGE_TRAITS(mavlink_available_modes_monitor_t, MAVLINK_MSG_ID_AVAILABLE_MODES_MONITOR, "AVAILABLE_MODES_MONITOR")
+#endif
+#ifdef MAVLINK_MSG_ID_AVAILABLE_MODES
+MAVLINK_MESSAGE_TRAITS(mavlink_available_modes_t, MAVLINK_MSG_ID_AVAILABLE_MODES, "AVAILABLE_MODES")
+#endif
+#ifdef MAVLINK_MSG_ID_AVSS_DRONE_IMU
+MAVLINK_MESSAGE_TRAITS(mavlink_avss_drone_imu_t, MAVLINK_MSG_ID_AVSS_DRONE_IMU, "AVSS_DRONE_IMU")
+#endif
+#ifdef MAVLINK_MSG_ID_AVSS_DRONE_OPERATION_MODE
+MAVLINK_MESSAGE_TRAITS(mavlink_avss_drone_operation_mode_t, MAVLINK_MSG_ID_AVSS_DRONE_OPERATION_MODE, "AVSS_DRONE_OPERATION_MODE")
+#endif
+#ifdef MAVLINK_MSG_ID_AVSS_DRONE_POSITION
+MAVLINK_MESSAGE_TRAITS(mavlink_avss_drone_position_t, MAVLINK_MSG_ID_AVSS_DRONE_POSITION, "AVSS_DRONE_POSITION")
+#endif
+#ifdef MAVLINK_MSG_ID_AVSS_PRS_SYS_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_avss_prs_sys_status_t, MAVLINK_MSG_ID_AVSS_PRS_SYS_STATUS, "AVSS_PRS_SYS_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_BATTERY2
+MAVLINK_MESSAGE_TRAITS(mavlink_battery2_t, MAVLINK_MSG_ID_BATTERY2, "BATTERY2")
+#endif
+#ifdef MAVLINK_MSG_ID_BATTERY_INFO
+MAVLINK_MESSAGE_TRAITS(mavlink_battery_info_t, MAVLINK_MSG_ID_BATTERY_INFO, "BATTERY_INFO")
+#endif
+#ifdef MAVLINK_MSG_ID_BATTERY_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_battery_status_t, MAVLINK_MSG_ID_BATTERY_STATUS, "BATTERY_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_BATTERY_STATUS_V2
+MAVLINK_MESSAGE_TRAITS(mavlink_battery_status_v2_t, MAVLINK_MSG_ID_BATTERY_STATUS_V2, "BATTERY_STATUS_V2")
+#endif
+#ifdef MAVLINK_MSG_ID_BUTTON_CHANGE
+MAVLINK_MESSAGE_TRAITS(mavlink_button_change_t, MAVLINK_MSG_ID_BUTTON_CHANGE, "BUTTON_CHANGE")
+#endif
+#ifdef MAVLINK_MSG_ID_CAMERA_CAPTURE_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_camera_capture_status_t, MAVLINK_MSG_ID_CAMERA_CAPTURE_STATUS, "CAMERA_CAPTURE_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_CAMERA_FEEDBACK
+MAVLINK_MESSAGE_TRAITS(mavlink_camera_feedback_t, MAVLINK_MSG_ID_CAMERA_FEEDBACK, "CAMERA_FEEDBACK")
+#endif
+#ifdef MAVLINK_MSG_ID_CAMERA_FOV_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_camera_fov_status_t, MAVLINK_MSG_ID_CAMERA_FOV_STATUS, "CAMERA_FOV_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_CAMERA_IMAGE_CAPTURED
+MAVLINK_MESSAGE_TRAITS(mavlink_camera_image_captured_t, MAVLINK_MSG_ID_CAMERA_IMAGE_CAPTURED, "CAMERA_IMAGE_CAPTURED")
+#endif
+#ifdef MAVLINK_MSG_ID_CAMERA_INFORMATION
+MAVLINK_MESSAGE_TRAITS(mavlink_camera_information_t, MAVLINK_MSG_ID_CAMERA_INFORMATION, "CAMERA_INFORMATION")
+#endif
+#ifdef MAVLINK_MSG_ID_CAMERA_SETTINGS
+MAVLINK_MESSAGE_TRAITS(mavlink_camera_settings_t, MAVLINK_MSG_ID_CAMERA_SETTINGS, "CAMERA_SETTINGS")
+#endif
+#ifdef MAVLINK_MSG_ID_CAMERA_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_camera_status_t, MAVLINK_MSG_ID_CAMERA_STATUS, "CAMERA_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_CAMERA_THERMAL_RANGE
+MAVLINK_MESSAGE_TRAITS(mavlink_camera_thermal_range_t, MAVLINK_MSG_ID_CAMERA_THERMAL_RANGE, "CAMERA_THERMAL_RANGE")
+#endif
+#ifdef MAVLINK_MSG_ID_CAMERA_TRACKING_GEO_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_camera_tracking_geo_status_t, MAVLINK_MSG_ID_CAMERA_TRACKING_GEO_STATUS, "CAMERA_TRACKING_GEO_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_CAMERA_TRACKING_IMAGE_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_camera_tracking_image_status_t, MAVLINK_MSG_ID_CAMERA_TRACKING_IMAGE_STATUS, "CAMERA_TRACKING_IMAGE_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_CAMERA_TRIGGER
+MAVLINK_MESSAGE_TRAITS(mavlink_camera_trigger_t, MAVLINK_MSG_ID_CAMERA_TRIGGER, "CAMERA_TRIGGER")
+#endif
+#ifdef MAVLINK_MSG_ID_CAN_FILTER_MODIFY
+MAVLINK_MESSAGE_TRAITS(mavlink_can_filter_modify_t, MAVLINK_MSG_ID_CAN_FILTER_MODIFY, "CAN_FILTER_MODIFY")
+#endif
+#ifdef MAVLINK_MSG_ID_CAN_FRAME
+MAVLINK_MESSAGE_TRAITS(mavlink_can_frame_t, MAVLINK_MSG_ID_CAN_FRAME, "CAN_FRAME")
+#endif
+#ifdef MAVLINK_MSG_ID_CANFD_FRAME
+MAVLINK_MESSAGE_TRAITS(mavlink_canfd_frame_t, MAVLINK_MSG_ID_CANFD_FRAME, "CANFD_FRAME")
+#endif
+#ifdef MAVLINK_MSG_ID_CELLULAR_CONFIG
+MAVLINK_MESSAGE_TRAITS(mavlink_cellular_config_t, MAVLINK_MSG_ID_CELLULAR_CONFIG, "CELLULAR_CONFIG")
+#endif
+#ifdef MAVLINK_MSG_ID_CELLULAR_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_cellular_status_t, MAVLINK_MSG_ID_CELLULAR_STATUS, "CELLULAR_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL_ACK
+MAVLINK_MESSAGE_TRAITS(mavlink_change_operator_control_ack_t, MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL_ACK, "CHANGE_OPERATOR_CONTROL_ACK")
+#endif
+#ifdef MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL
+MAVLINK_MESSAGE_TRAITS(mavlink_change_operator_control_t, MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL, "CHANGE_OPERATOR_CONTROL")
+#endif
+#ifdef MAVLINK_MSG_ID_COLLISION
+MAVLINK_MESSAGE_TRAITS(mavlink_collision_t, MAVLINK_MSG_ID_COLLISION, "COLLISION")
+#endif
+#ifdef MAVLINK_MSG_ID_COMMAND_ACK
+MAVLINK_MESSAGE_TRAITS(mavlink_command_ack_t, MAVLINK_MSG_ID_COMMAND_ACK, "COMMAND_ACK")
+#endif
+#ifdef MAVLINK_MSG_ID_COMMAND_CANCEL
+MAVLINK_MESSAGE_TRAITS(mavlink_command_cancel_t, MAVLINK_MSG_ID_COMMAND_CANCEL, "COMMAND_CANCEL")
+#endif
+#ifdef MAVLINK_MSG_ID_COMMAND_INT_STAMPED
+MAVLINK_MESSAGE_TRAITS(mavlink_command_int_stamped_t, MAVLINK_MSG_ID_COMMAND_INT_STAMPED, "COMMAND_INT_STAMPED")
+#endif
+#ifdef MAVLINK_MSG_ID_COMMAND_INT
+MAVLINK_MESSAGE_TRAITS(mavlink_command_int_t, MAVLINK_MSG_ID_COMMAND_INT, "COMMAND_INT")
+#endif
+#ifdef MAVLINK_MSG_ID_COMMAND_LONG_STAMPED
+MAVLINK_MESSAGE_TRAITS(mavlink_command_long_stamped_t, MAVLINK_MSG_ID_COMMAND_LONG_STAMPED, "COMMAND_LONG_STAMPED")
+#endif
+#ifdef MAVLINK_MSG_ID_COMMAND_LONG
+MAVLINK_MESSAGE_TRAITS(mavlink_command_long_t, MAVLINK_MSG_ID_COMMAND_LONG, "COMMAND_LONG")
+#endif
+#ifdef MAVLINK_MSG_ID_COMPASSMOT_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_compassmot_status_t, MAVLINK_MSG_ID_COMPASSMOT_STATUS, "COMPASSMOT_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_COMPONENT_INFORMATION_BASIC
+MAVLINK_MESSAGE_TRAITS(mavlink_component_information_basic_t, MAVLINK_MSG_ID_COMPONENT_INFORMATION_BASIC, "COMPONENT_INFORMATION_BASIC")
+#endif
+#ifdef MAVLINK_MSG_ID_COMPONENT_INFORMATION
+MAVLINK_MESSAGE_TRAITS(mavlink_component_information_t, MAVLINK_MSG_ID_COMPONENT_INFORMATION, "COMPONENT_INFORMATION")
+#endif
+#ifdef MAVLINK_MSG_ID_COMPONENT_METADATA
+MAVLINK_MESSAGE_TRAITS(mavlink_component_metadata_t, MAVLINK_MSG_ID_COMPONENT_METADATA, "COMPONENT_METADATA")
+#endif
+#ifdef MAVLINK_MSG_ID_CONTROL_SYSTEM_STATE
+MAVLINK_MESSAGE_TRAITS(mavlink_control_system_state_t, MAVLINK_MSG_ID_CONTROL_SYSTEM_STATE, "CONTROL_SYSTEM_STATE")
+#endif
+#ifdef MAVLINK_MSG_ID_CUBEPILOT_FIRMWARE_UPDATE_RESP
+MAVLINK_MESSAGE_TRAITS(mavlink_cubepilot_firmware_update_resp_t, MAVLINK_MSG_ID_CUBEPILOT_FIRMWARE_UPDATE_RESP, "CUBEPILOT_FIRMWARE_UPDATE_RESP")
+#endif
+#ifdef MAVLINK_MSG_ID_CUBEPILOT_FIRMWARE_UPDATE_START
+MAVLINK_MESSAGE_TRAITS(mavlink_cubepilot_firmware_update_start_t, MAVLINK_MSG_ID_CUBEPILOT_FIRMWARE_UPDATE_START, "CUBEPILOT_FIRMWARE_UPDATE_START")
+#endif
+#ifdef MAVLINK_MSG_ID_CUBEPILOT_RAW_RC
+MAVLINK_MESSAGE_TRAITS(mavlink_cubepilot_raw_rc_t, MAVLINK_MSG_ID_CUBEPILOT_RAW_RC, "CUBEPILOT_RAW_RC")
+#endif
+#ifdef MAVLINK_MSG_ID_CURRENT_EVENT_SEQUENCE
+MAVLINK_MESSAGE_TRAITS(mavlink_current_event_sequence_t, MAVLINK_MSG_ID_CURRENT_EVENT_SEQUENCE, "CURRENT_EVENT_SEQUENCE")
+#endif
+#ifdef MAVLINK_MSG_ID_CURRENT_MODE
+MAVLINK_MESSAGE_TRAITS(mavlink_current_mode_t, MAVLINK_MSG_ID_CURRENT_MODE, "CURRENT_MODE")
+#endif
+#ifdef MAVLINK_MSG_ID_DATA16
+MAVLINK_MESSAGE_TRAITS(mavlink_data16_t, MAVLINK_MSG_ID_DATA16, "DATA16")
+#endif
+#ifdef MAVLINK_MSG_ID_DATA32
+MAVLINK_MESSAGE_TRAITS(mavlink_data32_t, MAVLINK_MSG_ID_DATA32, "DATA32")
+#endif
+#ifdef MAVLINK_MSG_ID_DATA64
+MAVLINK_MESSAGE_TRAITS(mavlink_data64_t, MAVLINK_MSG_ID_DATA64, "DATA64")
+#endif
+#ifdef MAVLINK_MSG_ID_DATA96
+MAVLINK_MESSAGE_TRAITS(mavlink_data96_t, MAVLINK_MSG_ID_DATA96, "DATA96")
+#endif
+#ifdef MAVLINK_MSG_ID_DATA_STREAM
+MAVLINK_MESSAGE_TRAITS(mavlink_data_stream_t, MAVLINK_MSG_ID_DATA_STREAM, "DATA_STREAM")
+#endif
+#ifdef MAVLINK_MSG_ID_DATA_TRANSMISSION_HANDSHAKE
+MAVLINK_MESSAGE_TRAITS(mavlink_data_transmission_handshake_t, MAVLINK_MSG_ID_DATA_TRANSMISSION_HANDSHAKE, "DATA_TRANSMISSION_HANDSHAKE")
+#endif
+#ifdef MAVLINK_MSG_ID_DEBUG_FLOAT_ARRAY
+MAVLINK_MESSAGE_TRAITS(mavlink_debug_float_array_t, MAVLINK_MSG_ID_DEBUG_FLOAT_ARRAY, "DEBUG_FLOAT_ARRAY")
+#endif
+#ifdef MAVLINK_MSG_ID_DEBUG
+MAVLINK_MESSAGE_TRAITS(mavlink_debug_t, MAVLINK_MSG_ID_DEBUG, "DEBUG")
+#endif
+#ifdef MAVLINK_MSG_ID_DEBUG_VECT
+MAVLINK_MESSAGE_TRAITS(mavlink_debug_vect_t, MAVLINK_MSG_ID_DEBUG_VECT, "DEBUG_VECT")
+#endif
+#ifdef MAVLINK_MSG_ID_DEEPSTALL
+MAVLINK_MESSAGE_TRAITS(mavlink_deepstall_t, MAVLINK_MSG_ID_DEEPSTALL, "DEEPSTALL")
+#endif
+#ifdef MAVLINK_MSG_ID_DEVICE_OP_READ_REPLY
+MAVLINK_MESSAGE_TRAITS(mavlink_device_op_read_reply_t, MAVLINK_MSG_ID_DEVICE_OP_READ_REPLY, "DEVICE_OP_READ_REPLY")
+#endif
+#ifdef MAVLINK_MSG_ID_DEVICE_OP_READ
+MAVLINK_MESSAGE_TRAITS(mavlink_device_op_read_t, MAVLINK_MSG_ID_DEVICE_OP_READ, "DEVICE_OP_READ")
+#endif
+#ifdef MAVLINK_MSG_ID_DEVICE_OP_WRITE_REPLY
+MAVLINK_MESSAGE_TRAITS(mavlink_device_op_write_reply_t, MAVLINK_MSG_ID_DEVICE_OP_WRITE_REPLY, "DEVICE_OP_WRITE_REPLY")
+#endif
+#ifdef MAVLINK_MSG_ID_DEVICE_OP_WRITE
+MAVLINK_MESSAGE_TRAITS(mavlink_device_op_write_t, MAVLINK_MSG_ID_DEVICE_OP_WRITE, "DEVICE_OP_WRITE")
+#endif
+#ifdef MAVLINK_MSG_ID_DIGICAM_CONFIGURE
+MAVLINK_MESSAGE_TRAITS(mavlink_digicam_configure_t, MAVLINK_MSG_ID_DIGICAM_CONFIGURE, "DIGICAM_CONFIGURE")
+#endif
+#ifdef MAVLINK_MSG_ID_DIGICAM_CONTROL
+MAVLINK_MESSAGE_TRAITS(mavlink_digicam_control_t, MAVLINK_MSG_ID_DIGICAM_CONTROL, "DIGICAM_CONTROL")
+#endif
+#ifdef MAVLINK_MSG_ID_DISTANCE_SENSOR
+MAVLINK_MESSAGE_TRAITS(mavlink_distance_sensor_t, MAVLINK_MSG_ID_DISTANCE_SENSOR, "DISTANCE_SENSOR")
+#endif
+#ifdef MAVLINK_MSG_ID_EFI_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_efi_status_t, MAVLINK_MSG_ID_EFI_STATUS, "EFI_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_EKF_EXT
+MAVLINK_MESSAGE_TRAITS(mavlink_ekf_ext_t, MAVLINK_MSG_ID_EKF_EXT, "EKF_EXT")
+#endif
+#ifdef MAVLINK_MSG_ID_EKF_STATUS_REPORT
+MAVLINK_MESSAGE_TRAITS(mavlink_ekf_status_report_t, MAVLINK_MSG_ID_EKF_STATUS_REPORT, "EKF_STATUS_REPORT")
+#endif
+#ifdef MAVLINK_MSG_ID_ENCAPSULATED_DATA
+MAVLINK_MESSAGE_TRAITS(mavlink_encapsulated_data_t, MAVLINK_MSG_ID_ENCAPSULATED_DATA, "ENCAPSULATED_DATA")
+#endif
+#ifdef MAVLINK_MSG_ID_ESC_INFO
+MAVLINK_MESSAGE_TRAITS(mavlink_esc_info_t, MAVLINK_MSG_ID_ESC_INFO, "ESC_INFO")
+#endif
+#ifdef MAVLINK_MSG_ID_ESC_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_esc_status_t, MAVLINK_MSG_ID_ESC_STATUS, "ESC_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_ESC_TELEMETRY_1_TO_4
+MAVLINK_MESSAGE_TRAITS(mavlink_esc_telemetry_1_to_4_t, MAVLINK_MSG_ID_ESC_TELEMETRY_1_TO_4, "ESC_TELEMETRY_1_TO_4")
+#endif
+#ifdef MAVLINK_MSG_ID_ESC_TELEMETRY_5_TO_8
+MAVLINK_MESSAGE_TRAITS(mavlink_esc_telemetry_5_to_8_t, MAVLINK_MSG_ID_ESC_TELEMETRY_5_TO_8, "ESC_TELEMETRY_5_TO_8")
+#endif
+#ifdef MAVLINK_MSG_ID_ESC_TELEMETRY_9_TO_12
+MAVLINK_MESSAGE_TRAITS(mavlink_esc_telemetry_9_to_12_t, MAVLINK_MSG_ID_ESC_TELEMETRY_9_TO_12, "ESC_TELEMETRY_9_TO_12")
+#endif
+#ifdef MAVLINK_MSG_ID_ESTIMATOR_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_estimator_status_t, MAVLINK_MSG_ID_ESTIMATOR_STATUS, "ESTIMATOR_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_EVENT
+MAVLINK_MESSAGE_TRAITS(mavlink_event_t, MAVLINK_MSG_ID_EVENT, "EVENT")
+#endif
+#ifdef MAVLINK_MSG_ID_EXTENDED_SYS_STATE
+MAVLINK_MESSAGE_TRAITS(mavlink_extended_sys_state_t, MAVLINK_MSG_ID_EXTENDED_SYS_STATE, "EXTENDED_SYS_STATE")
+#endif
+#ifdef MAVLINK_MSG_ID_FENCE_FETCH_POINT
+MAVLINK_MESSAGE_TRAITS(mavlink_fence_fetch_point_t, MAVLINK_MSG_ID_FENCE_FETCH_POINT, "FENCE_FETCH_POINT")
+#endif
+#ifdef MAVLINK_MSG_ID_FENCE_POINT
+MAVLINK_MESSAGE_TRAITS(mavlink_fence_point_t, MAVLINK_MSG_ID_FENCE_POINT, "FENCE_POINT")
+#endif
+#ifdef MAVLINK_MSG_ID_FENCE_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_fence_status_t, MAVLINK_MSG_ID_FENCE_STATUS, "FENCE_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_FIGURE_EIGHT_EXECUTION_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_figure_eight_execution_status_t, MAVLINK_MSG_ID_FIGURE_EIGHT_EXECUTION_STATUS, "FIGURE_EIGHT_EXECUTION_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL
+MAVLINK_MESSAGE_TRAITS(mavlink_file_transfer_protocol_t, MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL, "FILE_TRANSFER_PROTOCOL")
+#endif
+#ifdef MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION_ACK
+MAVLINK_MESSAGE_TRAITS(mavlink_flexifunction_buffer_function_ack_t, MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION_ACK, "FLEXIFUNCTION_BUFFER_FUNCTION_ACK")
+#endif
+#ifdef MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION
+MAVLINK_MESSAGE_TRAITS(mavlink_flexifunction_buffer_function_t, MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, "FLEXIFUNCTION_BUFFER_FUNCTION")
+#endif
+#ifdef MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND_ACK
+MAVLINK_MESSAGE_TRAITS(mavlink_flexifunction_command_ack_t, MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND_ACK, "FLEXIFUNCTION_COMMAND_ACK")
+#endif
+#ifdef MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND
+MAVLINK_MESSAGE_TRAITS(mavlink_flexifunction_command_t, MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND, "FLEXIFUNCTION_COMMAND")
+#endif
+#ifdef MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK
+MAVLINK_MESSAGE_TRAITS(mavlink_flexifunction_directory_ack_t, MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK, "FLEXIFUNCTION_DIRECTORY_ACK")
+#endif
+#ifdef MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY
+MAVLINK_MESSAGE_TRAITS(mavlink_flexifunction_directory_t, MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY, "FLEXIFUNCTION_DIRECTORY")
+#endif
+#ifdef MAVLINK_MSG_ID_FLEXIFUNCTION_READ_REQ
+MAVLINK_MESSAGE_TRAITS(mavlink_flexifunction_read_req_t, MAVLINK_MSG_ID_FLEXIFUNCTION_READ_REQ, "FLEXIFUNCTION_READ_REQ")
+#endif
+#ifdef MAVLINK_MSG_ID_FLEXIFUNCTION_SET
+MAVLINK_MESSAGE_TRAITS(mavlink_flexifunction_set_t, MAVLINK_MSG_ID_FLEXIFUNCTION_SET, "FLEXIFUNCTION_SET")
+#endif
+#ifdef MAVLINK_MSG_ID_FLIGHT_INFORMATION
+MAVLINK_MESSAGE_TRAITS(mavlink_flight_information_t, MAVLINK_MSG_ID_FLIGHT_INFORMATION, "FLIGHT_INFORMATION")
+#endif
+#ifdef MAVLINK_MSG_ID_FOLLOW_TARGET
+MAVLINK_MESSAGE_TRAITS(mavlink_follow_target_t, MAVLINK_MSG_ID_FOLLOW_TARGET, "FOLLOW_TARGET")
+#endif
+#ifdef MAVLINK_MSG_ID_FRSKY_PASSTHROUGH_ARRAY
+MAVLINK_MESSAGE_TRAITS(mavlink_frsky_passthrough_array_t, MAVLINK_MSG_ID_FRSKY_PASSTHROUGH_ARRAY, "FRSKY_PASSTHROUGH_ARRAY")
+#endif
+#ifdef MAVLINK_MSG_ID_FUEL_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_fuel_status_t, MAVLINK_MSG_ID_FUEL_STATUS, "FUEL_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_FW_SOARING_DATA
+MAVLINK_MESSAGE_TRAITS(mavlink_fw_soaring_data_t, MAVLINK_MSG_ID_FW_SOARING_DATA, "FW_SOARING_DATA")
+#endif
+#ifdef MAVLINK_MSG_ID_GENERATOR_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_generator_status_t, MAVLINK_MSG_ID_GENERATOR_STATUS, "GENERATOR_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_GIMBAL_CONTROL
+MAVLINK_MESSAGE_TRAITS(mavlink_gimbal_control_t, MAVLINK_MSG_ID_GIMBAL_CONTROL, "GIMBAL_CONTROL")
+#endif
+#ifdef MAVLINK_MSG_ID_GIMBAL_DEVICE_ATTITUDE_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_gimbal_device_attitude_status_t, MAVLINK_MSG_ID_GIMBAL_DEVICE_ATTITUDE_STATUS, "GIMBAL_DEVICE_ATTITUDE_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_GIMBAL_DEVICE_INFORMATION
+MAVLINK_MESSAGE_TRAITS(mavlink_gimbal_device_information_t, MAVLINK_MSG_ID_GIMBAL_DEVICE_INFORMATION, "GIMBAL_DEVICE_INFORMATION")
+#endif
+#ifdef MAVLINK_MSG_ID_GIMBAL_DEVICE_SET_ATTITUDE
+MAVLINK_MESSAGE_TRAITS(mavlink_gimbal_device_set_attitude_t, MAVLINK_MSG_ID_GIMBAL_DEVICE_SET_ATTITUDE, "GIMBAL_DEVICE_SET_ATTITUDE")
+#endif
+#ifdef MAVLINK_MSG_ID_GIMBAL_MANAGER_INFORMATION
+MAVLINK_MESSAGE_TRAITS(mavlink_gimbal_manager_information_t, MAVLINK_MSG_ID_GIMBAL_MANAGER_INFORMATION, "GIMBAL_MANAGER_INFORMATION")
+#endif
+#ifdef MAVLINK_MSG_ID_GIMBAL_MANAGER_SET_ATTITUDE
+MAVLINK_MESSAGE_TRAITS(mavlink_gimbal_manager_set_attitude_t, MAVLINK_MSG_ID_GIMBAL_MANAGER_SET_ATTITUDE, "GIMBAL_MANAGER_SET_ATTITUDE")
+#endif
+#ifdef MAVLINK_MSG_ID_GIMBAL_MANAGER_SET_MANUAL_CONTROL
+MAVLINK_MESSAGE_TRAITS(mavlink_gimbal_manager_set_manual_control_t, MAVLINK_MSG_ID_GIMBAL_MANAGER_SET_MANUAL_CONTROL, "GIMBAL_MANAGER_SET_MANUAL_CONTROL")
+#endif
+#ifdef MAVLINK_MSG_ID_GIMBAL_MANAGER_SET_PITCHYAW
+MAVLINK_MESSAGE_TRAITS(mavlink_gimbal_manager_set_pitchyaw_t, MAVLINK_MSG_ID_GIMBAL_MANAGER_SET_PITCHYAW, "GIMBAL_MANAGER_SET_PITCHYAW")
+#endif
+#ifdef MAVLINK_MSG_ID_GIMBAL_MANAGER_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_gimbal_manager_status_t, MAVLINK_MSG_ID_GIMBAL_MANAGER_STATUS, "GIMBAL_MANAGER_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_GIMBAL_REPORT
+MAVLINK_MESSAGE_TRAITS(mavlink_gimbal_report_t, MAVLINK_MSG_ID_GIMBAL_REPORT, "GIMBAL_REPORT")
+#endif
+#ifdef MAVLINK_MSG_ID_GIMBAL_TORQUE_CMD_REPORT
+MAVLINK_MESSAGE_TRAITS(mavlink_gimbal_torque_cmd_report_t, MAVLINK_MSG_ID_GIMBAL_TORQUE_CMD_REPORT, "GIMBAL_TORQUE_CMD_REPORT")
+#endif
+#ifdef MAVLINK_MSG_ID_GLOBAL_POSITION_INT_COV
+MAVLINK_MESSAGE_TRAITS(mavlink_global_position_int_cov_t, MAVLINK_MSG_ID_GLOBAL_POSITION_INT_COV, "GLOBAL_POSITION_INT_COV")
+#endif
+#ifdef MAVLINK_MSG_ID_GLOBAL_POSITION_INT
+MAVLINK_MESSAGE_TRAITS(mavlink_global_position_int_t, MAVLINK_MSG_ID_GLOBAL_POSITION_INT, "GLOBAL_POSITION_INT")
+#endif
+#ifdef MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE
+MAVLINK_MESSAGE_TRAITS(mavlink_global_vision_position_estimate_t, MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, "GLOBAL_VISION_POSITION_ESTIMATE")
+#endif
+#ifdef MAVLINK_MSG_ID_GNSS_INTEGRITY
+MAVLINK_MESSAGE_TRAITS(mavlink_gnss_integrity_t, MAVLINK_MSG_ID_GNSS_INTEGRITY, "GNSS_INTEGRITY")
+#endif
+#ifdef MAVLINK_MSG_ID_GOPRO_GET_REQUEST
+MAVLINK_MESSAGE_TRAITS(mavlink_gopro_get_request_t, MAVLINK_MSG_ID_GOPRO_GET_REQUEST, "GOPRO_GET_REQUEST")
+#endif
+#ifdef MAVLINK_MSG_ID_GOPRO_GET_RESPONSE
+MAVLINK_MESSAGE_TRAITS(mavlink_gopro_get_response_t, MAVLINK_MSG_ID_GOPRO_GET_RESPONSE, "GOPRO_GET_RESPONSE")
+#endif
+#ifdef MAVLINK_MSG_ID_GOPRO_HEARTBEAT
+MAVLINK_MESSAGE_TRAITS(mavlink_gopro_heartbeat_t, MAVLINK_MSG_ID_GOPRO_HEARTBEAT, "GOPRO_HEARTBEAT")
+#endif
+#ifdef MAVLINK_MSG_ID_GOPRO_SET_REQUEST
+MAVLINK_MESSAGE_TRAITS(mavlink_gopro_set_request_t, MAVLINK_MSG_ID_GOPRO_SET_REQUEST, "GOPRO_SET_REQUEST")
+#endif
+#ifdef MAVLINK_MSG_ID_GOPRO_SET_RESPONSE
+MAVLINK_MESSAGE_TRAITS(mavlink_gopro_set_response_t, MAVLINK_MSG_ID_GOPRO_SET_RESPONSE, "GOPRO_SET_RESPONSE")
+#endif
+#ifdef MAVLINK_MSG_ID_GPS2_RAW
+MAVLINK_MESSAGE_TRAITS(mavlink_gps2_raw_t, MAVLINK_MSG_ID_GPS2_RAW, "GPS2_RAW")
+#endif
+#ifdef MAVLINK_MSG_ID_GPS2_RTK
+MAVLINK_MESSAGE_TRAITS(mavlink_gps2_rtk_t, MAVLINK_MSG_ID_GPS2_RTK, "GPS2_RTK")
+#endif
+#ifdef MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN
+MAVLINK_MESSAGE_TRAITS(mavlink_gps_global_origin_t, MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN, "GPS_GLOBAL_ORIGIN")
+#endif
+#ifdef MAVLINK_MSG_ID_GPS_INJECT_DATA
+MAVLINK_MESSAGE_TRAITS(mavlink_gps_inject_data_t, MAVLINK_MSG_ID_GPS_INJECT_DATA, "GPS_INJECT_DATA")
+#endif
+#ifdef MAVLINK_MSG_ID_GPS_INPUT
+MAVLINK_MESSAGE_TRAITS(mavlink_gps_input_t, MAVLINK_MSG_ID_GPS_INPUT, "GPS_INPUT")
+#endif
+#ifdef MAVLINK_MSG_ID_GPS_RAW_INT
+MAVLINK_MESSAGE_TRAITS(mavlink_gps_raw_int_t, MAVLINK_MSG_ID_GPS_RAW_INT, "GPS_RAW_INT")
+#endif
+#ifdef MAVLINK_MSG_ID_GPS_RTCM_DATA
+MAVLINK_MESSAGE_TRAITS(mavlink_gps_rtcm_data_t, MAVLINK_MSG_ID_GPS_RTCM_DATA, "GPS_RTCM_DATA")
+#endif
+#ifdef MAVLINK_MSG_ID_GPS_RTK
+MAVLINK_MESSAGE_TRAITS(mavlink_gps_rtk_t, MAVLINK_MSG_ID_GPS_RTK, "GPS_RTK")
+#endif
+#ifdef MAVLINK_MSG_ID_GPS_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_gps_status_t, MAVLINK_MSG_ID_GPS_STATUS, "GPS_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_GROUP_END
+MAVLINK_MESSAGE_TRAITS(mavlink_group_end_t, MAVLINK_MSG_ID_GROUP_END, "GROUP_END")
+#endif
+#ifdef MAVLINK_MSG_ID_GROUP_START
+MAVLINK_MESSAGE_TRAITS(mavlink_group_start_t, MAVLINK_MSG_ID_GROUP_START, "GROUP_START")
+#endif
+#ifdef MAVLINK_MSG_ID_GSM_LINK_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_gsm_link_status_t, MAVLINK_MSG_ID_GSM_LINK_STATUS, "GSM_LINK_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_HEARTBEAT
+MAVLINK_MESSAGE_TRAITS(mavlink_heartbeat_t, MAVLINK_MSG_ID_HEARTBEAT, "HEARTBEAT")
+#endif
+#ifdef MAVLINK_MSG_ID_HERELINK_TELEM
+MAVLINK_MESSAGE_TRAITS(mavlink_herelink_telem_t, MAVLINK_MSG_ID_HERELINK_TELEM, "HERELINK_TELEM")
+#endif
+#ifdef MAVLINK_MSG_ID_HERELINK_VIDEO_STREAM_INFORMATION
+MAVLINK_MESSAGE_TRAITS(mavlink_herelink_video_stream_information_t, MAVLINK_MSG_ID_HERELINK_VIDEO_STREAM_INFORMATION, "HERELINK_VIDEO_STREAM_INFORMATION")
+#endif
+#ifdef MAVLINK_MSG_ID_HIGH_LATENCY2
+MAVLINK_MESSAGE_TRAITS(mavlink_high_latency2_t, MAVLINK_MSG_ID_HIGH_LATENCY2, "HIGH_LATENCY2")
+#endif
+#ifdef MAVLINK_MSG_ID_HIGH_LATENCY
+MAVLINK_MESSAGE_TRAITS(mavlink_high_latency_t, MAVLINK_MSG_ID_HIGH_LATENCY, "HIGH_LATENCY")
+#endif
+#ifdef MAVLINK_MSG_ID_HIGHRES_IMU
+MAVLINK_MESSAGE_TRAITS(mavlink_highres_imu_t, MAVLINK_MSG_ID_HIGHRES_IMU, "HIGHRES_IMU")
+#endif
+#ifdef MAVLINK_MSG_ID_HIL_ACTUATOR_CONTROLS
+MAVLINK_MESSAGE_TRAITS(mavlink_hil_actuator_controls_t, MAVLINK_MSG_ID_HIL_ACTUATOR_CONTROLS, "HIL_ACTUATOR_CONTROLS")
+#endif
+#ifdef MAVLINK_MSG_ID_HIL_CONTROLS
+MAVLINK_MESSAGE_TRAITS(mavlink_hil_controls_t, MAVLINK_MSG_ID_HIL_CONTROLS, "HIL_CONTROLS")
+#endif
+#ifdef MAVLINK_MSG_ID_HIL_GPS
+MAVLINK_MESSAGE_TRAITS(mavlink_hil_gps_t, MAVLINK_MSG_ID_HIL_GPS, "HIL_GPS")
+#endif
+#ifdef MAVLINK_MSG_ID_HIL_OPTICAL_FLOW
+MAVLINK_MESSAGE_TRAITS(mavlink_hil_optical_flow_t, MAVLINK_MSG_ID_HIL_OPTICAL_FLOW, "HIL_OPTICAL_FLOW")
+#endif
+#ifdef MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW
+MAVLINK_MESSAGE_TRAITS(mavlink_hil_rc_inputs_raw_t, MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, "HIL_RC_INPUTS_RAW")
+#endif
+#ifdef MAVLINK_MSG_ID_HIL_SENSOR
+MAVLINK_MESSAGE_TRAITS(mavlink_hil_sensor_t, MAVLINK_MSG_ID_HIL_SENSOR, "HIL_SENSOR")
+#endif
+#ifdef MAVLINK_MSG_ID_HIL_STATE_QUATERNION
+MAVLINK_MESSAGE_TRAITS(mavlink_hil_state_quaternion_t, MAVLINK_MSG_ID_HIL_STATE_QUATERNION, "HIL_STATE_QUATERNION")
+#endif
+#ifdef MAVLINK_MSG_ID_HIL_STATE
+MAVLINK_MESSAGE_TRAITS(mavlink_hil_state_t, MAVLINK_MSG_ID_HIL_STATE, "HIL_STATE")
+#endif
+#ifdef MAVLINK_MSG_ID_HOME_POSITION
+MAVLINK_MESSAGE_TRAITS(mavlink_home_position_t, MAVLINK_MSG_ID_HOME_POSITION, "HOME_POSITION")
+#endif
+#ifdef MAVLINK_MSG_ID_HWSTATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_hwstatus_t, MAVLINK_MSG_ID_HWSTATUS, "HWSTATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_HYGROMETER_SENSOR
+MAVLINK_MESSAGE_TRAITS(mavlink_hygrometer_sensor_t, MAVLINK_MSG_ID_HYGROMETER_SENSOR, "HYGROMETER_SENSOR")
+#endif
+#ifdef MAVLINK_MSG_ID_ICAROUS_HEARTBEAT
+MAVLINK_MESSAGE_TRAITS(mavlink_icarous_heartbeat_t, MAVLINK_MSG_ID_ICAROUS_HEARTBEAT, "ICAROUS_HEARTBEAT")
+#endif
+#ifdef MAVLINK_MSG_ID_ICAROUS_KINEMATIC_BANDS
+MAVLINK_MESSAGE_TRAITS(mavlink_icarous_kinematic_bands_t, MAVLINK_MSG_ID_ICAROUS_KINEMATIC_BANDS, "ICAROUS_KINEMATIC_BANDS")
+#endif
+#ifdef MAVLINK_MSG_ID_ILLUMINATOR_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_illuminator_status_t, MAVLINK_MSG_ID_ILLUMINATOR_STATUS, "ILLUMINATOR_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_ISBD_LINK_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_isbd_link_status_t, MAVLINK_MSG_ID_ISBD_LINK_STATUS, "ISBD_LINK_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_LANDING_TARGET
+MAVLINK_MESSAGE_TRAITS(mavlink_landing_target_t, MAVLINK_MSG_ID_LANDING_TARGET, "LANDING_TARGET")
+#endif
+#ifdef MAVLINK_MSG_ID_LED_CONTROL
+MAVLINK_MESSAGE_TRAITS(mavlink_led_control_t, MAVLINK_MSG_ID_LED_CONTROL, "LED_CONTROL")
+#endif
+#ifdef MAVLINK_MSG_ID_LIMITS_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_limits_status_t, MAVLINK_MSG_ID_LIMITS_STATUS, "LIMITS_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_LINK_NODE_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_link_node_status_t, MAVLINK_MSG_ID_LINK_NODE_STATUS, "LINK_NODE_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_LOCAL_POSITION_NED_COV
+MAVLINK_MESSAGE_TRAITS(mavlink_local_position_ned_cov_t, MAVLINK_MSG_ID_LOCAL_POSITION_NED_COV, "LOCAL_POSITION_NED_COV")
+#endif
+#ifdef MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET
+MAVLINK_MESSAGE_TRAITS(mavlink_local_position_ned_system_global_offset_t, MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, "LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET")
+#endif
+#ifdef MAVLINK_MSG_ID_LOCAL_POSITION_NED
+MAVLINK_MESSAGE_TRAITS(mavlink_local_position_ned_t, MAVLINK_MSG_ID_LOCAL_POSITION_NED, "LOCAL_POSITION_NED")
+#endif
+#ifdef MAVLINK_MSG_ID_LOG_DATA
+MAVLINK_MESSAGE_TRAITS(mavlink_log_data_t, MAVLINK_MSG_ID_LOG_DATA, "LOG_DATA")
+#endif
+#ifdef MAVLINK_MSG_ID_LOG_ENTRY
+MAVLINK_MESSAGE_TRAITS(mavlink_log_entry_t, MAVLINK_MSG_ID_LOG_ENTRY, "LOG_ENTRY")
+#endif
+#ifdef MAVLINK_MSG_ID_LOG_ERASE
+MAVLINK_MESSAGE_TRAITS(mavlink_log_erase_t, MAVLINK_MSG_ID_LOG_ERASE, "LOG_ERASE")
+#endif
+#ifdef MAVLINK_MSG_ID_LOG_REQUEST_DATA
+MAVLINK_MESSAGE_TRAITS(mavlink_log_request_data_t, MAVLINK_MSG_ID_LOG_REQUEST_DATA, "LOG_REQUEST_DATA")
+#endif
+#ifdef MAVLINK_MSG_ID_LOG_REQUEST_END
+MAVLINK_MESSAGE_TRAITS(mavlink_log_request_end_t, MAVLINK_MSG_ID_LOG_REQUEST_END, "LOG_REQUEST_END")
+#endif
+#ifdef MAVLINK_MSG_ID_LOG_REQUEST_LIST
+MAVLINK_MESSAGE_TRAITS(mavlink_log_request_list_t, MAVLINK_MSG_ID_LOG_REQUEST_LIST, "LOG_REQUEST_LIST")
+#endif
+#ifdef MAVLINK_MSG_ID_LOGGING_ACK
+MAVLINK_MESSAGE_TRAITS(mavlink_logging_ack_t, MAVLINK_MSG_ID_LOGGING_ACK, "LOGGING_ACK")
+#endif
+#ifdef MAVLINK_MSG_ID_LOGGING_DATA_ACKED
+MAVLINK_MESSAGE_TRAITS(mavlink_logging_data_acked_t, MAVLINK_MSG_ID_LOGGING_DATA_ACKED, "LOGGING_DATA_ACKED")
+#endif
+#ifdef MAVLINK_MSG_ID_LOGGING_DATA
+MAVLINK_MESSAGE_TRAITS(mavlink_logging_data_t, MAVLINK_MSG_ID_LOGGING_DATA, "LOGGING_DATA")
+#endif
+#ifdef MAVLINK_MSG_ID_MAG_CAL_PROGRESS
+MAVLINK_MESSAGE_TRAITS(mavlink_mag_cal_progress_t, MAVLINK_MSG_ID_MAG_CAL_PROGRESS, "MAG_CAL_PROGRESS")
+#endif
+#ifdef MAVLINK_MSG_ID_MAG_CAL_REPORT
+MAVLINK_MESSAGE_TRAITS(mavlink_mag_cal_report_t, MAVLINK_MSG_ID_MAG_CAL_REPORT, "MAG_CAL_REPORT")
+#endif
+#ifdef MAVLINK_MSG_ID_MANUAL_CONTROL
+MAVLINK_MESSAGE_TRAITS(mavlink_manual_control_t, MAVLINK_MSG_ID_MANUAL_CONTROL, "MANUAL_CONTROL")
+#endif
+#ifdef MAVLINK_MSG_ID_MANUAL_SETPOINT
+MAVLINK_MESSAGE_TRAITS(mavlink_manual_setpoint_t, MAVLINK_MSG_ID_MANUAL_SETPOINT, "MANUAL_SETPOINT")
+#endif
+#ifdef MAVLINK_MSG_ID_MCU_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_mcu_status_t, MAVLINK_MSG_ID_MCU_STATUS, "MCU_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_MEMINFO
+MAVLINK_MESSAGE_TRAITS(mavlink_meminfo_t, MAVLINK_MSG_ID_MEMINFO, "MEMINFO")
+#endif
+#ifdef MAVLINK_MSG_ID_MEMORY_VECT
+MAVLINK_MESSAGE_TRAITS(mavlink_memory_vect_t, MAVLINK_MSG_ID_MEMORY_VECT, "MEMORY_VECT")
+#endif
+#ifdef MAVLINK_MSG_ID_MESSAGE_INTERVAL
+MAVLINK_MESSAGE_TRAITS(mavlink_message_interval_t, MAVLINK_MSG_ID_MESSAGE_INTERVAL, "MESSAGE_INTERVAL")
+#endif
+#ifdef MAVLINK_MSG_ID_MISSION_ACK
+MAVLINK_MESSAGE_TRAITS(mavlink_mission_ack_t, MAVLINK_MSG_ID_MISSION_ACK, "MISSION_ACK")
+#endif
+#ifdef MAVLINK_MSG_ID_MISSION_CLEAR_ALL
+MAVLINK_MESSAGE_TRAITS(mavlink_mission_clear_all_t, MAVLINK_MSG_ID_MISSION_CLEAR_ALL, "MISSION_CLEAR_ALL")
+#endif
+#ifdef MAVLINK_MSG_ID_MISSION_COUNT
+MAVLINK_MESSAGE_TRAITS(mavlink_mission_count_t, MAVLINK_MSG_ID_MISSION_COUNT, "MISSION_COUNT")
+#endif
+#ifdef MAVLINK_MSG_ID_MISSION_CURRENT
+MAVLINK_MESSAGE_TRAITS(mavlink_mission_current_t, MAVLINK_MSG_ID_MISSION_CURRENT, "MISSION_CURRENT")
+#endif
+#ifdef MAVLINK_MSG_ID_MISSION_ITEM_INT
+MAVLINK_MESSAGE_TRAITS(mavlink_mission_item_int_t, MAVLINK_MSG_ID_MISSION_ITEM_INT, "MISSION_ITEM_INT")
+#endif
+#ifdef MAVLINK_MSG_ID_MISSION_ITEM_REACHED
+MAVLINK_MESSAGE_TRAITS(mavlink_mission_item_reached_t, MAVLINK_MSG_ID_MISSION_ITEM_REACHED, "MISSION_ITEM_REACHED")
+#endif
+#ifdef MAVLINK_MSG_ID_MISSION_ITEM
+MAVLINK_MESSAGE_TRAITS(mavlink_mission_item_t, MAVLINK_MSG_ID_MISSION_ITEM, "MISSION_ITEM")
+#endif
+#ifdef MAVLINK_MSG_ID_MISSION_REQUEST_INT
+MAVLINK_MESSAGE_TRAITS(mavlink_mission_request_int_t, MAVLINK_MSG_ID_MISSION_REQUEST_INT, "MISSION_REQUEST_INT")
+#endif
+#ifdef MAVLINK_MSG_ID_MISSION_REQUEST_LIST
+MAVLINK_MESSAGE_TRAITS(mavlink_mission_request_list_t, MAVLINK_MSG_ID_MISSION_REQUEST_LIST, "MISSION_REQUEST_LIST")
+#endif
+#ifdef MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST
+MAVLINK_MESSAGE_TRAITS(mavlink_mission_request_partial_list_t, MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST, "MISSION_REQUEST_PARTIAL_LIST")
+#endif
+#ifdef MAVLINK_MSG_ID_MISSION_REQUEST
+MAVLINK_MESSAGE_TRAITS(mavlink_mission_request_t, MAVLINK_MSG_ID_MISSION_REQUEST, "MISSION_REQUEST")
+#endif
+#ifdef MAVLINK_MSG_ID_MISSION_SET_CURRENT
+MAVLINK_MESSAGE_TRAITS(mavlink_mission_set_current_t, MAVLINK_MSG_ID_MISSION_SET_CURRENT, "MISSION_SET_CURRENT")
+#endif
+#ifdef MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST
+MAVLINK_MESSAGE_TRAITS(mavlink_mission_write_partial_list_t, MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST, "MISSION_WRITE_PARTIAL_LIST")
+#endif
+#ifdef MAVLINK_MSG_ID_MOUNT_CONFIGURE
+MAVLINK_MESSAGE_TRAITS(mavlink_mount_configure_t, MAVLINK_MSG_ID_MOUNT_CONFIGURE, "MOUNT_CONFIGURE")
+#endif
+#ifdef MAVLINK_MSG_ID_MOUNT_CONTROL
+MAVLINK_MESSAGE_TRAITS(mavlink_mount_control_t, MAVLINK_MSG_ID_MOUNT_CONTROL, "MOUNT_CONTROL")
+#endif
+#ifdef MAVLINK_MSG_ID_MOUNT_ORIENTATION
+MAVLINK_MESSAGE_TRAITS(mavlink_mount_orientation_t, MAVLINK_MSG_ID_MOUNT_ORIENTATION, "MOUNT_ORIENTATION")
+#endif
+#ifdef MAVLINK_MSG_ID_MOUNT_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_mount_status_t, MAVLINK_MSG_ID_MOUNT_STATUS, "MOUNT_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_NAMED_VALUE_FLOAT
+MAVLINK_MESSAGE_TRAITS(mavlink_named_value_float_t, MAVLINK_MSG_ID_NAMED_VALUE_FLOAT, "NAMED_VALUE_FLOAT")
+#endif
+#ifdef MAVLINK_MSG_ID_NAMED_VALUE_INT
+MAVLINK_MESSAGE_TRAITS(mavlink_named_value_int_t, MAVLINK_MSG_ID_NAMED_VALUE_INT, "NAMED_VALUE_INT")
+#endif
+#ifdef MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT
+MAVLINK_MESSAGE_TRAITS(mavlink_nav_controller_output_t, MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, "NAV_CONTROLLER_OUTPUT")
+#endif
+#ifdef MAVLINK_MSG_ID_NAV_FILTER_BIAS
+MAVLINK_MESSAGE_TRAITS(mavlink_nav_filter_bias_t, MAVLINK_MSG_ID_NAV_FILTER_BIAS, "NAV_FILTER_BIAS")
+#endif
+#ifdef MAVLINK_MSG_ID_OBSTACLE_DISTANCE_3D
+MAVLINK_MESSAGE_TRAITS(mavlink_obstacle_distance_3d_t, MAVLINK_MSG_ID_OBSTACLE_DISTANCE_3D, "OBSTACLE_DISTANCE_3D")
+#endif
+#ifdef MAVLINK_MSG_ID_OBSTACLE_DISTANCE
+MAVLINK_MESSAGE_TRAITS(mavlink_obstacle_distance_t, MAVLINK_MSG_ID_OBSTACLE_DISTANCE, "OBSTACLE_DISTANCE")
+#endif
+#ifdef MAVLINK_MSG_ID_ODOMETRY
+MAVLINK_MESSAGE_TRAITS(mavlink_odometry_t, MAVLINK_MSG_ID_ODOMETRY, "ODOMETRY")
+#endif
+#ifdef MAVLINK_MSG_ID_ONBOARD_COMPUTER_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_onboard_computer_status_t, MAVLINK_MSG_ID_ONBOARD_COMPUTER_STATUS, "ONBOARD_COMPUTER_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_OPEN_DRONE_ID_ARM_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_open_drone_id_arm_status_t, MAVLINK_MSG_ID_OPEN_DRONE_ID_ARM_STATUS, "OPEN_DRONE_ID_ARM_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_OPEN_DRONE_ID_AUTHENTICATION
+MAVLINK_MESSAGE_TRAITS(mavlink_open_drone_id_authentication_t, MAVLINK_MSG_ID_OPEN_DRONE_ID_AUTHENTICATION, "OPEN_DRONE_ID_AUTHENTICATION")
+#endif
+#ifdef MAVLINK_MSG_ID_OPEN_DRONE_ID_BASIC_ID
+MAVLINK_MESSAGE_TRAITS(mavlink_open_drone_id_basic_id_t, MAVLINK_MSG_ID_OPEN_DRONE_ID_BASIC_ID, "OPEN_DRONE_ID_BASIC_ID")
+#endif
+#ifdef MAVLINK_MSG_ID_OPEN_DRONE_ID_LOCATION
+MAVLINK_MESSAGE_TRAITS(mavlink_open_drone_id_location_t, MAVLINK_MSG_ID_OPEN_DRONE_ID_LOCATION, "OPEN_DRONE_ID_LOCATION")
+#endif
+#ifdef MAVLINK_MSG_ID_OPEN_DRONE_ID_MESSAGE_PACK
+MAVLINK_MESSAGE_TRAITS(mavlink_open_drone_id_message_pack_t, MAVLINK_MSG_ID_OPEN_DRONE_ID_MESSAGE_PACK, "OPEN_DRONE_ID_MESSAGE_PACK")
+#endif
+#ifdef MAVLINK_MSG_ID_OPEN_DRONE_ID_OPERATOR_ID
+MAVLINK_MESSAGE_TRAITS(mavlink_open_drone_id_operator_id_t, MAVLINK_MSG_ID_OPEN_DRONE_ID_OPERATOR_ID, "OPEN_DRONE_ID_OPERATOR_ID")
+#endif
+#ifdef MAVLINK_MSG_ID_OPEN_DRONE_ID_SELF_ID
+MAVLINK_MESSAGE_TRAITS(mavlink_open_drone_id_self_id_t, MAVLINK_MSG_ID_OPEN_DRONE_ID_SELF_ID, "OPEN_DRONE_ID_SELF_ID")
+#endif
+#ifdef MAVLINK_MSG_ID_OPEN_DRONE_ID_SYSTEM
+MAVLINK_MESSAGE_TRAITS(mavlink_open_drone_id_system_t, MAVLINK_MSG_ID_OPEN_DRONE_ID_SYSTEM, "OPEN_DRONE_ID_SYSTEM")
+#endif
+#ifdef MAVLINK_MSG_ID_OPEN_DRONE_ID_SYSTEM_UPDATE
+MAVLINK_MESSAGE_TRAITS(mavlink_open_drone_id_system_update_t, MAVLINK_MSG_ID_OPEN_DRONE_ID_SYSTEM_UPDATE, "OPEN_DRONE_ID_SYSTEM_UPDATE")
+#endif
+#ifdef MAVLINK_MSG_ID_OPTICAL_FLOW_RAD
+MAVLINK_MESSAGE_TRAITS(mavlink_optical_flow_rad_t, MAVLINK_MSG_ID_OPTICAL_FLOW_RAD, "OPTICAL_FLOW_RAD")
+#endif
+#ifdef MAVLINK_MSG_ID_OPTICAL_FLOW
+MAVLINK_MESSAGE_TRAITS(mavlink_optical_flow_t, MAVLINK_MSG_ID_OPTICAL_FLOW, "OPTICAL_FLOW")
+#endif
+#ifdef MAVLINK_MSG_ID_ORBIT_EXECUTION_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_orbit_execution_status_t, MAVLINK_MSG_ID_ORBIT_EXECUTION_STATUS, "ORBIT_EXECUTION_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_OSD_PARAM_CONFIG_REPLY
+MAVLINK_MESSAGE_TRAITS(mavlink_osd_param_config_reply_t, MAVLINK_MSG_ID_OSD_PARAM_CONFIG_REPLY, "OSD_PARAM_CONFIG_REPLY")
+#endif
+#ifdef MAVLINK_MSG_ID_OSD_PARAM_CONFIG
+MAVLINK_MESSAGE_TRAITS(mavlink_osd_param_config_t, MAVLINK_MSG_ID_OSD_PARAM_CONFIG, "OSD_PARAM_CONFIG")
+#endif
+#ifdef MAVLINK_MSG_ID_OSD_PARAM_SHOW_CONFIG_REPLY
+MAVLINK_MESSAGE_TRAITS(mavlink_osd_param_show_config_reply_t, MAVLINK_MSG_ID_OSD_PARAM_SHOW_CONFIG_REPLY, "OSD_PARAM_SHOW_CONFIG_REPLY")
+#endif
+#ifdef MAVLINK_MSG_ID_OSD_PARAM_SHOW_CONFIG
+MAVLINK_MESSAGE_TRAITS(mavlink_osd_param_show_config_t, MAVLINK_MSG_ID_OSD_PARAM_SHOW_CONFIG, "OSD_PARAM_SHOW_CONFIG")
+#endif
+#ifdef MAVLINK_MSG_ID_PARAM_ACK_TRANSACTION
+MAVLINK_MESSAGE_TRAITS(mavlink_param_ack_transaction_t, MAVLINK_MSG_ID_PARAM_ACK_TRANSACTION, "PARAM_ACK_TRANSACTION")
+#endif
+#ifdef MAVLINK_MSG_ID_PARAM_EXT_ACK
+MAVLINK_MESSAGE_TRAITS(mavlink_param_ext_ack_t, MAVLINK_MSG_ID_PARAM_EXT_ACK, "PARAM_EXT_ACK")
+#endif
+#ifdef MAVLINK_MSG_ID_PARAM_EXT_REQUEST_LIST
+MAVLINK_MESSAGE_TRAITS(mavlink_param_ext_request_list_t, MAVLINK_MSG_ID_PARAM_EXT_REQUEST_LIST, "PARAM_EXT_REQUEST_LIST")
+#endif
+#ifdef MAVLINK_MSG_ID_PARAM_EXT_REQUEST_READ
+MAVLINK_MESSAGE_TRAITS(mavlink_param_ext_request_read_t, MAVLINK_MSG_ID_PARAM_EXT_REQUEST_READ, "PARAM_EXT_REQUEST_READ")
+#endif
+#ifdef MAVLINK_MSG_ID_PARAM_EXT_SET
+MAVLINK_MESSAGE_TRAITS(mavlink_param_ext_set_t, MAVLINK_MSG_ID_PARAM_EXT_SET, "PARAM_EXT_SET")
+#endif
+#ifdef MAVLINK_MSG_ID_PARAM_EXT_VALUE
+MAVLINK_MESSAGE_TRAITS(mavlink_param_ext_value_t, MAVLINK_MSG_ID_PARAM_EXT_VALUE, "PARAM_EXT_VALUE")
+#endif
+#ifdef MAVLINK_MSG_ID_PARAM_MAP_RC
+MAVLINK_MESSAGE_TRAITS(mavlink_param_map_rc_t, MAVLINK_MSG_ID_PARAM_MAP_RC, "PARAM_MAP_RC")
+#endif
+#ifdef MAVLINK_MSG_ID_PARAM_REQUEST_LIST
+MAVLINK_MESSAGE_TRAITS(mavlink_param_request_list_t, MAVLINK_MSG_ID_PARAM_REQUEST_LIST, "PARAM_REQUEST_LIST")
+#endif
+#ifdef MAVLINK_MSG_ID_PARAM_REQUEST_READ
+MAVLINK_MESSAGE_TRAITS(mavlink_param_request_read_t, MAVLINK_MSG_ID_PARAM_REQUEST_READ, "PARAM_REQUEST_READ")
+#endif
+#ifdef MAVLINK_MSG_ID_PARAM_SET
+MAVLINK_MESSAGE_TRAITS(mavlink_param_set_t, MAVLINK_MSG_ID_PARAM_SET, "PARAM_SET")
+#endif
+#ifdef MAVLINK_MSG_ID_PARAM_VALUE_ARRAY
+MAVLINK_MESSAGE_TRAITS(mavlink_param_value_array_t, MAVLINK_MSG_ID_PARAM_VALUE_ARRAY, "PARAM_VALUE_ARRAY")
+#endif
+#ifdef MAVLINK_MSG_ID_PARAM_VALUE
+MAVLINK_MESSAGE_TRAITS(mavlink_param_value_t, MAVLINK_MSG_ID_PARAM_VALUE, "PARAM_VALUE")
+#endif
+#ifdef MAVLINK_MSG_ID_PID_TUNING
+MAVLINK_MESSAGE_TRAITS(mavlink_pid_tuning_t, MAVLINK_MSG_ID_PID_TUNING, "PID_TUNING")
+#endif
+#ifdef MAVLINK_MSG_ID_PING
+MAVLINK_MESSAGE_TRAITS(mavlink_ping_t, MAVLINK_MSG_ID_PING, "PING")
+#endif
+#ifdef MAVLINK_MSG_ID_PLAY_TUNE
+MAVLINK_MESSAGE_TRAITS(mavlink_play_tune_t, MAVLINK_MSG_ID_PLAY_TUNE, "PLAY_TUNE")
+#endif
+#ifdef MAVLINK_MSG_ID_PLAY_TUNE_V2
+MAVLINK_MESSAGE_TRAITS(mavlink_play_tune_v2_t, MAVLINK_MSG_ID_PLAY_TUNE_V2, "PLAY_TUNE_V2")
+#endif
+#ifdef MAVLINK_MSG_ID_POSITION_TARGET_GLOBAL_INT
+MAVLINK_MESSAGE_TRAITS(mavlink_position_target_global_int_t, MAVLINK_MSG_ID_POSITION_TARGET_GLOBAL_INT, "POSITION_TARGET_GLOBAL_INT")
+#endif
+#ifdef MAVLINK_MSG_ID_POSITION_TARGET_LOCAL_NED
+MAVLINK_MESSAGE_TRAITS(mavlink_position_target_local_ned_t, MAVLINK_MSG_ID_POSITION_TARGET_LOCAL_NED, "POSITION_TARGET_LOCAL_NED")
+#endif
+#ifdef MAVLINK_MSG_ID_POWER_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_power_status_t, MAVLINK_MSG_ID_POWER_STATUS, "POWER_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_PROTOCOL_VERSION
+MAVLINK_MESSAGE_TRAITS(mavlink_protocol_version_t, MAVLINK_MSG_ID_PROTOCOL_VERSION, "PROTOCOL_VERSION")
+#endif
+#ifdef MAVLINK_MSG_ID_QSHOT_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_qshot_status_t, MAVLINK_MSG_ID_QSHOT_STATUS, "QSHOT_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_RADIO_CALIBRATION
+MAVLINK_MESSAGE_TRAITS(mavlink_radio_calibration_t, MAVLINK_MSG_ID_RADIO_CALIBRATION, "RADIO_CALIBRATION")
+#endif
+#ifdef MAVLINK_MSG_ID_RADIO_RC_CHANNELS
+MAVLINK_MESSAGE_TRAITS(mavlink_radio_rc_channels_t, MAVLINK_MSG_ID_RADIO_RC_CHANNELS, "RADIO_RC_CHANNELS")
+#endif
+#ifdef MAVLINK_MSG_ID_RADIO_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_radio_status_t, MAVLINK_MSG_ID_RADIO_STATUS, "RADIO_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_RADIO
+MAVLINK_MESSAGE_TRAITS(mavlink_radio_t, MAVLINK_MSG_ID_RADIO, "RADIO")
+#endif
+#ifdef MAVLINK_MSG_ID_RALLY_FETCH_POINT
+MAVLINK_MESSAGE_TRAITS(mavlink_rally_fetch_point_t, MAVLINK_MSG_ID_RALLY_FETCH_POINT, "RALLY_FETCH_POINT")
+#endif
+#ifdef MAVLINK_MSG_ID_RALLY_POINT
+MAVLINK_MESSAGE_TRAITS(mavlink_rally_point_t, MAVLINK_MSG_ID_RALLY_POINT, "RALLY_POINT")
+#endif
+#ifdef MAVLINK_MSG_ID_RANGEFINDER
+MAVLINK_MESSAGE_TRAITS(mavlink_rangefinder_t, MAVLINK_MSG_ID_RANGEFINDER, "RANGEFINDER")
+#endif
+#ifdef MAVLINK_MSG_ID_RAW_IMU
+MAVLINK_MESSAGE_TRAITS(mavlink_raw_imu_t, MAVLINK_MSG_ID_RAW_IMU, "RAW_IMU")
+#endif
+#ifdef MAVLINK_MSG_ID_RAW_PRESSURE
+MAVLINK_MESSAGE_TRAITS(mavlink_raw_pressure_t, MAVLINK_MSG_ID_RAW_PRESSURE, "RAW_PRESSURE")
+#endif
+#ifdef MAVLINK_MSG_ID_RAW_RPM
+MAVLINK_MESSAGE_TRAITS(mavlink_raw_rpm_t, MAVLINK_MSG_ID_RAW_RPM, "RAW_RPM")
+#endif
+#ifdef MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE
+MAVLINK_MESSAGE_TRAITS(mavlink_rc_channels_override_t, MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, "RC_CHANNELS_OVERRIDE")
+#endif
+#ifdef MAVLINK_MSG_ID_RC_CHANNELS_RAW
+MAVLINK_MESSAGE_TRAITS(mavlink_rc_channels_raw_t, MAVLINK_MSG_ID_RC_CHANNELS_RAW, "RC_CHANNELS_RAW")
+#endif
+#ifdef MAVLINK_MSG_ID_RC_CHANNELS_SCALED
+MAVLINK_MESSAGE_TRAITS(mavlink_rc_channels_scaled_t, MAVLINK_MSG_ID_RC_CHANNELS_SCALED, "RC_CHANNELS_SCALED")
+#endif
+#ifdef MAVLINK_MSG_ID_RC_CHANNELS
+MAVLINK_MESSAGE_TRAITS(mavlink_rc_channels_t, MAVLINK_MSG_ID_RC_CHANNELS, "RC_CHANNELS")
+#endif
+#ifdef MAVLINK_MSG_ID_REMOTE_LOG_BLOCK_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_remote_log_block_status_t, MAVLINK_MSG_ID_REMOTE_LOG_BLOCK_STATUS, "REMOTE_LOG_BLOCK_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_REMOTE_LOG_DATA_BLOCK
+MAVLINK_MESSAGE_TRAITS(mavlink_remote_log_data_block_t, MAVLINK_MSG_ID_REMOTE_LOG_DATA_BLOCK, "REMOTE_LOG_DATA_BLOCK")
+#endif
+#ifdef MAVLINK_MSG_ID_REQUEST_DATA_STREAM
+MAVLINK_MESSAGE_TRAITS(mavlink_request_data_stream_t, MAVLINK_MSG_ID_REQUEST_DATA_STREAM, "REQUEST_DATA_STREAM")
+#endif
+#ifdef MAVLINK_MSG_ID_REQUEST_EVENT
+MAVLINK_MESSAGE_TRAITS(mavlink_request_event_t, MAVLINK_MSG_ID_REQUEST_EVENT, "REQUEST_EVENT")
+#endif
+#ifdef MAVLINK_MSG_ID_RESOURCE_REQUEST
+MAVLINK_MESSAGE_TRAITS(mavlink_resource_request_t, MAVLINK_MSG_ID_RESOURCE_REQUEST, "RESOURCE_REQUEST")
+#endif
+#ifdef MAVLINK_MSG_ID_RESPONSE_EVENT_ERROR
+MAVLINK_MESSAGE_TRAITS(mavlink_response_event_error_t, MAVLINK_MSG_ID_RESPONSE_EVENT_ERROR, "RESPONSE_EVENT_ERROR")
+#endif
+#ifdef MAVLINK_MSG_ID_RPM
+MAVLINK_MESSAGE_TRAITS(mavlink_rpm_t, MAVLINK_MSG_ID_RPM, "RPM")
+#endif
+#ifdef MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA
+MAVLINK_MESSAGE_TRAITS(mavlink_safety_allowed_area_t, MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, "SAFETY_ALLOWED_AREA")
+#endif
+#ifdef MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA
+MAVLINK_MESSAGE_TRAITS(mavlink_safety_set_allowed_area_t, MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, "SAFETY_SET_ALLOWED_AREA")
+#endif
+#ifdef MAVLINK_MSG_ID_SATCOM_LINK_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_satcom_link_status_t, MAVLINK_MSG_ID_SATCOM_LINK_STATUS, "SATCOM_LINK_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_SCALED_IMU2
+MAVLINK_MESSAGE_TRAITS(mavlink_scaled_imu2_t, MAVLINK_MSG_ID_SCALED_IMU2, "SCALED_IMU2")
+#endif
+#ifdef MAVLINK_MSG_ID_SCALED_IMU3
+MAVLINK_MESSAGE_TRAITS(mavlink_scaled_imu3_t, MAVLINK_MSG_ID_SCALED_IMU3, "SCALED_IMU3")
+#endif
+#ifdef MAVLINK_MSG_ID_SCALED_IMU
+MAVLINK_MESSAGE_TRAITS(mavlink_scaled_imu_t, MAVLINK_MSG_ID_SCALED_IMU, "SCALED_IMU")
+#endif
+#ifdef MAVLINK_MSG_ID_SCALED_PRESSURE2
+MAVLINK_MESSAGE_TRAITS(mavlink_scaled_pressure2_t, MAVLINK_MSG_ID_SCALED_PRESSURE2, "SCALED_PRESSURE2")
+#endif
+#ifdef MAVLINK_MSG_ID_SCALED_PRESSURE3
+MAVLINK_MESSAGE_TRAITS(mavlink_scaled_pressure3_t, MAVLINK_MSG_ID_SCALED_PRESSURE3, "SCALED_PRESSURE3")
+#endif
+#ifdef MAVLINK_MSG_ID_SCALED_PRESSURE
+MAVLINK_MESSAGE_TRAITS(mavlink_scaled_pressure_t, MAVLINK_MSG_ID_SCALED_PRESSURE, "SCALED_PRESSURE")
+#endif
+#ifdef MAVLINK_MSG_ID_SCRIPT_COUNT
+MAVLINK_MESSAGE_TRAITS(mavlink_script_count_t, MAVLINK_MSG_ID_SCRIPT_COUNT, "SCRIPT_COUNT")
+#endif
+#ifdef MAVLINK_MSG_ID_SCRIPT_CURRENT
+MAVLINK_MESSAGE_TRAITS(mavlink_script_current_t, MAVLINK_MSG_ID_SCRIPT_CURRENT, "SCRIPT_CURRENT")
+#endif
+#ifdef MAVLINK_MSG_ID_SCRIPT_ITEM
+MAVLINK_MESSAGE_TRAITS(mavlink_script_item_t, MAVLINK_MSG_ID_SCRIPT_ITEM, "SCRIPT_ITEM")
+#endif
+#ifdef MAVLINK_MSG_ID_SCRIPT_REQUEST_LIST
+MAVLINK_MESSAGE_TRAITS(mavlink_script_request_list_t, MAVLINK_MSG_ID_SCRIPT_REQUEST_LIST, "SCRIPT_REQUEST_LIST")
+#endif
+#ifdef MAVLINK_MSG_ID_SCRIPT_REQUEST
+MAVLINK_MESSAGE_TRAITS(mavlink_script_request_t, MAVLINK_MSG_ID_SCRIPT_REQUEST, "SCRIPT_REQUEST")
+#endif
+#ifdef MAVLINK_MSG_ID_SENS_ATMOS
+MAVLINK_MESSAGE_TRAITS(mavlink_sens_atmos_t, MAVLINK_MSG_ID_SENS_ATMOS, "SENS_ATMOS")
+#endif
+#ifdef MAVLINK_MSG_ID_SENS_BATMON
+MAVLINK_MESSAGE_TRAITS(mavlink_sens_batmon_t, MAVLINK_MSG_ID_SENS_BATMON, "SENS_BATMON")
+#endif
+#ifdef MAVLINK_MSG_ID_SENS_MPPT
+MAVLINK_MESSAGE_TRAITS(mavlink_sens_mppt_t, MAVLINK_MSG_ID_SENS_MPPT, "SENS_MPPT")
+#endif
+#ifdef MAVLINK_MSG_ID_SENS_POWER_BOARD
+MAVLINK_MESSAGE_TRAITS(mavlink_sens_power_board_t, MAVLINK_MSG_ID_SENS_POWER_BOARD, "SENS_POWER_BOARD")
+#endif
+#ifdef MAVLINK_MSG_ID_SENS_POWER
+MAVLINK_MESSAGE_TRAITS(mavlink_sens_power_t, MAVLINK_MSG_ID_SENS_POWER, "SENS_POWER")
+#endif
+#ifdef MAVLINK_MSG_ID_SENSOR_AIRFLOW_ANGLES
+MAVLINK_MESSAGE_TRAITS(mavlink_sensor_airflow_angles_t, MAVLINK_MSG_ID_SENSOR_AIRFLOW_ANGLES, "SENSOR_AIRFLOW_ANGLES")
+#endif
+#ifdef MAVLINK_MSG_ID_SENSOR_OFFSETS
+MAVLINK_MESSAGE_TRAITS(mavlink_sensor_offsets_t, MAVLINK_MSG_ID_SENSOR_OFFSETS, "SENSOR_OFFSETS")
+#endif
+#ifdef MAVLINK_MSG_ID_SENSORPOD_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_sensorpod_status_t, MAVLINK_MSG_ID_SENSORPOD_STATUS, "SENSORPOD_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_CONTROL
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_control_t, MAVLINK_MSG_ID_SERIAL_CONTROL, "SERIAL_CONTROL")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F13
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f13_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F13, "SERIAL_UDB_EXTRA_F13")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f14_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, "SERIAL_UDB_EXTRA_F14")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F15
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f15_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F15, "SERIAL_UDB_EXTRA_F15")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F16
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f16_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F16, "SERIAL_UDB_EXTRA_F16")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F17
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f17_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F17, "SERIAL_UDB_EXTRA_F17")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F18
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f18_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F18, "SERIAL_UDB_EXTRA_F18")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F19
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f19_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F19, "SERIAL_UDB_EXTRA_F19")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F20
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f20_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F20, "SERIAL_UDB_EXTRA_F20")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F21
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f21_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F21, "SERIAL_UDB_EXTRA_F21")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F22
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f22_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F22, "SERIAL_UDB_EXTRA_F22")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f2_a_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, "SERIAL_UDB_EXTRA_F2_A")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f2_b_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, "SERIAL_UDB_EXTRA_F2_B")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f4_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, "SERIAL_UDB_EXTRA_F4")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f5_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5, "SERIAL_UDB_EXTRA_F5")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f6_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6, "SERIAL_UDB_EXTRA_F6")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f7_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7, "SERIAL_UDB_EXTRA_F7")
+#endif
+#ifdef MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8
+MAVLINK_MESSAGE_TRAITS(mavlink_serial_udb_extra_f8_t, MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, "SERIAL_UDB_EXTRA_F8")
+#endif
+#ifdef MAVLINK_MSG_ID_SERVO_OUTPUT_RAW
+MAVLINK_MESSAGE_TRAITS(mavlink_servo_output_raw_t, MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, "SERVO_OUTPUT_RAW")
+#endif
+#ifdef MAVLINK_MSG_ID_SET_ACTUATOR_CONTROL_TARGET
+MAVLINK_MESSAGE_TRAITS(mavlink_set_actuator_control_target_t, MAVLINK_MSG_ID_SET_ACTUATOR_CONTROL_TARGET, "SET_ACTUATOR_CONTROL_TARGET")
+#endif
+#ifdef MAVLINK_MSG_ID_SET_ATTITUDE_TARGET
+MAVLINK_MESSAGE_TRAITS(mavlink_set_attitude_target_t, MAVLINK_MSG_ID_SET_ATTITUDE_TARGET, "SET_ATTITUDE_TARGET")
+#endif
+#ifdef MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN
+MAVLINK_MESSAGE_TRAITS(mavlink_set_gps_global_origin_t, MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN, "SET_GPS_GLOBAL_ORIGIN")
+#endif
+#ifdef MAVLINK_MSG_ID_SET_HOME_POSITION
+MAVLINK_MESSAGE_TRAITS(mavlink_set_home_position_t, MAVLINK_MSG_ID_SET_HOME_POSITION, "SET_HOME_POSITION")
+#endif
+#ifdef MAVLINK_MSG_ID_SET_MAG_OFFSETS
+MAVLINK_MESSAGE_TRAITS(mavlink_set_mag_offsets_t, MAVLINK_MSG_ID_SET_MAG_OFFSETS, "SET_MAG_OFFSETS")
+#endif
+#ifdef MAVLINK_MSG_ID_SET_MODE
+MAVLINK_MESSAGE_TRAITS(mavlink_set_mode_t, MAVLINK_MSG_ID_SET_MODE, "SET_MODE")
+#endif
+#ifdef MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT
+MAVLINK_MESSAGE_TRAITS(mavlink_set_position_target_global_int_t, MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT, "SET_POSITION_TARGET_GLOBAL_INT")
+#endif
+#ifdef MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED
+MAVLINK_MESSAGE_TRAITS(mavlink_set_position_target_local_ned_t, MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED, "SET_POSITION_TARGET_LOCAL_NED")
+#endif
+#ifdef MAVLINK_MSG_ID_SET_VELOCITY_LIMITS
+MAVLINK_MESSAGE_TRAITS(mavlink_set_velocity_limits_t, MAVLINK_MSG_ID_SET_VELOCITY_LIMITS, "SET_VELOCITY_LIMITS")
+#endif
+#ifdef MAVLINK_MSG_ID_SETUP_SIGNING
+MAVLINK_MESSAGE_TRAITS(mavlink_setup_signing_t, MAVLINK_MSG_ID_SETUP_SIGNING, "SETUP_SIGNING")
+#endif
+#ifdef MAVLINK_MSG_ID_SIM_STATE
+MAVLINK_MESSAGE_TRAITS(mavlink_sim_state_t, MAVLINK_MSG_ID_SIM_STATE, "SIM_STATE")
+#endif
+#ifdef MAVLINK_MSG_ID_SIMSTATE
+MAVLINK_MESSAGE_TRAITS(mavlink_simstate_t, MAVLINK_MSG_ID_SIMSTATE, "SIMSTATE")
+#endif
+#ifdef MAVLINK_MSG_ID_STATUSTEXT
+MAVLINK_MESSAGE_TRAITS(mavlink_statustext_t, MAVLINK_MSG_ID_STATUSTEXT, "STATUSTEXT")
+#endif
+#ifdef MAVLINK_MSG_ID_STORAGE_INFORMATION
+MAVLINK_MESSAGE_TRAITS(mavlink_storage_information_t, MAVLINK_MSG_ID_STORAGE_INFORMATION, "STORAGE_INFORMATION")
+#endif
+#ifdef MAVLINK_MSG_ID_STORM32_GIMBAL_MANAGER_CONTROL_PITCHYAW
+MAVLINK_MESSAGE_TRAITS(mavlink_storm32_gimbal_manager_control_pitchyaw_t, MAVLINK_MSG_ID_STORM32_GIMBAL_MANAGER_CONTROL_PITCHYAW, "STORM32_GIMBAL_MANAGER_CONTROL_PITCHYAW")
+#endif
+#ifdef MAVLINK_MSG_ID_STORM32_GIMBAL_MANAGER_CONTROL
+MAVLINK_MESSAGE_TRAITS(mavlink_storm32_gimbal_manager_control_t, MAVLINK_MSG_ID_STORM32_GIMBAL_MANAGER_CONTROL, "STORM32_GIMBAL_MANAGER_CONTROL")
+#endif
+#ifdef MAVLINK_MSG_ID_STORM32_GIMBAL_MANAGER_CORRECT_ROLL
+MAVLINK_MESSAGE_TRAITS(mavlink_storm32_gimbal_manager_correct_roll_t, MAVLINK_MSG_ID_STORM32_GIMBAL_MANAGER_CORRECT_ROLL, "STORM32_GIMBAL_MANAGER_CORRECT_ROLL")
+#endif
+#ifdef MAVLINK_MSG_ID_STORM32_GIMBAL_MANAGER_INFORMATION
+MAVLINK_MESSAGE_TRAITS(mavlink_storm32_gimbal_manager_information_t, MAVLINK_MSG_ID_STORM32_GIMBAL_MANAGER_INFORMATION, "STORM32_GIMBAL_MANAGER_INFORMATION")
+#endif
+#ifdef MAVLINK_MSG_ID_STORM32_GIMBAL_MANAGER_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_storm32_gimbal_manager_status_t, MAVLINK_MSG_ID_STORM32_GIMBAL_MANAGER_STATUS, "STORM32_GIMBAL_MANAGER_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_SUPPORTED_TUNES
+MAVLINK_MESSAGE_TRAITS(mavlink_supported_tunes_t, MAVLINK_MSG_ID_SUPPORTED_TUNES, "SUPPORTED_TUNES")
+#endif
+#ifdef MAVLINK_MSG_ID_SYS_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_sys_status_t, MAVLINK_MSG_ID_SYS_STATUS, "SYS_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_SYSTEM_TIME
+MAVLINK_MESSAGE_TRAITS(mavlink_system_time_t, MAVLINK_MSG_ID_SYSTEM_TIME, "SYSTEM_TIME")
+#endif
+#ifdef MAVLINK_MSG_ID_TARGET_ABSOLUTE
+MAVLINK_MESSAGE_TRAITS(mavlink_target_absolute_t, MAVLINK_MSG_ID_TARGET_ABSOLUTE, "TARGET_ABSOLUTE")
+#endif
+#ifdef MAVLINK_MSG_ID_TARGET_RELATIVE
+MAVLINK_MESSAGE_TRAITS(mavlink_target_relative_t, MAVLINK_MSG_ID_TARGET_RELATIVE, "TARGET_RELATIVE")
+#endif
+#ifdef MAVLINK_MSG_ID_TERRAIN_CHECK
+MAVLINK_MESSAGE_TRAITS(mavlink_terrain_check_t, MAVLINK_MSG_ID_TERRAIN_CHECK, "TERRAIN_CHECK")
+#endif
+#ifdef MAVLINK_MSG_ID_TERRAIN_DATA
+MAVLINK_MESSAGE_TRAITS(mavlink_terrain_data_t, MAVLINK_MSG_ID_TERRAIN_DATA, "TERRAIN_DATA")
+#endif
+#ifdef MAVLINK_MSG_ID_TERRAIN_REPORT
+MAVLINK_MESSAGE_TRAITS(mavlink_terrain_report_t, MAVLINK_MSG_ID_TERRAIN_REPORT, "TERRAIN_REPORT")
+#endif
+#ifdef MAVLINK_MSG_ID_TERRAIN_REQUEST
+MAVLINK_MESSAGE_TRAITS(mavlink_terrain_request_t, MAVLINK_MSG_ID_TERRAIN_REQUEST, "TERRAIN_REQUEST")
+#endif
+#ifdef MAVLINK_MSG_ID_TEST_TYPES
+MAVLINK_MESSAGE_TRAITS(mavlink_test_types_t, MAVLINK_MSG_ID_TEST_TYPES, "TEST_TYPES")
+#endif
+#ifdef MAVLINK_MSG_ID_TIME_ESTIMATE_TO_TARGET
+MAVLINK_MESSAGE_TRAITS(mavlink_time_estimate_to_target_t, MAVLINK_MSG_ID_TIME_ESTIMATE_TO_TARGET, "TIME_ESTIMATE_TO_TARGET")
+#endif
+#ifdef MAVLINK_MSG_ID_TIMESYNC
+MAVLINK_MESSAGE_TRAITS(mavlink_timesync_t, MAVLINK_MSG_ID_TIMESYNC, "TIMESYNC")
+#endif
+#ifdef MAVLINK_MSG_ID_TRAJECTORY_REPRESENTATION_BEZIER
+MAVLINK_MESSAGE_TRAITS(mavlink_trajectory_representation_bezier_t, MAVLINK_MSG_ID_TRAJECTORY_REPRESENTATION_BEZIER, "TRAJECTORY_REPRESENTATION_BEZIER")
+#endif
+#ifdef MAVLINK_MSG_ID_TRAJECTORY_REPRESENTATION_WAYPOINTS
+MAVLINK_MESSAGE_TRAITS(mavlink_trajectory_representation_waypoints_t, MAVLINK_MSG_ID_TRAJECTORY_REPRESENTATION_WAYPOINTS, "TRAJECTORY_REPRESENTATION_WAYPOINTS")
+#endif
+#ifdef MAVLINK_MSG_ID_TUNNEL
+MAVLINK_MESSAGE_TRAITS(mavlink_tunnel_t, MAVLINK_MSG_ID_TUNNEL, "TUNNEL")
+#endif
+#ifdef MAVLINK_MSG_ID_UALBERTA_SYS_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_ualberta_sys_status_t, MAVLINK_MSG_ID_UALBERTA_SYS_STATUS, "UALBERTA_SYS_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_UAVCAN_NODE_INFO
+MAVLINK_MESSAGE_TRAITS(mavlink_uavcan_node_info_t, MAVLINK_MSG_ID_UAVCAN_NODE_INFO, "UAVCAN_NODE_INFO")
+#endif
+#ifdef MAVLINK_MSG_ID_UAVCAN_NODE_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_uavcan_node_status_t, MAVLINK_MSG_ID_UAVCAN_NODE_STATUS, "UAVCAN_NODE_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_UAVIONIX_ADSB_OUT_CFG
+MAVLINK_MESSAGE_TRAITS(mavlink_uavionix_adsb_out_cfg_t, MAVLINK_MSG_ID_UAVIONIX_ADSB_OUT_CFG, "UAVIONIX_ADSB_OUT_CFG")
+#endif
+#ifdef MAVLINK_MSG_ID_UAVIONIX_ADSB_OUT_DYNAMIC
+MAVLINK_MESSAGE_TRAITS(mavlink_uavionix_adsb_out_dynamic_t, MAVLINK_MSG_ID_UAVIONIX_ADSB_OUT_DYNAMIC, "UAVIONIX_ADSB_OUT_DYNAMIC")
+#endif
+#ifdef MAVLINK_MSG_ID_UAVIONIX_ADSB_TRANSCEIVER_HEALTH_REPORT
+MAVLINK_MESSAGE_TRAITS(mavlink_uavionix_adsb_transceiver_health_report_t, MAVLINK_MSG_ID_UAVIONIX_ADSB_TRANSCEIVER_HEALTH_REPORT, "UAVIONIX_ADSB_TRANSCEIVER_HEALTH_REPORT")
+#endif
+#ifdef MAVLINK_MSG_ID_UTM_GLOBAL_POSITION
+MAVLINK_MESSAGE_TRAITS(mavlink_utm_global_position_t, MAVLINK_MSG_ID_UTM_GLOBAL_POSITION, "UTM_GLOBAL_POSITION")
+#endif
+#ifdef MAVLINK_MSG_ID_V2_EXTENSION
+MAVLINK_MESSAGE_TRAITS(mavlink_v2_extension_t, MAVLINK_MSG_ID_V2_EXTENSION, "V2_EXTENSION")
+#endif
+#ifdef MAVLINK_MSG_ID_VELOCITY_LIMITS
+MAVLINK_MESSAGE_TRAITS(mavlink_velocity_limits_t, MAVLINK_MSG_ID_VELOCITY_LIMITS, "VELOCITY_LIMITS")
+#endif
+#ifdef MAVLINK_MSG_ID_VFR_HUD
+MAVLINK_MESSAGE_TRAITS(mavlink_vfr_hud_t, MAVLINK_MSG_ID_VFR_HUD, "VFR_HUD")
+#endif
+#ifdef MAVLINK_MSG_ID_VIBRATION
+MAVLINK_MESSAGE_TRAITS(mavlink_vibration_t, MAVLINK_MSG_ID_VIBRATION, "VIBRATION")
+#endif
+#ifdef MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE
+MAVLINK_MESSAGE_TRAITS(mavlink_vicon_position_estimate_t, MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, "VICON_POSITION_ESTIMATE")
+#endif
+#ifdef MAVLINK_MSG_ID_VIDEO_STREAM_INFORMATION
+MAVLINK_MESSAGE_TRAITS(mavlink_video_stream_information_t, MAVLINK_MSG_ID_VIDEO_STREAM_INFORMATION, "VIDEO_STREAM_INFORMATION")
+#endif
+#ifdef MAVLINK_MSG_ID_VIDEO_STREAM_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_video_stream_status_t, MAVLINK_MSG_ID_VIDEO_STREAM_STATUS, "VIDEO_STREAM_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_VISION_POSITION_DELTA
+MAVLINK_MESSAGE_TRAITS(mavlink_vision_position_delta_t, MAVLINK_MSG_ID_VISION_POSITION_DELTA, "VISION_POSITION_DELTA")
+#endif
+#ifdef MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE
+MAVLINK_MESSAGE_TRAITS(mavlink_vision_position_estimate_t, MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, "VISION_POSITION_ESTIMATE")
+#endif
+#ifdef MAVLINK_MSG_ID_VISION_SPEED_ESTIMATE
+MAVLINK_MESSAGE_TRAITS(mavlink_vision_speed_estimate_t, MAVLINK_MSG_ID_VISION_SPEED_ESTIMATE, "VISION_SPEED_ESTIMATE")
+#endif
+#ifdef MAVLINK_MSG_ID_WATER_DEPTH
+MAVLINK_MESSAGE_TRAITS(mavlink_water_depth_t, MAVLINK_MSG_ID_WATER_DEPTH, "WATER_DEPTH")
+#endif
+#ifdef MAVLINK_MSG_ID_WHEEL_DISTANCE
+MAVLINK_MESSAGE_TRAITS(mavlink_wheel_distance_t, MAVLINK_MSG_ID_WHEEL_DISTANCE, "WHEEL_DISTANCE")
+#endif
+#ifdef MAVLINK_MSG_ID_WIFI_CONFIG_AP
+MAVLINK_MESSAGE_TRAITS(mavlink_wifi_config_ap_t, MAVLINK_MSG_ID_WIFI_CONFIG_AP, "WIFI_CONFIG_AP")
+#endif
+#ifdef MAVLINK_MSG_ID_WIFI_NETWORK_INFO
+MAVLINK_MESSAGE_TRAITS(mavlink_wifi_network_info_t, MAVLINK_MSG_ID_WIFI_NETWORK_INFO, "WIFI_NETWORK_INFO")
+#endif
+#ifdef MAVLINK_MSG_ID_WINCH_STATUS
+MAVLINK_MESSAGE_TRAITS(mavlink_winch_status_t, MAVLINK_MSG_ID_WINCH_STATUS, "WINCH_STATUS")
+#endif
+#ifdef MAVLINK_MSG_ID_WIND_COV
+MAVLINK_MESSAGE_TRAITS(mavlink_wind_cov_t, MAVLINK_MSG_ID_WIND_COV, "WIND_COV")
+#endif
+#ifdef MAVLINK_MSG_ID_WIND
+MAVLINK_MESSAGE_TRAITS(mavlink_wind_t, MAVLINK_MSG_ID_WIND, "WIND")
+#endif
+
+#undef MAVLINK_MESSAGE_TRAITS
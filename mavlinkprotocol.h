@@ -0,0 +1,120 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinkprotocol.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：项目使用的 MAVLink 方言
+ *   使用说明 ：所有 MAVLink 相关代码都通过本文件引入 libs/mavlink，
+ *             默认使用 all 方言，可定义 MAVLINK_DIALECT_HEADER 切换。
+ *             mavlink_get_msg_entry 由本文件提供：编译期根据方言的
+ *             MAVLINK_MESSAGE_CRCS 生成按 msgid 直接索引的两级表，
+ *             取代库中的二分查找
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include <mavlink_types.h>
+
+#include <array>
+
+// 替换 mavlink_helpers.h 中的二分查找实现，声明需在库头文件之前
+#define MAVLINK_GET_MSG_ENTRY
+static inline const mavlink_msg_entry_t *mavlink_get_msg_entry(uint32_t msgid);
+
+#ifndef MAVLINK_DIALECT_HEADER
+#define MAVLINK_DIALECT_HEADER <all/mavlink.h>
+#endif
+#include MAVLINK_DIALECT_HEADER
+
+namespace MavlinkMsgTable {
+
+/// 方言中的全部消息条目
+inline constexpr mavlink_msg_entry_t kEntries[] = MAVLINK_MESSAGE_CRCS;
+inline constexpr int kEntryCount = int(sizeof(kEntries) / sizeof(kEntries[0]));
+inline constexpr uint16_t kNone = 0xFFFF;
+
+constexpr uint32_t maxMsgId()
+{
+    uint32_t id = 0;
+    for (const auto &entry : kEntries) {
+        id = entry.msgid > id ? entry.msgid : id;
+    }
+    return id;
+}
+
+inline constexpr uint32_t kMaxMsgId = maxMsgId();
+inline constexpr int kPageCount = int(kMaxMsgId >> 8) + 1;
+
+/// msgid 高位相同的消息共用一页，统计实际用到的页数
+constexpr int usedPages()
+{
+    bool used[kPageCount] = {};
+    int count = 0;
+    for (const auto &entry : kEntries) {
+        if (!used[entry.msgid >> 8]) {
+            used[entry.msgid >> 8] = true;
+            ++count;
+        }
+    }
+    return count;
+}
+
+inline constexpr int kUsedPages = usedPages();
+
+/// 第一级按 msgid >> 8 找到页号（0 表示空页），第二级按低 8 位找到条目下标
+struct Table
+{
+    std::array<uint16_t, kPageCount> pageOf{};
+    std::array<std::array<uint16_t, 256>, kUsedPages> index{};
+};
+
+constexpr Table build()
+{
+    static_assert(kEntryCount < kNone, "too many messages for 16-bit table");
+    Table table;
+    int pages = 0;
+    for (int i = 0; i < kEntryCount; ++i) {
+        const uint32_t msgid = kEntries[i].msgid;
+        uint16_t &page = table.pageOf[msgid >> 8];
+        if (page == 0) {
+            page = uint16_t(++pages);
+            for (auto &slot : table.index[page - 1]) {
+                slot = kNone;
+            }
+        }
+        table.index[page - 1][msgid & 0xFF] = uint16_t(i);
+    }
+    return table;
+}
+
+inline constexpr Table kTable = build();
+
+/// msgid 在 kEntries 中的下标，方言中没有该消息时返回 -1
+constexpr int indexOf(uint32_t msgid)
+{
+    if (msgid > kMaxMsgId) {
+        return -1;
+    }
+    const uint16_t page = kTable.pageOf[msgid >> 8];
+    if (page == 0) {
+        return -1;
+    }
+    const uint16_t index = kTable.index[page - 1][msgid & 0xFF];
+    return index == kNone ? -1 : index;
+}
+
+} // namespace MavlinkMsgTable
+
+static inline const mavlink_msg_entry_t *mavlink_get_msg_entry(uint32_t msgid)
+{
+    const int index = MavlinkMsgTable::indexOf(msgid);
+    return index < 0 ? nullptr : &MavlinkMsgTable::kEntries[index];
+}
@@ -0,0 +1,263 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinkreflect.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MAVLink 消息字段的编译期反射
+ *   使用说明 ：基于方言生成的 MAVLINK_MESSAGE_INFO 在编译期建立字段表，替代运行时遍历
+ *             mavlink_message_info_t 并按类型分支。已知 msgid 时用 forEachField/get 按真实类型读取；
+ *             只在运行时知道 msgid 时用 message(msgid)->extract 调用为该消息生成的函数，一次把全部数值列读成 double，
+ *             函数体是按常量偏移展开的加载序列。payload 须按 max_msg_len 补零（解析器已保证）
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include <stddef.h> // MAVLINK_MESSAGE_INFO 使用 offsetof
+
+#include "mavlinkmessagetraits.h"
+#include "mavlinkprotocol.h"
+
+#include <array>
+#include <string.h>
+#include <string_view>
+#include <utility>
+
+namespace MavlinkReflect {
+
+/// 方言中全部消息的字段描述，顺序为生成器的顺序，不按 msgid 排列
+inline constexpr mavlink_message_info_t kInfo[] = MAVLINK_MESSAGE_INFO;
+inline constexpr int kInfoCount = int(sizeof(kInfo) / sizeof(kInfo[0]));
+
+/// 超过此长度的数组多为原始数据块，不展开为数值列
+inline constexpr unsigned kMaxColumnArray = 32;
+
+template<mavlink_message_type_t Type>
+struct TypeOf;
+template<> struct TypeOf<MAVLINK_TYPE_CHAR> { using type = char; };
+template<> struct TypeOf<MAVLINK_TYPE_UINT8_T> { using type = uint8_t; };
+template<> struct TypeOf<MAVLINK_TYPE_INT8_T> { using type = int8_t; };
+template<> struct TypeOf<MAVLINK_TYPE_UINT16_T> { using type = uint16_t; };
+template<> struct TypeOf<MAVLINK_TYPE_INT16_T> { using type = int16_t; };
+template<> struct TypeOf<MAVLINK_TYPE_UINT32_T> { using type = uint32_t; };
+template<> struct TypeOf<MAVLINK_TYPE_INT32_T> { using type = int32_t; };
+template<> struct TypeOf<MAVLINK_TYPE_UINT64_T> { using type = uint64_t; };
+template<> struct TypeOf<MAVLINK_TYPE_INT64_T> { using type = int64_t; };
+template<> struct TypeOf<MAVLINK_TYPE_FLOAT> { using type = float; };
+template<> struct TypeOf<MAVLINK_TYPE_DOUBLE> { using type = double; };
+
+constexpr unsigned sizeOf(mavlink_message_type_t type)
+{
+    switch (type) {
+    case MAVLINK_TYPE_CHAR:
+    case MAVLINK_TYPE_UINT8_T:
+    case MAVLINK_TYPE_INT8_T:
+        return 1;
+    case MAVLINK_TYPE_UINT16_T:
+    case MAVLINK_TYPE_INT16_T:
+        return 2;
+    case MAVLINK_TYPE_UINT32_T:
+    case MAVLINK_TYPE_INT32_T:
+    case MAVLINK_TYPE_FLOAT:
+        return 4;
+    case MAVLINK_TYPE_UINT64_T:
+    case MAVLINK_TYPE_INT64_T:
+    case MAVLINK_TYPE_DOUBLE:
+        return 8;
+    }
+    return 0;
+}
+
+template<typename T>
+inline T load(const uint8_t *p)
+{
+    T value;
+    memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+/// msgid 在 kInfo 中的下标，方言中没有时返回 -1。线性查找，供编译期使用
+constexpr int infoIndex(uint32_t msgid)
+{
+    for (int i = 0; i < kInfoCount; ++i) {
+        if (kInfo[i].msgid == msgid) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/// 字段下标，没有时返回 -1
+constexpr int fieldIndex(uint32_t msgid, std::string_view name)
+{
+    const int index = infoIndex(msgid);
+    if (index < 0) {
+        return -1;
+    }
+    for (unsigned i = 0; i < kInfo[index].num_fields; ++i) {
+        if (name == kInfo[index].fields[i].name) {
+            return int(i);
+        }
+    }
+    return -1;
+}
+
+template<uint32_t MsgId>
+inline constexpr int kIndexOf = infoIndex(MsgId);
+
+/// 已知 msgid 的字段 Field 的值，数组字段为 std::array
+template<uint32_t MsgId, int Field>
+inline auto get(const uint8_t *payload)
+{
+    static_assert(kIndexOf<MsgId> >= 0, "message not in dialect");
+    constexpr const mavlink_field_info_t &field = kInfo[kIndexOf<MsgId>].fields[Field];
+    static_assert(Field >= 0 && unsigned(Field) < kInfo[kIndexOf<MsgId>].num_fields, "no such field");
+    using T = typename TypeOf<field.type>::type;
+    if constexpr (field.array_length == 0) {
+        return load<T>(payload + field.wire_offset);
+    } else {
+        return load<std::array<T, field.array_length>>(payload + field.wire_offset);
+    }
+}
+
+template<uint32_t MsgId, typename Func, std::size_t... F>
+inline void forEachField(const uint8_t *payload, Func &func, std::index_sequence<F...>)
+{
+    (func(kInfo[kIndexOf<MsgId>].fields[F], get<MsgId, int(F)>(payload)), ...);
+}
+
+/// 按 XML 中的顺序依次调用 func(const mavlink_field_info_t &, value)，value 为字段的真实类型
+template<uint32_t MsgId, typename Func>
+inline void forEachField(const uint8_t *payload, Func &&func)
+{
+    static_assert(kIndexOf<MsgId> >= 0, "message not in dialect");
+    forEachField<MsgId>(payload, func, std::make_index_sequence<kInfo[kIndexOf<MsgId>].num_fields>());
+}
+
+/// 已解码的消息结构体。生成的结构体按线上顺序紧凑排列，字段偏移与 payload 相同
+template<typename T, typename Func>
+inline void forEachField(const T &message, Func &&func)
+{
+    forEachField<MavlinkMessageTraits<T>::id>(reinterpret_cast<const uint8_t *>(&message), func);
+}
+
+/// 一个数值列：标量字段或数组字段的一个元素，字符字段和过长的数组不入列
+struct Column
+{
+    const char *name;
+    int element; // 数组元素下标，标量为 -1
+    mavlink_message_type_t type;
+    unsigned offset;
+};
+
+constexpr bool isColumn(const mavlink_field_info_t &field)
+{
+    return field.type != MAVLINK_TYPE_CHAR && field.array_length <= kMaxColumnArray;
+}
+
+constexpr int columnCount(const mavlink_message_info_t &info)
+{
+    int count = 0;
+    for (unsigned i = 0; i < info.num_fields; ++i) {
+        if (isColumn(info.fields[i])) {
+            count += info.fields[i].array_length == 0 ? 1 : int(info.fields[i].array_length);
+        }
+    }
+    return count;
+}
+
+constexpr int maxColumnCount()
+{
+    int count = 0;
+    for (const auto &info : kInfo) {
+        count = columnCount(info) > count ? columnCount(info) : count;
+    }
+    return count;
+}
+
+/// 单条消息最多的列数，可用作提取缓冲区的大小
+inline constexpr int kMaxColumns = maxColumnCount();
+
+template<int Info>
+constexpr std::array<Column, columnCount(kInfo[Info])> buildColumns()
+{
+    std::array<Column, columnCount(kInfo[Info])> columns{};
+    int n = 0;
+    for (unsigned i = 0; i < kInfo[Info].num_fields; ++i) {
+        const mavlink_field_info_t &field = kInfo[Info].fields[i];
+        if (!isColumn(field)) {
+            continue;
+        }
+        if (field.array_length == 0) {
+            columns[n++] = {field.name, -1, field.type, field.wire_offset};
+            continue;
+        }
+        for (unsigned k = 0; k < field.array_length; ++k) {
+            columns[n++] = {field.name, int(k), field.type, field.wire_offset + k * sizeOf(field.type)};
+        }
+    }
+    return columns;
+}
+
+template<int Info>
+inline constexpr auto kColumns = buildColumns<Info>();
+
+template<int Info, std::size_t... C>
+inline void extract(const uint8_t *payload, double *out, std::index_sequence<C...>)
+{
+    (void) payload; // 没有数值列的消息
+    (void) out;
+    ((out[C] = double(load<typename TypeOf<kColumns<Info>[C].type>::type>(payload + kColumns<Info>[C].offset))), ...);
+}
+
+/// 把第 Info 条消息的全部数值列读入 out[0..columnCount)
+template<int Info>
+void extract(const uint8_t *payload, double *out)
+{
+    extract<Info>(payload, out, std::make_index_sequence<kColumns<Info>.size()>());
+}
+
+using Extractor = void (*)(const uint8_t *payload, double *out);
+
+/// 一条消息的字段描述、数值列和提取函数
+struct Message
+{
+    const mavlink_message_info_t *info = nullptr;
+    const Column *columns = nullptr;
+    int columnCount = 0;
+    Extractor extract = nullptr;
+};
+
+template<std::size_t... I>
+constexpr std::array<Message, MavlinkMsgTable::kEntryCount> buildMessages(std::index_sequence<I...>)
+{
+    constexpr Message messages[] = {{&kInfo[I], kColumns<int(I)>.data(), int(kColumns<int(I)>.size()), &extract<int(I)>}...};
+    std::array<Message, MavlinkMsgTable::kEntryCount> table{};
+    for (const Message &message : messages) {
+        const int index = MavlinkMsgTable::indexOf(message.info->msgid);
+        if (index >= 0) {
+            table[index] = message;
+        }
+    }
+    return table;
+}
+
+/// 下标与 MavlinkMsgTable::kEntries 一致，kInfo 中缺少的消息各项为空
+inline constexpr std::array<Message, MavlinkMsgTable::kEntryCount> kMessages = buildMessages(
+    std::make_index_sequence<kInfoCount>());
+
+/// 运行时按 msgid 查找，方言中没有时返回空
+inline const Message *message(uint32_t msgid)
+{
+    const int index = MavlinkMsgTable::indexOf(msgid);
+    return index < 0 || kMessages[index].info == nullptr ? nullptr : &kMessages[index];
+}
+
+} // namespace MavlinkReflect
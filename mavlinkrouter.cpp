@@ -0,0 +1,222 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinkrouter.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "mavlinkrouter.h"
+#include "linkinterface.h"
+#include "mavlinkencoder.h"
+
+#include <QThread>
+#include <QtAlgorithms>
+
+MavlinkRouter::MavlinkRouter(QObject *parent)
+    : QObject(parent)
+    , m_componentLinks(256 * 256, kNoLink)
+{
+    // 解析结果引用 Route 中的数据，预留空间避免发信号期间扩容
+    m_routes.reserve(kMaxLinks);
+}
+
+MavlinkRouter::~MavlinkRouter()
+{
+    if (m_thread) {
+        m_thread->quit();
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+void MavlinkRouter::startThread()
+{
+    if (m_thread || parent()) {
+        return;
+    }
+    m_thread = new QThread();
+    m_thread->setObjectName("MavlinkRouter");
+    moveToThread(m_thread);
+    m_thread->start();
+}
+
+bool MavlinkRouter::addLink(LinkInterface *link)
+{
+    if (QThread::currentThread() != thread() && thread()->isRunning()) {
+        bool ok = false;
+        QMetaObject::invokeMethod(this, [&]() { ok = addLink(link); }, Qt::BlockingQueuedConnection);
+        return ok;
+    }
+    if (link == nullptr || m_indexes.contains(link)) {
+        return false;
+    }
+
+    int index = -1;
+    for (int i = 0; i < m_routes.size(); ++i) {
+        if (!(m_activeLinks & (quint64(1) << i))) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        if (m_routes.size() >= kMaxLinks) {
+            return false;
+        }
+        m_routes.append(Route());
+        index = m_routes.size() - 1;
+    }
+
+    Route &route = m_routes[index];
+    route.link = link;
+    route.framer = MavlinkFramer();
+    m_indexes.insert(link, index);
+    m_activeLinks |= quint64(1) << index;
+
+    link->metrics().syncDispatch();
+    // 连接和路由不在同一线程时排队投递，数据在路由线程中解析
+    connect(link, &LinkInterface::receiveData, this, &MavlinkRouter::receiveData);
+    connect(link, &QObject::destroyed, this, [this, link]() {
+        // 连接已析构，只清理路由自身的状态
+        const int index = m_indexes.value(link, -1);
+        if (index < 0) {
+            return;
+        }
+        m_indexes.remove(link);
+        m_activeLinks &= ~(quint64(1) << index);
+        forget(index);
+    });
+    return true;
+}
+
+void MavlinkRouter::removeLink(LinkInterface *link)
+{
+    if (QThread::currentThread() != thread() && thread()->isRunning()) {
+        // 之前排队的数据先处理完，之后的数据在 receiveData 中按未知连接丢弃
+        QMetaObject::invokeMethod(this, [=]() { removeLink(link); }, Qt::BlockingQueuedConnection);
+        return;
+    }
+    auto it = m_indexes.find(link);
+    if (it == m_indexes.end()) {
+        return;
+    }
+    const int index = it.value();
+    m_indexes.erase(it);
+    m_activeLinks &= ~(quint64(1) << index);
+    disconnect(link, nullptr, this, nullptr);
+    forget(index);
+}
+
+quint64 MavlinkRouter::parseErrors(const LinkInterface *link) const
+{
+    const int index = m_indexes.value(link, -1);
+    return index < 0 ? 0 : m_routes[index].framer.parseErrors();
+}
+
+void MavlinkRouter::forget(int index)
+{
+    const quint64 mask = ~(quint64(1) << index);
+    for (auto &links : m_systemLinks) {
+        links &= mask;
+    }
+    for (auto &link : m_componentLinks) {
+        if (link == index) {
+            link = kNoLink;
+        }
+    }
+    m_routes[index].link.clear();
+    m_routes[index].framer = MavlinkFramer();
+}
+
+void MavlinkRouter::receiveData(const LinkInterface *link, const QByteArray &data)
+{
+    const int index = m_indexes.value(link, -1);
+    if (index < 0) {
+        return; // 已移出路由，队列中残留的数据
+    }
+
+    Route &route = m_routes[index];
+    LinkInterface *source = route.link.data();
+    if (source == nullptr) {
+        // 连接已析构而排队的 destroyed 处理还没执行，残留的数据直接丢弃，
+        // 不发出 link 为空的 messageReceived
+        return;
+    }
+    source->metrics().dispatched();
+    const quint64 parseErrors = route.framer.parseErrors();
+    const quint64 crcErrors = route.framer.crcErrors();
+    const auto &frames = route.framer.parse(data);
+    source->metrics().parsed(frames.size(),
+                             route.framer.parseErrors() - parseErrors,
+                             route.framer.crcErrors() - crcErrors);
+    for (const auto &message : frames) {
+        learn(index, message);
+        emit messageReceived(source, message);
+        if (m_forwarding) {
+            forward(index, message);
+        }
+    }
+}
+
+void MavlinkRouter::learn(int index, const mavlink_message_t &message)
+{
+    m_systemLinks[message.sysid] |= quint64(1) << index;
+    m_componentLinks[message.sysid * 256 + message.compid] = quint8(index);
+}
+
+quint64 MavlinkRouter::targets(int index, const mavlink_message_t &message) const
+{
+    const quint64 others = m_activeLinks & ~(quint64(1) << index);
+
+    // 帧中已补零到最大长度，按偏移读取目标地址是安全的
+    const mavlink_msg_entry_t *entry = mavlink_get_msg_entry(message.msgid);
+    if (entry == nullptr || !(entry->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_SYSTEM)) {
+        return others;
+    }
+    const char *payload = _MAV_PAYLOAD(&message);
+    const quint8 targetSystem = quint8(payload[entry->target_system_ofs]);
+    if (targetSystem == 0) {
+        return others;
+    }
+
+    if (entry->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_COMPONENT) {
+        const quint8 targetComponent = quint8(payload[entry->target_component_ofs]);
+        const quint8 link = targetComponent == 0
+                                ? kNoLink
+                                : m_componentLinks[targetSystem * 256 + targetComponent];
+        if (link != kNoLink) {
+            return others & (quint64(1) << link);
+        }
+    }
+    // 组件未知时发往见过该系统的所有连接
+    return others & m_systemLinks[targetSystem];
+}
+
+void MavlinkRouter::forward(int index, const mavlink_message_t &message)
+{
+    quint64 links = targets(index, message);
+    if (links == 0) {
+        if (m_activeLinks & ~(quint64(1) << index)) {
+            ++m_unroutable;
+        }
+        return;
+    }
+
+    while (links) {
+        const int target = qCountTrailingZeroBits(links);
+        links &= links - 1;
+        LinkInterface *link = m_routes[target].link.data();
+        if (link && MavlinkEncoder::resend(link, message)) {
+            ++m_forwarded;
+        }
+    }
+}
@@ -0,0 +1,97 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinkrouter.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MAVLink 路由，在多个连接之间按 sysid/compid 转发
+ *   使用说明 ：addLink 后由路由为该连接维护独立的解析状态，不使用
+ *             mavlink_get_channel_status 中的静态通道数组。
+ *             收到的帧记录来源连接，再按目标 sysid/compid 转发到其它连接：
+ *             广播发往全部连接，已知目标只发往见过该目标的连接，未知目标丢弃
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "mavlinkframer.h"
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+class LinkInterface;
+class QThread;
+
+class MavlinkRouter : public QObject
+{
+    Q_OBJECT
+public:
+    /// 连接数量上限，受 quint64 位掩码限制
+    static constexpr int kMaxLinks = 64;
+
+    explicit MavlinkRouter(QObject *parent = nullptr);
+    ~MavlinkRouter();
+
+    /// 把路由移到独立线程：解析、分发器回调和转发都在该线程中完成，界面线程只接收
+    /// 回调处理后的结果（如 TelemetryModel 按帧发布的值）。路由不能有父对象，
+    /// 分发器的处理函数要在调用之前注册，之后 MavlinkDispatcher 只能在路由线程中访问
+    void startThread();
+
+    /// 加入路由，连接数已满或重复加入时返回 false。任意线程可调用，路由线程运行时阻塞到执行完成
+    bool addLink(LinkInterface *link);
+    /// 移出路由并清除该连接学到的地址。任意线程可调用，返回后不会再处理该连接的数据
+    void removeLink(LinkInterface *link);
+
+    /// 是否在连接之间转发，关闭后仍解析并发出 messageReceived
+    void setForwarding(bool enable) { m_forwarding = enable; }
+    bool forwarding() const { return m_forwarding; }
+
+    /// 转发到其它连接的帧数（每个目标连接计一次，发送队列满而丢弃的不计）
+    quint64 forwarded() const { return m_forwarded; }
+    /// 目标未知被丢弃的帧数
+    quint64 unroutable() const { return m_unroutable; }
+    /// 某个连接的解析错误数，连接不在路由中时返回 0
+    quint64 parseErrors(const LinkInterface *link) const;
+
+signals:
+    /// 每个解析成功的帧，message 只在槽函数内有效，只能使用直接连接。link 不会为空：
+    /// 连接析构后队列中残留的数据被丢弃
+    void messageReceived(LinkInterface *link, const mavlink_message_t &message);
+
+private:
+    struct Route
+    {
+        QPointer<LinkInterface> link;
+        MavlinkFramer framer; // 每个连接独立的解析状态
+    };
+
+    void receiveData(const LinkInterface *link, const QByteArray &data);
+    void learn(int index, const mavlink_message_t &message);
+    void forward(int index, const mavlink_message_t &message);
+    /// 按目标计算应发往的连接掩码，不含来源连接
+    quint64 targets(int index, const mavlink_message_t &message) const;
+    void forget(int index);
+
+    QThread *m_thread = nullptr;
+
+    QVector<Route> m_routes; // 下标即连接编号，空位可复用
+    QHash<const LinkInterface *, int> m_indexes;
+    quint64 m_activeLinks = 0;
+
+    // 地址表直接按 sysid、sysid * 256 + compid 下标访问
+    quint64 m_systemLinks[256] = {};          // 见过该 sysid 的连接掩码
+    QVector<quint8> m_componentLinks;         // 最近发出该组件帧的连接编号，kNoLink 表示未知
+    static constexpr quint8 kNoLink = 0xFF;
+
+    bool m_forwarding = true;
+    quint64 m_forwarded = 0;
+    quint64 m_unroutable = 0;
+};
@@ -0,0 +1,621 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinksignature.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "mavlinksignature.h"
+#include "mavlinksigningstreams.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define MAVLINK_SIGNATURE_SHANI 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SHANI_TARGET
+#define AVX2_TARGET
+#else
+#include <cpuid.h>
+#define SHANI_TARGET __attribute__((target("sha,sse4.1")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+// 密钥 32 + 帧头 10 + 负载 255 + CRC 2 + link_id 与时间戳 7，补位后最多 5 个块
+constexpr int kMaxBlocks = 5;
+constexpr int kLanes = 8;   // AVX2 一次并行计算的帧数
+constexpr int kWindow = 64; // 批量校验时一次按块数排序的帧数
+
+alignas(16) const uint32_t kRound[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+const uint32_t kInitial[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                              0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+inline uint32_t rotr(uint32_t x, int n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+void compressScalar(uint32_t state[8], const uint8_t *data, int blocks)
+{
+    for (; blocks > 0; --blocks, data += 64) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = uint32_t(data[i * 4]) << 24 | uint32_t(data[i * 4 + 1]) << 16
+                   | uint32_t(data[i * 4 + 2]) << 8 | data[i * 4 + 3];
+        }
+        for (int i = 16; i < 64; ++i) {
+            const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i) {
+            const uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g))
+                                + kRound[i] + w[i];
+            const uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+#ifdef MAVLINK_SIGNATURE_SHANI
+SHANI_TARGET void compressShaNi(uint32_t state[8], const uint8_t *data, int blocks)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // 状态字重排为 sha256rnds2 需要的 ABEF/CDGH
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0xB1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state + 4)), 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    for (; blocks > 0; --blocks, data += 64) {
+        const __m128i abef = state0;
+        const __m128i cdgh = state1;
+        __m128i w[4];
+        for (int i = 0; i < 16; ++i) {
+            __m128i cur;
+            if (i < 4) {
+                cur = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i * 16)), mask);
+            } else {
+                // w[i & 3] 为 W[i-4]，依次往后为 W[i-3]、W[i-2]、W[i-1]
+                cur = _mm_sha256msg1_epu32(w[i & 3], w[(i + 1) & 3]);
+                cur = _mm_add_epi32(cur, _mm_alignr_epi8(w[(i + 3) & 3], w[(i + 2) & 3], 4));
+                cur = _mm_sha256msg2_epu32(cur, w[(i + 3) & 3]);
+            }
+            w[i & 3] = cur;
+            __m128i msg = _mm_add_epi32(cur, _mm_load_si128(reinterpret_cast<const __m128i *>(kRound + i * 4)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+        }
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state + 4), state1);
+}
+
+bool cpuHasShaNi()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuidex(info, 7, 0);
+    const bool sha = info[1] & (1 << 29);
+    __cpuid(info, 1);
+    return sha && (info[2] & (1 << 19));
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) || !(ebx & (1 << 29))) {
+        return false;
+    }
+    return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & (1 << 19));
+#endif
+}
+
+bool cpuHasAvx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return info[1] & (1 << 5);
+#else
+    unsigned int eax, ebx, ecx, edx;
+    // 还要求操作系统保存 YMM 寄存器
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & (1 << 27))) {
+        return false;
+    }
+    unsigned int xcr0, xcr0High;
+    __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+    if ((xcr0 & 6) != 6) {
+        return false;
+    }
+    return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & (1 << 5));
+#endif
+}
+
+AVX2_TARGET inline __m256i rotr8(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+/// 8 路并行压缩：每一路是一帧的签名输入，从第 0 块开始，lane 的块数为 blocks[lane]。
+/// 只输出签名用到的前两个状态字，out[lane][0..1]
+AVX2_TARGET void compressAvx2(const uint8_t *const data[kLanes], const int blocks[kLanes], uint32_t out[kLanes][2])
+{
+    int maxBlocks = 0;
+    for (int lane = 0; lane < kLanes; ++lane) {
+        maxBlocks = blocks[lane] > maxBlocks ? blocks[lane] : maxBlocks;
+    }
+
+    __m256i state[8];
+    for (int i = 0; i < 8; ++i) {
+        state[i] = _mm256_set1_epi32(int(kInitial[i]));
+    }
+
+    for (int block = 0; block < maxBlocks; ++block) {
+        __m256i w[16];
+        for (int i = 0; i < 16; ++i) {
+            uint32_t words[kLanes];
+            for (int lane = 0; lane < kLanes; ++lane) {
+                const uint8_t *p = data[lane] + block * 64 + i * 4;
+                words[lane] = uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | p[3];
+            }
+            w[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words));
+        }
+
+        __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+        __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i) {
+            __m256i wi;
+            if (i < 16) {
+                wi = w[i];
+            } else {
+                // w 为 16 项的环形表，w[i & 15] 中原为 W[i-16]
+                const __m256i w15 = w[(i - 15) & 15];
+                const __m256i w2 = w[(i - 2) & 15];
+                const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr8(w15, 7), rotr8(w15, 18)),
+                                                    _mm256_srli_epi32(w15, 3));
+                const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr8(w2, 17), rotr8(w2, 19)),
+                                                    _mm256_srli_epi32(w2, 10));
+                wi = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], s0), _mm256_add_epi32(w[(i - 7) & 15], s1));
+                w[i & 15] = wi;
+            }
+
+            const __m256i sum1 = _mm256_xor_si256(_mm256_xor_si256(rotr8(e, 6), rotr8(e, 11)), rotr8(e, 25));
+            const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+            const __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, sum1),
+                                                _mm256_add_epi32(_mm256_add_epi32(ch, wi),
+                                                                 _mm256_set1_epi32(int(kRound[i]))));
+            const __m256i sum0 = _mm256_xor_si256(_mm256_xor_si256(rotr8(a, 2), rotr8(a, 13)), rotr8(a, 22));
+            const __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+            h = g;
+            g = f;
+            f = e;
+            e = _mm256_add_epi32(d, t1);
+            d = c;
+            c = b;
+            b = a;
+            a = _mm256_add_epi32(t1, _mm256_add_epi32(sum0, maj));
+        }
+        state[0] = _mm256_add_epi32(state[0], a);
+        state[1] = _mm256_add_epi32(state[1], b);
+        state[2] = _mm256_add_epi32(state[2], c);
+        state[3] = _mm256_add_epi32(state[3], d);
+        state[4] = _mm256_add_epi32(state[4], e);
+        state[5] = _mm256_add_epi32(state[5], f);
+        state[6] = _mm256_add_epi32(state[6], g);
+        state[7] = _mm256_add_epi32(state[7], h);
+
+        // 块数较少的路在最后一块之后取出结果，之后的计算结果不再使用
+        uint32_t first[kLanes], second[kLanes];
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(first), state[0]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(second), state[1]);
+        for (int lane = 0; lane < kLanes; ++lane) {
+            if (blocks[lane] == block + 1) {
+                out[lane][0] = first[lane];
+                out[lane][1] = second[lane];
+            }
+        }
+    }
+}
+#endif
+
+using Compress = void (*)(uint32_t state[8], const uint8_t *data, int blocks);
+
+Compress compress = compressScalar;
+bool useAvx2 = false; // 批量校验使用 8 路 AVX2，单帧仍用 compress
+
+/// 优先 SHA-NI；没有 SHA 指令时批量校验用 AVX2 多路并行
+bool selectBackend(const char *name)
+{
+#ifdef MAVLINK_SIGNATURE_SHANI
+    const bool shaNi = cpuHasShaNi();
+    const bool avx2 = cpuHasAvx2();
+#else
+    const bool shaNi = false;
+    const bool avx2 = false;
+#endif
+    if (name == nullptr) {
+        name = shaNi ? "sha-ni" : avx2 ? "avx2" : "scalar";
+    }
+    if (strcmp(name, "scalar") == 0) {
+        compress = compressScalar;
+        useAvx2 = false;
+        return true;
+    }
+#ifdef MAVLINK_SIGNATURE_SHANI
+    if (strcmp(name, "sha-ni") == 0 && shaNi) {
+        compress = compressShaNi;
+        useAvx2 = false;
+        return true;
+    }
+    if (strcmp(name, "avx2") == 0 && avx2) {
+        compress = compressScalar;
+        useAvx2 = true;
+        return true;
+    }
+#endif
+    return false;
+}
+
+const bool backendSelected = selectBackend(nullptr);
+
+/// 对 buffer 中已写入到 p 的数据补齐 SHA-256 填充，返回块数
+int pad(uint8_t *buffer, uint8_t *p)
+{
+    const uint64_t bits = uint64_t(p - buffer) * 8;
+    *p++ = 0x80;
+    const int blocks = int((p - buffer) + 8 + 63) / 64;
+    uint8_t *end = buffer + blocks * 64;
+    memset(p, 0, end - 8 - p);
+    for (int i = 0; i < 8; ++i) {
+        end[-1 - i] = uint8_t(bits >> (i * 8));
+    }
+    return blocks;
+}
+
+/// 摘要前两个状态字中的前 6 字节即签名
+void toSignature(const uint32_t state[2], uint8_t out[6])
+{
+    for (int i = 0; i < 6; ++i) {
+        out[i] = uint8_t(state[i / 4] >> (24 - (i % 4) * 8));
+    }
+}
+
+/// buffer 中已写入到 p 的数据补齐 SHA-256 填充后压缩，输出摘要的前 6 字节
+void digest48(uint8_t *buffer, uint8_t *p, uint8_t out[6])
+{
+    const int blocks = pad(buffer, p);
+    uint32_t state[8];
+    memcpy(state, kInitial, sizeof(state));
+    compress(state, buffer, blocks);
+    toSignature(state, out);
+}
+
+/// 写入签名输入：密钥 + 帧头 + 负载 + CRC + link_id + 时间戳，返回写入结束的位置
+uint8_t *messageInput(const uint8_t key[32], const mavlink_message_t *message, uint8_t *buffer)
+{
+    uint8_t *p = buffer;
+    memcpy(p, key, 32);
+    p += 32;
+    memcpy(p, &message->magic, MAVLINK_NUM_HEADER_BYTES);
+    p += MAVLINK_NUM_HEADER_BYTES;
+    memcpy(p, _MAV_PAYLOAD(message), message->len);
+    p += message->len;
+    memcpy(p, message->ck, 2);
+    p += 2;
+    memcpy(p, message->signature, 7);
+    return p + 7;
+}
+
+/// 同上，帧头、负载、CRC 与签名块前 7 字节在连续的帧中本就相邻
+uint8_t *frameInput(const uint8_t key[32], const uint8_t *frame, uint8_t *buffer)
+{
+    const int size = MAVLINK_NUM_HEADER_BYTES + frame[1] + MAVLINK_NUM_CHECKSUM_BYTES + 7;
+    memcpy(buffer, key, 32);
+    memcpy(buffer + 32, frame, size);
+    return buffer + 32 + size;
+}
+
+/// 计算签名：SHA-256(密钥 + 帧头 + 负载 + CRC + link_id + 时间戳) 的前 6 字节
+void signature48(const uint8_t key[32], const mavlink_message_t *message, uint8_t out[6])
+{
+    alignas(16) uint8_t buffer[kMaxBlocks * 64];
+    digest48(buffer, messageInput(key, message, buffer), out);
+}
+
+/// 批量比较签名。input(i, buffer) 写入第 i 帧的签名输入并返回结束位置，
+/// expected(i) 返回帧中携带的 6 字节签名，len(i) 为负载长度
+template<typename Input, typename Expected, typename Len>
+void verifyBatch(int count, bool *matches, Input input, Expected expected, Len len)
+{
+#ifdef MAVLINK_SIGNATURE_SHANI
+    if (useAvx2) {
+        alignas(32) uint8_t buffers[kLanes][kMaxBlocks * 64];
+        for (int start = 0; start < count; start += kWindow) {
+            const int n = count - start < kWindow ? count - start : kWindow;
+
+            // 按块数排序，同一组中各路的块数接近，少做无用的块
+            int order[kWindow];
+            int blocksOf[kWindow];
+            int bucket[kMaxBlocks + 1] = {};
+            for (int i = 0; i < n; ++i) {
+                blocksOf[i] = (len(start + i) + 60 + 63) / 64; // 与 pad 的结果相同
+                ++bucket[blocksOf[i]];
+            }
+            for (int b = 1, offset = 0; b <= kMaxBlocks; ++b) {
+                const int size = bucket[b];
+                bucket[b] = offset;
+                offset += size;
+            }
+            for (int i = 0; i < n; ++i) {
+                order[bucket[blocksOf[i]]++] = i;
+            }
+
+            for (int first = 0; first < n; first += kLanes) {
+                const int lanes = n - first < kLanes ? n - first : kLanes;
+                const uint8_t *data[kLanes];
+                int blocks[kLanes];
+                for (int lane = 0; lane < lanes; ++lane) {
+                    blocks[lane] = pad(buffers[lane], input(start + order[first + lane], buffers[lane]));
+                    data[lane] = buffers[lane];
+                }
+                // 不满 8 路时空位重复第一路，结果不使用
+                for (int lane = lanes; lane < kLanes; ++lane) {
+                    blocks[lane] = blocks[0];
+                    data[lane] = data[0];
+                }
+                uint32_t out[kLanes][2];
+                compressAvx2(data, blocks, out);
+                for (int lane = 0; lane < lanes; ++lane) {
+                    const int i = start + order[first + lane];
+                    uint8_t signature[6];
+                    toSignature(out[lane], signature);
+                    matches[i] = memcmp(signature, expected(i), 6) == 0;
+                }
+            }
+        }
+        return;
+    }
+#endif
+    alignas(16) uint8_t buffer[kMaxBlocks * 64];
+    for (int i = 0; i < count; ++i) {
+        uint8_t signature[6];
+        digest48(buffer, input(i, buffer), signature);
+        matches[i] = memcmp(signature, expected(i), 6) == 0;
+    }
+}
+} // namespace
+
+bool MavlinkSignature::signatureMatches(const uint8_t key[32], const mavlink_message_t *message)
+{
+    uint8_t signature[6];
+    signature48(key, message, signature);
+    return memcmp(signature, message->signature + 7, 6) == 0;
+}
+
+int MavlinkSignature::sign(mavlink_signing_t *signing, uint8_t *frame, int size)
+{
+    if (signing == nullptr || !(signing->flags & MAVLINK_SIGNING_FLAG_SIGN_OUTGOING)) {
+        return 0;
+    }
+    uint8_t *signature = frame + size;
+    signature[0] = signing->link_id;
+    const uint64_t timestamp = signing->timestamp++;
+    for (int i = 0; i < 6; ++i) {
+        signature[1 + i] = uint8_t(timestamp >> (i * 8));
+    }
+
+    // 帧头、负载、CRC 与签名块前 7 字节在帧中本就连续
+    alignas(16) uint8_t buffer[kMaxBlocks * 64];
+    memcpy(buffer, signing->secret_key, 32);
+    memcpy(buffer + 32, frame, size + 7);
+    digest48(buffer, buffer + 32 + size + 7, signature + 7);
+    return MAVLINK_SIGNATURE_BLOCK_LEN;
+}
+
+void MavlinkSignature::verify(const uint8_t key[32], const mavlink_message_t *const *messages, int count, bool *matches)
+{
+    verifyBatch(
+        count,
+        matches,
+        [&](int i, uint8_t *buffer) { return messageInput(key, messages[i], buffer); },
+        [&](int i) { return messages[i]->signature + 7; },
+        [&](int i) { return int(messages[i]->len); });
+}
+
+void MavlinkSignature::verify(const uint8_t key[32], const uint8_t *const *frames, int count, bool *matches)
+{
+    verifyBatch(
+        count,
+        matches,
+        [&](int i, uint8_t *buffer) { return frameInput(key, frames[i], buffer); },
+        [&](int i) { return frames[i] + MAVLINK_NUM_HEADER_BYTES + frames[i][1] + MAVLINK_NUM_CHECKSUM_BYTES + 7; },
+        [&](int i) { return int(frames[i][1]); });
+}
+
+const char *MavlinkSignature::backend()
+{
+#ifdef MAVLINK_SIGNATURE_SHANI
+    if (compress == compressShaNi) {
+        return "sha-ni";
+    }
+    if (useAvx2) {
+        return "avx2";
+    }
+#endif
+    return "scalar";
+}
+
+bool MavlinkSignature::setBackend(const char *name)
+{
+    return selectBackend(name);
+}
+
+bool MavlinkSignature::check(mavlink_signing_t *signing,
+                             mavlink_signing_streams_t *streams,
+                             const mavlink_message_t *message)
+{
+    if (signing == nullptr) {
+        return true;
+    }
+    return checkStream(signing, streams, message, signatureMatches(signing->secret_key, message));
+}
+
+bool MavlinkSignature::check(mavlink_signing_t *signing,
+                             MavlinkSigningStreams *streams,
+                             const mavlink_message_t *message)
+{
+    if (signing == nullptr) {
+        return true;
+    }
+    const bool signatureOk = signatureMatches(signing->secret_key, message);
+    if (streams == nullptr) {
+        return checkStream(signing, nullptr, message, signatureOk);
+    }
+    return streams->accept(signing, message, signatureOk);
+}
+
+void MavlinkSignature::verify(mavlink_signing_t *signing,
+                              mavlink_signing_streams_t *streams,
+                              const mavlink_message_t *const *messages,
+                              int count,
+                              bool *verdicts)
+{
+    if (signing == nullptr) {
+        for (int i = 0; i < count; ++i) {
+            verdicts[i] = true;
+        }
+        return;
+    }
+    // 签名互不依赖，先全部算完；时间戳检查依赖前面的帧，必须按顺序进行
+    verify(signing->secret_key, messages, count, verdicts);
+    for (int i = 0; i < count; ++i) {
+        verdicts[i] = checkStream(signing, streams, messages[i], verdicts[i]);
+    }
+}
+
+void MavlinkSignature::verify(mavlink_signing_t *signing,
+                              MavlinkSigningStreams *streams,
+                              const mavlink_message_t *const *messages,
+                              int count,
+                              bool *verdicts)
+{
+    if (signing == nullptr || streams == nullptr) {
+        verify(signing, static_cast<mavlink_signing_streams_t *>(nullptr), messages, count, verdicts);
+        return;
+    }
+    verify(signing->secret_key, messages, count, verdicts);
+    for (int i = 0; i < count; ++i) {
+        verdicts[i] = streams->accept(signing, messages[i], verdicts[i]);
+    }
+}
+
+bool MavlinkSignature::checkStream(mavlink_signing_t *signing,
+                                   mavlink_signing_streams_t *streams,
+                                   const mavlink_message_t *message,
+                                   bool signatureOk)
+{
+    // 以下与 mavlink_signature_check 中签名比较之后的部分相同
+    if (!signatureOk) {
+        signing->last_status = MAVLINK_SIGNING_STATUS_BAD_SIGNATURE;
+        return false;
+    }
+
+    const uint8_t *psig = message->signature;
+    const uint8_t linkId = psig[0];
+    uint64_t timestamp = 0;
+    memcpy(&timestamp, psig + 1, 6);
+
+    if (streams == nullptr) {
+        signing->last_status = MAVLINK_SIGNING_STATUS_NO_STREAMS;
+        return false;
+    }
+
+    uint16_t i;
+    for (i = 0; i < streams->num_signing_streams; i++) {
+        if (message->sysid == streams->stream[i].sysid && message->compid == streams->stream[i].compid
+            && linkId == streams->stream[i].link_id) {
+            break;
+        }
+    }
+    if (i == streams->num_signing_streams) {
+        if (streams->num_signing_streams >= MAVLINK_MAX_SIGNING_STREAMS) {
+            signing->last_status = MAVLINK_SIGNING_STATUS_TOO_MANY_STREAMS;
+            return false;
+        }
+        // 新的流只接受一分钟以内的时间戳
+        if (timestamp + 6000 * 1000UL < signing->timestamp) {
+            signing->last_status = MAVLINK_SIGNING_STATUS_OLD_TIMESTAMP;
+            return false;
+        }
+        streams->stream[i].sysid = message->sysid;
+        streams->stream[i].compid = message->compid;
+        streams->stream[i].link_id = linkId;
+        streams->num_signing_streams++;
+    } else {
+        uint64_t last = 0;
+        memcpy(&last, streams->stream[i].timestamp_bytes, 6);
+        if (timestamp <= last) {
+            signing->last_status = MAVLINK_SIGNING_STATUS_REPLAY;
+            return false;
+        }
+    }
+
+    memcpy(streams->stream[i].timestamp_bytes, psig + 1, 6);
+    if (timestamp > signing->timestamp) {
+        signing->timestamp = timestamp;
+    }
+    signing->last_status = MAVLINK_SIGNING_STATUS_OK;
+    return true;
+}
@@ -0,0 +1,75 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinksignature.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MAVLink 签名校验
+ *   使用说明 ：check/verify 的结果与 mavlink_signature_check 逐帧调用完全一致。
+ *             SHA-256 对拼接好的连续内存整块计算，x86 上支持 SHA 指令时
+ *             使用 SHA-NI；没有 SHA 指令但支持 AVX2 时，verify 每 8 帧一组
+ *             并行计算；否则使用标量实现。verify 先批量计算全部帧的签名，
+ *             再按顺序检查时间戳，保证重放检测的先后语义不变
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "mavlinkprotocol.h"
+
+class MavlinkSigningStreams;
+
+class MavlinkSignature
+{
+public:
+    /// 与 mavlink_signature_check 相同，包括 signing->last_status 与 streams 的更新
+    static bool check(mavlink_signing_t *signing,
+                      mavlink_signing_streams_t *streams,
+                      const mavlink_message_t *message);
+
+    /// 批量校验 count 帧，verdicts[i] 等于按顺序逐帧调用 check 的结果
+    static void verify(mavlink_signing_t *signing,
+                       mavlink_signing_streams_t *streams,
+                       const mavlink_message_t *const *messages,
+                       int count,
+                       bool *verdicts);
+
+    /// 同上，流状态使用 MavlinkSigningStreams，不受 MAVLINK_MAX_SIGNING_STREAMS 限制
+    static bool check(mavlink_signing_t *signing,
+                      MavlinkSigningStreams *streams,
+                      const mavlink_message_t *message);
+    static void verify(mavlink_signing_t *signing,
+                       MavlinkSigningStreams *streams,
+                       const mavlink_message_t *const *messages,
+                       int count,
+                       bool *verdicts);
+
+    /// 只比较签名，不检查时间戳
+    static bool signatureMatches(const uint8_t key[32], const mavlink_message_t *message);
+    /// 批量比较签名，matches[i] 等于 signatureMatches(key, messages[i])
+    static void verify(const uint8_t key[32], const mavlink_message_t *const *messages, int count, bool *matches);
+    /// 同上，frames[i] 指向内存中连续的已签名 MAVLink 2 帧，从 STX 开始到签名块结束
+    static void verify(const uint8_t key[32], const uint8_t *const *frames, int count, bool *matches);
+
+    /// 为内存中连续的帧签名：frame 从 STX 开始，size 含 CRC，签名块写在 frame + size，
+    /// 与 mavlink_sign_packet 相同地递增 signing->timestamp。未开启 SIGN_OUTGOING 时返回 0
+    static int sign(mavlink_signing_t *signing, uint8_t *frame, int size);
+
+    /// 当前使用的 SHA-256 实现，"sha-ni"、"avx2" 或 "scalar"
+    static const char *backend();
+    /// 指定实现，CPU 不支持时返回 false 且不改变当前实现。
+    /// 供测试和基准程序使用，不能与校验并发调用
+    static bool setBackend(const char *name);
+
+    /// 检查时间戳并更新 streams，signatureOk 为签名比较的结果
+    static bool checkStream(mavlink_signing_t *signing,
+                            mavlink_signing_streams_t *streams,
+                            const mavlink_message_t *message,
+                            bool signatureOk);
+};
@@ -0,0 +1,156 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinksigningstreams.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "mavlinksigningstreams.h"
+
+#include <string.h>
+
+MavlinkSigningStreams::MavlinkSigningStreams(quint64 idleTimeout)
+{
+    setIdleTimeout(idleTimeout);
+}
+
+void MavlinkSigningStreams::setIdleTimeout(quint64 timeout)
+{
+    m_idleTimeout = qMax(timeout, kNewStreamWindow);
+}
+
+void MavlinkSigningStreams::clear()
+{
+    m_index.clear();
+    m_streams.clear();
+    m_free.clear();
+    m_head = -1;
+    m_tail = -1;
+}
+
+bool MavlinkSigningStreams::accept(mavlink_signing_t *signing,
+                                   const mavlink_message_t *message,
+                                   bool signatureOk)
+{
+    if (!signatureOk) {
+        signing->last_status = MAVLINK_SIGNING_STATUS_BAD_SIGNATURE;
+        return false;
+    }
+
+    const uint8_t *psig = message->signature;
+    uint64_t timestamp = 0;
+    memcpy(&timestamp, psig + 1, 6);
+
+    const quint32 key = keyOf(message, psig[0]);
+    auto it = m_index.constFind(key);
+    int index;
+    if (it == m_index.constEnd()) {
+        if (timestamp + kNewStreamWindow < signing->timestamp) {
+            signing->last_status = MAVLINK_SIGNING_STATUS_OLD_TIMESTAMP;
+            return false;
+        }
+        evictIdle(signing->timestamp);
+        index = insert(key);
+    } else {
+        index = it.value();
+        if (timestamp <= m_streams[index].timestamp) {
+            signing->last_status = MAVLINK_SIGNING_STATUS_REPLAY;
+            return false;
+        }
+        touch(index);
+    }
+
+    m_streams[index].timestamp = timestamp;
+    if (timestamp > signing->timestamp) {
+        signing->timestamp = timestamp;
+    }
+    signing->last_status = MAVLINK_SIGNING_STATUS_OK;
+    return true;
+}
+
+int MavlinkSigningStreams::insert(quint32 key)
+{
+    if (m_maxStreams > 0 && m_index.size() >= m_maxStreams && m_tail >= 0) {
+        evict(m_tail);
+        ++m_forcedEvictions;
+    }
+
+    int index;
+    if (m_free.isEmpty()) {
+        m_streams.append(Stream());
+        index = int(m_streams.size()) - 1;
+    } else {
+        index = m_free.takeLast();
+    }
+    Stream &stream = m_streams[index];
+    stream.key = key;
+    stream.timestamp = 0;
+    stream.prev = -1;
+    stream.next = m_head;
+    if (m_head >= 0) {
+        m_streams[m_head].prev = index;
+    }
+    m_head = index;
+    if (m_tail < 0) {
+        m_tail = index;
+    }
+    m_index.insert(key, index);
+    return index;
+}
+
+void MavlinkSigningStreams::unlink(int index)
+{
+    Stream &stream = m_streams[index];
+    if (stream.prev >= 0) {
+        m_streams[stream.prev].next = stream.next;
+    } else {
+        m_head = stream.next;
+    }
+    if (stream.next >= 0) {
+        m_streams[stream.next].prev = stream.prev;
+    } else {
+        m_tail = stream.prev;
+    }
+}
+
+void MavlinkSigningStreams::touch(int index)
+{
+    if (index == m_head) {
+        return;
+    }
+    unlink(index);
+    Stream &stream = m_streams[index];
+    stream.prev = -1;
+    stream.next = m_head;
+    m_streams[m_head].prev = index;
+    m_head = index;
+}
+
+void MavlinkSigningStreams::evict(int index)
+{
+    unlink(index);
+    m_index.remove(m_streams[index].key);
+    m_free.append(index);
+}
+
+void MavlinkSigningStreams::evictIdle(quint64 now)
+{
+    // 只在新建流时检查表尾，每次最多淘汰少量流，均摊 O(1)
+    for (int i = 0; i < 4 && m_tail >= 0; ++i) {
+        if (m_streams[m_tail].timestamp + m_idleTimeout >= now) {
+            break;
+        }
+        evict(m_tail);
+        ++m_evictions;
+    }
+}
@@ -0,0 +1,87 @@
+﻿/**************************************************************************
+ *   文件名	：mavlinksigningstreams.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MAVLink 签名流的时间戳状态
+ *   使用说明 ：取代 mavlink_signing_streams_t：按 (sysid, compid, link_id) 哈希查找，
+ *             数量不设上限，不会返回 TOO_MANY_STREAMS。
+ *             空闲流按最近使用顺序淘汰，只淘汰最后时间戳早于当前签名时间戳
+ *             超过 idleTimeout 的流，idleTimeout 不小于新流的一分钟接受窗口，
+ *             因此被淘汰流的旧帧重放时仍会因 OLD_TIMESTAMP 被拒绝
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "mavlinkprotocol.h"
+
+#include <QHash>
+#include <QVector>
+
+class MavlinkSigningStreams
+{
+public:
+    /// 签名时间戳单位为 10 微秒，新流只接受一分钟以内的时间戳
+    static constexpr quint64 kNewStreamWindow = 6000 * 1000;
+    static constexpr quint64 kDefaultIdleTimeout = 10 * kNewStreamWindow;
+
+    explicit MavlinkSigningStreams(quint64 idleTimeout = kDefaultIdleTimeout);
+
+    /// 签名比较之后的时间戳检查，语义与 mavlink_signature_check 相同，
+    /// 结果写入 signing->last_status，并更新 signing->timestamp
+    bool accept(mavlink_signing_t *signing, const mavlink_message_t *message, bool signatureOk);
+
+    /// 空闲多久（签名时间戳单位）后可以淘汰，小于 kNewStreamWindow 时按 kNewStreamWindow
+    void setIdleTimeout(quint64 timeout);
+    quint64 idleTimeout() const { return m_idleTimeout; }
+
+    /// 流数量的软上限，超过时强制淘汰最久未用的流，0 表示不限制。
+    /// 强制淘汰的流在一分钟窗口内可能被重放，默认不限制
+    void setMaxStreams(int count) { m_maxStreams = qMax(0, count); }
+    int maxStreams() const { return m_maxStreams; }
+
+    int size() const { return int(m_index.size()); }
+    /// 因空闲被淘汰的流数
+    quint64 evictions() const { return m_evictions; }
+    /// 因超过软上限被强制淘汰的流数
+    quint64 forcedEvictions() const { return m_forcedEvictions; }
+    void clear();
+
+private:
+    struct Stream
+    {
+        quint32 key;
+        quint64 timestamp;
+        int prev; // 最近使用链表，表头为最近使用
+        int next;
+    };
+
+    static quint32 keyOf(const mavlink_message_t *message, uint8_t linkId)
+    {
+        return quint32(message->sysid) << 16 | quint32(message->compid) << 8 | linkId;
+    }
+    int insert(quint32 key);
+    void touch(int index);
+    void unlink(int index);
+    void evict(int index);
+    void evictIdle(quint64 now);
+
+    QHash<quint32, int> m_index; // 键 -> m_streams 下标
+    QVector<Stream> m_streams;
+    QVector<int> m_free; // m_streams 中可复用的空位
+    int m_head = -1;
+    int m_tail = -1;
+
+    quint64 m_idleTimeout;
+    int m_maxStreams = 0;
+    quint64 m_evictions = 0;
+    quint64 m_forcedEvictions = 0;
+};
@@ -0,0 +1,222 @@
+﻿/**************************************************************************
+ *   文件名	：missionmanager.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "missionmanager.h"
+#include "mavlinkdispatcher.h"
+#include "mavlinkencoder.h"
+
+namespace {
+constexpr int kPollMs = 10;
+constexpr qint64 kProgressUs = 100000;
+} // namespace
+
+MissionManager::MissionManager(MavlinkEncoder *encoder, QObject *parent)
+    : QObject(parent)
+    , m_encoder(encoder)
+{
+    m_clock.start();
+    connect(&m_timer, &QTimer::timeout, this, &MissionManager::poll);
+}
+
+void MissionManager::attach(MavlinkDispatcher *dispatcher)
+{
+    const auto handler = [this](LinkInterface *link, const mavlink_message_t &message) {
+        Q_UNUSED(link);
+        received(message);
+    };
+    dispatcher->onMessage(MAVLINK_MSG_ID_MISSION_REQUEST_INT, handler);
+    dispatcher->onMessage(MAVLINK_MSG_ID_MISSION_REQUEST, handler);
+    dispatcher->onMessage(MAVLINK_MSG_ID_MISSION_COUNT, handler);
+    dispatcher->onMessage(MAVLINK_MSG_ID_MISSION_ITEM_INT, handler);
+    dispatcher->onMessage(MAVLINK_MSG_ID_MISSION_ACK, handler);
+}
+
+MissionManager::Vehicle *MissionManager::start(LinkInterface *link,
+                                               uint8_t systemId,
+                                               uint8_t componentId,
+                                               uint8_t missionType)
+{
+    auto &vehicle = m_vehicles[key(systemId, componentId)];
+    if (vehicle.isNull()) {
+        vehicle.reset(new Vehicle());
+    }
+    vehicle->link = link;
+    vehicle->reported = -1;
+
+    Vehicle *v = vehicle.data();
+    v->transfer.setTarget(systemId, componentId, missionType);
+    v->transfer.setWindow(m_windows.value(key(systemId, componentId), 1));
+    v->transfer.setSenders(
+        [this, v](uint32_t msgid, const void *payload, int length) {
+            if (v->link) {
+                m_encoder->send(v->link.data(), msgid, payload, length);
+            }
+        },
+        [this, v](const uint8_t *frame, int size) {
+            if (v->link) {
+                m_encoder->sendEncoded(v->link.data(), frame, size);
+            }
+        });
+
+    if (!m_timer.isActive()) {
+        m_timer.start(kPollMs);
+    }
+    return v;
+}
+
+void MissionManager::setWindow(uint8_t systemId, uint8_t componentId, int window)
+{
+    m_windows.insert(key(systemId, componentId), qMax(1, window));
+}
+
+void MissionManager::upload(LinkInterface *link,
+                            uint8_t systemId,
+                            uint8_t componentId,
+                            const QVector<mavlink_mission_item_int_t> &items,
+                            uint8_t missionType)
+{
+    Vehicle *v = start(link, systemId, componentId, missionType);
+    v->transfer.prepareUpload(items, *m_encoder);
+    v->transfer.startUpload(now());
+}
+
+void MissionManager::download(LinkInterface *link, uint8_t systemId, uint8_t componentId, uint8_t missionType)
+{
+    Vehicle *v = start(link, systemId, componentId, missionType);
+    v->transfer.startDownload(now());
+}
+
+QVector<mavlink_mission_item_int_t> MissionManager::items(uint8_t systemId, uint8_t componentId) const
+{
+    auto vehicle = m_vehicles.value(key(systemId, componentId));
+    return vehicle.isNull() ? QVector<mavlink_mission_item_int_t>() : vehicle->transfer.items();
+}
+
+MissionTransfer::Statistics MissionManager::statistics(uint8_t systemId, uint8_t componentId) const
+{
+    auto vehicle = m_vehicles.value(key(systemId, componentId));
+    return vehicle.isNull() ? MissionTransfer::Statistics() : vehicle->transfer.statistics();
+}
+
+void MissionManager::received(const mavlink_message_t &message)
+{
+    auto it = m_vehicles.constFind(key(message.sysid, message.compid));
+    if (it == m_vehicles.constEnd()) {
+        return;
+    }
+    Vehicle *vehicle = it.value().data();
+    if (!vehicle->transfer.isActive()) {
+        return;
+    }
+
+    // 负载已补零到最大长度，可以直接按结构体访问；只处理发给本机的消息
+    const char *payload = _MAV_PAYLOAD(&message);
+    const uint8_t self = m_encoder->systemId();
+    const qint64 current = now();
+    switch (message.msgid) {
+    case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
+    case MAVLINK_MSG_ID_MISSION_REQUEST: {
+        // 两者负载布局相同；旧飞控发来的 MISSION_REQUEST 同样用 MISSION_ITEM_INT 回应
+        const auto &request = *reinterpret_cast<const mavlink_mission_request_int_t *>(payload);
+        if (request.target_system != self) {
+            return;
+        }
+        vehicle->transfer.requested(request.seq, current);
+        break;
+    }
+    case MAVLINK_MSG_ID_MISSION_COUNT: {
+        const auto &count = *reinterpret_cast<const mavlink_mission_count_t *>(payload);
+        if (count.target_system != self) {
+            return;
+        }
+        vehicle->transfer.countReceived(count.count, current);
+        break;
+    }
+    case MAVLINK_MSG_ID_MISSION_ITEM_INT: {
+        const auto &item = *reinterpret_cast<const mavlink_mission_item_int_t *>(payload);
+        if (item.target_system != self) {
+            return;
+        }
+        vehicle->transfer.itemReceived(item, current);
+        break;
+    }
+    case MAVLINK_MSG_ID_MISSION_ACK: {
+        const auto &ack = *reinterpret_cast<const mavlink_mission_ack_t *>(payload);
+        if (ack.target_system != self) {
+            return;
+        }
+        vehicle->transfer.ackReceived(ack.type, current);
+        break;
+    }
+    default:
+        return;
+    }
+    report(message.sysid, message.compid, vehicle);
+}
+
+void MissionManager::report(uint8_t systemId, uint8_t componentId, Vehicle *vehicle)
+{
+    const MissionTransfer &transfer = vehicle->transfer;
+    if (transfer.statistics().sequentialFallback) {
+        // 飞控不接受乱序请求，之后的下载都逐条请求
+        m_windows.insert(key(systemId, componentId), 1);
+    }
+    if (!transfer.isActive()) {
+        emit progress(systemId, componentId, transfer.progress(), transfer.count());
+        emit finished(systemId, componentId, transfer.state() == MissionTransfer::Done, transfer.statistics().result);
+    }
+}
+
+void MissionManager::poll()
+{
+    const qint64 current = now();
+    const bool reportProgress = current - m_lastProgress >= kProgressUs;
+    if (reportProgress) {
+        m_lastProgress = current;
+    }
+
+    bool active = false;
+    for (auto it = m_vehicles.cbegin(); it != m_vehicles.cend(); ++it) {
+        Vehicle *vehicle = it.value().data();
+        MissionTransfer &transfer = vehicle->transfer;
+        if (!transfer.isActive()) {
+            continue;
+        }
+        const uint8_t systemId = uint8_t(it.key() >> 8);
+        const uint8_t componentId = uint8_t(it.key() & 0xFF);
+        if (vehicle->link.isNull()) {
+            // 连接已析构，按失败结束
+            transfer = MissionTransfer();
+            emit finished(systemId, componentId, false, MAV_MISSION_OPERATION_CANCELLED);
+            continue;
+        }
+
+        transfer.poll(current);
+        if (!transfer.isActive()) {
+            report(systemId, componentId, vehicle);
+            continue;
+        }
+        active = true;
+        if (reportProgress && transfer.progress() != vehicle->reported) {
+            vehicle->reported = transfer.progress();
+            emit progress(systemId, componentId, transfer.progress(), transfer.count());
+        }
+    }
+    if (!active) {
+        m_timer.stop();
+    }
+}
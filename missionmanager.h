@@ -0,0 +1,92 @@
+﻿/**************************************************************************
+ *   文件名	：missionmanager.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：航线上传和下载
+ *   使用说明 ：attach 到 MavlinkDispatcher 后调用 upload/download，每个飞控同时只进行一次传输，
+ *             结果通过 finished 信号报告，下载的航点由 items 取得
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "missiontransfer.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QTimer>
+
+class LinkInterface;
+class MavlinkDispatcher;
+class MavlinkEncoder;
+
+class MissionManager : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MissionManager(MavlinkEncoder *encoder, QObject *parent = nullptr);
+
+    void attach(MavlinkDispatcher *dispatcher);
+
+    /// 下载时同时在途的 MISSION_REQUEST_INT 数量上限，默认 1（逐条请求）。
+    /// 流水线下载需要飞控接受乱序请求，按飞控单独打开；被拒绝后该飞控退回 1
+    void setWindow(uint8_t systemId, uint8_t componentId, int window);
+
+    /// 上传航点，seq 和目标由这里填写；正在传输时重新开始
+    void upload(LinkInterface *link,
+                uint8_t systemId,
+                uint8_t componentId,
+                const QVector<mavlink_mission_item_int_t> &items,
+                uint8_t missionType = MAV_MISSION_TYPE_MISSION);
+    /// 下载航点，完成后由 items 取得
+    void download(LinkInterface *link,
+                  uint8_t systemId,
+                  uint8_t componentId,
+                  uint8_t missionType = MAV_MISSION_TYPE_MISSION);
+
+    /// 最近一次下载的航点
+    QVector<mavlink_mission_item_int_t> items(uint8_t systemId, uint8_t componentId = MAV_COMP_ID_AUTOPILOT1) const;
+    /// 最近一次传输的统计
+    MissionTransfer::Statistics statistics(uint8_t systemId, uint8_t componentId = MAV_COMP_ID_AUTOPILOT1) const;
+
+signals:
+    /// 传输进度，每 100 毫秒最多一次
+    void progress(uint8_t systemId, uint8_t componentId, int done, int count);
+    /// result 为 MAV_MISSION_RESULT
+    void finished(uint8_t systemId, uint8_t componentId, bool ok, uint8_t result);
+
+private:
+    struct Vehicle
+    {
+        QPointer<LinkInterface> link;
+        MissionTransfer transfer;
+        int reported = -1; // 上次报告进度时的完成数
+    };
+
+    static quint16 key(uint8_t systemId, uint8_t componentId) { return quint16(systemId << 8 | componentId); }
+
+    Vehicle *start(LinkInterface *link, uint8_t systemId, uint8_t componentId, uint8_t missionType);
+    void received(const mavlink_message_t &message);
+    /// 传输刚结束时发出 finished
+    void report(uint8_t systemId, uint8_t componentId, Vehicle *vehicle);
+    void poll();
+    qint64 now() const { return m_clock.nsecsElapsed() / 1000; }
+
+    MavlinkEncoder *m_encoder;
+    QHash<quint16, QSharedPointer<Vehicle>> m_vehicles;
+    QHash<quint16, int> m_windows; // 没有设置的飞控窗口为 1
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_lastProgress = 0;
+};
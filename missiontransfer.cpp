@@ -0,0 +1,376 @@
+﻿/**************************************************************************
+ *   文件名	：missiontransfer.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "missiontransfer.h"
+#include "mavlinkencoder.h"
+
+namespace {
+constexpr qint64 kInitialRtoUs = 1000000; // 没有往返时间样本时的超时
+constexpr qint64 kMinRtoUs = 20000;
+constexpr qint64 kMaxRtoUs = 5000000;
+constexpr int kInitialWindow = 4;
+} // namespace
+
+void MissionTransfer::setSenders(Sender send, FrameSender sendFrame)
+{
+    m_send = std::move(send);
+    m_sendFrame = std::move(sendFrame);
+}
+
+void MissionTransfer::setTarget(uint8_t systemId, uint8_t componentId, uint8_t missionType)
+{
+    m_systemId = systemId;
+    m_componentId = componentId;
+    m_missionType = missionType;
+}
+
+void MissionTransfer::prepareUpload(const QVector<mavlink_mission_item_int_t> &items, const MavlinkEncoder &encoder)
+{
+    // 单独的编码器：预编码的帧不签名，序号在发送时重写
+    MavlinkEncoder pre(encoder.systemId(), encoder.componentId());
+    pre.setMavlink1(encoder.mavlink1());
+
+    m_count = int(items.size());
+    m_frames.resize(qsizetype(m_count) * MAVLINK_MAX_PACKET_LEN);
+    m_offsets.resize(m_count + 1);
+    int offset = 0;
+    for (int i = 0; i < m_count; ++i) {
+        mavlink_mission_item_int_t item = items.at(i);
+        item.seq = uint16_t(i);
+        item.target_system = m_systemId;
+        item.target_component = m_componentId;
+        item.mission_type = m_missionType;
+        m_offsets[i] = offset;
+        offset += pre.encode(reinterpret_cast<uint8_t *>(m_frames.data()) + offset,
+                             MAVLINK_MSG_ID_MISSION_ITEM_INT,
+                             &item,
+                             int(sizeof(item)));
+    }
+    m_offsets[m_count] = offset;
+    m_frames.resize(offset);
+}
+
+void MissionTransfer::begin(State state, qint64 nowUs)
+{
+    m_state = state;
+    m_stats = Statistics();
+    m_startedAt = nowUs;
+    m_done = 0;
+    m_expected = 0;
+    m_lastRequested = -1;
+    m_lastActivity = nowUs;
+    m_lastSentAt = nowUs;
+    m_tries = 1;
+    m_srtt = 0;
+    m_rttvar = 0;
+    m_pending.clear();
+    m_inFlight = 0;
+    m_cursor = 0;
+}
+
+void MissionTransfer::startUpload(qint64 nowUs)
+{
+    begin(Uploading, nowUs);
+    m_seen.fill(false, m_count);
+    m_stats.items = m_count;
+    sendCount();
+}
+
+void MissionTransfer::startDownload(qint64 nowUs)
+{
+    begin(Downloading, nowUs);
+    m_count = 0;
+    m_haveCount = false;
+    m_items.clear();
+    m_seen.clear();
+    m_window = qMin(kInitialWindow, m_maxWindow);
+    sendRequestList();
+}
+
+void MissionTransfer::requested(int seq, qint64 nowUs)
+{
+    if (m_state != Uploading || seq < 0 || seq >= m_count) {
+        return;
+    }
+
+    if (m_seen.testBit(seq)) {
+        ++m_stats.duplicates; // 飞控没收到上一个航点，重复请求
+    } else {
+        // 只用第一次发出的消息计算往返时间（Karn 算法）
+        if (m_tries == 1) {
+            sampleRtt(nowUs - m_lastSentAt);
+        }
+        m_seen.setBit(seq);
+        ++m_done;
+    }
+    if (seq != m_expected) {
+        ++m_stats.outOfOrder;
+    }
+    m_expected = qMax(m_expected, seq + 1);
+    m_lastRequested = seq;
+    m_lastActivity = nowUs;
+    m_lastSentAt = nowUs;
+    m_tries = 1;
+    sendItem(seq);
+}
+
+void MissionTransfer::countReceived(int count, qint64 nowUs)
+{
+    if (m_state != Downloading || m_haveCount) {
+        return; // 重发 MISSION_REQUEST_LIST 后可能收到多个 MISSION_COUNT
+    }
+    if (m_tries == 1) {
+        sampleRtt(nowUs - m_lastSentAt);
+    }
+    m_haveCount = true;
+    m_count = count;
+    m_stats.items = count;
+    m_items.resize(count);
+    m_seen.fill(false, count);
+    m_sentAt.fill(-1, count);
+    m_requestTries.fill(0, count);
+
+    if (count == 0) {
+        sendAck(MAV_MISSION_ACCEPTED);
+        finish(Done, MAV_MISSION_ACCEPTED, nowUs);
+        return;
+    }
+    fill(nowUs);
+}
+
+void MissionTransfer::itemReceived(const mavlink_mission_item_int_t &item, qint64 nowUs)
+{
+    const int seq = item.seq;
+    if (m_state != Downloading || !m_haveCount || seq >= m_count
+        || item.mission_type != m_missionType) {
+        return;
+    }
+
+    if (m_seen.testBit(seq)) {
+        ++m_stats.duplicates;
+    } else {
+        if (seq != m_expected) {
+            ++m_stats.outOfOrder;
+        }
+        m_seen.setBit(seq);
+        m_items[seq] = item;
+        ++m_done;
+        while (m_expected < m_count && m_seen.testBit(m_expected)) {
+            ++m_expected;
+        }
+    }
+
+    if (m_sentAt[seq] >= 0) {
+        if (m_requestTries[seq] == 1) {
+            sampleRtt(nowUs - m_sentAt[seq]);
+        }
+        m_sentAt[seq] = -1;
+        --m_inFlight;
+        m_window = qMin<double>(m_maxWindow, m_window + 1.0 / m_window);
+    }
+
+    if (m_done == m_count) {
+        sendAck(MAV_MISSION_ACCEPTED);
+        finish(Done, MAV_MISSION_ACCEPTED, nowUs);
+        return;
+    }
+    fill(nowUs);
+}
+
+void MissionTransfer::ackReceived(uint8_t type, qint64 nowUs)
+{
+    if (m_state == Uploading) {
+        finish(type == MAV_MISSION_ACCEPTED ? Done : Failed, type, nowUs);
+    } else if (m_state == Downloading && type != MAV_MISSION_ACCEPTED) {
+        // 下载过程中飞控只会用 MISSION_ACK 报告错误
+        if (m_maxWindow > 1 && m_haveCount) {
+            // 多半是飞控不接受超前的请求，逐条请求从头再下载一次，用时从最初开始算
+            const qint64 startedAt = m_startedAt;
+            m_maxWindow = 1;
+            startDownload(nowUs);
+            m_startedAt = startedAt;
+            m_stats.sequentialFallback = true;
+            return;
+        }
+        finish(Failed, type, nowUs);
+    }
+}
+
+void MissionTransfer::poll(qint64 nowUs)
+{
+    if (m_state == Uploading || (m_state == Downloading && !m_haveCount)) {
+        // 上传由飞控驱动，超时只能重发最近一次的消息
+        if (nowUs - m_lastActivity < rto(m_tries)) {
+            return;
+        }
+        ++m_stats.timeouts;
+        if (m_tries >= kMaxTries) {
+            finish(Failed, MAV_MISSION_OPERATION_CANCELLED, nowUs);
+            return;
+        }
+        ++m_tries;
+        ++m_stats.retries;
+        m_lastActivity = nowUs;
+        m_lastSentAt = nowUs;
+        if (m_state == Downloading) {
+            sendRequestList();
+        } else if (m_lastRequested < 0) {
+            sendCount();
+        } else {
+            sendItem(m_lastRequested);
+        }
+        return;
+    }
+    if (m_state != Downloading) {
+        return;
+    }
+
+    // 重发过的请求超时更长，按发送先后排列的队列中不一定最早到期，需要整体扫描
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        const Pending pending = *it;
+        if (m_sentAt[pending.seq] != pending.sentAt) {
+            it = m_pending.erase(it); // 已响应或已重发
+            continue;
+        }
+        if (pending.sentAt + rto(m_requestTries[pending.seq]) > nowUs) {
+            ++it;
+            continue;
+        }
+        it = m_pending.erase(it);
+        m_sentAt[pending.seq] = -1;
+        --m_inFlight;
+        ++m_stats.timeouts;
+        m_window = qMax(1.0, m_window / 2);
+        if (m_requestTries[pending.seq] >= kMaxTries) {
+            sendAck(MAV_MISSION_OPERATION_CANCELLED);
+            finish(Failed, MAV_MISSION_OPERATION_CANCELLED, nowUs);
+            return;
+        }
+        m_cursor = qMin(m_cursor, pending.seq);
+    }
+    fill(nowUs);
+}
+
+void MissionTransfer::fill(qint64 nowUs)
+{
+    bool wrapped = false;
+    while (m_inFlight < int(m_window)) {
+        int seq = m_cursor;
+        while (seq < m_count && (m_seen.testBit(seq) || m_sentAt[seq] >= 0)) {
+            ++seq;
+        }
+        if (seq >= m_count) {
+            if (wrapped || m_cursor == 0) {
+                break; // 所有空缺都已在途
+            }
+            wrapped = true;
+            m_cursor = 0;
+            continue;
+        }
+
+        if (m_requestTries[seq] > 0) {
+            ++m_stats.retries;
+        }
+        ++m_requestTries[seq];
+        m_sentAt[seq] = nowUs;
+        m_pending.append({seq, nowUs});
+        ++m_inFlight;
+        m_cursor = seq + 1 < m_count ? seq + 1 : 0;
+        sendRequest(seq);
+    }
+    m_stats.window = int(m_window);
+}
+
+void MissionTransfer::sendCount()
+{
+    mavlink_mission_count_t count = {};
+    count.count = uint16_t(m_count);
+    count.target_system = m_systemId;
+    count.target_component = m_componentId;
+    count.mission_type = m_missionType;
+    m_send(MAVLINK_MSG_ID_MISSION_COUNT, &count, int(sizeof(count)));
+}
+
+void MissionTransfer::sendRequestList()
+{
+    mavlink_mission_request_list_t request = {};
+    request.target_system = m_systemId;
+    request.target_component = m_componentId;
+    request.mission_type = m_missionType;
+    m_send(MAVLINK_MSG_ID_MISSION_REQUEST_LIST, &request, int(sizeof(request)));
+}
+
+void MissionTransfer::sendItem(int seq)
+{
+    ++m_stats.itemsSent;
+    const int offset = m_offsets.at(seq);
+    m_sendFrame(reinterpret_cast<const uint8_t *>(m_frames.constData()) + offset, m_offsets.at(seq + 1) - offset);
+}
+
+void MissionTransfer::sendRequest(int seq)
+{
+    mavlink_mission_request_int_t request = {};
+    request.seq = uint16_t(seq);
+    request.target_system = m_systemId;
+    request.target_component = m_componentId;
+    request.mission_type = m_missionType;
+    m_send(MAVLINK_MSG_ID_MISSION_REQUEST_INT, &request, int(sizeof(request)));
+}
+
+void MissionTransfer::sendAck(uint8_t type)
+{
+    mavlink_mission_ack_t ack = {};
+    ack.target_system = m_systemId;
+    ack.target_component = m_componentId;
+    ack.type = type;
+    ack.mission_type = m_missionType;
+    m_send(MAVLINK_MSG_ID_MISSION_ACK, &ack, int(sizeof(ack)));
+}
+
+void MissionTransfer::sampleRtt(qint64 sampleUs)
+{
+    sampleUs = qMax<qint64>(sampleUs, 1);
+    if (m_srtt == 0) {
+        m_srtt = sampleUs;
+        m_rttvar = sampleUs / 2;
+    } else {
+        const qint64 delta = sampleUs > m_srtt ? sampleUs - m_srtt : m_srtt - sampleUs;
+        m_rttvar = (m_rttvar * 3 + delta) / 4;
+        m_srtt = (m_srtt * 7 + sampleUs) / 8;
+    }
+    m_stats.srttUs = m_srtt;
+}
+
+qint64 MissionTransfer::rto(int tries) const
+{
+    // 连续超时时按 2 的幂退避，避免丢包集中时几次重发都落在同一个丢包区间
+    const qint64 base = m_srtt == 0 ? kInitialRtoUs : qMax(kMinRtoUs, m_srtt + 4 * m_rttvar);
+    return qMin(base << qBound(0, tries - 1, 4), kMaxRtoUs);
+}
+
+void MissionTransfer::finish(State state, uint8_t result, qint64 nowUs)
+{
+    m_state = state;
+    m_stats.result = result;
+    m_stats.elapsedUs = nowUs - m_startedAt;
+    m_stats.window = int(m_window);
+    if (m_stats.elapsedUs > 0) {
+        m_stats.itemsPerSecond = double(m_done) * 1e6 / double(m_stats.elapsedUs);
+    }
+    m_pending.clear();
+    m_inFlight = 0;
+}
@@ -0,0 +1,153 @@
+﻿/**************************************************************************
+ *   文件名	：missiontransfer.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：航线上传/下载状态机，与收发方式无关
+ *   使用说明 ：上传：prepareUpload 把全部 MISSION_ITEM_INT 预先编码到一块连续缓冲区，
+ *             飞控发来的 MISSION_REQUEST_INT 按 seq 直接取出对应的帧发送，不再编码；
+ *             乱序和重复的请求照常回应并计数。
+ *             下载：收到 MISSION_COUNT 后同时保持 window 个 MISSION_REQUEST_INT 在途，
+ *             超时重发并把窗口减半，收到响应逐步恢复。window 默认为 1，即协议规定的
+ *             逐条请求，流水线需要飞控支持乱序请求。时间由调用方传入（微秒）
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "mavlinkprotocol.h"
+
+#include <QBitArray>
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+#include <functional>
+
+class MavlinkEncoder;
+
+class MissionTransfer
+{
+public:
+    enum State {
+        Idle,
+        Uploading,
+        Downloading,
+        Done,
+        Failed
+    };
+
+    struct Statistics
+    {
+        int items = 0;
+        quint64 itemsSent = 0;     // 上传时发出的 MISSION_ITEM_INT（含重复回应）
+        quint64 duplicates = 0;    // 重复请求（上传）或重复收到的航点（下载）
+        quint64 outOfOrder = 0;    // 不是下一个序号的请求或航点
+        quint64 retries = 0;       // 超时后重发的消息
+        quint64 timeouts = 0;
+        qint64 elapsedUs = 0;
+        double itemsPerSecond = 0;
+        qint64 srttUs = 0;
+        int window = 0;
+        bool sequentialFallback = false; // 飞控拒绝了流水线请求，已退回逐条请求重新下载
+        uint8_t result = MAV_MISSION_ACCEPTED; // 失败时为 MAV_MISSION_RESULT，超时为 MAV_MISSION_OPERATION_CANCELLED
+    };
+
+    /// 按 msgid 编码并发送
+    using Sender = std::function<void(uint32_t msgid, const void *payload, int length)>;
+    /// 发送预编码的帧
+    using FrameSender = std::function<void(const uint8_t *frame, int size)>;
+
+    static constexpr int kMaxTries = 8; // 单条消息的发送次数上限，超时按 2 的幂退避
+
+    void setSenders(Sender send, FrameSender sendFrame);
+    void setTarget(uint8_t systemId, uint8_t componentId, uint8_t missionType = MAV_MISSION_TYPE_MISSION);
+    /// 下载时同时在途的请求数上限，默认 1 即协议规定的逐条请求。PX4 等飞控对超前的
+    /// 请求回应错误并结束传输，只对确认支持乱序请求的飞控（如 ArduPilot）调大；
+    /// 窗口大于 1 时收到错误应答会退回 1 并重新下载
+    void setWindow(int window) { m_maxWindow = qMax(1, window); }
+
+    /// 预编码航点，seq、目标和 mission_type 由这里填写；按 encoder 的系统号、组件号和版本编码，不签名
+    void prepareUpload(const QVector<mavlink_mission_item_int_t> &items, const MavlinkEncoder &encoder);
+    void startUpload(qint64 nowUs);
+    void startDownload(qint64 nowUs);
+
+    /// 以下函数处理来自目标飞控的消息
+    void requested(int seq, qint64 nowUs);
+    void countReceived(int count, qint64 nowUs);
+    void itemReceived(const mavlink_mission_item_int_t &item, qint64 nowUs);
+    void ackReceived(uint8_t type, qint64 nowUs);
+    /// 处理超时
+    void poll(qint64 nowUs);
+
+    State state() const { return m_state; }
+    bool isActive() const { return m_state == Uploading || m_state == Downloading; }
+    /// 已完成的航点数：上传为已请求过的不同序号数，下载为已收到的航点数
+    int progress() const { return m_done; }
+    int count() const { return m_count; }
+    const Statistics &statistics() const { return m_stats; }
+    /// 下载结果
+    const QVector<mavlink_mission_item_int_t> &items() const { return m_items; }
+
+private:
+    struct Pending
+    {
+        int seq;
+        qint64 sentAt;
+    };
+
+    void begin(State state, qint64 nowUs);
+    void sendCount();
+    void sendRequestList();
+    void sendItem(int seq);
+    void sendRequest(int seq);
+    void sendAck(uint8_t type);
+    void fill(qint64 nowUs);
+    void sampleRtt(qint64 sampleUs);
+    /// 已发送 tries 次的消息的超时
+    qint64 rto(int tries) const;
+    void finish(State state, uint8_t result, qint64 nowUs);
+
+    Sender m_send;
+    FrameSender m_sendFrame;
+    uint8_t m_systemId = 1;
+    uint8_t m_componentId = MAV_COMP_ID_AUTOPILOT1;
+    uint8_t m_missionType = MAV_MISSION_TYPE_MISSION;
+
+    State m_state = Idle;
+    Statistics m_stats;
+    qint64 m_startedAt = 0;
+    int m_count = 0;
+    int m_done = 0;
+    QBitArray m_seen;
+
+    // 上传：全部帧首尾相接，第 i 帧为 [m_offsets[i], m_offsets[i + 1])
+    QByteArray m_frames;
+    QVector<int> m_offsets;
+    int m_expected = 0;       // 下一个应被请求的序号
+    int m_lastRequested = -1;
+    qint64 m_lastActivity = 0; // 上次收发的时刻，超过 rto 没有新请求时重发
+    qint64 m_lastSentAt = 0;   // 最近一次发出 MISSION_COUNT 或航点的时刻
+    int m_tries = 0;           // 最近一次发出的消息已发送的次数
+
+    // 下载
+    QVector<mavlink_mission_item_int_t> m_items;
+    QVector<qint64> m_sentAt; // 每个序号在途请求的发送时刻，-1 表示不在途
+    QVector<quint8> m_requestTries;
+    QList<Pending> m_pending;
+    int m_inFlight = 0;
+    int m_cursor = 0;
+    bool m_haveCount = false;
+    double m_window = 0;
+    int m_maxWindow = 1;
+
+    qint64 m_srtt = 0;
+    qint64 m_rttvar = 0;
+};
@@ -0,0 +1,181 @@
+﻿/**************************************************************************
+ *   文件名	：parametermanager.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "parametermanager.h"
+#include "mavlinkdispatcher.h"
+#include "mavlinkencoder.h"
+
+#include <string.h>
+
+namespace {
+constexpr int kPollMs = 10;
+constexpr qint64 kProgressUs = 100000;
+} // namespace
+
+ParameterManager::ParameterManager(MavlinkEncoder *encoder, QObject *parent)
+    : QObject(parent)
+    , m_encoder(encoder)
+{
+    m_clock.start();
+    connect(&m_timer, &QTimer::timeout, this, &ParameterManager::poll);
+}
+
+void ParameterManager::attach(MavlinkDispatcher *dispatcher)
+{
+    dispatcher->onMessage(MAVLINK_MSG_ID_PARAM_VALUE,
+                          [this](LinkInterface *link, const mavlink_message_t &message) {
+                              received(link, message);
+                          });
+}
+
+void ParameterManager::sync(LinkInterface *link, uint8_t systemId, uint8_t componentId)
+{
+    auto &vehicle = m_vehicles[key(systemId, componentId)];
+    if (vehicle.isNull()) {
+        vehicle.reset(new Vehicle());
+    }
+    vehicle->link = link;
+    vehicle->reported = -1;
+
+    Vehicle *v = vehicle.data();
+    v->sync.setSenders(
+        [this, v, systemId, componentId]() {
+            mavlink_param_request_list_t request = {};
+            request.target_system = systemId;
+            request.target_component = componentId;
+            if (v->link) {
+                m_encoder->send(v->link.data(), request);
+            }
+        },
+        [this, v, systemId, componentId](int index) {
+            if (index < 0 || index > ParameterSync::kMaxReadIndex) {
+                return; // param_index 为 int16_t，超出范围时不发送
+            }
+            mavlink_param_request_read_t request = {};
+            request.param_index = int16_t(index);
+            request.target_system = systemId;
+            request.target_component = componentId;
+            if (v->link) {
+                m_encoder->send(v->link.data(), request);
+            }
+        });
+    v->sync.start(now());
+
+    if (!m_timer.isActive()) {
+        m_timer.start(kPollMs);
+    }
+}
+
+bool ParameterManager::setParameter(uint8_t systemId, uint8_t componentId, const QString &name, float value)
+{
+    auto vehicle = m_vehicles.value(key(systemId, componentId));
+    if (vehicle.isNull() || vehicle->link.isNull()) {
+        return false;
+    }
+    const QByteArray id = name.toLatin1();
+    const int index = vehicle->store.indexOf(id.constData(), int(qMin<qsizetype>(id.size(), ParameterStore::kIdLength)));
+    if (index < 0) {
+        return false;
+    }
+
+    const auto *param = vehicle->store.at(index);
+    mavlink_param_set_t request = {};
+    request.param_value = value;
+    request.target_system = systemId;
+    request.target_component = componentId;
+    memcpy(request.param_id, param->id, ParameterStore::kIdLength);
+    request.param_type = param->type;
+    return m_encoder->send(vehicle->link.data(), request);
+}
+
+const ParameterStore *ParameterManager::store(uint8_t systemId, uint8_t componentId) const
+{
+    auto vehicle = m_vehicles.value(key(systemId, componentId));
+    return vehicle.isNull() ? nullptr : &vehicle->store;
+}
+
+ParameterSync::Statistics ParameterManager::statistics(uint8_t systemId, uint8_t componentId) const
+{
+    auto vehicle = m_vehicles.value(key(systemId, componentId));
+    return vehicle.isNull() ? ParameterSync::Statistics() : vehicle->sync.statistics();
+}
+
+void ParameterManager::received(LinkInterface *link, const mavlink_message_t &message)
+{
+    Q_UNUSED(link);
+    auto it = m_vehicles.constFind(key(message.sysid, message.compid));
+    if (it == m_vehicles.constEnd()) {
+        return; // 没有同步过的飞控
+    }
+    Vehicle *vehicle = it.value().data();
+
+    // 负载已补零到最大长度，可以直接按结构体访问
+    const auto &value = *reinterpret_cast<const mavlink_param_value_t *>(_MAV_PAYLOAD(&message));
+    const bool active = vehicle->sync.isActive();
+    const int index = vehicle->sync.received(value, now());
+    if (active) {
+        if (!vehicle->sync.isActive()) {
+            emit syncProgress(message.sysid, message.compid, vehicle->store.received(), vehicle->store.count());
+            emit syncFinished(message.sysid, message.compid, vehicle->sync.state() == ParameterSync::Done);
+        }
+    } else if (index >= 0) {
+        const auto *param = vehicle->store.at(index);
+        emit parameterChanged(message.sysid,
+                              message.compid,
+                              QString::fromLatin1(param->id, ParameterStore::idLength(param->id)),
+                              param->value);
+    }
+}
+
+void ParameterManager::poll()
+{
+    const qint64 current = now();
+    const bool report = current - m_lastProgress >= kProgressUs;
+    if (report) {
+        m_lastProgress = current;
+    }
+
+    bool active = false;
+    for (auto it = m_vehicles.cbegin(); it != m_vehicles.cend(); ++it) {
+        Vehicle *vehicle = it.value().data();
+        if (!vehicle->sync.isActive()) {
+            continue;
+        }
+        const uint8_t systemId = uint8_t(it.key() >> 8);
+        const uint8_t componentId = uint8_t(it.key() & 0xFF);
+        if (vehicle->link.isNull()) {
+            // 连接已析构，按失败结束
+            vehicle->sync = ParameterSync(&vehicle->store);
+            emit syncFinished(systemId, componentId, false);
+            continue;
+        }
+
+        vehicle->sync.poll(current);
+        if (!vehicle->sync.isActive()) {
+            emit syncFinished(systemId, componentId, vehicle->sync.state() == ParameterSync::Done);
+            continue;
+        }
+        active = true;
+        if (report && vehicle->store.received() != vehicle->reported) {
+            vehicle->reported = vehicle->store.received();
+            emit syncProgress(systemId, componentId, vehicle->store.received(), vehicle->store.count());
+        }
+    }
+    if (!active) {
+        m_timer.stop();
+    }
+}
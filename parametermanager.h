@@ -0,0 +1,85 @@
+﻿/**************************************************************************
+ *   文件名	：parametermanager.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MAVLink 参数管理
+ *   使用说明 ：attach 到分发器后接收全部 PARAM_VALUE，sync 对某台飞控发起全量同步，
+ *             同步过程见 ParameterSync；setParameter 发出 PARAM_SET，飞控回应的
+ *             PARAM_VALUE 写入参数表后发出 parameterChanged。
+ *             需要与分发器在同一线程中使用
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "parameterstore.h"
+#include "parametersync.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QTimer>
+
+class LinkInterface;
+class MavlinkDispatcher;
+class MavlinkEncoder;
+
+class ParameterManager : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ParameterManager(MavlinkEncoder *encoder, QObject *parent = nullptr);
+
+    void attach(MavlinkDispatcher *dispatcher);
+
+    /// 通过 link 同步 systemId/componentId 的全部参数，正在同步时重新开始
+    void sync(LinkInterface *link, uint8_t systemId, uint8_t componentId = MAV_COMP_ID_AUTOPILOT1);
+    /// 修改参数，名字未知或未同步过该飞控时返回 false
+    bool setParameter(uint8_t systemId, uint8_t componentId, const QString &name, float value);
+
+    /// 未同步过时返回 nullptr
+    const ParameterStore *store(uint8_t systemId, uint8_t componentId = MAV_COMP_ID_AUTOPILOT1) const;
+    /// 最近一次同步的统计
+    ParameterSync::Statistics statistics(uint8_t systemId, uint8_t componentId = MAV_COMP_ID_AUTOPILOT1) const;
+
+signals:
+    /// 同步进度，每 100 毫秒最多一次
+    void syncProgress(uint8_t systemId, uint8_t componentId, int received, int count);
+    void syncFinished(uint8_t systemId, uint8_t componentId, bool ok);
+    /// 同步完成后收到的参数更新（PARAM_SET 的回应或飞控主动发送）
+    void parameterChanged(uint8_t systemId, uint8_t componentId, const QString &name, float value);
+
+private:
+    struct Vehicle
+    {
+        Vehicle()
+            : sync(&store)
+        {}
+        QPointer<LinkInterface> link;
+        ParameterStore store;
+        ParameterSync sync;
+        int reported = -1; // 上次报告进度时的已收到个数
+    };
+
+    static quint16 key(uint8_t systemId, uint8_t componentId) { return quint16(systemId << 8 | componentId); }
+
+    void received(LinkInterface *link, const mavlink_message_t &message);
+    void poll();
+    qint64 now() const { return m_clock.nsecsElapsed() / 1000; }
+
+    MavlinkEncoder *m_encoder;
+    QHash<quint16, QSharedPointer<Vehicle>> m_vehicles;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_lastProgress = 0;
+};
@@ -0,0 +1,143 @@
+﻿/**************************************************************************
+ *   文件名	：parameterstore.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "parameterstore.h"
+
+#include <string.h>
+
+void ParameterStore::reset(int count)
+{
+    count = qMax(0, count);
+    m_params.fill(Parameter(), count);
+    m_bitmap.fill(0, (count + 63) / 64);
+    m_received = 0;
+    m_names = 0;
+
+    // 装载率不超过 1/2
+    int capacity = 16;
+    while (capacity < count * 2) {
+        capacity <<= 1;
+    }
+    m_slots.fill(-1, capacity);
+    m_slotHashes.fill(0, capacity);
+}
+
+bool ParameterStore::set(int index, const char *id, float value, quint8 type)
+{
+    if (index < 0 || index >= count()) {
+        return false;
+    }
+    Parameter &param = m_params[index];
+    const bool first = !contains(index);
+    param.value = value;
+    param.type = type;
+    if (first) {
+        memcpy(param.id, id, kIdLength);
+        m_bitmap[index >> 6] |= quint64(1) << (index & 63);
+        ++m_received;
+        insertName(index);
+    }
+    return first;
+}
+
+int ParameterStore::idLength(const char *id)
+{
+    const void *end = memchr(id, 0, kIdLength);
+    return end ? int(static_cast<const char *>(end) - id) : kIdLength;
+}
+
+quint32 ParameterStore::hash(const char *id, int length)
+{
+    quint32 h = 2166136261u;
+    for (int i = 0; i < length; ++i) {
+        h = (h ^ quint8(id[i])) * 16777619u;
+    }
+    return h;
+}
+
+int ParameterStore::indexOf(const char *id, int length) const
+{
+    if (m_slots.isEmpty()) {
+        return -1;
+    }
+    if (length < 0) {
+        length = idLength(id);
+    }
+    const quint32 h = hash(id, length);
+    const int mask = int(m_slots.size()) - 1;
+    for (int slot = int(h) & mask;; slot = (slot + 1) & mask) {
+        const int index = m_slots[slot];
+        if (index < 0) {
+            return -1;
+        }
+        if (m_slotHashes[slot] == h) {
+            const char *name = m_params[index].id;
+            if (idLength(name) == length && memcmp(name, id, length) == 0) {
+                return index;
+            }
+        }
+    }
+}
+
+void ParameterStore::insertName(int index)
+{
+    if ((m_names + 1) * 2 > m_slots.size()) {
+        rehash(int(m_slots.size()) * 2);
+    }
+    const char *id = m_params[index].id;
+    const quint32 h = hash(id, idLength(id));
+    const int mask = int(m_slots.size()) - 1;
+    int slot = int(h) & mask;
+    while (m_slots[slot] >= 0) {
+        slot = (slot + 1) & mask;
+    }
+    m_slots[slot] = index;
+    m_slotHashes[slot] = h;
+    ++m_names;
+}
+
+void ParameterStore::rehash(int capacity)
+{
+    const QVector<qint32> old = m_slots;
+    m_slots.fill(-1, capacity);
+    m_slotHashes.fill(0, capacity);
+    m_names = 0;
+    for (const int index : old) {
+        if (index >= 0) {
+            insertName(index);
+        }
+    }
+}
+
+int ParameterStore::nextMissing(int from) const
+{
+    const int total = count();
+    if (from < 0) {
+        from = 0;
+    }
+    for (int word = from >> 6; word < m_bitmap.size(); ++word) {
+        quint64 missing = ~m_bitmap[word];
+        if (word == from >> 6) {
+            missing &= ~quint64(0) << (from & 63);
+        }
+        if (missing) {
+            const int index = word * 64 + qCountTrailingZeroBits(missing);
+            return index < total ? index : -1;
+        }
+    }
+    return -1;
+}
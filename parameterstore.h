@@ -0,0 +1,73 @@
+﻿/**************************************************************************
+ *   文件名	：parameterstore.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：一台飞控的参数表
+ *   使用说明 ：参数按 param_index 平铺存放，已收到的下标记录在位图中；
+ *             按名字查找使用名字哈希的开放寻址表，表中只存下标，不另存字符串
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+
+class ParameterStore
+{
+public:
+    static constexpr int kIdLength = 16; // param_id 最长 16 字节，满长时不以 0 结尾
+
+    struct Parameter
+    {
+        char id[kIdLength];
+        float value;
+        quint8 type; // MAV_PARAM_TYPE
+    };
+
+    /// 清空并按参数总数分配空间
+    void reset(int count);
+    int count() const { return int(m_params.size()); }
+    /// 已收到的参数个数
+    int received() const { return m_received; }
+    bool isComplete() const { return m_received == count() && count() > 0; }
+
+    /// 写入 index 处的参数，返回是否为第一次收到该下标
+    bool set(int index, const char *id, float value, quint8 type);
+    bool contains(int index) const
+    {
+        return index >= 0 && index < count() && (m_bitmap[index >> 6] >> (index & 63)) & 1;
+    }
+    /// index 尚未收到时返回 nullptr
+    const Parameter *at(int index) const { return contains(index) ? &m_params[index] : nullptr; }
+
+    /// 按名字查找已收到的参数，length 为 -1 时按 0 结尾或 kIdLength 截断
+    int indexOf(const char *id, int length = -1) const;
+    /// 从 from 开始第一个未收到的下标，没有时返回 -1
+    int nextMissing(int from) const;
+
+    /// param_id 的 FNV-1a 哈希
+    static quint32 hash(const char *id, int length);
+    static int idLength(const char *id);
+
+private:
+    void insertName(int index);
+    void rehash(int capacity);
+
+    QVector<Parameter> m_params;
+    QVector<quint64> m_bitmap;
+    int m_received = 0;
+
+    // 开放寻址表：槽位存参数下标，-1 为空；哈希单独存放，比较名字前先比哈希
+    QVector<qint32> m_slots;
+    QVector<quint32> m_slotHashes;
+    int m_names = 0;
+};
@@ -0,0 +1,250 @@
+﻿/**************************************************************************
+ *   文件名	：parametersync.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "parametersync.h"
+#include "parameterstore.h"
+
+#include <math.h>
+
+namespace {
+constexpr qint64 kInitialRtoUs = 1000000; // 没有往返时间样本时的超时
+constexpr qint64 kMinRtoUs = 20000;
+constexpr qint64 kMaxRtoUs = 5000000;
+constexpr qint64 kMinIdleUs = 50000; // 推送停止的最短判定时间
+constexpr int kDefaultWindow = 8;
+} // namespace
+
+ParameterSync::ParameterSync(ParameterStore *store)
+    : m_store(store)
+{}
+
+void ParameterSync::setSenders(ListSender list, ReadSender read)
+{
+    m_sendList = std::move(list);
+    m_sendRead = std::move(read);
+}
+
+void ParameterSync::start(qint64 nowUs)
+{
+    m_store->reset(0);
+    m_stats = Statistics();
+    m_state = Listing;
+    m_startedAt = nowUs;
+    m_listSentAt = nowUs;
+    m_listTries = 1;
+    m_lastArrival = -1;
+    m_gapUs = 0;
+    m_srtt = 0;
+    m_rttvar = 0;
+    m_window = kDefaultWindow;
+    m_targetWindow = kMaxWindow;
+    m_sentAt.clear();
+    m_tries.clear();
+    m_pending.clear();
+    m_inFlight = 0;
+    m_cursor = 0;
+
+    ++m_stats.listRequests;
+    m_sendList();
+}
+
+int ParameterSync::received(const mavlink_param_value_t &value, qint64 nowUs)
+{
+    if (value.param_count > 0 && value.param_count != m_store->count() && isActive()) {
+        // 第一次得知参数总数；总数中途变化时（飞控重启等）重新开始计数
+        m_store->reset(value.param_count);
+        m_sentAt.fill(-1, value.param_count);
+        m_tries.fill(0, value.param_count);
+        m_pending.clear();
+        m_inFlight = 0;
+        m_cursor = 0;
+    }
+
+    int index = value.param_index;
+    if (index >= m_store->count()) {
+        // PARAM_SET 的回应或按名字读取的结果，下标可能为 -1（65535）
+        index = m_store->indexOf(value.param_id);
+        if (index < 0) {
+            return -1;
+        }
+    }
+
+    if (!m_store->set(index, value.param_id, value.param_value, value.param_type)) {
+        ++m_stats.duplicates;
+    }
+    if (!isActive()) {
+        return index;
+    }
+
+    if (m_sentAt[index] >= 0) {
+        // 只用没有重发过的请求计算往返时间（Karn 算法）
+        if (m_tries[index] == 1) {
+            sampleRtt(nowUs - m_sentAt[index]);
+        }
+        m_sentAt[index] = -1;
+        --m_inFlight;
+        m_window = qMin<double>(m_targetWindow, m_window + 1.0 / m_window);
+    }
+
+    if (m_state == Listing) {
+        if (m_lastArrival < 0) {
+            sampleRtt(nowUs - m_listSentAt);
+        } else {
+            const qint64 gap = nowUs - m_lastArrival;
+            m_gapUs = m_gapUs == 0 ? gap : (m_gapUs * 7 + gap) / 8;
+        }
+        m_lastArrival = nowUs;
+    }
+
+    if (m_store->isComplete()) {
+        finish(Done, nowUs);
+    } else if (m_state == Filling) {
+        fill(nowUs);
+    }
+    return index;
+}
+
+void ParameterSync::poll(qint64 nowUs)
+{
+    if (m_state == Listing) {
+        if (m_lastArrival < 0) {
+            // 还没有任何回应，重发 PARAM_REQUEST_LIST
+            if (nowUs - m_listSentAt >= kInitialRtoUs) {
+                if (m_listTries >= kMaxTries) {
+                    finish(Failed, nowUs);
+                    return;
+                }
+                ++m_listTries;
+                ++m_stats.listRequests;
+                m_listSentAt = nowUs;
+                m_sendList();
+            }
+            return;
+        }
+        // 推送间隔的数倍内没有新参数，认为推送已结束
+        const qint64 idle = qMax(qMax(kMinIdleUs, m_gapUs * 8), m_srtt * 2);
+        if (nowUs - m_lastArrival < idle) {
+            return;
+        }
+        enterFilling(nowUs);
+    }
+    if (m_state != Filling) {
+        return;
+    }
+
+    const qint64 timeout = rto();
+    while (!m_pending.isEmpty() && m_pending.first().sentAt + timeout <= nowUs) {
+        const Pending pending = m_pending.takeFirst();
+        if (m_sentAt[pending.index] != pending.sentAt) {
+            continue; // 已响应或已重发
+        }
+        m_sentAt[pending.index] = -1;
+        --m_inFlight;
+        ++m_stats.timeouts;
+        m_window = qMax<double>(kMinWindow, m_window / 2);
+        if (m_tries[pending.index] >= kMaxTries) {
+            finish(Failed, nowUs);
+            return;
+        }
+        // 从超时的下标开始重新扫描，优先补发
+        m_cursor = qMin(m_cursor, pending.index);
+    }
+    fill(nowUs);
+}
+
+void ParameterSync::enterFilling(qint64 nowUs)
+{
+    m_state = Filling;
+    if (m_gapUs > 0) {
+        m_stats.streamRate = 1e6 / double(m_gapUs);
+    }
+    // 窗口取带宽时延积：飞控的推送速率乘以往返时间
+    if (m_gapUs > 0 && m_srtt > 0) {
+        m_targetWindow = qBound(kMinWindow, int(ceil(double(m_srtt) / double(m_gapUs))) + 1, kMaxWindow);
+        m_window = m_targetWindow;
+    }
+    m_cursor = 0;
+    fill(nowUs);
+}
+
+void ParameterSync::fill(qint64 nowUs)
+{
+    const int total = m_store->count();
+    bool wrapped = false;
+    while (m_inFlight < int(m_window)) {
+        int index = m_store->nextMissing(m_cursor);
+        while (index >= 0 && m_sentAt[index] >= 0) {
+            index = m_store->nextMissing(index + 1);
+        }
+        if (index < 0) {
+            if (wrapped || m_cursor == 0) {
+                break; // 所有空缺都已在途
+            }
+            wrapped = true;
+            m_cursor = 0;
+            continue;
+        }
+        if (index > kMaxReadIndex) {
+            // 推送阶段漏掉的超范围下标无法补齐，不截断成错误的下标
+            finish(Failed, nowUs);
+            return;
+        }
+
+        if (m_tries[index] > 0) {
+            ++m_stats.retries;
+        }
+        ++m_tries[index];
+        ++m_stats.readRequests;
+        m_sentAt[index] = nowUs;
+        m_pending.append({index, nowUs});
+        ++m_inFlight;
+        m_cursor = index + 1 < total ? index + 1 : 0;
+        m_sendRead(index);
+    }
+    m_stats.window = int(m_window);
+}
+
+void ParameterSync::sampleRtt(qint64 sampleUs)
+{
+    sampleUs = qMax<qint64>(sampleUs, 1);
+    if (m_srtt == 0) {
+        m_srtt = sampleUs;
+        m_rttvar = sampleUs / 2;
+    } else {
+        const qint64 delta = sampleUs > m_srtt ? sampleUs - m_srtt : m_srtt - sampleUs;
+        m_rttvar = (m_rttvar * 3 + delta) / 4;
+        m_srtt = (m_srtt * 7 + sampleUs) / 8;
+    }
+    m_stats.srttUs = m_srtt;
+}
+
+qint64 ParameterSync::rto() const
+{
+    if (m_srtt == 0) {
+        return kInitialRtoUs;
+    }
+    return qBound(kMinRtoUs, m_srtt + 4 * m_rttvar, kMaxRtoUs);
+}
+
+void ParameterSync::finish(State state, qint64 nowUs)
+{
+    m_state = state;
+    m_stats.elapsedUs = nowUs - m_startedAt;
+    m_stats.window = int(m_window);
+    m_pending.clear();
+    m_inFlight = 0;
+}
@@ -0,0 +1,117 @@
+﻿/**************************************************************************
+ *   文件名	：parametersync.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：参数同步状态机，与收发方式无关
+ *   使用说明 ：start 发出 PARAM_REQUEST_LIST 并接收飞控连续推送的参数，推送停止后
+ *             按位图中的空缺用 PARAM_REQUEST_READ 补齐：同时在途的请求数按
+ *             推送速率乘以往返时间估算，超时减半、收到响应逐步恢复；
+ *             超时时间按收到响应的往返时间平滑估算（与 TCP 的 RTO 算法相同）。
+ *             时间由调用方传入（微秒），poll 需要定时调用
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "mavlinkprotocol.h"
+
+#include <QList>
+#include <QVector>
+
+#include <functional>
+
+class ParameterStore;
+
+class ParameterSync
+{
+public:
+    enum State {
+        Idle,
+        Listing, // 等待连续推送
+        Filling, // 补齐空缺
+        Done,
+        Failed
+    };
+
+    struct Statistics
+    {
+        quint64 listRequests = 0;
+        quint64 readRequests = 0;
+        quint64 retries = 0;   // 超时后重发的 PARAM_REQUEST_READ
+        quint64 timeouts = 0;
+        quint64 duplicates = 0; // 已收到过的下标再次收到
+        qint64 elapsedUs = 0;   // start 到完成的用时
+        qint64 srttUs = 0;
+        int window = 0;
+        double streamRate = 0; // 连续推送阶段每秒收到的参数数
+    };
+
+    /// 发送 PARAM_REQUEST_LIST
+    using ListSender = std::function<void()>;
+    /// 发送 PARAM_REQUEST_READ，按下标读取，index 不超过 kMaxReadIndex
+    using ReadSender = std::function<void(int index)>;
+
+    static constexpr int kMinWindow = 2;
+    static constexpr int kMaxWindow = 64;
+    static constexpr int kMaxTries = 5; // 每个请求的发送次数上限
+    /// PARAM_REQUEST_READ 的 param_index 为 int16_t，更大的下标无法按下标补齐
+    static constexpr int kMaxReadIndex = INT16_MAX;
+
+    explicit ParameterSync(ParameterStore *store);
+
+    void setSenders(ListSender list, ReadSender read);
+
+    void start(qint64 nowUs);
+    /// 收到 PARAM_VALUE，返回写入的下标，名字未知时返回 -1
+    int received(const mavlink_param_value_t &value, qint64 nowUs);
+    /// 处理超时、切换阶段并发出请求
+    void poll(qint64 nowUs);
+
+    State state() const { return m_state; }
+    bool isActive() const { return m_state == Listing || m_state == Filling; }
+    const Statistics &statistics() const { return m_stats; }
+
+private:
+    struct Pending
+    {
+        int index;
+        qint64 sentAt;
+    };
+
+    void enterFilling(qint64 nowUs);
+    void fill(qint64 nowUs);
+    void sampleRtt(qint64 sampleUs);
+    qint64 rto() const;
+    void finish(State state, qint64 nowUs);
+
+    ParameterStore *m_store;
+    ListSender m_sendList;
+    ReadSender m_sendRead;
+    State m_state = Idle;
+    Statistics m_stats;
+
+    qint64 m_startedAt = 0;
+    qint64 m_listSentAt = 0;
+    int m_listTries = 0;
+    qint64 m_lastArrival = -1;
+    qint64 m_gapUs = 0; // 推送间隔的平滑值
+
+    qint64 m_srtt = 0;
+    qint64 m_rttvar = 0;
+    double m_window = 0;
+    int m_targetWindow = kMaxWindow; // 按推送速率和往返时间估算的上限
+
+    QVector<qint64> m_sentAt; // 每个下标在途请求的发送时刻，-1 表示不在途
+    QVector<quint8> m_tries;
+    QList<Pending> m_pending; // 按发送先后排列，响应后留下的过期项在检查超时时跳过
+    int m_inFlight = 0;
+    int m_cursor = 0;
+};
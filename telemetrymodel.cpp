@@ -0,0 +1,184 @@
+﻿/**************************************************************************
+ *   文件名	：telemetrymodel.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "telemetrymodel.h"
+#include "mavlinkdispatcher.h"
+
+#include <QMutexLocker>
+#include <QtNumeric>
+
+TelemetryModel::TelemetryModel(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_timer, &QTimer::timeout, this, &TelemetryModel::publish);
+    m_timer.start(1000 / m_frameRate);
+}
+
+void TelemetryModel::attach(MavlinkDispatcher *dispatcher)
+{
+    const int baseMode = addField("HEARTBEAT.base_mode");
+    const int customMode = addField("HEARTBEAT.custom_mode");
+    const int systemStatus = addField("HEARTBEAT.system_status");
+    dispatcher->on<mavlink_heartbeat_t>([=](const mavlink_heartbeat_t &p, const mavlink_message_t &m) {
+        if (!accept(m.sysid)) {
+            return;
+        }
+        update({{baseMode, double(p.base_mode)},
+                {customMode, double(p.custom_mode)},
+                {systemStatus, double(p.system_status)}});
+    });
+
+    const int roll = addField("ATTITUDE.roll");
+    const int pitch = addField("ATTITUDE.pitch");
+    const int yaw = addField("ATTITUDE.yaw");
+    dispatcher->on<mavlink_attitude_t>([=](const mavlink_attitude_t &p, const mavlink_message_t &m) {
+        if (!accept(m.sysid)) {
+            return;
+        }
+        update({{roll, p.roll}, {pitch, p.pitch}, {yaw, p.yaw}});
+    });
+
+    const int lat = addField("GLOBAL_POSITION_INT.lat");
+    const int lon = addField("GLOBAL_POSITION_INT.lon");
+    const int alt = addField("GLOBAL_POSITION_INT.alt");
+    const int relativeAlt = addField("GLOBAL_POSITION_INT.relative_alt");
+    const int hdg = addField("GLOBAL_POSITION_INT.hdg");
+    dispatcher->on<mavlink_global_position_int_t>(
+        [=](const mavlink_global_position_int_t &p, const mavlink_message_t &m) {
+            if (!accept(m.sysid)) {
+                return;
+            }
+            update({{lat, p.lat * 1e-7},
+                    {lon, p.lon * 1e-7},
+                    {alt, p.alt * 1e-3},
+                    {relativeAlt, p.relative_alt * 1e-3},
+                    {hdg, p.hdg * 1e-2}});
+        });
+
+    const int airspeed = addField("VFR_HUD.airspeed");
+    const int groundspeed = addField("VFR_HUD.groundspeed");
+    const int climb = addField("VFR_HUD.climb");
+    const int throttle = addField("VFR_HUD.throttle");
+    dispatcher->on<mavlink_vfr_hud_t>([=](const mavlink_vfr_hud_t &p, const mavlink_message_t &m) {
+        if (!accept(m.sysid)) {
+            return;
+        }
+        update({{airspeed, p.airspeed},
+                {groundspeed, p.groundspeed},
+                {climb, p.climb},
+                {throttle, double(p.throttle)}});
+    });
+
+    const int voltage = addField("SYS_STATUS.voltage_battery");
+    const int remaining = addField("SYS_STATUS.battery_remaining");
+    dispatcher->on<mavlink_sys_status_t>([=](const mavlink_sys_status_t &p, const mavlink_message_t &m) {
+        if (!accept(m.sysid)) {
+            return;
+        }
+        update({{voltage, p.voltage_battery * 1e-3}, {remaining, double(p.battery_remaining)}});
+    });
+
+    const int fixType = addField("GPS_RAW_INT.fix_type");
+    const int satellites = addField("GPS_RAW_INT.satellites_visible");
+    dispatcher->on<mavlink_gps_raw_int_t>([=](const mavlink_gps_raw_int_t &p, const mavlink_message_t &m) {
+        if (!accept(m.sysid)) {
+            return;
+        }
+        update({{fixType, double(p.fix_type)}, {satellites, double(p.satellites_visible)}});
+    });
+}
+
+int TelemetryModel::addField(const QString &name)
+{
+    const int index = m_names.indexOf(name);
+    if (index >= 0) {
+        return index;
+    }
+    QMutexLocker l(&m_mutex);
+    m_names.append(name);
+    m_latest.append(qQNaN());
+    m_dirty.append(false);
+    return m_names.size() - 1;
+}
+
+void TelemetryModel::update(std::initializer_list<Update> updates)
+{
+    QMutexLocker l(&m_mutex);
+    m_pendingUpdates += updates.size();
+    for (const Update &update : updates) {
+        // 值没变时不标记，遥测中大部分字段（模式、卫星数等）多数时候不变
+        if (m_latest[update.field] == update.value) {
+            continue;
+        }
+        m_latest[update.field] = update.value;
+        if (!m_dirty[update.field]) {
+            m_dirty[update.field] = true;
+            m_dirtyFields.append(update.field);
+        }
+    }
+}
+
+void TelemetryModel::publish()
+{
+    QVariantMap changes;
+    quint64 updates;
+    {
+        QMutexLocker l(&m_mutex);
+        updates = m_pendingUpdates;
+        m_pendingUpdates = 0;
+        for (int field : std::as_const(m_dirtyFields)) {
+            m_dirty[field] = false;
+            changes.insert(m_names[field], m_latest[field]);
+        }
+        m_dirtyFields.clear();
+    }
+
+    m_lastFrameUpdates = updates;
+    m_lastFrameCoalesced = updates - quint64(changes.size());
+    m_totalCoalesced += m_lastFrameCoalesced;
+    if (changes.isEmpty()) {
+        return;
+    }
+    for (auto it = changes.cbegin(); it != changes.cend(); ++it) {
+        m_values.insert(it.key(), it.value());
+    }
+    emit valuesChanged(changes);
+}
+
+void TelemetryModel::setFrameRate(int newFrameRate)
+{
+    newFrameRate = qBound(0, newFrameRate, 1000);
+    if (m_frameRate == newFrameRate) {
+        return;
+    }
+    m_frameRate = newFrameRate;
+    if (m_frameRate == 0) {
+        m_timer.stop();
+    } else {
+        m_timer.start(1000 / m_frameRate);
+    }
+    emit frameRateChanged();
+}
+
+void TelemetryModel::setSystemId(int newSystemId)
+{
+    if (m_systemId == newSystemId) {
+        return;
+    }
+    m_systemId = newSystemId;
+    emit systemIdChanged();
+}
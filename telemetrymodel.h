@@ -0,0 +1,108 @@
+﻿/**************************************************************************
+ *   文件名	：telemetrymodel.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：遥测数据模型，连接 MAVLink 分发器与 QML
+ *   使用说明 ：每个字段只保留最新值，update 只写值并登记脏标记；
+ *             定时器按 frameRate 把这一帧内变化过的字段一次性发布给 QML，
+ *             同一字段在一帧内的多次更新被合并，合并数量见 coalesced 系列属性
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include <QMutex>
+#include <QObject>
+#include <QTimer>
+#include <QVariantMap>
+#include <QVector>
+#include <QtQml/qqmlregistration.h>
+
+#include <atomic>
+#include <initializer_list>
+
+class MavlinkDispatcher;
+
+class TelemetryModel : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("TelemetryModel is created in C++")
+    Q_PROPERTY(QVariantMap values READ values NOTIFY valuesChanged FINAL)
+    Q_PROPERTY(int frameRate READ frameRate WRITE setFrameRate NOTIFY frameRateChanged FINAL)
+    Q_PROPERTY(int systemId READ systemId WRITE setSystemId NOTIFY systemIdChanged FINAL)
+    Q_PROPERTY(quint64 lastFrameUpdates READ lastFrameUpdates NOTIFY valuesChanged FINAL)
+    Q_PROPERTY(quint64 lastFrameCoalesced READ lastFrameCoalesced NOTIFY valuesChanged FINAL)
+    Q_PROPERTY(quint64 totalCoalesced READ totalCoalesced NOTIFY valuesChanged FINAL)
+public:
+    struct Update
+    {
+        int field;
+        double value;
+    };
+
+    explicit TelemetryModel(QObject *parent = nullptr);
+
+    /// 注册常用遥测消息（心跳、姿态、位置、速度、电池、GPS）的字段
+    void attach(MavlinkDispatcher *dispatcher);
+
+    /// 注册字段，返回 update 使用的编号，同名字段返回同一个编号
+    int addField(const QString &name);
+    /// 任意线程可调用：一条消息的字段在一次加锁中更新，只记录最新值，值有变化的字段标记为脏
+    void update(std::initializer_list<Update> updates);
+    void update(int field, double value) { update({{field, value}}); }
+
+    /// 当前全部字段的最新值
+    QVariantMap values() const { return m_values; }
+    Q_INVOKABLE QVariant value(const QString &name) const { return m_values.value(name); }
+
+    /// 每秒发布给 QML 的次数，0 表示停止发布
+    int frameRate() const { return m_frameRate; }
+    void setFrameRate(int newFrameRate);
+
+    /// 只接收该 sysid 的消息，0 表示不过滤
+    int systemId() const { return m_systemId; }
+    void setSystemId(int newSystemId);
+
+    /// 最近一帧收到的更新次数
+    quint64 lastFrameUpdates() const { return m_lastFrameUpdates; }
+    /// 最近一帧中被合并（未单独发布）的更新次数
+    quint64 lastFrameCoalesced() const { return m_lastFrameCoalesced; }
+    /// 累计被合并的更新次数
+    quint64 totalCoalesced() const { return m_totalCoalesced; }
+
+signals:
+    /// 每帧最多发出一次，changes 只含本帧变化的字段
+    void valuesChanged(const QVariantMap &changes);
+    void frameRateChanged();
+    void systemIdChanged();
+
+private:
+    void publish();
+    bool accept(int sysid) const { return m_systemId == 0 || sysid == m_systemId; }
+
+    // 由 update 写入，publish 读取，锁内只做赋值
+    mutable QMutex m_mutex;
+    QVector<double> m_latest; // 初值为 NaN，保证第一次更新一定发布
+    QVector<bool> m_dirty;
+    QVector<int> m_dirtyFields;
+    quint64 m_pendingUpdates = 0;
+
+    // 只在模型所在线程中访问
+    QStringList m_names;
+    QVariantMap m_values;
+    QTimer m_timer;
+    int m_frameRate = 30;
+    std::atomic_int m_systemId{0}; // 分发线程中读取
+    quint64 m_lastFrameUpdates = 0;
+    quint64 m_lastFrameCoalesced = 0;
+    quint64 m_totalCoalesced = 0;
+};
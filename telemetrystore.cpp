@@ -0,0 +1,383 @@
+﻿/**************************************************************************
+ *   文件名	：telemetrystore.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "telemetrystore.h"
+#include "linkmetrics.h"
+#include "mavlinkdispatcher.h"
+#include "mavlinkreflect.h"
+
+#include <QHash>
+#include <QVariantList>
+
+#include <algorithm>
+#include <limits>
+#include <new>
+#include <string.h>
+
+namespace {
+constexpr std::size_t kAlign = 64;
+
+struct Summary
+{
+    double min;
+    double max;
+    double sum;
+};
+
+/// 列名按需生成，数组元素为 name[i]，下标与 MavlinkMsgTable::kEntries 一致
+struct Names
+{
+    QVector<QStringList> columns;
+    QHash<QString, uint32_t> ids;
+
+    Names()
+    {
+        columns.resize(MavlinkMsgTable::kEntryCount);
+        for (int i = 0; i < MavlinkMsgTable::kEntryCount; ++i) {
+            const MavlinkReflect::Message &message = MavlinkReflect::kMessages[i];
+            if (message.info == nullptr) {
+                continue;
+            }
+            ids.insert(QString::fromLatin1(message.info->name), message.info->msgid);
+            for (int c = 0; c < message.columnCount; ++c) {
+                const MavlinkReflect::Column &column = message.columns[c];
+                const QString name = QString::fromLatin1(column.name);
+                columns[i].append(column.element < 0 ? name : QStringLiteral("%1[%2]").arg(name).arg(column.element));
+            }
+        }
+    }
+};
+
+const Names &names()
+{
+    static const Names instance;
+    return instance;
+}
+
+const MavlinkReflect::Message *numeric(uint32_t msgid)
+{
+    const MavlinkReflect::Message *message = MavlinkReflect::message(msgid);
+    return message == nullptr || message->columnCount == 0 ? nullptr : message;
+}
+
+int roundCapacity(int capacity)
+{
+    int n = TelemetryStore::kBlock;
+    while (n < capacity && n < (1 << 26)) {
+        n <<= 1;
+    }
+    return n;
+}
+} // namespace
+
+/// 一个 (sysid, msgid) 的全部列，放在一块按缓存行对齐的内存里：
+/// 时间戳列、各字段的值列、各字段的块摘要依次排列。
+/// 逻辑下标 i 位于槽 i & mask，第 i / kBlock 块的摘要位于 (i / kBlock) & blockMask
+struct TelemetryStore::Series
+{
+    Series(const MavlinkReflect::Message *message, int capacity)
+        : message(message)
+        , capacity(capacity)
+        , mask(capacity - 1)
+        , blockMask(capacity / kBlock - 1)
+        , fields(message->columnCount)
+        , maxLen(MavlinkMsgTable::kEntries[MavlinkMsgTable::indexOf(message->info->msgid)].max_msg_len)
+    {
+        const std::size_t column = std::size_t(capacity) * sizeof(double);
+        const std::size_t summaries = std::size_t(capacity / kBlock) * sizeof(Summary);
+        bytes = column * (fields + 1) + summaries * fields;
+        memory = static_cast<char *>(::operator new(bytes, std::align_val_t(kAlign)));
+        timestamps = reinterpret_cast<qint64 *>(memory);
+        values = reinterpret_cast<double *>(memory + column);
+        blocks = reinterpret_cast<Summary *>(memory + column * (fields + 1));
+    }
+
+    ~Series() { ::operator delete(memory, bytes, std::align_val_t(kAlign)); }
+
+    Series(const Series &) = delete;
+    Series &operator=(const Series &) = delete;
+
+    const double *column(int field) const { return values + std::size_t(field) * capacity; }
+    Summary *summaries(int field) const { return blocks + std::size_t(field) * (capacity / kBlock); }
+
+    quint64 first() const { return head > quint64(capacity) ? head - capacity : 0; }
+
+    /// [first(), head) 中第一个时间戳不小于 t 的逻辑下标
+    quint64 lowerBound(qint64 t) const
+    {
+        quint64 lo = first();
+        quint64 hi = head;
+        while (lo < hi) {
+            const quint64 mid = lo + (hi - lo) / 2;
+            if (timestamps[mid & mask] < t) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    void append(qint64 timestampUs, const uint8_t *payload)
+    {
+        const quint64 i = head;
+        const int slot = int(i & mask);
+        const bool reset = (i % kBlock) == 0;
+        const int block = int((i / kBlock) & blockMask);
+        timestamps[slot] = std::max(timestampUs, last);
+        last = timestamps[slot];
+        double row[MavlinkReflect::kMaxColumns];
+        message->extract(payload, row);
+        for (int f = 0; f < fields; ++f) {
+            const double v = row[f];
+            values[std::size_t(f) * capacity + slot] = v;
+            Summary &s = summaries(f)[block];
+            if (reset) {
+                s = {v, v, v};
+            } else {
+                s.min = std::min(s.min, v);
+                s.max = std::max(s.max, v);
+                s.sum += v;
+            }
+        }
+        head = i + 1;
+    }
+
+    /// 汇总 [from, to) 内的点，整块使用摘要
+    void aggregate(int field, quint64 from, quint64 to, Summary &out) const
+    {
+        const double *values = column(field);
+        const Summary *blockSummaries = summaries(field);
+        const quint64 oldest = first();
+        quint64 i = from;
+        while (i < to) {
+            const quint64 blockEnd = (i / kBlock + 1) * kBlock;
+            if (i % kBlock == 0 && blockEnd <= to && i >= oldest) {
+                const Summary &s = blockSummaries[(i / kBlock) & blockMask];
+                out.min = std::min(out.min, s.min);
+                out.max = std::max(out.max, s.max);
+                out.sum += s.sum;
+                i = blockEnd;
+                continue;
+            }
+            const quint64 end = std::min(blockEnd, to);
+            for (; i < end; ++i) {
+                const double v = values[i & mask];
+                out.min = std::min(out.min, v);
+                out.max = std::max(out.max, v);
+                out.sum += v;
+            }
+        }
+    }
+
+    const MavlinkReflect::Message *message;
+    const int capacity;
+    const quint64 mask;
+    const quint64 blockMask;
+    const int fields;
+    const uint8_t maxLen;
+    std::size_t bytes = 0;
+    char *memory = nullptr;
+    qint64 *timestamps = nullptr;
+    double *values = nullptr;
+    Summary *blocks = nullptr;
+    quint64 head = 0; // 已追加的总点数
+    qint64 last = std::numeric_limits<qint64>::min();
+};
+
+TelemetryStore::TelemetryStore(int capacity, QObject *parent)
+    : QObject(parent)
+    , m_capacity(roundCapacity(capacity))
+{}
+
+TelemetryStore::~TelemetryStore()
+{
+    qDeleteAll(m_series);
+}
+
+void TelemetryStore::attach(MavlinkDispatcher *dispatcher)
+{
+    dispatcher->onAny([this](LinkInterface *link, const mavlink_message_t &message) {
+        Q_UNUSED(link);
+        append(message, LinkMetrics::now() / 1000);
+    });
+}
+
+void TelemetryStore::setCapacity(uint32_t msgid, int capacity)
+{
+    QWriteLocker locker(&m_lock);
+    m_capacities.insert(msgid, roundCapacity(capacity));
+}
+
+TelemetryStore::Series *TelemetryStore::series(uint8_t systemId, uint32_t msgid) const
+{
+    return m_series.value(key(systemId, msgid));
+}
+
+TelemetryStore::Series *TelemetryStore::create(uint8_t systemId, uint32_t msgid)
+{
+    const MavlinkReflect::Message *message = numeric(msgid);
+    if (message == nullptr) {
+        return nullptr;
+    }
+    auto *s = new Series(message, m_capacities.value(msgid, m_capacity));
+    m_series.insert(key(systemId, msgid), s);
+    return s;
+}
+
+void TelemetryStore::append(const mavlink_message_t &message, qint64 timestampUs)
+{
+    QWriteLocker locker(&m_lock);
+    Series *s = series(message.sysid, message.msgid);
+    if (s == nullptr) {
+        if (m_series.contains(key(message.sysid, message.msgid))) {
+            return;
+        }
+        s = create(message.sysid, message.msgid);
+        if (s == nullptr) {
+            m_series.insert(key(message.sysid, message.msgid), nullptr); // 方言中没有或无数值字段
+            return;
+        }
+    }
+    const auto *payload = reinterpret_cast<const uint8_t *>(_MAV_PAYLOAD(&message));
+    uint8_t padded[MAVLINK_MAX_PAYLOAD_LEN];
+    if (message.len < s->maxLen) { // 解析器已补零，这里只处理本地组包时被截去的尾部零
+        memcpy(padded, payload, message.len);
+        memset(padded + message.len, 0, s->maxLen - message.len);
+        payload = padded;
+    }
+    s->append(timestampUs, payload);
+}
+
+QStringList TelemetryStore::fieldNames(uint32_t msgid)
+{
+    const int index = MavlinkMsgTable::indexOf(msgid);
+    return index < 0 ? QStringList() : names().columns[index];
+}
+
+int TelemetryStore::fieldIndex(uint32_t msgid, const QString &name)
+{
+    const int index = MavlinkMsgTable::indexOf(msgid);
+    return index < 0 ? -1 : int(names().columns[index].indexOf(name));
+}
+
+qint64 TelemetryStore::messageId(const QString &name)
+{
+    const auto &ids = names().ids;
+    const auto it = ids.constFind(name);
+    return it == ids.constEnd() ? -1 : qint64(it.value());
+}
+
+int TelemetryStore::count(uint8_t systemId, uint32_t msgid) const
+{
+    QReadLocker locker(&m_lock);
+    const Series *s = series(systemId, msgid);
+    return s == nullptr ? 0 : int(s->head - s->first());
+}
+
+QVector<TelemetryStore::Bucket> TelemetryStore::query(uint8_t systemId,
+                                                      uint32_t msgid,
+                                                      int field,
+                                                      qint64 fromUs,
+                                                      qint64 toUs,
+                                                      int buckets) const
+{
+    QVector<Bucket> result;
+    if (buckets <= 0 || toUs <= fromUs) {
+        return result;
+    }
+    QReadLocker locker(&m_lock);
+    const Series *s = series(systemId, msgid);
+    if (s == nullptr || field < 0 || field >= s->fields) {
+        return result;
+    }
+    const quint64 end = s->lowerBound(toUs);
+    quint64 from = s->lowerBound(fromUs);
+    const double width = double(toUs - fromUs) / buckets;
+    result.reserve(int(std::min<quint64>(end - from, quint64(buckets))));
+    for (int b = 0; b < buckets && from < end; ++b) {
+        const qint64 bucketEnd = b + 1 == buckets ? toUs : fromUs + qint64(width * (b + 1));
+        if (s->timestamps[from & s->mask] >= bucketEnd) {
+            continue;
+        }
+        const quint64 to = std::min(s->lowerBound(bucketEnd), end);
+        Summary sum{std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), 0};
+        s->aggregate(field, from, to, sum);
+        const int n = int(to - from);
+        result.append({s->timestamps[from & s->mask], s->timestamps[(to - 1) & s->mask], sum.min, sum.max, sum.sum / n, n});
+        from = to;
+    }
+    return result;
+}
+
+int TelemetryStore::copy(uint8_t systemId,
+                         uint32_t msgid,
+                         int field,
+                         qint64 fromUs,
+                         qint64 toUs,
+                         qint64 *timestamps,
+                         double *values,
+                         int max) const
+{
+    QReadLocker locker(&m_lock);
+    const Series *s = series(systemId, msgid);
+    if (s == nullptr || field < 0 || field >= s->fields || max <= 0) {
+        return 0;
+    }
+    const quint64 from = s->lowerBound(fromUs);
+    const quint64 to = std::min(s->lowerBound(toUs), from + quint64(max));
+    const double *column = s->column(field);
+    for (quint64 i = from; i < to; ++i) {
+        timestamps[i - from] = s->timestamps[i & s->mask];
+        values[i - from] = column[i & s->mask];
+    }
+    return int(to - from);
+}
+
+QVariantMap TelemetryStore::downsample(
+    int systemId, const QString &message, const QString &field, double fromMs, double toMs, int buckets) const
+{
+    QVariantMap result;
+    const qint64 msgid = messageId(message);
+    if (msgid < 0) {
+        return result;
+    }
+    const int index = fieldIndex(uint32_t(msgid), field);
+    const QVector<Bucket> points
+        = query(uint8_t(systemId), uint32_t(msgid), index, qint64(fromMs * 1000), qint64(toMs * 1000), buckets);
+    QVariantList t, min, max, mean;
+    t.reserve(points.size());
+    min.reserve(points.size());
+    max.reserve(points.size());
+    mean.reserve(points.size());
+    for (const Bucket &bucket : points) {
+        t.append((bucket.firstUs + bucket.lastUs) / 2000.0);
+        min.append(bucket.min);
+        max.append(bucket.max);
+        mean.append(bucket.mean);
+    }
+    result.insert(QStringLiteral("t"), t);
+    result.insert(QStringLiteral("min"), min);
+    result.insert(QStringLiteral("max"), max);
+    result.insert(QStringLiteral("mean"), mean);
+    return result;
+}
+
+double TelemetryStore::nowMs() const
+{
+    return LinkMetrics::now() / 1e6;
+}
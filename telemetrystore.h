@@ -0,0 +1,98 @@
+﻿/**************************************************************************
+ *   文件名	：telemetrystore.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：解码后遥测字段的列式历史存储
+ *   使用说明 ：按 (sysid, msgid) 建立序列，序列内各字段一列，共用一列时间戳；每列为预先分配、
+ *             按缓存行对齐的环形数组，追加为 O(1)。字段布局取自方言生成的 MAVLINK_MESSAGE_INFO。
+ *             query 按时间范围分桶返回最小值、最大值和平均值，每 kBlock 个点维护一个摘要，
+ *             跨越整块时不必逐点扫描
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "mavlinkprotocol.h"
+
+#include <QHash>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+
+class MavlinkDispatcher;
+
+class TelemetryStore : public QObject
+{
+    Q_OBJECT
+public:
+    /// 每个摘要块的点数，容量取它的整数倍
+    static constexpr int kBlock = 256;
+
+    struct Bucket
+    {
+        qint64 firstUs; // 桶内第一个点的时间
+        qint64 lastUs;  // 桶内最后一个点的时间
+        double min;
+        double max;
+        double mean;
+        int count;
+    };
+
+    /// capacity 为每个序列保留的点数，向上取到 kBlock 的整数倍
+    explicit TelemetryStore(int capacity = 16384, QObject *parent = nullptr);
+    ~TelemetryStore();
+
+    /// 记录分发器收到的全部消息，时间戳为收到的时刻
+    void attach(MavlinkDispatcher *dispatcher);
+
+    /// 单独设置某个消息的容量，只影响之后新建的序列
+    void setCapacity(uint32_t msgid, int capacity);
+
+    /// 追加一条消息，timestampUs 应单调不减，回退时按上一个时间戳记录。可在任意线程调用
+    void append(const mavlink_message_t &message, qint64 timestampUs);
+
+    /// 消息的列名，数组元素为 name[i]；方言中没有该消息时为空
+    static QStringList fieldNames(uint32_t msgid);
+    /// 列号，未知时返回 -1
+    static int fieldIndex(uint32_t msgid, const QString &name);
+    /// 按消息名查 msgid，未知时返回 -1
+    static qint64 messageId(const QString &name);
+
+    /// 序列中当前保留的点数
+    int count(uint8_t systemId, uint32_t msgid) const;
+    /// [fromUs, toUs) 内的点均分为 buckets 个时间桶，只返回有数据的桶
+    QVector<Bucket> query(uint8_t systemId, uint32_t msgid, int field, qint64 fromUs, qint64 toUs, int buckets) const;
+    /// 复制 [fromUs, toUs) 内的原始点，最多 max 个，返回复制的点数
+    int copy(uint8_t systemId, uint32_t msgid, int field, qint64 fromUs, qint64 toUs,
+             qint64 *timestamps, double *values, int max) const;
+
+    /// 供 QML 绘图：时间为 now() 的毫秒数，返回 {t, min, max, mean} 四个数组，t 为桶中点
+    Q_INVOKABLE QVariantMap downsample(int systemId, const QString &message, const QString &field,
+                                       double fromMs, double toMs, int buckets) const;
+    /// attach 使用的时间基准（毫秒）
+    Q_INVOKABLE double nowMs() const;
+
+private:
+    struct Series;
+
+    static quint32 key(uint8_t systemId, uint32_t msgid) { return quint32(systemId) << 24 | (msgid & 0xFFFFFF); }
+
+    Series *series(uint8_t systemId, uint32_t msgid) const;
+    Series *create(uint8_t systemId, uint32_t msgid);
+
+    int m_capacity;
+    QHash<uint32_t, int> m_capacities;
+
+    mutable QReadWriteLock m_lock; // 保护 m_series 和各序列的写入位置
+    QHash<quint32, Series *> m_series; // 值为空表示该消息不入库
+};
@@ -0,0 +1,81 @@
+﻿/**************************************************************************
+ *   文件名	：bench_checksum.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MAVLink CRC 基准：slice-by-8 与逐字节实现的吞吐量
+ *   使用说明 ：bench_checksum [帧长度，默认 280]
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "checksum.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr size_t kBufferSize = 4 * 1024 * 1024; // 大于 L2，和连续收包的情况接近
+constexpr int kPasses = 20;
+
+uint16_t bytewiseCrc(const uint8_t *p, uint16_t length)
+{
+    uint16_t crc = X25_INIT_CRC;
+    while (length--) {
+        crc_accumulate(*p++, &crc);
+    }
+    return crc;
+}
+
+template<typename Func>
+double run(const std::vector<uint8_t> &buffer, int frameSize, Func &&crc, uint32_t *sink)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < kPasses; ++pass) {
+        for (size_t pos = 0; pos + frameSize <= buffer.size(); pos += frameSize) {
+            *sink += crc(buffer.data() + pos, uint16_t(frameSize));
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const int frameSize = argc > 1 ? atoi(argv[1]) : 280;
+    if (frameSize <= 0 || frameSize > 65535) {
+        fprintf(stderr, "frame size must be 1..65535\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> buffer(kBufferSize);
+    std::mt19937 rng(1);
+    for (auto &byte : buffer) {
+        byte = uint8_t(rng());
+    }
+
+    const double frames = double(kPasses) * double(buffer.size() / frameSize);
+    const double bytes = frames * frameSize;
+    uint32_t sink = 0;
+
+    const double bytewise = run(buffer, frameSize, bytewiseCrc, &sink);
+    const double table = run(buffer, frameSize, crc_calculate, &sink);
+
+    printf("frame size %d bytes\n", frameSize);
+    printf("bytewise      %8.1f MB/s %12.0f frames/s\n", bytes / bytewise / 1e6, frames / bytewise);
+    printf("crc_calculate %8.1f MB/s %12.0f frames/s (%.1fx)\n",
+           bytes / table / 1e6,
+           frames / table,
+           bytewise / table);
+    printf("(checksum sink %u)\n", sink);
+    return 0;
+}
@@ -0,0 +1,91 @@
+﻿/**************************************************************************
+ *   文件名	：bench_encoder.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MavlinkEncoder 基准：原地编码与 encode + to_send_buffer + 入队的每秒帧数和复制字节数
+ *   使用说明 ：bench_encoder [帧数，默认 2000000]
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "mavlinkencoder.h"
+#include "ringlink.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+constexpr int kDrainEvery = 1024; // 发送队列 256 KB，定期取空
+
+template<typename Func>
+double run(RingLink &link, int frames, Func &&sendOne)
+{
+    qint64 bytes = 0;
+    auto count = [&](const char *, int size) { bytes += size; };
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i) {
+        sendOne(i);
+        if (i % kDrainEvery == kDrainEvery - 1) {
+            link.drain(count);
+        }
+    }
+    link.drain(count);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const int frames = argc > 1 ? atoi(argv[1]) : 2000000;
+    if (frames <= 0) {
+        fprintf(stderr, "frame count must be positive\n");
+        return 1;
+    }
+
+    RingLink link;
+    MavlinkEncoder encoder(1, 1);
+    mavlink_attitude_t attitude = {};
+    attitude.roll = 0.1f;
+    attitude.pitch = 0.2f;
+    attitude.yaw = 0.3f;
+
+    // 原地编码：负载直接写进发送队列，之后只计算 CRC
+    const double inPlace = run(link, frames, [&](int i) {
+        attitude.time_boot_ms = uint32_t(i);
+        encoder.send(&link, attitude);
+    });
+
+    // 原来的做法：打包到 mavlink_message_t，序列化到栈上缓冲区，再复制进发送队列
+    mavlink_message_t message;
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int frameSize = 0;
+    const double legacy = run(link, frames, [&](int i) {
+        attitude.time_boot_ms = uint32_t(i);
+        mavlink_msg_attitude_encode(1, 1, &message, &attitude);
+        frameSize = mavlink_msg_to_send_buffer(buffer, &message);
+        link.writeBytesThreadSafe(reinterpret_cast<const char *>(buffer), frameSize);
+    });
+
+    // 每帧的内存复制量：原地编码只复制一次负载；原做法复制负载、整帧序列化、整帧入队
+    const int payload = int(sizeof(attitude));
+    const int inPlaceCopied = payload;
+    const int legacyCopied = payload + frameSize + frameSize;
+
+    printf("ATTITUDE, %d frames, %d-byte frames\n", frames, frameSize);
+    printf("encode + to_send_buffer + push %12.0f frames/s %4d bytes copied/frame\n",
+           frames / legacy,
+           legacyCopied);
+    printf("MavlinkEncoder::send           %12.0f frames/s %4d bytes copied/frame (%.1fx)\n",
+           frames / inPlace,
+           inPlaceCopied,
+           legacy / inPlace);
+    return 0;
+}
@@ -0,0 +1,150 @@
+﻿/**************************************************************************
+ *   文件名	：bench_framer.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MavlinkFramer 基准：按块解析与逐字节 mavlink_parse_char 的 MB/s 和每秒帧数
+ *   使用说明 ：bench_framer [数据块大小，默认 4096]
+ *             数据为方言中随机消息组成的 MAVLink 2 帧流，分别测量不签名和全部签名两种情况
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "mavlinkframer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr int kFrames = 50000;
+constexpr int kPasses = 5;
+constexpr uint8_t kChannel = MAVLINK_COMM_0;
+
+std::vector<uint8_t> makeStream(mavlink_signing_t *signing)
+{
+    std::mt19937 rng(1);
+    mavlink_status_t tx = {};
+    tx.signing = signing;
+    std::vector<uint8_t> stream;
+    for (int n = 0; n < kFrames; ++n) {
+        const auto &entry = MavlinkMsgTable::kEntries[rng() % MavlinkMsgTable::kEntryCount];
+        mavlink_message_t msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msgid = entry.msgid;
+        for (int i = 0; i < entry.max_msg_len; ++i) {
+            _MAV_PAYLOAD_NON_CONST(&msg)[i] = char(rng());
+        }
+        mavlink_finalize_message_buffer(&msg, 1, 1, &tx, entry.min_msg_len, entry.max_msg_len, entry.crc_extra);
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const int size = mavlink_msg_to_send_buffer(buffer, &msg);
+        stream.insert(stream.end(), buffer, buffer + size);
+    }
+    return stream;
+}
+
+/// 逐字节调用 mavlink_parse_char，返回最快一轮的秒数
+double runReference(const std::vector<uint8_t> &stream, const mavlink_signing_t *key, int *frames)
+{
+    double best = 1e9;
+    for (int pass = 0; pass < kPasses; ++pass) {
+        mavlink_signing_t signing = key ? *key : mavlink_signing_t{};
+        signing.flags = 0;
+        signing.timestamp = 0;
+        mavlink_signing_streams_t streams = {};
+        mavlink_status_t *status = mavlink_get_channel_status(kChannel);
+        memset(status, 0, sizeof(*status));
+        if (key) {
+            status->signing = &signing;
+            status->signing_streams = &streams;
+        }
+
+        *frames = 0;
+        mavlink_message_t msg;
+        mavlink_status_t r_status;
+        const auto start = std::chrono::steady_clock::now();
+        for (const uint8_t c : stream) {
+            if (mavlink_parse_char(kChannel, c, &msg, &r_status)) {
+                ++*frames;
+            }
+        }
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+/// 按 chunk 字节切块调用 MavlinkFramer::parse
+double runFramer(const std::vector<uint8_t> &stream, const mavlink_signing_t *key, int chunk, int *frames)
+{
+    double best = 1e9;
+    for (int pass = 0; pass < kPasses; ++pass) {
+        mavlink_signing_t signing = key ? *key : mavlink_signing_t{};
+        signing.flags = 0;
+        signing.timestamp = 0;
+        mavlink_signing_streams_t streams = {};
+        MavlinkFramer framer;
+        if (key) {
+            framer.setSigning(&signing, &streams);
+        }
+
+        *frames = 0;
+        const char *data = reinterpret_cast<const char *>(stream.data());
+        const qsizetype size = qsizetype(stream.size());
+        const auto start = std::chrono::steady_clock::now();
+        for (qsizetype pos = 0; pos < size; pos += chunk) {
+            *frames += int(framer.parse(data + pos, std::min<qsizetype>(chunk, size - pos)).size());
+        }
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const int chunk = argc > 1 ? atoi(argv[1]) : 4096;
+    if (chunk <= 0) {
+        fprintf(stderr, "chunk size must be positive\n");
+        return 1;
+    }
+
+    mavlink_signing_t signing = {};
+    signing.flags = MAVLINK_SIGNING_FLAG_SIGN_OUTGOING;
+    signing.timestamp = 1;
+    std::mt19937 rng(2);
+    for (auto &byte : signing.secret_key) {
+        byte = uint8_t(rng());
+    }
+
+    printf("%d frames, %d byte chunks\n", kFrames, chunk);
+    printf("%-8s %-18s %10s %12s %8s\n", "signing", "parser", "MB/s", "frames/s", "speedup");
+    bool ok = true;
+    for (const bool signed_ : {false, true}) {
+        const auto stream = makeStream(signed_ ? &signing : nullptr);
+        const mavlink_signing_t *key = signed_ ? &signing : nullptr;
+        int referenceFrames = 0;
+        int framerFrames = 0;
+        const double reference = runReference(stream, key, &referenceFrames);
+        const double framer = runFramer(stream, key, chunk, &framerFrames);
+        if (referenceFrames != kFrames || framerFrames != kFrames) {
+            fprintf(stderr, "frames lost: reference %d, framer %d\n", referenceFrames, framerFrames);
+            ok = false;
+        }
+        const char *mode = signed_ ? "on" : "off";
+        printf("%-8s %-18s %10.1f %12.0f\n", mode, "mavlink_parse_char", stream.size() / reference / 1e6,
+               kFrames / reference);
+        printf("%-8s %-18s %10.1f %12.0f %7.1fx\n", mode, "MavlinkFramer", stream.size() / framer / 1e6,
+               kFrames / framer, reference / framer);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,594 @@
+﻿/**************************************************************************
+ *   文件名	：bench_ftp.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MAVLink FTP 下载基准：模拟飞控和链路上的下载速度，下载结果逐字节校验
+ *   使用说明 ：bench_ftp [文件大小 KB，默认 1024]
+ *             第一部分为离散事件模拟，不依赖真实时间：模拟飞控按链路速率逐包发出
+ *             连续读取的数据，每包按丢包率和误码率独立丢弃，FtpDownload 按模拟时间轮询。
+ *             第二部分在回环链路上运行 FtpClient，请求和回应经过编码、解析和分发，
+ *             飞控只允许两个会话而客户端同时下载三个文件，第三个会话被拒绝后重新排队。
+ *             任何一个文件与飞控上的内容不一致时返回 1
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "ftpclient.h"
+#include "mavlinkdispatcher.h"
+#include "mavlinkencoder.h"
+#include "mavlinkframer.h"
+#include "ringlink.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <queue>
+#include <random>
+#include <vector>
+
+using namespace MavlinkFtp;
+
+namespace {
+constexpr qint64 kPollUs = 10000;         // 与 FtpClient 的轮询间隔相同
+constexpr qint64 kLimitUs = 3600000000LL; // 模拟时间上限
+constexpr quint32 kBurstBytes = 256 * 1024; // 飞控每次连续读取最多发出的字节数
+constexpr uint8_t kVehicleId = 1;
+constexpr int kClientFiles = 3;
+constexpr int kVehicleSessions = 2;
+constexpr int kRepliesPerStep = 32;       // 回环上每轮事件循环发出的回应数
+constexpr double kClientLoss = 0.01;
+constexpr qint64 kClientTimeoutMs = 60000;
+
+struct LinkModel
+{
+    const char *name;
+    double rttMs;
+    double rate; // 飞控到地面站每秒的字节数
+    double loss; // 与长度无关的丢包率
+    double ber;  // 误码率，长帧更容易丢
+};
+
+QByteArray makeFile(int size, unsigned seed)
+{
+    std::mt19937 random(seed);
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        data[i] = char(random());
+    }
+    return data;
+}
+
+/// 负载所在 MAVLink 2 帧的长度
+int frameBytes(const Payload &payload)
+{
+    return MAVLINK_NUM_NON_PAYLOAD_BYTES + 3 + kHeaderSize + payload.size;
+}
+
+/// 模拟飞控上的 FTP 服务：只读文件，会话数有上限，连续读取每次最多发出 kBurstBytes。
+/// 与飞控上的实现一样，其它请求的回应插在连续读取的数据包之间优先发出
+class SimFtpServer
+{
+public:
+    explicit SimFtpServer(int maxSessions)
+        : m_maxSessions(maxSessions)
+    {}
+
+    void addFile(const QByteArray &path, const QByteArray &data) { m_files.append({path, data}); }
+
+    /// 被拒绝的 OpenFileRO 次数（没有空闲会话）
+    int busyNaks() const { return m_busyNaks; }
+    int openSessions() const { return int(m_sessions.size()); }
+
+    /// 处理一个请求，回应进入发送队列
+    void handle(const Payload &request)
+    {
+        Payload reply;
+        memset(&reply, 0, sizeof(reply));
+        reply.seqNumber = uint16_t(request.seqNumber + 1);
+        reply.session = request.session;
+        reply.reqOpcode = request.opcode;
+        reply.opcode = Ack;
+
+        switch (request.opcode) {
+        case OpenFileRO: {
+            const QByteArray path(reinterpret_cast<const char *>(request.data), request.size);
+            int file = -1;
+            for (int i = 0; i < m_files.size(); ++i) {
+                if (m_files.at(i).path == path) {
+                    file = i;
+                }
+            }
+            if (file < 0) {
+                nak(&reply, FileNotFound);
+                return;
+            }
+            if (int(m_sessions.size()) >= m_maxSessions) {
+                ++m_busyNaks;
+                nak(&reply, NoSessionsAvailable);
+                return;
+            }
+            reply.session = m_nextSession++;
+            m_sessions.push_back({reply.session, file});
+            const quint32 size = quint32(m_files.at(file).data.size());
+            reply.size = sizeof(size);
+            memcpy(reply.data, &size, sizeof(size));
+            m_replies.push_back(reply);
+            return;
+        }
+        case ReadFile:
+        case BurstReadFile: {
+            const int file = fileOf(request.session);
+            if (file < 0) {
+                nak(&reply, InvalidSession);
+                return;
+            }
+            const QByteArray &data = m_files.at(file).data;
+            if (request.offset >= quint32(data.size())) {
+                nak(&reply, EndOfFile);
+                return;
+            }
+            const quint32 chunk = request.size > 0 ? qMin<quint32>(request.size, kDataSize) : kDataSize;
+            if (request.opcode == ReadFile) {
+                fill(&reply, data, request.offset, chunk);
+                m_replies.push_back(reply);
+                return;
+            }
+            // 同一会话新的连续读取取代未发完的上一次
+            stopBurst(request.session);
+            m_bursts.push_back({reply,
+                                file,
+                                request.offset,
+                                qMin<quint32>(quint32(data.size()), request.offset + kBurstBytes),
+                                chunk});
+            return;
+        }
+        case TerminateSession:
+            stopBurst(request.session);
+            for (auto it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+                if (it->id == request.session) {
+                    m_sessions.erase(it);
+                    break;
+                }
+            }
+            m_replies.push_back(reply);
+            return;
+        case ResetSessions:
+            m_sessions.clear();
+            m_bursts.clear();
+            m_replies.push_back(reply);
+            return;
+        default:
+            nak(&reply, UnknownCommand);
+            return;
+        }
+    }
+
+    /// 取出下一个要发送的回应，没有时返回 false。各会话的连续读取轮流发包
+    bool next(Payload *reply)
+    {
+        if (!m_replies.empty()) {
+            *reply = m_replies.front();
+            m_replies.pop_front();
+            return true;
+        }
+        if (m_bursts.empty()) {
+            return false;
+        }
+        Burst burst = m_bursts.front();
+        m_bursts.pop_front();
+        const quint32 size = fill(&burst.reply, m_files.at(burst.file).data, burst.offset, burst.chunk);
+        burst.offset += size;
+        burst.reply.burstComplete = burst.offset >= burst.end;
+        *reply = burst.reply;
+        if (!burst.reply.burstComplete) {
+            ++burst.reply.seqNumber;
+            m_bursts.push_back(burst);
+        }
+        return true;
+    }
+
+private:
+    struct File
+    {
+        QByteArray path;
+        QByteArray data;
+    };
+
+    struct Session
+    {
+        uint8_t id;
+        int file;
+    };
+
+    struct Burst
+    {
+        Payload reply; // 下一包的帧头
+        int file;
+        quint32 offset;
+        quint32 end;
+        quint32 chunk;
+    };
+
+    void nak(Payload *reply, Error error)
+    {
+        reply->opcode = Nak;
+        reply->size = 1;
+        reply->data[0] = error;
+        m_replies.push_back(*reply);
+    }
+
+    /// 从 offset 起复制最多 chunk 字节的文件数据，返回复制的长度
+    static quint32 fill(Payload *reply, const QByteArray &data, quint32 offset, quint32 chunk)
+    {
+        const quint32 size = qMin(chunk, quint32(data.size()) - offset);
+        reply->offset = offset;
+        reply->size = uint8_t(size);
+        memcpy(reply->data, data.constData() + offset, size);
+        return size;
+    }
+
+    int fileOf(uint8_t session) const
+    {
+        for (const Session &open : m_sessions) {
+            if (open.id == session) {
+                return open.file;
+            }
+        }
+        return -1;
+    }
+
+    void stopBurst(uint8_t session)
+    {
+        for (auto it = m_bursts.begin(); it != m_bursts.end(); ++it) {
+            if (it->reply.session == session) {
+                m_bursts.erase(it);
+                return;
+            }
+        }
+    }
+
+    int m_maxSessions;
+    QList<File> m_files;
+    std::vector<Session> m_sessions;
+    uint8_t m_nextSession = 0;
+    int m_busyNaks = 0;
+    std::deque<Payload> m_replies;
+    std::deque<Burst> m_bursts;
+};
+
+/// 模拟链路：请求经过半个往返时间到达飞控，回应按链路速率逐个发出
+class SimLink
+{
+public:
+    enum Kind {
+        Request,
+        Reply,
+        Sent // 上一个回应发送完毕，链路空闲
+    };
+
+    struct Event
+    {
+        qint64 at;
+        quint64 seq; // 同一时刻按发生先后处理
+        Kind kind;
+        Payload payload;
+        bool operator>(const Event &other) const { return at != other.at ? at > other.at : seq > other.seq; }
+    };
+
+    SimLink(const LinkModel &link, SimFtpServer *server, unsigned seed)
+        : m_link(link)
+        , m_oneWayUs(qint64(link.rttMs * 500))
+        , m_server(server)
+        , m_random(seed)
+    {}
+
+    void sendRequest(qint64 now, const Payload &request)
+    {
+        if (!lost(request)) {
+            m_events.push({now + m_oneWayUs, m_seq++, Request, request});
+        }
+    }
+
+    bool isEmpty() const { return m_events.empty(); }
+    qint64 nextAt() const { return m_events.top().at; }
+
+    /// 处理下一个事件，到达地面站的回应写入 reply 并返回 true
+    bool step(Payload *reply)
+    {
+        const Event event = m_events.top();
+        m_events.pop();
+        switch (event.kind) {
+        case Request:
+            m_server->handle(event.payload);
+            if (!m_sending) {
+                transmit(event.at);
+            }
+            return false;
+        case Sent:
+            m_sending = false;
+            transmit(event.at);
+            return false;
+        case Reply:
+            break;
+        }
+        *reply = event.payload;
+        return true;
+    }
+
+private:
+    void transmit(qint64 now)
+    {
+        Payload payload;
+        if (!m_server->next(&payload)) {
+            return;
+        }
+        // 丢失的回应同样占用链路时间
+        m_sending = true;
+        const qint64 sentAt = now + qint64(frameBytes(payload) * 1e6 / m_link.rate);
+        m_events.push({sentAt, m_seq++, Sent, {}});
+        if (!lost(payload)) {
+            m_events.push({sentAt + m_oneWayUs, m_seq++, Reply, payload});
+        }
+    }
+
+    bool lost(const Payload &payload)
+    {
+        const double delivered = (1 - m_link.loss) * std::pow(1 - m_link.ber, 8.0 * frameBytes(payload));
+        return std::bernoulli_distribution(1 - delivered)(m_random);
+    }
+
+    LinkModel m_link;
+    qint64 m_oneWayUs;
+    SimFtpServer *m_server;
+    std::mt19937 m_random;
+    bool m_sending = false;
+    quint64 m_seq = 0;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> m_events;
+};
+
+/// 下载结果与飞控上的文件逐字节比较
+bool sameContent(const QString &fileName, const QByteArray &expected)
+{
+    QFile file(fileName);
+    return file.open(QIODevice::ReadOnly) && file.readAll() == expected;
+}
+
+/// 按模拟时间下载一个文件，成功且内容一致时返回 true
+bool runSimulated(const LinkModel &link,
+                  const QByteArray &data,
+                  const QString &fileName,
+                  FtpDownload::Statistics *stats,
+                  double *wallSeconds)
+{
+    SimFtpServer server(1);
+    server.addFile("/fs/microsd/log.bin", data);
+    SimLink sim(link, &server, 1);
+
+    FtpDownload download(QStringLiteral("/fs/microsd/log.bin"), fileName);
+    qint64 now = 0;
+    quint16 sequence = 0;
+    download.setSender([&](Payload &request, bool resend) {
+        if (!resend) {
+            request.seqNumber = sequence++;
+        }
+        sim.sendRequest(now, request);
+    });
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    download.start(now);
+    qint64 nextPoll = kPollUs;
+    Payload reply;
+    while (download.isActive() && now < kLimitUs) {
+        if (sim.isEmpty() || nextPoll <= sim.nextAt()) {
+            now = nextPoll;
+            nextPoll += kPollUs;
+            download.poll(now);
+            continue;
+        }
+        now = sim.nextAt();
+        if (sim.step(&reply) && download.accepts(reply)) {
+            download.received(reply, now);
+        }
+    }
+    *wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    *stats = download.statistics();
+    if (download.state() != FtpDownload::Done) {
+        fprintf(stderr, "%s: download failed: %s\n", link.name, qPrintable(download.errorString()));
+        return false;
+    }
+    if (!sameContent(fileName, data)) {
+        fprintf(stderr, "%s: downloaded file differs\n", link.name);
+        return false;
+    }
+    return true;
+}
+
+/// FtpClient 在回环链路上同时下载 kClientFiles 个文件，飞控只允许 kVehicleSessions 个会话
+bool runClient(const QTemporaryDir &dir, int size)
+{
+    SimFtpServer server(kVehicleSessions);
+    QByteArray files[kClientFiles];
+    for (int i = 0; i < kClientFiles; ++i) {
+        files[i] = makeFile(size, unsigned(100 + i));
+        server.addFile("/logs/" + QByteArray::number(i) + ".bin", files[i]);
+    }
+
+    RingLink gcsLink;     // 地面站发出的帧
+    RingLink vehicleLink; // 飞控发出的帧
+    MavlinkEncoder gcs;
+    MavlinkEncoder vehicle(kVehicleId, MAV_COMP_ID_AUTOPILOT1);
+    MavlinkFramer vehicleFramer;
+    MavlinkFramer gcsFramer;
+    MavlinkDispatcher dispatcher;
+    FtpClient client(&gcs);
+    client.attach(&dispatcher);
+    client.setMaxSessions(kClientFiles);
+
+    int finished = 0;
+    bool ok = true;
+    QObject::connect(&client, &FtpClient::downloadFinished, [&](int id, bool success, const QString &error) {
+        ++finished;
+        if (!success) {
+            fprintf(stderr, "client: download %d failed: %s\n", id, qPrintable(error));
+            ok = false;
+        }
+    });
+
+    int ids[kClientFiles];
+    QString fileNames[kClientFiles];
+    for (int i = 0; i < kClientFiles; ++i) {
+        fileNames[i] = dir.filePath(QStringLiteral("client%1.bin").arg(i));
+        ids[i] = client.download(&gcsLink,
+                                 kVehicleId,
+                                 MAV_COMP_ID_AUTOPILOT1,
+                                 QStringLiteral("/logs/%1.bin").arg(i),
+                                 fileNames[i]);
+    }
+
+    std::mt19937 random(7);
+    std::bernoulli_distribution lose(kClientLoss);
+    QElapsedTimer clock;
+    clock.start();
+    while (finished < kClientFiles && clock.elapsed() < kClientTimeoutMs) {
+        QCoreApplication::processEvents();
+
+        gcsLink.drain([&](const char *data, int length) {
+            for (const mavlink_message_t &message : vehicleFramer.parse(data, length)) {
+                if (message.msgid != MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL) {
+                    continue;
+                }
+                mavlink_file_transfer_protocol_t request;
+                mavlink_msg_file_transfer_protocol_decode(&message, &request);
+                server.handle(*reinterpret_cast<const Payload *>(request.payload));
+            }
+        });
+
+        Payload reply;
+        for (int n = 0; n < kRepliesPerStep && server.next(&reply); ++n) {
+            if (lose(random)) {
+                continue;
+            }
+            mavlink_file_transfer_protocol_t message;
+            message.target_network = 0;
+            message.target_system = gcs.systemId();
+            message.target_component = MAV_COMP_ID_MISSIONPLANNER;
+            memcpy(message.payload, &reply, sizeof(reply));
+            vehicle.send(&vehicleLink, message);
+        }
+
+        vehicleLink.drain([&](const char *data, int length) {
+            for (const mavlink_message_t &message : gcsFramer.parse(data, length)) {
+                dispatcher.dispatch(&vehicleLink, message);
+            }
+        });
+    }
+    const double seconds = clock.nsecsElapsed() / 1e9;
+
+    if (finished < kClientFiles) {
+        fprintf(stderr, "client: %d of %d downloads finished before the timeout\n", finished, kClientFiles);
+        return false;
+    }
+    qint64 received = 0;
+    for (int i = 0; i < kClientFiles; ++i) {
+        const FtpDownload::Statistics stats = client.statistics(ids[i]);
+        received += stats.received;
+        printf("client %d: %8.1f KB %6llu bursts %6llu reads %5llu gaps %4d chunk\n",
+               i,
+               stats.received / 1024.0,
+               stats.bursts,
+               stats.reads,
+               stats.gaps,
+               stats.chunkSize);
+        if (!sameContent(fileNames[i], files[i])) {
+            fprintf(stderr, "client: downloaded file %d differs\n", i);
+            ok = false;
+        }
+    }
+    printf("client: %d files in %.2fs, %.1f MB/s, %d requeued after NoSessionsAvailable, %d sessions left open\n",
+           kClientFiles,
+           seconds,
+           received / seconds / 1e6,
+           server.busyNaks(),
+           server.openSessions());
+    if (server.busyNaks() == 0) {
+        fprintf(stderr, "client: the vehicle never refused a session, requeue not exercised\n");
+        ok = false;
+    }
+    return ok;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const int sizeKb = argc > 1 ? atoi(argv[1]) : 1024;
+    if (sizeKb <= 0 || sizeKb > 1024 * 1024) {
+        fprintf(stderr, "file size must be in 1..%d KB\n", 1024 * 1024);
+        return 1;
+    }
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        fprintf(stderr, "cannot create a temporary directory\n");
+        return 1;
+    }
+
+    const LinkModel links[] = {
+        {"loopback", 0.1, 100e6, 0, 0},
+        {"LTE", 150, 1e6, 0.02, 0},
+        {"radio", 60, 12e3, 0, 1e-4},
+    };
+
+    const QByteArray data = makeFile(sizeKb * 1024, 1);
+    printf("%d KB file, simulated time\n", sizeKb);
+    printf("%-8s %7s %11s %5s %6s %8s %8s %6s %6s %5s %5s %7s %7s\n",
+           "link", "rtt", "rate", "loss", "ber", "time", "MB/s", "bursts", "reads", "gaps", "chunk",
+           "retries", "wall");
+    bool ok = true;
+    for (const auto &link : links) {
+        FtpDownload::Statistics stats;
+        double wall = 0;
+        if (!runSimulated(link, data, dir.filePath(QString::fromLatin1(link.name)), &stats, &wall)) {
+            ok = false;
+            continue;
+        }
+        printf("%-8s %5.1fms %7.0fkB/s %4.0f%% %6.0e %7.2fs %8.3f %6llu %6llu %5llu %5d %7llu %6.3fs\n",
+               link.name,
+               link.rttMs,
+               link.rate / 1e3,
+               link.loss * 100,
+               link.ber,
+               stats.elapsedUs / 1e6,
+               stats.bytesPerSecond / 1e6,
+               stats.bursts,
+               stats.reads,
+               stats.gaps,
+               stats.chunkSize,
+               stats.retries,
+               wall);
+    }
+
+    printf("\nFtpClient over a loopback link, %d files, %d sessions on the vehicle, %.0f%% loss\n",
+           kClientFiles,
+           kVehicleSessions,
+           kClientLoss * 100);
+    if (!runClient(dir, qMax(1, sizeKb / 4) * 1024)) {
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
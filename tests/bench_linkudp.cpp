@@ -0,0 +1,137 @@
+﻿/**************************************************************************
+ *   文件名	：bench_linkudp.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：LinkUdp 回环基准：每秒报文数和收包延迟
+ *   使用说明 ：bench_linkudp [-n 报文数] [-p 端口] [-6]
+ *             在途报文数限制在 kWindow 以内，测的是 LinkUdp 收发线程的处理能力
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "linkconfig.h"
+#include "linkudp.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QUdpSocket>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr int kPayloadSize = 64; // 报文大小，开头 8 字节为发送时刻
+constexpr int kWindow = 256;     // 最多在途的报文数，避免 socket 缓冲区溢出丢包
+
+qint64 nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption countOption("n", "Datagrams to send", "count", "200000");
+    QCommandLineOption portOption("p", "Local UDP port", "port", "14650");
+    QCommandLineOption ipv6Option("6", "Send over IPv6 loopback");
+    parser.addOptions({countOption, portOption, ipv6Option});
+    parser.process(app);
+
+    const int total = parser.value(countOption).toInt();
+    const quint16 port = quint16(parser.value(portOption).toUInt());
+    const QHostAddress loopback = parser.isSet(ipv6Option) ? QHostAddress(QHostAddress::LocalHostIPv6)
+                                                           : QHostAddress(QHostAddress::LocalHost);
+
+    auto config = QSharedPointer<LinkUdpConfig>::create();
+    config->setLocalPort(port);
+
+    // 延迟在 LinkUdp 的收发线程中计算，主线程只在结束后读取
+    std::vector<qint64> latencies;
+    latencies.reserve(total);
+    std::atomic<int> received{0};
+
+    LinkUdp link;
+    link.setConfig(config);
+    QObject::connect(
+        &link,
+        &LinkInterface::receiveData,
+        &link,
+        [&](const LinkInterface *, const QByteArray &data) {
+            const qint64 now = nowNs();
+            const int count = int(data.size()) / kPayloadSize;
+            for (int i = 0; i < count; ++i) {
+                qint64 sentAt;
+                memcpy(&sentAt, data.constData() + i * kPayloadSize, sizeof(sentAt));
+                latencies.push_back(now - sentAt);
+            }
+            received.fetch_add(count, std::memory_order_release);
+        },
+        Qt::DirectConnection);
+    if (!link.connectLink()) {
+        qCritical("bind failed on port %u", port);
+        return 1;
+    }
+
+    QUdpSocket sender;
+    char payload[kPayloadSize] = {};
+    const qint64 start = nowNs();
+    int sent = 0;
+    for (; sent < total; ++sent) {
+        // 窗口内的报文丢失时不会再有回应，等 1 秒后放弃
+        const qint64 stallDeadline = nowNs() + 1'000'000'000;
+        while (sent - received.load(std::memory_order_acquire) >= kWindow && nowNs() < stallDeadline) {
+            std::this_thread::yield();
+        }
+        if (sent - received.load(std::memory_order_acquire) >= kWindow) {
+            qWarning("stalled after %d datagrams, datagrams lost", sent);
+            break;
+        }
+        const qint64 ts = nowNs();
+        memcpy(payload, &ts, sizeof(ts));
+        if (sender.writeDatagram(payload, kPayloadSize, loopback, port) != kPayloadSize) {
+            qCritical("send failed: %s", qPrintable(sender.errorString()));
+            return 1;
+        }
+    }
+
+    // 丢失的报文最多等 2 秒
+    const qint64 deadline = nowNs() + 2'000'000'000;
+    while (received.load(std::memory_order_acquire) < sent && nowNs() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const qint64 elapsed = nowNs() - start;
+    link.disconnectLink();
+
+    if (latencies.empty()) {
+        qCritical("no datagrams received");
+        return 1;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        return latencies[std::min(latencies.size() - 1, size_t(p * latencies.size()))] / 1000.0;
+    };
+    printf("received %zu/%d datagrams in %.3f s\n", latencies.size(), sent, elapsed / 1e9);
+    printf("throughput %.0f datagrams/s\n", latencies.size() * 1e9 / elapsed);
+    printf("latency p50 %.1f us, p99 %.1f us, max %.1f us\n",
+           percentile(0.50),
+           percentile(0.99),
+           latencies.back() / 1000.0);
+    return 0;
+}
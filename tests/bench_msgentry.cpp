@@ -0,0 +1,116 @@
+﻿/**************************************************************************
+ *   文件名	：bench_msgentry.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：mavlink_get_msg_entry 基准：两级直接索引表与库中二分查找的每秒查找次数
+ *   使用说明 ：bench_msgentry [查找次数，默认 20000000]
+ *             按方言各编译一份（common、ardupilotmega、all），方言由 MAVLINK_DIALECT_HEADER 指定。
+ *             mavlinkprotocol.h 已替换掉库中的实现，这里保留一份同样的二分查找作对比，
+ *             先对 0..kMaxMsgId+256 的每个 msgid 检查两者结果一致，再分别测量
+ *             全部命中和一半未命中两种 msgid 序列
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "mavlinkprotocol.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#define BENCH_STRING(x) #x
+#define BENCH_EXPAND(x) BENCH_STRING(x)
+
+namespace {
+constexpr int kSequence = 1 << 16; // 预先生成的 msgid 序列长度，循环使用
+
+/// mavlink_helpers.h 中 mavlink_get_msg_entry 的二分查找，表同样按 msgid 升序
+const mavlink_msg_entry_t *bisect(uint32_t msgid)
+{
+    const auto *entries = MavlinkMsgTable::kEntries;
+    uint32_t low = 0;
+    uint32_t high = MavlinkMsgTable::kEntryCount - 1;
+    while (low < high) {
+        const uint32_t mid = (low + 1 + high) / 2;
+        if (msgid < entries[mid].msgid) {
+            high = mid - 1;
+            continue;
+        }
+        if (msgid > entries[mid].msgid) {
+            low = mid;
+            continue;
+        }
+        low = mid;
+        break;
+    }
+    return entries[low].msgid == msgid ? &entries[low] : nullptr;
+}
+
+template<typename Lookup>
+double run(const std::vector<uint32_t> &msgids, long long lookups, Lookup &&lookup, uint32_t *sink)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (long long n = 0; n < lookups; n += kSequence) {
+        for (const uint32_t msgid : msgids) {
+            const mavlink_msg_entry_t *entry = lookup(msgid);
+            *sink += entry ? entry->crc_extra : 1;
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const long long lookups = argc > 1 ? atoll(argv[1]) : 20000000;
+    if (lookups <= 0) {
+        fprintf(stderr, "lookup count must be positive\n");
+        return 1;
+    }
+
+    int mismatches = 0;
+    for (uint32_t msgid = 0; msgid <= MavlinkMsgTable::kMaxMsgId + 256; ++msgid) {
+        if (mavlink_get_msg_entry(msgid) != bisect(msgid)) {
+            ++mismatches;
+        }
+    }
+
+    std::mt19937 rng(1);
+    std::vector<uint32_t> hits(kSequence);
+    std::vector<uint32_t> mixed(kSequence);
+    for (int i = 0; i < kSequence; ++i) {
+        hits[i] = MavlinkMsgTable::kEntries[rng() % MavlinkMsgTable::kEntryCount].msgid;
+        // 未命中的 msgid 取 24 位范围内的随机值，大多落在空页
+        mixed[i] = rng() % 2 ? hits[i] : rng() & 0xFFFFFF;
+    }
+
+    printf("%s: %d messages, max msgid %u, %d pages, %d mismatches\n",
+           BENCH_EXPAND(MAVLINK_DIALECT_HEADER),
+           MavlinkMsgTable::kEntryCount,
+           MavlinkMsgTable::kMaxMsgId,
+           MavlinkMsgTable::kUsedPages,
+           mismatches);
+    printf("%-8s %14s %14s %8s\n", "msgids", "table/s", "bisect/s", "speedup");
+    uint32_t sink = 0;
+    const long long total = (lookups + kSequence - 1) / kSequence * kSequence;
+    for (const auto *sequence : {&hits, &mixed}) {
+        const double table = run(*sequence, lookups, mavlink_get_msg_entry, &sink);
+        const double bisection = run(*sequence, lookups, bisect, &sink);
+        printf("%-8s %14.0f %14.0f %7.1fx\n",
+               sequence == &hits ? "hits" : "50% miss",
+               total / table,
+               total / bisection,
+               bisection / table);
+    }
+    printf("(checksum %u)\n", sink);
+    return mismatches == 0 ? 0 : 1;
+}
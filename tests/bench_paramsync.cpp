@@ -0,0 +1,248 @@
+﻿/**************************************************************************
+ *   文件名	：bench_paramsync.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：ParameterSync 基准：模拟飞控上全量同步参数的用时，与逐个请求对比
+ *   使用说明 ：bench_paramsync [参数个数，默认 1200]
+ *             离散事件模拟，不依赖真实时间：飞控按链路速率逐条发出 PARAM_VALUE，
+ *             两个方向的每条消息按丢包率独立丢弃。逐个请求指一次只发一个
+ *             PARAM_REQUEST_READ，1 秒收不到回应时重发
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "parameterstore.h"
+#include "parametersync.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr qint64 kPollUs = 10000;         // 与 ParameterManager 的轮询间隔相同
+constexpr qint64 kSerialTimeoutUs = 1000000;
+constexpr qint64 kLimitUs = 3600000000LL; // 模拟时间上限
+
+struct LinkModel
+{
+    const char *name;
+    double rttMs;
+    double rate; // 飞控每秒能发出的 PARAM_VALUE 条数
+    double loss; // 每条消息的丢包率
+};
+
+/// 模拟飞控和链路：请求经过半个往返时间到达飞控，回应按链路速率排队发出
+class SimVehicle
+{
+public:
+    enum Kind {
+        ListRequest,
+        ReadRequest,
+        Value
+    };
+
+    struct Event
+    {
+        qint64 at;
+        quint64 seq; // 同一时刻按发生先后处理
+        Kind kind;
+        int index;
+        bool operator>(const Event &other) const { return at != other.at ? at > other.at : seq > other.seq; }
+    };
+
+    SimVehicle(const LinkModel &link, int count, unsigned seed)
+        : m_oneWayUs(qint64(link.rttMs * 500))
+        , m_txUs(qint64(1e6 / link.rate))
+        , m_count(count)
+        , m_random(seed)
+        , m_loss(link.loss)
+    {}
+
+    int count() const { return m_count; }
+    static float valueOf(int index) { return float(index) * 0.5f + 1.0f; }
+
+    void sendList(qint64 now) { toVehicle(now, ListRequest, -1); }
+    void sendRead(qint64 now, int index) { toVehicle(now, ReadRequest, index); }
+
+    bool isEmpty() const { return m_events.empty(); }
+    qint64 nextAt() const { return m_events.top().at; }
+
+    /// 处理下一个事件，到达地面站的 PARAM_VALUE 写入 value 并返回 true
+    bool step(mavlink_param_value_t *value)
+    {
+        const Event event = m_events.top();
+        m_events.pop();
+        switch (event.kind) {
+        case ListRequest:
+            for (int i = 0; i < m_count; ++i) {
+                reply(event.at, i);
+            }
+            return false;
+        case ReadRequest:
+            reply(event.at, event.index);
+            return false;
+        case Value:
+            break;
+        }
+        *value = {};
+        value->param_value = valueOf(event.index);
+        value->param_count = uint16_t(m_count);
+        value->param_index = uint16_t(event.index);
+        value->param_type = MAV_PARAM_TYPE_REAL32;
+        snprintf(value->param_id, sizeof(value->param_id), "PARAM_%05d", event.index);
+        return true;
+    }
+
+private:
+    bool lost() { return std::bernoulli_distribution(m_loss)(m_random); }
+
+    void toVehicle(qint64 now, Kind kind, int index)
+    {
+        if (!lost()) {
+            m_events.push({now + m_oneWayUs, m_seq++, kind, index});
+        }
+    }
+
+    void reply(qint64 now, int index)
+    {
+        // 丢失的消息同样占用链路时间
+        m_busyUntil = qMax(m_busyUntil, now) + m_txUs;
+        if (!lost()) {
+            m_events.push({m_busyUntil + m_oneWayUs, m_seq++, Value, index});
+        }
+    }
+
+    qint64 m_oneWayUs;
+    qint64 m_txUs;
+    int m_count;
+    std::mt19937 m_random;
+    double m_loss;
+    qint64 m_busyUntil = 0;
+    quint64 m_seq = 0;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> m_events;
+};
+
+/// 收到的参数与飞控一致才算同步成功
+bool verify(const ParameterStore &store, int count)
+{
+    if (store.count() != count || !store.isComplete()) {
+        return false;
+    }
+    for (int i = 0; i < count; ++i) {
+        char id[ParameterStore::kIdLength + 1];
+        snprintf(id, sizeof(id), "PARAM_%05d", i);
+        if (store.at(i)->value != SimVehicle::valueOf(i) || store.indexOf(id) != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// ParameterSync 全量同步，返回模拟用时（微秒），失败时返回 -1
+qint64 runWindowed(const LinkModel &link, int count, ParameterSync::Statistics *stats)
+{
+    SimVehicle vehicle(link, count, 1);
+    ParameterStore store;
+    ParameterSync sync(&store);
+    qint64 now = 0;
+    sync.setSenders([&]() { vehicle.sendList(now); }, [&](int index) { vehicle.sendRead(now, index); });
+    sync.start(now);
+
+    qint64 nextPoll = kPollUs;
+    mavlink_param_value_t value;
+    while (sync.isActive() && now < kLimitUs) {
+        if (vehicle.isEmpty() || nextPoll <= vehicle.nextAt()) {
+            now = nextPoll;
+            nextPoll += kPollUs;
+            sync.poll(now);
+            continue;
+        }
+        now = vehicle.nextAt();
+        if (vehicle.step(&value)) {
+            sync.received(value, now);
+        }
+    }
+    *stats = sync.statistics();
+    return sync.state() == ParameterSync::Done && verify(store, count) ? stats->elapsedUs : -1;
+}
+
+/// 逐个按下标请求，返回模拟用时（微秒）
+qint64 runSerial(const LinkModel &link, int count)
+{
+    SimVehicle vehicle(link, count, 1);
+    ParameterStore store;
+    store.reset(count);
+    qint64 now = 0;
+    mavlink_param_value_t value;
+    for (int index = 0; index < count && now < kLimitUs; ++index) {
+        vehicle.sendRead(now, index);
+        qint64 deadline = now + kSerialTimeoutUs;
+        while (!store.contains(index) && now < kLimitUs) {
+            if (vehicle.isEmpty() || deadline <= vehicle.nextAt()) {
+                now = deadline;
+                deadline = now + kSerialTimeoutUs;
+                vehicle.sendRead(now, index);
+                continue;
+            }
+            now = vehicle.nextAt();
+            if (vehicle.step(&value)) {
+                store.set(value.param_index, value.param_id, value.param_value, value.param_type);
+            }
+        }
+    }
+    return verify(store, count) ? now : -1;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const int count = argc > 1 ? atoi(argv[1]) : 1200;
+    if (count <= 0 || count > ParameterSync::kMaxReadIndex + 1) {
+        fprintf(stderr, "parameter count must be in 1..%d\n", ParameterSync::kMaxReadIndex + 1);
+        return 1;
+    }
+
+    const LinkModel links[] = {
+        {"LAN", 2, 1500, 0.02},
+        {"radio", 60, 300, 0.10},
+        {"LTE", 150, 1000, 0.05},
+    };
+
+    printf("%d parameters, simulated time\n", count);
+    printf("%-6s %6s %6s %5s %9s %9s %6s %7s %7s %7s %9s\n",
+           "link", "rtt", "rate", "loss", "windowed", "serial", "reads", "retries", "window", "srtt",
+           "speedup");
+    bool ok = true;
+    for (const auto &link : links) {
+        ParameterSync::Statistics stats;
+        const qint64 windowed = runWindowed(link, count, &stats);
+        const qint64 serial = runSerial(link, count);
+        if (windowed < 0 || serial < 0) {
+            fprintf(stderr, "%s: sync failed\n", link.name);
+            ok = false;
+            continue;
+        }
+        printf("%-6s %4.0fms %6.0f %4.0f%% %8.2fs %8.1fs %6llu %7llu %7d %5.1fms %8.1fx\n",
+               link.name,
+               link.rttMs,
+               link.rate,
+               link.loss * 100,
+               windowed / 1e6,
+               serial / 1e6,
+               stats.readRequests,
+               stats.retries,
+               stats.window,
+               stats.srttUs / 1e3,
+               double(serial) / double(windowed));
+    }
+    return ok ? 0 : 1;
+}
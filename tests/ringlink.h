@@ -0,0 +1,49 @@
+﻿/**************************************************************************
+ *   文件名	：ringlink.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：测试用连接：不做 I/O，由测试代码直接取出发送队列中的帧
+ *   使用说明 ：drain 按队列顺序逐帧回调，只能在一个线程中调用
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "linkinterface.h"
+
+class RingLink : public LinkInterface
+{
+public:
+    bool connectLink() override { return true; }
+    void disconnectLink() override {}
+    bool isConnected() const override { return true; }
+
+    /// 取出发送队列中的全部帧，按队列顺序调用 func(const char *data, int size)，返回帧数
+    template<typename Func>
+    int drain(Func &&func)
+    {
+        LinkSendRing::Span spans[64];
+        int total = 0;
+        int count;
+        while ((count = sendRing().peek(spans, 64)) > 0) {
+            for (int i = 0; i < count; ++i) {
+                func(spans[i].data, spans[i].size);
+            }
+            sendRing().release();
+            total += count;
+        }
+        return total;
+    }
+
+protected:
+    quint64 writeData(const QByteArray &data) override { return data.size(); }
+    void wakeIoThread() override {}
+};
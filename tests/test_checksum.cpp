@@ -0,0 +1,82 @@
+﻿/**************************************************************************
+ *   文件名	：test_checksum.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：slice-by-8 CRC 与逐字节 crc_accumulate 的等价性测试
+ *   使用说明 ：随机长度、起始偏移和初值，任何不一致都返回非 0
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "checksum.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr int kRounds = 200000;
+constexpr int kMaxLength = 300; // 比最长的 MAVLink 帧再多一些
+constexpr int kMaxOffset = 8;   // 覆盖所有 8 字节对齐情况
+
+uint16_t referenceCrc(uint16_t crc, const uint8_t *p, int length)
+{
+    while (length--) {
+        crc_accumulate(*p++, &crc);
+    }
+    return crc;
+}
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(20240926);
+    std::vector<uint8_t> buffer(kMaxLength + kMaxOffset);
+    int mismatches = 0;
+
+    for (int round = 0; round < kRounds; ++round) {
+        for (auto &byte : buffer) {
+            byte = uint8_t(rng());
+        }
+        const int offset = int(rng() % kMaxOffset);
+        const int length = int(rng() % (kMaxLength + 1));
+        const uint8_t *data = buffer.data() + offset;
+
+        // crc_calculate 从 X25_INIT_CRC 开始
+        const uint16_t expected = referenceCrc(X25_INIT_CRC, data, length);
+        const uint16_t actual = crc_calculate(data, uint16_t(length));
+
+        // crc_accumulate_buffer 从任意初值开始，并按两段分别累加
+        const uint16_t seed = uint16_t(rng());
+        const int split = length ? int(rng() % (length + 1)) : 0;
+        uint16_t accumulated = seed;
+        crc_accumulate_buffer(&accumulated, reinterpret_cast<const char *>(data), uint16_t(split));
+        crc_accumulate_buffer(&accumulated,
+                              reinterpret_cast<const char *>(data + split),
+                              uint16_t(length - split));
+        const uint16_t expectedSeeded = referenceCrc(seed, data, length);
+
+        if (actual != expected || accumulated != expectedSeeded) {
+            if (++mismatches <= 10) {
+                printf("mismatch: offset %d length %d seed 0x%04x: 0x%04x/0x%04x, 0x%04x/0x%04x\n",
+                       offset,
+                       length,
+                       seed,
+                       actual,
+                       expected,
+                       accumulated,
+                       expectedSeeded);
+            }
+        }
+    }
+
+    printf("%d buffers, %d mismatches\n", kRounds, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
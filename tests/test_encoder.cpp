@@ -0,0 +1,141 @@
+﻿/**************************************************************************
+ *   文件名	：test_encoder.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MavlinkEncoder 测试：多线程签名发送的时间戳顺序、sendEncoded 的长度检查
+ *   使用说明 ：多个线程同时发送签名帧，接收方按队列顺序校验，不能出现 REPLAY
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "mavlinkencoder.h"
+#include "mavlinksignature.h"
+#include "ringlink.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr int kThreads = 4;
+constexpr int kFramesPerThread = 20000;
+
+/// 由队列中的一帧还原出 mavlink_message_t，只处理 MAVLink 2
+bool toMessage(const char *data, int size, mavlink_message_t *message)
+{
+    const uint8_t *frame = reinterpret_cast<const uint8_t *>(data);
+    if (size < MAVLINK_NUM_NON_PAYLOAD_BYTES || frame[0] != MAVLINK_STX) {
+        return false;
+    }
+    const int len = frame[1];
+    const bool signedFrame = frame[2] & MAVLINK_IFLAG_SIGNED;
+    if (size != MAVLINK_NUM_NON_PAYLOAD_BYTES + len + (signedFrame ? MAVLINK_SIGNATURE_BLOCK_LEN : 0)) {
+        return false;
+    }
+    memset(message, 0, sizeof(*message));
+    memcpy(&message->magic, frame, MAVLINK_NUM_HEADER_BYTES);
+    memcpy(_MAV_PAYLOAD_NON_CONST(message), frame + MAVLINK_NUM_HEADER_BYTES, len);
+    memcpy(message->ck, frame + MAVLINK_NUM_HEADER_BYTES + len, 2);
+    if (signedFrame) {
+        memcpy(message->signature, frame + MAVLINK_NUM_HEADER_BYTES + len + 2, MAVLINK_SIGNATURE_BLOCK_LEN);
+    }
+    return true;
+}
+
+int testConcurrentSigning()
+{
+    mavlink_signing_t tx = {};
+    tx.flags = MAVLINK_SIGNING_FLAG_SIGN_OUTGOING;
+    tx.link_id = 1;
+    tx.timestamp = 1;
+    for (int i = 0; i < 32; ++i) {
+        tx.secret_key[i] = uint8_t(i * 7 + 3);
+    }
+    mavlink_signing_t rx = {};
+    memcpy(rx.secret_key, tx.secret_key, sizeof(rx.secret_key));
+    mavlink_signing_streams_t streams = {};
+
+    RingLink link;
+    MavlinkEncoder encoder(1, 1);
+    encoder.setSigning(&tx);
+
+    std::atomic<int> running{kThreads};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            mavlink_attitude_t attitude = {};
+            for (int i = 0; i < kFramesPerThread; ++i) {
+                attitude.time_boot_ms = uint32_t(i);
+                attitude.roll = float(t);
+                while (!encoder.send(&link, attitude)) {
+                    std::this_thread::yield(); // 队列满，等消费者取走
+                }
+            }
+            running.fetch_sub(1);
+        });
+    }
+
+    int received = 0;
+    int rejected = 0;
+    int replays = 0;
+    auto check = [&](const char *data, int size) {
+        ++received;
+        mavlink_message_t message;
+        if (!toMessage(data, size, &message) || !MavlinkSignature::check(&rx, &streams, &message)) {
+            ++rejected;
+            if (rx.last_status == MAVLINK_SIGNING_STATUS_REPLAY) {
+                ++replays;
+            }
+        }
+    };
+    while (running.load() > 0) {
+        if (link.drain(check) == 0) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    link.drain(check);
+
+    const int expected = kThreads * kFramesPerThread;
+    printf("concurrent signing: %d/%d frames, %d rejected (%d replay)\n", received, expected, rejected, replays);
+    return received == expected && rejected == 0 ? 0 : 1;
+}
+
+int testTruncatedEncoded()
+{
+    RingLink link;
+    MavlinkEncoder encoder(1, 1);
+    mavlink_attitude_t attitude = {};
+    attitude.roll = 1.0f;
+    uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+    const int size = encoder.encode(frame, MavlinkMessageTraits<mavlink_attitude_t>::id, &attitude, sizeof(attitude));
+
+    // 长度字节声明的负载超出 frame 时必须拒绝，不能越界复制
+    const bool truncated = encoder.sendEncoded(&link, frame, size - 1);
+    const bool whole = encoder.sendEncoded(&link, frame, size);
+    int sizes = 0;
+    link.drain([&](const char *, int frameSize) { sizes += frameSize; });
+
+    printf("sendEncoded: truncated %s, whole %s\n", truncated ? "accepted" : "rejected", whole ? "accepted" : "rejected");
+    return !truncated && whole && sizes == size ? 0 : 1;
+}
+} // namespace
+
+int main()
+{
+    int failures = 0;
+    failures += testConcurrentSigning();
+    failures += testTruncatedEncoded();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,342 @@
+﻿/**************************************************************************
+ *   文件名	：test_framer.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MavlinkFramer::parse 与逐字节 mavlink_parse_char 的等价性测试
+ *   使用说明 ：随机生成 MAVLink 1/2 帧、签名帧、错误密钥的签名帧和重放帧，
+ *             按比例翻转、删除字节或插入垃圾数据，随机切块交给 MavlinkFramer，
+ *             同一数据逐字节交给 mavlink_parse_char。比较解析出的帧、
+ *             解析错误数（parse_error 之和）、packet_rx_drop_count 等通道状态、
+ *             CRC 错误数，以及签名判定、last_status 和签名流状态
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "mavlinkframer.h"
+#include "mavlinksigningstreams.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr int kStreams = 300;
+constexpr int kFramesPerStream = 1000;
+constexpr int kMaxChunk = 1024;
+constexpr uint8_t kChannel = MAVLINK_COMM_0;
+constexpr uint8_t kCheckChannel = MAVLINK_COMM_1; // 直接调用 mavlink_parse_char，核对 referenceParse
+
+struct Options
+{
+    double corruption; // 每帧被改动的概率
+    bool signing;      // 接收方开启签名校验
+};
+
+/// 未签名的 HEARTBEAT 也接受，覆盖 accept_unsigned_callback
+bool acceptHeartbeat(const mavlink_status_t *status, uint32_t msgid)
+{
+    (void)status;
+    return msgid == MAVLINK_MSG_ID_HEARTBEAT;
+}
+
+/// 生成一段数据：MAVLink 1/2 帧、签名帧、错误密钥签名帧、重放帧，按 corruption 改动
+std::vector<uint8_t> makeStream(std::mt19937 &rng, const uint8_t key[32], double corruption)
+{
+    mavlink_signing_t good = {};
+    good.flags = MAVLINK_SIGNING_FLAG_SIGN_OUTGOING;
+    good.timestamp = 1000000 + rng() % 1000;
+    memcpy(good.secret_key, key, 32);
+    mavlink_signing_t bad = good;
+    bad.secret_key[rng() % 32] ^= 0x5A;
+
+    mavlink_status_t tx = {};
+    std::vector<uint8_t> stream;
+    std::vector<std::vector<uint8_t>> signedFrames;
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    for (int n = 0; n < kFramesPerStream; ++n) {
+        const double kind = uniform(rng);
+        if (kind < 0.03 && !signedFrames.empty()) {
+            const auto &old = signedFrames[rng() % signedFrames.size()];
+            stream.insert(stream.end(), old.begin(), old.end());
+            continue;
+        }
+
+        const auto &entry = MavlinkMsgTable::kEntries[rng() % MavlinkMsgTable::kEntryCount];
+        mavlink_message_t msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msgid = entry.msgid;
+        char *payload = _MAV_PAYLOAD_NON_CONST(&msg);
+        for (int i = 0; i < entry.max_msg_len; ++i) {
+            // 一部分负载以 0 结尾，覆盖 MAVLink 2 的截短
+            payload[i] = i >= entry.min_msg_len && rng() % 2 ? 0 : char(rng());
+        }
+
+        const bool mavlink1 = kind < 0.15 && entry.msgid < 256;
+        tx.flags = mavlink1 ? MAVLINK_STATUS_FLAG_OUT_MAVLINK1 : 0;
+        tx.signing = nullptr;
+        if (!mavlink1 && kind > 0.4) {
+            tx.signing = kind > 0.95 ? &bad : &good;
+            tx.signing->link_id = uint8_t(rng() % 2);
+        }
+        mavlink_finalize_message_buffer(&msg,
+                                        uint8_t(1 + rng() % 4),
+                                        uint8_t(1 + rng() % 2),
+                                        &tx,
+                                        entry.min_msg_len,
+                                        entry.max_msg_len,
+                                        entry.crc_extra);
+        // 两个签名上下文的时间戳一起前进，错误密钥的帧不会因时间戳被拒
+        bad.timestamp = good.timestamp = std::max(good.timestamp, bad.timestamp);
+
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        std::vector<uint8_t> frame(buffer, buffer + mavlink_msg_to_send_buffer(buffer, &msg));
+        if (tx.signing == &good) {
+            signedFrames.push_back(frame);
+        }
+
+        if (uniform(rng) < corruption) {
+            switch (rng() % 4) {
+            case 0:
+                frame[rng() % frame.size()] ^= uint8_t(1 + rng() % 255);
+                break;
+            case 1:
+                frame.erase(frame.begin() + rng() % frame.size());
+                break;
+            case 2:
+                frame.resize(rng() % frame.size());
+                break;
+            default: {
+                // 垃圾数据中多放帧头字节
+                const int size = 1 + int(rng() % 20);
+                for (int i = 0; i < size; ++i) {
+                    const uint32_t r = rng() % 4;
+                    frame.insert(frame.begin() + rng() % (frame.size() + 1),
+                                 r == 0 ? MAVLINK_STX : r == 1 ? MAVLINK_STX_MAVLINK1 : uint8_t(rng()));
+                }
+                break;
+            }
+            }
+        }
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    return stream;
+}
+
+struct Result
+{
+    std::vector<mavlink_message_t> frames;
+    quint64 parseErrors = 0;
+    quint64 crcErrors = 0;
+    quint64 badSignatures = 0;
+    mavlink_status_t status = {};
+    mavlink_signing_t signing = {};
+    mavlink_signing_streams_t streams = {};
+};
+
+void initSigning(mavlink_signing_t *signing, const uint8_t key[32])
+{
+    *signing = {};
+    memcpy(signing->secret_key, key, 32);
+    signing->accept_unsigned_callback = acceptHeartbeat;
+}
+
+/// 与 mavlink_parse_char 相同，另外统计 CRC 错误和签名错误
+uint8_t referenceParse(uint8_t c, mavlink_message_t *msg, mavlink_status_t *r_status, Result *result)
+{
+    const uint8_t framing = mavlink_frame_char(kChannel, c, msg, r_status);
+    if (framing == MAVLINK_FRAMING_BAD_CRC || framing == MAVLINK_FRAMING_BAD_SIGNATURE) {
+        if (framing == MAVLINK_FRAMING_BAD_CRC) {
+            ++result->crcErrors;
+        } else {
+            ++result->badSignatures;
+        }
+        mavlink_message_t *rxmsg = mavlink_get_channel_buffer(kChannel);
+        mavlink_status_t *status = mavlink_get_channel_status(kChannel);
+        status->parse_error++;
+        status->msg_received = MAVLINK_FRAMING_INCOMPLETE;
+        status->parse_state = MAVLINK_PARSE_STATE_IDLE;
+        if (c == MAVLINK_STX) {
+            status->parse_state = MAVLINK_PARSE_STATE_GOT_STX;
+            rxmsg->len = 0;
+            mavlink_start_checksum(rxmsg);
+        }
+        return 0;
+    }
+    return framing;
+}
+
+/// 逐字节解析，返回值与直接调用 mavlink_parse_char 不一致时 consistent 置为 false
+Result runReference(const std::vector<uint8_t> &stream, const uint8_t key[32], const Options &options, bool *consistent)
+{
+    Result result;
+    initSigning(&result.signing, key);
+    mavlink_signing_t checkSigning = result.signing;
+    mavlink_signing_streams_t checkStreams = {};
+    for (const uint8_t channel : {kChannel, kCheckChannel}) {
+        memset(mavlink_get_channel_status(channel), 0, sizeof(mavlink_status_t));
+        memset(mavlink_get_channel_buffer(channel), 0, sizeof(mavlink_message_t));
+    }
+    if (options.signing) {
+        mavlink_get_channel_status(kChannel)->signing = &result.signing;
+        mavlink_get_channel_status(kChannel)->signing_streams = &result.streams;
+        mavlink_get_channel_status(kCheckChannel)->signing = &checkSigning;
+        mavlink_get_channel_status(kCheckChannel)->signing_streams = &checkStreams;
+    }
+
+    mavlink_message_t msg;
+    mavlink_message_t checkMsg;
+    mavlink_status_t r_status;
+    mavlink_status_t checkStatus;
+    for (const uint8_t c : stream) {
+        const uint8_t ok = referenceParse(c, &msg, &r_status, &result);
+        if (mavlink_parse_char(kCheckChannel, c, &checkMsg, &checkStatus) != ok) {
+            *consistent = false;
+        }
+        result.parseErrors += r_status.packet_rx_drop_count;
+        if (ok == MAVLINK_FRAMING_OK) {
+            result.frames.push_back(msg);
+        }
+    }
+    // 最后一个坏帧的错误要到下一个字节才计入 r_status
+    result.parseErrors += mavlink_get_channel_status(kChannel)->parse_error;
+    result.status = *mavlink_get_channel_status(kChannel);
+    return result;
+}
+
+/// 随机切块交给 MavlinkFramer
+Result runFramer(std::mt19937 &rng, const std::vector<uint8_t> &stream, const uint8_t key[32], const Options &options)
+{
+    Result result;
+    initSigning(&result.signing, key);
+    MavlinkFramer framer;
+    if (options.signing) {
+        framer.setSigning(&result.signing, &result.streams);
+    }
+
+    size_t pos = 0;
+    while (pos < stream.size()) {
+        const size_t size = std::min<size_t>(stream.size() - pos, 1 + rng() % kMaxChunk);
+        const auto &frames = framer.parse(reinterpret_cast<const char *>(stream.data() + pos), qsizetype(size));
+        result.frames.insert(result.frames.end(), frames.begin(), frames.end());
+        pos += size;
+    }
+    result.parseErrors = framer.parseErrors();
+    result.crcErrors = framer.crcErrors();
+    result.status = framer.status();
+    return result;
+}
+
+bool sameFrame(const mavlink_message_t &a, const mavlink_message_t &b)
+{
+    if (a.magic != b.magic || a.len != b.len || a.incompat_flags != b.incompat_flags
+        || a.compat_flags != b.compat_flags || a.seq != b.seq || a.sysid != b.sysid || a.compid != b.compid
+        || a.msgid != b.msgid || a.checksum != b.checksum || memcmp(a.ck, b.ck, 2) != 0
+        || memcmp(_MAV_PAYLOAD(&a), _MAV_PAYLOAD(&b), a.len) != 0) {
+        return false;
+    }
+    return !(a.incompat_flags & MAVLINK_IFLAG_SIGNED)
+           || memcmp(a.signature, b.signature, MAVLINK_SIGNATURE_BLOCK_LEN) == 0;
+}
+
+/// 返回不一致的项目，一致时返回 nullptr
+const char *compare(const Result &framer, const Result &reference)
+{
+    if (framer.frames.size() != reference.frames.size()) {
+        return "frame count";
+    }
+    for (size_t i = 0; i < framer.frames.size(); ++i) {
+        if (!sameFrame(framer.frames[i], reference.frames[i])) {
+            return "frame content";
+        }
+    }
+    if (framer.parseErrors != reference.parseErrors) {
+        return "parse errors";
+    }
+    if (framer.crcErrors != reference.crcErrors) {
+        return "crc errors";
+    }
+    const mavlink_status_t &a = framer.status;
+    const mavlink_status_t &b = reference.status;
+    if (a.packet_rx_drop_count != b.packet_rx_drop_count || a.packet_rx_success_count != b.packet_rx_success_count
+        || a.current_rx_seq != b.current_rx_seq || a.parse_state != b.parse_state) {
+        return "channel status";
+    }
+    if (framer.signing.last_status != reference.signing.last_status
+        || framer.signing.timestamp != reference.signing.timestamp
+        || memcmp(&framer.streams, &reference.streams, sizeof(framer.streams)) != 0) {
+        return "signing state";
+    }
+    return nullptr;
+}
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(20240926);
+    uint8_t key[32];
+    for (auto &byte : key) {
+        byte = uint8_t(rng());
+    }
+
+    const Options cases[] = {
+        {0.0, false},
+        {0.0, true},
+        {0.05, false},
+        {0.05, true},
+        {0.3, true},
+    };
+
+    int failures = 0;
+    bool consistent = true;
+    for (const auto &options : cases) {
+        Result total;
+        quint64 bytes = 0;
+        quint64 frames = 0;
+        for (int n = 0; n < kStreams; ++n) {
+            const auto stream = makeStream(rng, key, options.corruption);
+            const Result reference = runReference(stream, key, options, &consistent);
+            const Result framer = runFramer(rng, stream, key, options);
+            if (const char *what = compare(framer, reference)) {
+                if (failures < 10) {
+                    fprintf(stderr,
+                            "corruption %.2f signing %d stream %d: %s differs\n",
+                            options.corruption,
+                            int(options.signing),
+                            n,
+                            what);
+                }
+                ++failures;
+            }
+            bytes += stream.size();
+            total.parseErrors += reference.parseErrors;
+            total.crcErrors += reference.crcErrors;
+            total.badSignatures += reference.badSignatures;
+            frames += reference.frames.size();
+        }
+        printf("corruption %.2f signing %-3s: %llu bytes, %llu frames, %llu parse errors, %llu crc errors, "
+               "%llu bad signatures\n",
+               options.corruption,
+               options.signing ? "on" : "off",
+               (unsigned long long) bytes,
+               (unsigned long long) frames,
+               (unsigned long long) total.parseErrors,
+               (unsigned long long) total.crcErrors,
+               (unsigned long long) total.badSignatures);
+    }
+
+    if (!consistent) {
+        fprintf(stderr, "referenceParse differs from mavlink_parse_char\n");
+        ++failures;
+    }
+    printf("%d mismatching streams\n", failures);
+    return failures == 0 ? 0 : 1;
+}
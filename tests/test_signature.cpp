@@ -0,0 +1,240 @@
+﻿/**************************************************************************
+ *   文件名	：test_signature.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MavlinkSignature 与 MAVLink 参考实现的等价性测试
+ *   使用说明 ：随机密钥、帧头、负载和时间戳，比较 sign 生成的签名块，
+ *             并检查 signatureMatches 对原帧和改动一个字节的帧的结果。
+ *             批量 verify 在本机支持的每种实现下与参考 SHA-256 逐帧比较，
+ *             带时间戳检查的 verify 与逐帧调用 mavlink_signature_check 比较
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "mavlinksignature.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr int kRounds = 100000;
+constexpr int kBatchFrames = 50000;
+constexpr int kMaxBatch = 100;
+constexpr int kHeaderLen = MAVLINK_NUM_HEADER_BYTES;
+
+/// 由连续的帧（帧头 + 负载 + CRC + 签名块）还原出 mavlink_message_t
+void toMessage(const uint8_t *frame, int payloadLen, mavlink_message_t *message)
+{
+    memset(message, 0, sizeof(*message));
+    memcpy(&message->magic, frame, kHeaderLen);
+    memcpy(_MAV_PAYLOAD_NON_CONST(message), frame + kHeaderLen, payloadLen);
+    memcpy(message->ck, frame + kHeaderLen + payloadLen, 2);
+    memcpy(message->signature, frame + kHeaderLen + payloadLen + 2, MAVLINK_SIGNATURE_BLOCK_LEN);
+}
+
+/// 参考实现：与 mavlink_signature_check 中的签名计算相同
+bool referenceMatches(const uint8_t key[32], const mavlink_message_t *message)
+{
+    mavlink_sha256_ctx ctx;
+    uint8_t signature[6];
+    mavlink_sha256_init(&ctx);
+    mavlink_sha256_update(&ctx, key, 32);
+    mavlink_sha256_update(&ctx, &message->magic, kHeaderLen);
+    mavlink_sha256_update(&ctx, _MAV_PAYLOAD(message), message->len);
+    mavlink_sha256_update(&ctx, message->ck, 2);
+    mavlink_sha256_update(&ctx, message->signature, 7);
+    mavlink_sha256_final_48(&ctx, signature);
+    return memcmp(signature, message->signature + 7, 6) == 0;
+}
+
+struct SignedFrames
+{
+    std::vector<uint8_t> bytes; // 连续存放的帧
+    std::vector<int> offsets;
+    std::vector<mavlink_message_t> messages;
+};
+
+/// 同一密钥签名的帧：少量流、偶尔重放旧帧、约四分之一改动一个字节
+SignedFrames makeFrames(std::mt19937_64 &rng, const uint8_t key[32])
+{
+    SignedFrames frames;
+    mavlink_signing_t signing = {};
+    signing.flags = MAVLINK_SIGNING_FLAG_SIGN_OUTGOING;
+    signing.timestamp = 1000000;
+    memcpy(signing.secret_key, key, 32);
+
+    for (int n = 0; n < kBatchFrames; ++n) {
+        if (n > 0 && rng() % 20 == 0) {
+            // 重放之前的一帧
+            const int old = int(rng() % frames.offsets.size());
+            const int offset = frames.offsets[old];
+            const int size = kHeaderLen + frames.bytes[offset + 1] + 2 + MAVLINK_SIGNATURE_BLOCK_LEN;
+            frames.offsets.push_back(int(frames.bytes.size()));
+            frames.bytes.insert(frames.bytes.end(), frames.bytes.begin() + offset, frames.bytes.begin() + offset + size);
+            continue;
+        }
+        const int payloadLen = int(rng() % (MAVLINK_MAX_PAYLOAD_LEN + 1));
+        const int size = kHeaderLen + payloadLen + 2;
+        uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+        for (int i = 0; i < size; ++i) {
+            frame[i] = uint8_t(rng());
+        }
+        frame[0] = MAVLINK_STX;
+        frame[1] = uint8_t(payloadLen);
+        frame[2] = MAVLINK_IFLAG_SIGNED;
+        frame[5] = uint8_t(1 + rng() % 4); // sysid
+        frame[6] = uint8_t(1 + rng() % 2); // compid
+        signing.link_id = uint8_t(rng() % 2);
+        signing.timestamp += rng() % 3;
+        mavlink_sign_packet(&signing, frame + size, frame, kHeaderLen, frame + kHeaderLen, uint8_t(payloadLen),
+                            frame + kHeaderLen + payloadLen);
+        if (rng() % 4 == 0) {
+            const int flip = int(rng() % (size + MAVLINK_SIGNATURE_BLOCK_LEN));
+            if (flip != 1) {
+                frame[flip] ^= uint8_t(1 + rng() % 255);
+            }
+        }
+        frames.offsets.push_back(int(frames.bytes.size()));
+        frames.bytes.insert(frames.bytes.end(), frame, frame + size + MAVLINK_SIGNATURE_BLOCK_LEN);
+    }
+
+    frames.messages.resize(frames.offsets.size());
+    for (size_t i = 0; i < frames.offsets.size(); ++i) {
+        const uint8_t *frame = frames.bytes.data() + frames.offsets[i];
+        toMessage(frame, frame[1], &frames.messages[i]);
+    }
+    return frames;
+}
+
+/// 随机大小分批调用 verify，与参考实现和逐帧 mavlink_signature_check 比较，返回不一致的帧数
+int checkBatches(std::mt19937_64 &rng, const uint8_t key[32], const SignedFrames &frames)
+{
+    const int total = int(frames.messages.size());
+    std::vector<const mavlink_message_t *> messages(total);
+    std::vector<const uint8_t *> framePtrs(total);
+    for (int i = 0; i < total; ++i) {
+        messages[i] = &frames.messages[i];
+        framePtrs[i] = frames.bytes.data() + frames.offsets[i];
+    }
+
+    mavlink_signing_t reference = {};
+    memcpy(reference.secret_key, key, 32);
+    mavlink_signing_streams_t referenceStreams = {};
+    mavlink_signing_t ours = reference;
+    mavlink_signing_streams_t ourStreams = {};
+
+    int mismatches = 0;
+    bool matches[kMaxBatch];
+    bool frameMatches[kMaxBatch];
+    bool verdicts[kMaxBatch];
+    for (int start = 0; start < total;) {
+        const int count = std::min(total - start, int(1 + rng() % kMaxBatch));
+        MavlinkSignature::verify(key, messages.data() + start, count, matches);
+        MavlinkSignature::verify(key, framePtrs.data() + start, count, frameMatches);
+        MavlinkSignature::verify(&ours, &ourStreams, messages.data() + start, count, verdicts);
+        for (int i = 0; i < count; ++i) {
+            const bool expected = referenceMatches(key, messages[start + i]);
+            const bool accepted = mavlink_signature_check(&reference, &referenceStreams, messages[start + i]);
+            if (matches[i] != expected || frameMatches[i] != expected || verdicts[i] != accepted) {
+                ++mismatches;
+            }
+        }
+        if (ours.last_status != reference.last_status || ours.timestamp != reference.timestamp
+            || memcmp(&ourStreams, &referenceStreams, sizeof(ourStreams)) != 0) {
+            ++mismatches;
+        }
+        start += count;
+    }
+    return mismatches;
+}
+} // namespace
+
+int main()
+{
+    std::mt19937_64 rng(20240926);
+    int signMismatches = 0;
+    int verifyMismatches = 0;
+
+    for (int round = 0; round < kRounds; ++round) {
+        mavlink_signing_t reference = {};
+        reference.flags = MAVLINK_SIGNING_FLAG_SIGN_OUTGOING;
+        reference.link_id = uint8_t(rng());
+        reference.timestamp = rng() & 0xFFFFFFFFFFFFULL;
+        for (auto &byte : reference.secret_key) {
+            byte = uint8_t(rng());
+        }
+        mavlink_signing_t ours = reference;
+
+        const int payloadLen = int(rng() % (MAVLINK_MAX_PAYLOAD_LEN + 1));
+        const int size = kHeaderLen + payloadLen + 2;
+        uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+        for (int i = 0; i < size; ++i) {
+            frame[i] = uint8_t(rng());
+        }
+        frame[0] = MAVLINK_STX;
+        frame[1] = uint8_t(payloadLen);
+        frame[2] = MAVLINK_IFLAG_SIGNED;
+
+        uint8_t expected[MAVLINK_SIGNATURE_BLOCK_LEN];
+        mavlink_sign_packet(&reference, expected, frame, kHeaderLen, frame + kHeaderLen, uint8_t(payloadLen),
+                            frame + kHeaderLen + payloadLen);
+        const int written = MavlinkSignature::sign(&ours, frame, size);
+        if (written != MAVLINK_SIGNATURE_BLOCK_LEN || memcmp(expected, frame + size, written) != 0
+            || ours.timestamp != reference.timestamp) {
+            ++signMismatches;
+            continue;
+        }
+
+        mavlink_message_t message;
+        toMessage(frame, payloadLen, &message);
+        if (!MavlinkSignature::signatureMatches(ours.secret_key, &message)) {
+            ++verifyMismatches;
+        }
+
+        // 改动帧头、负载、CRC 或签名块中的任意一个字节都必须校验失败
+        const int flip = int(rng() % (size + MAVLINK_SIGNATURE_BLOCK_LEN));
+        frame[flip] ^= uint8_t(1 + rng() % 255);
+        if (flip == 1) {
+            frame[1] = uint8_t(payloadLen); // 长度字节决定帧的布局，改为改 seq
+            frame[4] ^= 1;
+        }
+        toMessage(frame, payloadLen, &message);
+        if (MavlinkSignature::signatureMatches(ours.secret_key, &message)) {
+            ++verifyMismatches;
+        }
+    }
+
+    printf("%d frames (%s): %d sign mismatches, %d verify mismatches\n",
+           kRounds,
+           MavlinkSignature::backend(),
+           signMismatches,
+           verifyMismatches);
+
+    uint8_t key[32];
+    for (auto &byte : key) {
+        byte = uint8_t(rng());
+    }
+    const SignedFrames frames = makeFrames(rng, key);
+    int batchMismatches = 0;
+    for (const char *backend : {"sha-ni", "avx2", "scalar"}) {
+        if (!MavlinkSignature::setBackend(backend)) {
+            printf("batch verify (%s): not supported on this CPU\n", backend);
+            continue;
+        }
+        const int mismatches = checkBatches(rng, key, frames);
+        printf("batch verify (%s): %d frames, %d mismatches\n", backend, int(frames.messages.size()), mismatches);
+        batchMismatches += mismatches;
+    }
+
+    return signMismatches == 0 && verifyMismatches == 0 && batchMismatches == 0 ? 0 : 1;
+}
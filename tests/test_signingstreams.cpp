@@ -0,0 +1,242 @@
+﻿/**************************************************************************
+ *   文件名	：test_signingstreams.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：MavlinkSigningStreams 的等价性和淘汰测试
+ *   使用说明 ：不超过 16 个流时，accept 的结果、last_status 和时间戳与 mavlink_signature_check
+ *             逐帧比较，帧中有重放、过旧的新流和签名错误。流很多且空闲超时取最小值时，
+ *             被淘汰流的旧帧重放必须仍被拒绝。setMaxStreams 的强制淘汰计数和流数量
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "mavlinksignature.h"
+#include "mavlinksigningstreams.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr int kEquivalenceFrames = 200000;
+constexpr int kReplayFrames = 200000;
+
+struct Signer
+{
+    mavlink_signing_t signing;
+    mavlink_status_t status;
+};
+
+void initSigner(Signer *signer, const uint8_t key[32])
+{
+    memset(signer, 0, sizeof(*signer));
+    signer->signing.flags = MAVLINK_SIGNING_FLAG_SIGN_OUTGOING;
+    memcpy(signer->signing.secret_key, key, 32);
+    signer->status.signing = &signer->signing;
+}
+
+/// 以 (sysid, compid, linkId) 签名一帧 HEARTBEAT，签名时间戳为 timestamp
+mavlink_message_t signedFrame(Signer *signer, uint8_t sysid, uint8_t compid, uint8_t linkId, quint64 timestamp)
+{
+    mavlink_heartbeat_t heartbeat = {};
+    heartbeat.custom_mode = uint32_t(timestamp);
+    mavlink_message_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msgid = MAVLINK_MSG_ID_HEARTBEAT;
+    memcpy(_MAV_PAYLOAD_NON_CONST(&msg), &heartbeat, sizeof(heartbeat));
+    signer->signing.link_id = linkId;
+    signer->signing.timestamp = timestamp;
+    mavlink_finalize_message_buffer(&msg,
+                                    sysid,
+                                    compid,
+                                    &signer->status,
+                                    MAVLINK_MSG_ID_HEARTBEAT_MIN_LEN,
+                                    MAVLINK_MSG_ID_HEARTBEAT_LEN,
+                                    MAVLINK_MSG_ID_HEARTBEAT_CRC);
+    // finalize 把 CRC 写在负载之后，解析器收到的帧则放在 ck 中，签名校验读的是 ck
+    memcpy(msg.ck, _MAV_PAYLOAD(&msg) + msg.len, 2);
+    return msg;
+}
+
+/// 不超过 16 个流：与 mavlink_signature_check 逐帧比较，返回不一致的帧数
+int testEquivalence(std::mt19937_64 &rng, const uint8_t key[32])
+{
+    Signer signer;
+    initSigner(&signer, key);
+    mavlink_signing_t reference = {};
+    memcpy(reference.secret_key, key, 32);
+    reference.timestamp = 1000000000;
+    mavlink_signing_streams_t referenceStreams = {};
+    mavlink_signing_t ours = reference;
+    MavlinkSigningStreams streams;
+
+    std::vector<mavlink_message_t> sent;
+    quint64 now = reference.timestamp;
+    int mismatches = 0;
+    int statuses[MAVLINK_SIGNING_STATUS_REPLAY + 1] = {};
+    for (int n = 0; n < kEquivalenceFrames; ++n) {
+        mavlink_message_t msg;
+        const unsigned kind = unsigned(rng() % 20);
+        if (kind == 0 && !sent.empty()) {
+            msg = sent[rng() % sent.size()]; // 重放
+        } else {
+            // 流逐渐增加到 16 个，部分新流的时间戳早于一分钟窗口
+            const int streamCount = 1 + qMin(15, n / 2000);
+            int stream = int(rng() % streamCount);
+            now += rng() % 1000;
+            quint64 timestamp = now - rng() % 2000;
+            if (kind == 1) {
+                // 最新的流在第一帧被接受之前，这样的帧按过旧的时间戳拒绝
+                stream = streamCount - 1;
+                timestamp = now > 2 * MavlinkSigningStreams::kNewStreamWindow
+                                ? now - 2 * MavlinkSigningStreams::kNewStreamWindow
+                                : 1;
+            }
+            msg = signedFrame(&signer, uint8_t(1 + stream / 4), uint8_t(1 + stream % 2), uint8_t(stream % 3),
+                              timestamp);
+            if (kind == 2) {
+                msg.signature[7 + rng() % 6] ^= uint8_t(1 + rng() % 255);
+            }
+            sent.push_back(msg);
+        }
+
+        const bool expected = mavlink_signature_check(&reference, &referenceStreams, &msg);
+        const bool accepted = streams.accept(&ours, &msg, MavlinkSignature::signatureMatches(key, &msg));
+        if (accepted != expected || ours.last_status != reference.last_status
+            || ours.timestamp != reference.timestamp) {
+            ++mismatches;
+        }
+        ++statuses[reference.last_status];
+    }
+    if (streams.size() != int(referenceStreams.num_signing_streams) || streams.evictions() != 0) {
+        ++mismatches;
+    }
+
+    printf("equivalence: %d frames, %d streams, ok %d, bad signature %d, replay %d, old timestamp %d, "
+           "%d mismatches\n",
+           kEquivalenceFrames,
+           streams.size(),
+           statuses[MAVLINK_SIGNING_STATUS_OK],
+           statuses[MAVLINK_SIGNING_STATUS_BAD_SIGNATURE],
+           statuses[MAVLINK_SIGNING_STATUS_REPLAY],
+           statuses[MAVLINK_SIGNING_STATUS_OLD_TIMESTAMP],
+           mismatches);
+    return mismatches;
+}
+
+/// 空闲超时取最小值、流远多于 16 个：已接受帧的重放在流被淘汰后仍必须被拒绝
+int testReplayAfterEviction(std::mt19937_64 &rng, const uint8_t key[32])
+{
+    Signer signer;
+    initSigner(&signer, key);
+    mavlink_signing_t signing = {};
+    memcpy(signing.secret_key, key, 32);
+    MavlinkSigningStreams streams(0);
+    if (streams.idleTimeout() != MavlinkSigningStreams::kNewStreamWindow) {
+        printf("replay: idle timeout %llu below the new stream window\n", streams.idleTimeout());
+        return 1;
+    }
+
+    std::vector<mavlink_message_t> accepted;
+    quint64 now = 1000000000;
+    int replays = 0;
+    int replayed = 0;
+    int oldTimestamps = 0;
+    for (int n = 0; n < kReplayFrames; ++n) {
+        if (!accepted.empty() && rng() % 10 == 0) {
+            const mavlink_message_t msg = accepted[rng() % accepted.size()];
+            ++replays;
+            if (streams.accept(&signing, &msg, true)) {
+                ++replayed;
+            } else if (signing.last_status == MAVLINK_SIGNING_STATUS_OLD_TIMESTAMP) {
+                ++oldTimestamps;
+            }
+            continue;
+        }
+        // 每 100 帧出现一个新流，活跃的是最新的 20 个，旧流空闲后被淘汰，偶尔又重新出现
+        const int newest = n / 100;
+        const int stream = rng() % 50 == 0 ? int(rng() % (newest + 1))
+                                           : newest - int(rng() % qMin(newest + 1, 20));
+        now += rng() % 2000;
+        const mavlink_message_t msg = signedFrame(&signer, uint8_t(1 + stream % 250), uint8_t(stream / 250), 0,
+                                                  now - rng() % 1000);
+        if (streams.accept(&signing, &msg, MavlinkSignature::signatureMatches(key, &msg))) {
+            accepted.push_back(msg);
+        }
+    }
+
+    // 被淘汰流的旧帧作为新流出现，时间戳早于窗口而被拒绝，不会当作新流接受
+    printf("replay: %d accepted, %d streams live, %llu idle evictions, %d replays, %d replayed, "
+           "%d rejected as old timestamps\n",
+           int(accepted.size()),
+           streams.size(),
+           streams.evictions(),
+           replays,
+           replayed,
+           oldTimestamps);
+    return replayed == 0 && oldTimestamps > 0 && streams.evictions() > 0 ? 0 : 1;
+}
+
+/// setMaxStreams 超过上限时强制淘汰最久未用的流
+int testForcedEviction(const uint8_t key[32])
+{
+    Signer signer;
+    initSigner(&signer, key);
+    mavlink_signing_t signing = {};
+    memcpy(signing.secret_key, key, 32);
+    MavlinkSigningStreams streams;
+    streams.setMaxStreams(8);
+
+    quint64 now = 1000000000;
+    for (int stream = 0; stream < 20; ++stream) {
+        const mavlink_message_t msg = signedFrame(&signer, uint8_t(1 + stream), 1, 0, ++now);
+        streams.accept(&signing, &msg, true);
+    }
+    const int limited = streams.size();
+    const quint64 forced = streams.forcedEvictions();
+
+    // 最近使用的流不被淘汰：流 12 再发一帧后插入新流，淘汰的是流 13
+    const mavlink_message_t touch = signedFrame(&signer, 13, 1, 0, ++now);
+    streams.accept(&signing, &touch, true);
+    const mavlink_message_t extra = signedFrame(&signer, 100, 1, 0, ++now);
+    streams.accept(&signing, &extra, true);
+    const mavlink_message_t again = signedFrame(&signer, 13, 1, 0, ++now);
+    const bool kept = streams.accept(&signing, &again, true) && streams.forcedEvictions() == forced + 1;
+
+    streams.setMaxStreams(0);
+    for (int stream = 20; stream < 40; ++stream) {
+        const mavlink_message_t msg = signedFrame(&signer, uint8_t(1 + stream), 1, 0, ++now);
+        streams.accept(&signing, &msg, true);
+    }
+    const int unlimited = streams.size();
+
+    printf("forced eviction: %d streams at max 8, %llu forced, %d streams unlimited\n",
+           limited,
+           forced,
+           unlimited);
+    return limited == 8 && forced == 12 && kept && unlimited == 28 && streams.evictions() == 0 ? 0 : 1;
+}
+} // namespace
+
+int main()
+{
+    std::mt19937_64 rng(20240926);
+    uint8_t key[32];
+    for (auto &byte : key) {
+        byte = uint8_t(rng());
+    }
+
+    int failures = 0;
+    failures += testEquivalence(rng, key);
+    failures += testReplayAfterEviction(rng, key);
+    failures += testForcedEviction(key);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,282 @@
+﻿/**************************************************************************
+ *   文件名	：test_tlog.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：TlogRecorder 与 TlogReader 的往返测试
+ *   使用说明 ：随机消息按随机大小的数据块送入 receiveData，录制后用 TlogReader 逐条读回比较，
+ *             seek 和 offsets 与逐条扫描的结果比较。再模拟录制中途崩溃：没有索引且带着
+ *             预分配的零尾，以及截断在记录中间而索引仍是完整日志的，都必须重建索引。
+ *             最后在 I/O 线程持续收数据时 detach 和析构记录器
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "ringlink.h"
+#include "tlogrecorder.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr int kFrames = 5000;
+constexpr int kMaxChunk = 300;
+constexpr int kSeekStride = 7; // 每隔几帧检查一次 seek
+constexpr uint32_t kMissingMsgid = 0xFFFFFF; // 方言中没有的 msgid
+
+struct Stream
+{
+    QByteArray bytes;
+    std::vector<QByteArray> frames;
+    std::vector<uint32_t> msgids;
+};
+
+/// 方言中的随机消息，负载随机
+Stream makeStream(std::mt19937 &rng)
+{
+    Stream stream;
+    mavlink_status_t tx = {};
+    for (int n = 0; n < kFrames; ++n) {
+        // 只用前 16 种消息，每种都有足够多的帧
+        const auto &entry = MavlinkMsgTable::kEntries[rng() % qMin(16, MavlinkMsgTable::kEntryCount)];
+        mavlink_message_t msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msgid = entry.msgid;
+        for (int i = 0; i < entry.max_msg_len; ++i) {
+            _MAV_PAYLOAD_NON_CONST(&msg)[i] = char(rng());
+        }
+        mavlink_finalize_message_buffer(&msg, 1, 1, &tx, entry.min_msg_len, entry.max_msg_len, entry.crc_extra);
+        char buffer[MAVLINK_MAX_PACKET_LEN];
+        const int size = mavlink_msg_to_send_buffer(reinterpret_cast<uint8_t *>(buffer), &msg);
+        stream.frames.emplace_back(buffer, size);
+        stream.msgids.push_back(entry.msgid);
+        stream.bytes.append(buffer, size);
+    }
+    return stream;
+}
+
+/// 按随机大小的数据块送入连接，偶尔停顿让时间戳分散
+void feed(RingLink *link, const QByteArray &bytes, std::mt19937 &rng)
+{
+    for (qsizetype pos = 0; pos < bytes.size();) {
+        const qsizetype size = qMin<qsizetype>(1 + rng() % kMaxChunk, bytes.size() - pos);
+        emit link->receiveData(link, bytes.mid(pos, size));
+        pos += size;
+        if (rng() % 16 == 0) {
+            QThread::usleep(100);
+        }
+    }
+}
+
+bool copyFile(const QString &from, const QString &to, qint64 size, qint64 zeroTail)
+{
+    QFile in(from);
+    QFile out(to);
+    if (!in.open(QIODevice::ReadOnly) || !out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    const QByteArray data = in.read(size);
+    return out.write(data) == data.size() && out.write(QByteArray(zeroTail, 0)) == zeroTail;
+}
+
+/// 用 TlogReader 读回日志，与前 expected 帧比较，返回不一致的项数
+int checkLog(const QString &path, const Stream &stream, int expected, const char *name)
+{
+    TlogReader reader;
+    if (!reader.open(path)) {
+        printf("%s: open failed: %s\n", name, qPrintable(reader.errorString()));
+        return 1;
+    }
+
+    int errors = 0;
+    std::vector<qint64> offsets;
+    std::vector<quint64> timestamps;
+    TlogReader::Frame frame;
+    for (qint64 offset = 0; reader.frameAt(offset, &frame); offset = frame.next) {
+        const int i = int(offsets.size());
+        if (i >= expected || QByteArray(frame.data, frame.size) != stream.frames[i]) {
+            ++errors;
+        }
+        offsets.push_back(offset);
+        timestamps.push_back(frame.timestamp);
+    }
+    const qint64 end = offsets.empty() ? 0 : offsets.back() + 8 + stream.frames[offsets.size() - 1].size();
+    if (int(offsets.size()) != expected || reader.frameCount() != quint64(expected) || reader.size() != end) {
+        printf("%s: %d frames read, %llu indexed, expected %d\n",
+               name,
+               int(offsets.size()),
+               reader.frameCount(),
+               expected);
+        return errors + 1;
+    }
+
+    // 每种 msgid 的偏移表与逐条扫描一致
+    std::vector<uint32_t> msgids(stream.msgids.begin(), stream.msgids.begin() + expected);
+    std::sort(msgids.begin(), msgids.end());
+    msgids.erase(std::unique(msgids.begin(), msgids.end()), msgids.end());
+    msgids.push_back(kMissingMsgid);
+    for (const uint32_t msgid : msgids) {
+        std::vector<qint64> scanned;
+        for (int i = 0; i < expected; ++i) {
+            if (stream.msgids[i] == msgid) {
+                scanned.push_back(offsets[i]);
+            }
+        }
+        qsizetype count = 0;
+        const quint64 *indexed = reader.offsets(msgid, &count);
+        bool same = count == qsizetype(scanned.size());
+        for (qsizetype i = 0; same && i < count; ++i) {
+            same = qint64(indexed[i]) == scanned[i];
+        }
+        if (!same) {
+            ++errors;
+        }
+    }
+
+    // seek 返回第一条时间戳不早于目标的记录
+    auto scanSeek = [&](quint64 timestamp) {
+        for (int i = 0; i < expected; ++i) {
+            if (timestamps[i] >= timestamp) {
+                return offsets[i];
+            }
+        }
+        return reader.size();
+    };
+    int seekErrors = 0;
+    for (int i = 0; i < expected; i += kSeekStride) {
+        for (const quint64 timestamp : {timestamps[i], timestamps[i] + 1}) {
+            if (reader.seek(timestamp) != scanSeek(timestamp)) {
+                ++seekErrors;
+            }
+        }
+    }
+    if (expected > 0 && (reader.seek(0) != 0 || reader.seek(timestamps.back() + 1) != reader.size())) {
+        ++seekErrors;
+    }
+
+    printf("%s: %d frames, %d msgids, %d mismatches, %d seek mismatches\n",
+           name,
+           expected,
+           int(msgids.size()) - 1,
+           errors,
+           seekErrors);
+    return errors + seekErrors;
+}
+
+/// I/O 线程持续收数据时 detach 和析构：返回后不能再有帧写入
+int testDetach(const QTemporaryDir &dir)
+{
+    mavlink_heartbeat_t heartbeat = {};
+    mavlink_message_t msg;
+    mavlink_msg_heartbeat_encode(1, 1, &msg, &heartbeat);
+    char buffer[MAVLINK_MAX_PACKET_LEN];
+    const QByteArray frame(buffer, mavlink_msg_to_send_buffer(reinterpret_cast<uint8_t *>(buffer), &msg));
+
+    RingLink link;
+    TlogRecorder recorder;
+    auto *other = new TlogRecorder();
+    recorder.attach(&link);
+    other->attach(&link);
+    if (!recorder.open(dir.filePath(QStringLiteral("detach.tlog")), 0)
+        || !other->open(dir.filePath(QStringLiteral("destroy.tlog")), 0)) {
+        printf("detach: open failed\n");
+        return 1;
+    }
+
+    std::atomic_bool stop{false};
+    std::thread io([&]() {
+        while (!stop.load()) {
+            emit link.receiveData(&link, frame);
+        }
+    });
+
+    QThread::msleep(20);
+    delete other; // 析构等待进行中的 record
+    recorder.detach(&link);
+    const quint64 frames = recorder.frames();
+    QThread::msleep(20);
+    const quint64 later = recorder.frames();
+    stop = true;
+    io.join();
+    recorder.close();
+
+    printf("detach: %llu frames before detach, %llu after\n", frames, later);
+    return frames > 0 && later == frames ? 0 : 1;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        printf("cannot create a temporary directory\n");
+        return 1;
+    }
+
+    std::mt19937 rng(20240926);
+    const Stream stream = makeStream(rng);
+    const QString path = dir.filePath(QStringLiteral("record.tlog"));
+
+    int failures = 0;
+    {
+        RingLink link;
+        TlogRecorder recorder;
+        recorder.attach(&link);
+        if (!recorder.open(path, 0)) {
+            printf("record: open failed\n");
+            return 1;
+        }
+        feed(&link, stream.bytes, rng);
+        recorder.close();
+        if (recorder.frames() != quint64(kFrames) || !QFile::exists(TlogReader::indexPath(path))) {
+            printf("record: %llu frames recorded, expected %d\n", recorder.frames(), kFrames);
+            ++failures;
+        }
+    }
+    failures += checkLog(path, stream, kFrames, "record");
+
+    // 录制中途崩溃：没有索引，文件末尾是预分配的零
+    const QString noIndex = dir.filePath(QStringLiteral("noindex.tlog"));
+    const qint64 logSize = QFile(path).size();
+    if (!copyFile(path, noIndex, logSize, 1024 * 1024)) {
+        printf("cannot copy the log\n");
+        return 1;
+    }
+    failures += checkLog(noIndex, stream, kFrames, "no index, zero tail");
+    failures += checkLog(noIndex, stream, kFrames, "no index, reopened");
+
+    // 截断在一条记录的最后一个字节之前，旁边的索引仍描述完整日志
+    const int kept = kFrames * 2 / 3;
+    qint64 cut = 0;
+    for (int i = 0; i < kept; ++i) {
+        cut += 8 + stream.frames[i].size();
+    }
+    const QString truncated = dir.filePath(QStringLiteral("truncated.tlog"));
+    if (!copyFile(path, truncated, cut + 8 + stream.frames[kept].size() - 1, 0)
+        || !QFile::copy(TlogReader::indexPath(path), TlogReader::indexPath(truncated))) {
+        printf("cannot copy the log\n");
+        return 1;
+    }
+    failures += checkLog(truncated, stream, kept, "truncated, stale index");
+    failures += checkLog(truncated, stream, kept, "truncated, reopened");
+
+    failures += testDetach(dir);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+﻿/**************************************************************************
+ *   文件名	：tlogreader.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "tlogreader.h"
+
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <string.h>
+
+using namespace TlogIndexFormat;
+
+namespace {
+constexpr int kTimestampSize = 8;
+} // namespace
+
+void TlogIndexBuilder::add(quint64 timestamp, qint64 offset, uint32_t msgid)
+{
+    if (m_frameCount == 0) {
+        m_startTime = timestamp;
+    }
+    // 时间点取截至当前帧的最大时间戳，系统时间回拨时二分查找仍然有效
+    m_endTime = qMax(m_endTime, timestamp);
+    if (m_frameCount % kTimeStride == 0) {
+        m_times.append({m_endTime, quint64(offset)});
+    }
+    m_offsets[msgid].append(quint64(offset));
+    ++m_frameCount;
+}
+
+void TlogIndexBuilder::clear()
+{
+    m_times.clear();
+    m_offsets.clear();
+    m_frameCount = 0;
+    m_startTime = 0;
+    m_endTime = 0;
+}
+
+QByteArray TlogIndexBuilder::serialize(qint64 logSize) const
+{
+    QVector<quint32> msgids;
+    msgids.reserve(m_offsets.size());
+    for (auto it = m_offsets.cbegin(); it != m_offsets.cend(); ++it) {
+        msgids.append(it.key());
+    }
+    std::sort(msgids.begin(), msgids.end());
+
+    Header header;
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.logSize = quint64(logSize);
+    header.frameCount = m_frameCount;
+    header.startTime = m_startTime;
+    header.endTime = m_endTime;
+    header.timeCount = quint32(m_times.size());
+    header.messageCount = quint32(msgids.size());
+
+    QByteArray data;
+    data.reserve(sizeof(Header) + m_times.size() * sizeof(TimeEntry)
+                 + msgids.size() * sizeof(MessageEntry) + m_frameCount * sizeof(quint64));
+    data.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    data.append(reinterpret_cast<const char *>(m_times.constData()), m_times.size() * sizeof(TimeEntry));
+    quint64 first = 0;
+    for (quint32 msgid : std::as_const(msgids)) {
+        const quint64 count = quint64(m_offsets.value(msgid).size());
+        const MessageEntry entry = {msgid, 0, first, count};
+        data.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+        first += count;
+    }
+    for (quint32 msgid : std::as_const(msgids)) {
+        const auto offsets = m_offsets.value(msgid);
+        data.append(reinterpret_cast<const char *>(offsets.constData()), offsets.size() * sizeof(quint64));
+    }
+    return data;
+}
+
+bool TlogIndexBuilder::save(const QString &path, qint64 logSize) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(serialize(logSize));
+    return file.commit();
+}
+
+TlogReader::~TlogReader()
+{
+    close();
+}
+
+int TlogReader::recordSize(const uchar *data, qint64 available)
+{
+    if (available < kTimestampSize + 2) {
+        return 0;
+    }
+    const uchar *frame = data + kTimestampSize;
+    qint64 size;
+    if (frame[0] == MAVLINK_STX_MAVLINK1) {
+        size = MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 + frame[1] + MAVLINK_NUM_CHECKSUM_BYTES;
+    } else if (frame[0] == MAVLINK_STX) {
+        if (available < kTimestampSize + 3) {
+            return 0;
+        }
+        size = MAVLINK_NUM_NON_PAYLOAD_BYTES + frame[1]
+               + ((frame[2] & MAVLINK_IFLAG_SIGNED) ? MAVLINK_SIGNATURE_BLOCK_LEN : 0);
+    } else {
+        return 0; // 预分配未写入的区域全为 0
+    }
+    size += kTimestampSize;
+    return size <= available ? int(size) : 0;
+}
+
+bool TlogReader::open(const QString &path)
+{
+    close();
+    m_logFile.setFileName(path);
+    if (!m_logFile.open(QIODevice::ReadOnly)) {
+        m_error = m_logFile.errorString();
+        return false;
+    }
+    const qint64 fileSize = m_logFile.size();
+    if (fileSize > 0) {
+        m_log = m_logFile.map(0, fileSize);
+        if (m_log == nullptr) {
+            m_error = m_logFile.errorString();
+            m_logFile.close();
+            return false;
+        }
+    } else {
+        static const uchar empty = 0;
+        m_log = &empty;
+    }
+
+    // 索引覆盖的长度之后还有完整记录，说明索引是录制中途留下的
+    m_indexFile.setFileName(indexPath(path));
+    if (m_indexFile.open(QIODevice::ReadOnly)) {
+        const qint64 indexSize = m_indexFile.size();
+        const uchar *index = indexSize > 0 ? m_indexFile.map(0, indexSize) : nullptr;
+        if (index && attachIndex(index, indexSize) && qint64(m_header.logSize) <= fileSize
+            && recordSize(m_log + m_header.logSize, fileSize - qint64(m_header.logSize)) == 0) {
+            m_size = qint64(m_header.logSize);
+            return true;
+        }
+        if (index) {
+            m_indexFile.unmap(const_cast<uchar *>(index));
+        }
+        m_indexFile.close();
+    }
+    return rebuildIndex(path, fileSize);
+}
+
+void TlogReader::close()
+{
+    if (m_indexFile.isOpen()) {
+        m_indexFile.close(); // 关闭时自动解除映射
+    }
+    if (m_logFile.isOpen()) {
+        m_logFile.close();
+    }
+    m_log = nullptr;
+    m_size = 0;
+    m_header = {};
+    m_times = nullptr;
+    m_messages = nullptr;
+    m_offsets = nullptr;
+    m_rebuilt.clear();
+}
+
+bool TlogReader::attachIndex(const uchar *data, qint64 size)
+{
+    if (size < qint64(sizeof(Header))) {
+        return false;
+    }
+    Header header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    const qint64 expected = qint64(sizeof(Header)) + qint64(header.timeCount) * qint64(sizeof(TimeEntry))
+                            + qint64(header.messageCount) * qint64(sizeof(MessageEntry))
+                            + qint64(header.frameCount) * qint64(sizeof(quint64));
+    if (expected != size) {
+        return false;
+    }
+
+    m_header = header;
+    m_times = reinterpret_cast<const TimeEntry *>(data + sizeof(Header));
+    m_messages = reinterpret_cast<const MessageEntry *>(m_times + header.timeCount);
+    m_offsets = reinterpret_cast<const quint64 *>(m_messages + header.messageCount);
+    return true;
+}
+
+bool TlogReader::rebuildIndex(const QString &path, qint64 fileSize)
+{
+    TlogIndexBuilder builder;
+    qint64 offset = 0;
+    int size;
+    while ((size = recordSize(m_log + offset, fileSize - offset)) > 0) {
+        const uchar *frame = m_log + offset + kTimestampSize;
+        const uint32_t msgid = frame[0] == MAVLINK_STX_MAVLINK1
+                                   ? frame[5]
+                                   : frame[7] | uint32_t(frame[8]) << 8 | uint32_t(frame[9]) << 16;
+        builder.add(qFromBigEndian<quint64>(m_log + offset), offset, msgid);
+        offset += size;
+    }
+
+    // 写回失败（如只读目录）不影响本次使用
+    m_rebuilt = builder.serialize(offset);
+    builder.save(indexPath(path), offset);
+    m_size = offset;
+    return attachIndex(reinterpret_cast<const uchar *>(m_rebuilt.constData()), m_rebuilt.size());
+}
+
+bool TlogReader::frameAt(qint64 offset, Frame *frame) const
+{
+    if (offset < 0 || offset >= m_size) {
+        return false;
+    }
+    const int size = recordSize(m_log + offset, m_size - offset);
+    if (size == 0) {
+        return false;
+    }
+    frame->timestamp = qFromBigEndian<quint64>(m_log + offset);
+    frame->data = reinterpret_cast<const char *>(m_log + offset + kTimestampSize);
+    frame->size = size - kTimestampSize;
+    frame->next = offset + size;
+    return true;
+}
+
+qint64 TlogReader::seek(quint64 timestamp) const
+{
+    // 第一个不早于 timestamp 的时间点之前的所有帧都更早，从它的前一个时间点开始逐帧查找
+    const TimeEntry *end = m_times + m_header.timeCount;
+    const TimeEntry *it = std::lower_bound(m_times, end, timestamp,
+                                           [](const TimeEntry &entry, quint64 value) {
+                                               return entry.timestamp < value;
+                                           });
+    qint64 offset = it == m_times ? 0 : qint64((it - 1)->offset);
+    Frame frame;
+    while (frameAt(offset, &frame)) {
+        if (frame.timestamp >= timestamp) {
+            return offset;
+        }
+        offset = frame.next;
+    }
+    return m_size;
+}
+
+const quint64 *TlogReader::offsets(uint32_t msgid, qsizetype *count) const
+{
+    const MessageEntry *end = m_messages + m_header.messageCount;
+    const MessageEntry *it = std::lower_bound(m_messages, end, msgid,
+                                              [](const MessageEntry &entry, uint32_t value) {
+                                                  return entry.msgid < value;
+                                              });
+    if (it == end || it->msgid != msgid) {
+        *count = 0;
+        return nullptr;
+    }
+    *count = qsizetype(it->count);
+    return m_offsets + it->first;
+}
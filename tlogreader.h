@@ -0,0 +1,142 @@
+﻿/**************************************************************************
+ *   文件名	：tlogreader.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：tlog 遥测日志的读取与索引
+ *   使用说明 ：日志为标准 tlog：每帧前是 8 字节大端序的微秒时间戳。
+ *             旁边的 .idx 索引记录稀疏的时间 -> 偏移表和每个 msgid 的帧偏移表，
+ *             打开时日志和索引都只做内存映射，按时间定位和按 msgid 取帧不需要从头解析；
+ *             索引缺失或比日志旧时扫描一遍日志重建
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "mavlinkprotocol.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/// 索引文件格式，所有字段为小端序：
+/// Header | TimeEntry[timeCount] | MessageEntry[messageCount] | quint64 offsets[frameCount]
+namespace TlogIndexFormat {
+constexpr char kMagic[8] = {'C', 'H', 'T', 'L', 'I', 'D', 'X', '1'};
+constexpr int kTimeStride = 64; // 每 64 帧记录一个时间点
+
+struct Header
+{
+    char magic[8];
+    quint64 logSize;    // 索引覆盖的日志字节数
+    quint64 frameCount;
+    quint64 startTime;  // 微秒
+    quint64 endTime;
+    quint32 timeCount;
+    quint32 messageCount;
+};
+
+struct TimeEntry
+{
+    quint64 timestamp; // 截至该帧的最大时间戳，保证单调
+    quint64 offset;
+};
+
+/// msgid 的帧偏移位于 offsets[first, first + count)，按 msgid 升序排列
+struct MessageEntry
+{
+    quint32 msgid;
+    quint32 reserved;
+    quint64 first;
+    quint64 count;
+};
+} // namespace TlogIndexFormat
+
+/// 记录或扫描日志时在内存中累积索引
+class TlogIndexBuilder
+{
+public:
+    void add(quint64 timestamp, qint64 offset, uint32_t msgid);
+    void clear();
+    quint64 frameCount() const { return m_frameCount; }
+    /// 按索引文件格式序列化，logSize 为索引覆盖的日志长度
+    QByteArray serialize(qint64 logSize) const;
+    /// 写入索引文件，先写临时文件再替换
+    bool save(const QString &path, qint64 logSize) const;
+
+private:
+    QVector<TlogIndexFormat::TimeEntry> m_times;
+    QHash<quint32, QVector<quint64>> m_offsets;
+    quint64 m_frameCount = 0;
+    quint64 m_startTime = 0;
+    quint64 m_endTime = 0;
+};
+
+class TlogReader
+{
+public:
+    struct Frame
+    {
+        quint64 timestamp; // 微秒
+        const char *data;  // 指向映射内存中的 MAVLink 帧
+        int size;
+        qint64 next; // 下一条记录的偏移
+    };
+
+    TlogReader() = default;
+    ~TlogReader();
+
+    TlogReader(const TlogReader &) = delete;
+    TlogReader &operator=(const TlogReader &) = delete;
+
+    static QString indexPath(const QString &logPath) { return logPath + QStringLiteral(".idx"); }
+
+    /// 映射日志和索引，索引不可用时重建并尝试写回
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_log != nullptr; }
+    QString errorString() const { return m_error; }
+
+    /// 有效日志的字节数，不含预分配未写入的部分
+    qint64 size() const { return m_size; }
+    quint64 frameCount() const { return m_header.frameCount; }
+    quint64 startTime() const { return m_header.startTime; }
+    quint64 endTime() const { return m_header.endTime; }
+
+    /// 读取 offset 处的记录，超出有效范围或不是完整帧时返回 false
+    bool frameAt(qint64 offset, Frame *frame) const;
+    /// 第一条时间戳不早于 timestamp 的记录的偏移，全部更早时返回 size()
+    qint64 seek(quint64 timestamp) const;
+    /// msgid 的全部帧偏移，按记录顺序，count 为数量
+    const quint64 *offsets(uint32_t msgid, qsizetype *count) const;
+
+    /// 解析 data 处一条记录的长度，不完整或不是 MAVLink 帧时返回 0
+    static int recordSize(const uchar *data, qint64 available);
+
+private:
+    /// 校验并引用 data 中的索引，data 在 close 之前必须有效
+    bool attachIndex(const uchar *data, qint64 size);
+    bool rebuildIndex(const QString &path, qint64 fileSize);
+
+    QFile m_logFile;
+    QFile m_indexFile;
+    const uchar *m_log = nullptr;
+    qint64 m_size = 0;
+
+    TlogIndexFormat::Header m_header = {};
+    const TlogIndexFormat::TimeEntry *m_times = nullptr;
+    const TlogIndexFormat::MessageEntry *m_messages = nullptr;
+    const quint64 *m_offsets = nullptr;
+    QByteArray m_rebuilt; // 无法写回索引文件时，重建的索引保存在内存中
+
+    QString m_error;
+};
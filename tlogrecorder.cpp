@@ -0,0 +1,373 @@
+﻿/**************************************************************************
+ *   文件名	：tlogrecorder.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：
+ *   使用说明 ：
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "tlogrecorder.h"
+#include "linkinterface.h"
+
+#include <QDeadlineTimer>
+#include <QThread>
+#include <QtAlgorithms>
+#include <QtEndian>
+
+#include <chrono>
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr int kTimestampSize = 8;
+constexpr int kMaxRecordSize = kTimestampSize + MAVLINK_MAX_PACKET_LEN;
+constexpr qint64 kMinPreallocate = 1024 * 1024;
+#ifdef Q_OS_LINUX
+// 一次预留足够的地址空间，文件扩展后不需要重新映射，提交线程可以不加锁 msync
+constexpr qint64 kMapReserve = sizeof(void *) == 8 ? qint64(1) << 38 : qint64(1) << 28;
+#endif
+
+quint64 currentMicroseconds()
+{
+    using namespace std::chrono;
+    return quint64(duration_cast<microseconds>(system_clock::now().time_since_epoch()).count());
+}
+} // namespace
+
+TlogRecorder::TlogRecorder(QObject *parent)
+    : QObject(parent)
+{
+}
+
+TlogRecorder::~TlogRecorder()
+{
+    // 断开后 I/O 线程可能已经进入 record，等它们结束再关闭文件
+    QHash<const LinkInterface *, QSharedPointer<Source>> sources;
+    {
+        QMutexLocker locker(&m_lock);
+        sources.swap(m_sources);
+    }
+    for (auto it = sources.cbegin(); it != sources.cend(); ++it) {
+        disconnect(const_cast<LinkInterface *>(it.key()), nullptr, this, nullptr);
+        release(it.value().data());
+    }
+    close();
+}
+
+bool TlogRecorder::open(const QString &path, qint64 preallocate)
+{
+    close();
+
+    // 文件已关闭，record 不会再解析；分帧状态在取 m_lock 之前重置，保持锁顺序
+    QList<QSharedPointer<Source>> sources;
+    {
+        QMutexLocker locker(&m_lock);
+        sources = m_sources.values();
+    }
+    for (const auto &source : std::as_const(sources)) {
+        QMutexLocker sourceLocker(&source->mutex);
+        source->framer.reset();
+    }
+
+    QMutexLocker locker(&m_lock);
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        const QString error = m_file.errorString();
+        locker.unlock();
+        emit recordError(error);
+        return false;
+    }
+    // 旧索引对应的是被覆盖的日志
+    QFile::remove(TlogReader::indexPath(path));
+
+    m_path = path;
+    m_preallocate = qMax(preallocate, kMinPreallocate);
+    m_capacity = 0;
+    m_committed = 0;
+    m_size = 0;
+    m_frames = 0;
+    m_commits = 0;
+    m_index.clear();
+
+#ifdef Q_OS_LINUX
+    void *map = mmap(nullptr, kMapReserve, PROT_READ | PROT_WRITE, MAP_SHARED, m_file.handle(), 0);
+    if (map != MAP_FAILED) {
+        m_map = static_cast<uchar *>(map);
+        m_mapSize = kMapReserve;
+    }
+#endif
+    // 映射失败或其它平台退化为 QFile 追加写
+
+    m_shouldExit = false;
+    m_open = true;
+    m_commitThread = QThread::create([this]() { commitLoop(); });
+    m_commitThread->setObjectName("TlogCommit");
+    m_commitThread->start();
+    return true;
+}
+
+void TlogRecorder::close()
+{
+    {
+        QMutexLocker locker(&m_lock);
+        if (!m_file.isOpen()) {
+            return;
+        }
+        m_open = false;
+        m_shouldExit = true;
+        m_commitWake.wakeAll();
+    }
+    m_commitThread->wait();
+    delete m_commitThread;
+    m_commitThread = nullptr;
+
+    QMutexLocker locker(&m_lock);
+    const qint64 size = m_size;
+#ifdef Q_OS_LINUX
+    if (m_map) {
+        commitRange(m_file.handle(), m_committed, size);
+        munmap(m_map, m_mapSize);
+        m_map = nullptr;
+        m_mapSize = 0;
+    }
+#endif
+    // 截掉预分配未使用的部分，截断后的长度也要落盘
+    m_file.resize(size);
+    m_file.flush();
+    syncFile(m_file.handle());
+    m_file.close();
+    const bool saved = m_index.save(TlogReader::indexPath(m_path), size);
+    m_index.clear();
+    locker.unlock();
+
+    if (!saved) {
+        emit recordError(tr("failed to write index %1").arg(TlogReader::indexPath(m_path)));
+    }
+}
+
+void TlogRecorder::attach(LinkInterface *link)
+{
+    if (link == nullptr) {
+        return;
+    }
+    const auto source = QSharedPointer<Source>::create();
+    {
+        QMutexLocker locker(&m_lock);
+        if (m_sources.contains(link)) {
+            return;
+        }
+        m_sources.insert(link, source);
+    }
+
+    // 在连接的 I/O 线程中直接记录，时间戳贴近实际收到的时刻。
+    // 槽函数持有 source 的引用，断开后迟到的调用也能安全地检查 attached
+    connect(
+        link,
+        &LinkInterface::receiveData,
+        this,
+        [this, source](const LinkInterface *, const QByteArray &data) { record(source.data(), data); },
+        Qt::DirectConnection);
+    connect(link, &QObject::destroyed, this, [this, link]() { forget(link); });
+}
+
+void TlogRecorder::detach(LinkInterface *link)
+{
+    disconnect(link, nullptr, this, nullptr);
+    forget(link);
+}
+
+void TlogRecorder::forget(const LinkInterface *link)
+{
+    QSharedPointer<Source> source;
+    {
+        QMutexLocker locker(&m_lock);
+        source = m_sources.take(link);
+    }
+    // 锁顺序为 Source::mutex 在前，释放 m_lock 之后再等待
+    if (source) {
+        release(source.data());
+    }
+}
+
+void TlogRecorder::release(Source *source)
+{
+    QMutexLocker locker(&source->mutex);
+    source->attached = false;
+}
+
+void TlogRecorder::record(Source *source, const QByteArray &data)
+{
+    // 先取得 source->mutex 再访问记录器，detach 和析构会等待这里结束
+    QMutexLocker sourceLocker(&source->mutex);
+    if (!source->attached || !m_open) {
+        return;
+    }
+
+    // 分帧不持有 m_lock，各连接的 I/O 线程可以并行解析
+    const auto &frames = source->framer.parse(data.constData(), data.size());
+    if (frames.isEmpty()) {
+        return;
+    }
+
+    // 同一次 receiveData 中的帧使用同一个时间戳
+    const quint64 timestamp = currentMicroseconds();
+    QMutexLocker locker(&m_lock);
+    if (!m_open) {
+        return;
+    }
+    for (const auto &message : frames) {
+        if (!append(timestamp, message)) {
+            return;
+        }
+    }
+    if (m_size - m_committed >= kCommitBytes) {
+        m_commitWake.wakeOne();
+    }
+}
+
+bool TlogRecorder::append(quint64 timestamp, const mavlink_message_t &message)
+{
+    const qint64 offset = m_size;
+    int size;
+    if (m_map) {
+        if (!reserve(offset + kMaxRecordSize)) {
+            return false;
+        }
+        uchar *dst = m_map + offset;
+        qToBigEndian(timestamp, dst);
+        size = kTimestampSize + mavlink_msg_to_send_buffer(dst + kTimestampSize, &message);
+    } else {
+        uchar buffer[kMaxRecordSize];
+        qToBigEndian(timestamp, buffer);
+        size = kTimestampSize + mavlink_msg_to_send_buffer(buffer + kTimestampSize, &message);
+        if (m_file.write(reinterpret_cast<const char *>(buffer), size) != size) {
+            fail(m_file.errorString());
+            return false;
+        }
+    }
+
+    m_index.add(timestamp, offset, message.msgid);
+    m_size.store(offset + size, std::memory_order_relaxed);
+    m_frames.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool TlogRecorder::reserve(qint64 size)
+{
+    if (size <= m_capacity) {
+        return true;
+    }
+    const qint64 capacity = qMin(m_capacity + qMax(m_preallocate, size - m_capacity), m_mapSize);
+    if (capacity < size) {
+        fail(tr("log exceeds %1 bytes").arg(m_mapSize));
+        return false;
+    }
+#ifdef Q_OS_LINUX
+    // 真正分配磁盘空间，磁盘满时在这里报错，而不是写映射内存时收到 SIGBUS
+    const int ret = posix_fallocate(m_file.handle(), m_capacity, capacity - m_capacity);
+    if (ret != 0) {
+        fail(QString::fromLocal8Bit(strerror(ret)));
+        return false;
+    }
+#endif
+    m_capacity = capacity;
+    return true;
+}
+
+void TlogRecorder::fail(const QString &error)
+{
+    // 持有 m_lock，信号投递到对象所在线程再发出；已写入的数据在 close 时照常保存
+    m_open = false;
+    QMetaObject::invokeMethod(this, [this, error]() { emit recordError(error); }, Qt::QueuedConnection);
+}
+
+void TlogRecorder::commitLoop()
+{
+    QMutexLocker locker(&m_lock);
+    while (!m_shouldExit) {
+        m_commitWake.wait(&m_lock, QDeadlineTimer(m_commitInterval.load()));
+        const qint64 begin = m_committed;
+        const qint64 end = m_size;
+        if (end == begin) {
+            continue;
+        }
+        const int fd = m_file.handle();
+        if (m_map) {
+            // 映射在提交线程退出之前不会变化，写盘期间不阻塞记录
+            locker.unlock();
+            commitRange(fd, begin, end);
+            locker.relock();
+        } else {
+            // QFile 的缓冲区只能在锁内写出，同步磁盘不需要持锁
+            m_file.flush();
+            locker.unlock();
+            syncFile(fd);
+            locker.relock();
+        }
+        m_committed = end;
+        m_commits.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void TlogRecorder::commitRange(int fd, qint64 begin, qint64 end)
+{
+#ifdef Q_OS_LINUX
+    if (end <= begin) {
+        return;
+    }
+    const qint64 page = sysconf(_SC_PAGESIZE);
+    const qint64 aligned = begin & ~(page - 1);
+    if (msync(m_map + aligned, end - aligned, MS_SYNC) != 0) {
+        QMetaObject::invokeMethod(
+            this,
+            [this, error = QString::fromLocal8Bit(strerror(errno))]() { emit recordError(error); },
+            Qt::QueuedConnection);
+        return;
+    }
+#else
+    Q_UNUSED(begin);
+    Q_UNUSED(end);
+#endif
+    // msync 只写数据页，posix_fallocate 扩展的文件长度要靠 fdatasync 落盘
+    syncFile(fd);
+}
+
+void TlogRecorder::syncFile(int fd)
+{
+    if (fd < 0) {
+        return;
+    }
+#if defined(Q_OS_WIN)
+    const int ret = _commit(fd);
+#elif defined(Q_OS_LINUX)
+    const int ret = fdatasync(fd);
+#else
+    const int ret = fsync(fd);
+#endif
+    if (ret != 0) {
+        QMetaObject::invokeMethod(
+            this,
+            [this, error = QString::fromLocal8Bit(strerror(errno))]() { emit recordError(error); },
+            Qt::QueuedConnection);
+    }
+}
@@ -0,0 +1,123 @@
+﻿/**************************************************************************
+ *   文件名	：tlogrecorder.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2024-9-26
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：把连接收到的 MAVLink 帧记录为 tlog 日志
+ *   使用说明 ：每个连接用各自的 MavlinkFramer 分帧，帧在连接的 I/O 线程中带时间戳
+ *             追加到预分配并内存映射的文件；独立的提交线程按时间间隔或累积字节数
+ *             成组 msync，不在收发路径上等待磁盘。关闭时截掉预分配的空白并写出
+ *             .idx 索引，异常退出后 TlogReader 会扫描日志重建索引
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include "mavlinkframer.h"
+#include "tlogreader.h"
+
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSharedPointer>
+#include <QWaitCondition>
+
+#include <atomic>
+
+class LinkInterface;
+class QThread;
+
+class TlogRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr qint64 kDefaultPreallocate = 64 * 1024 * 1024;
+
+    explicit TlogRecorder(QObject *parent = nullptr);
+    ~TlogRecorder();
+
+    /// 新建日志文件，已存在时覆盖；preallocate 为每次扩展文件的字节数
+    bool open(const QString &path, qint64 preallocate = kDefaultPreallocate);
+    /// 提交剩余数据、截断文件并写出索引
+    void close();
+    bool isOpen() const { return m_open; }
+    QString path() const { return m_path; }
+
+    /// 记录该连接收到的全部帧，可以同时记录多个连接，文件打开前后都可以调用
+    void attach(LinkInterface *link);
+    void detach(LinkInterface *link);
+
+    /// 成组提交的间隔，未提交的数据超过 kCommitBytes 时提前提交
+    void setCommitInterval(int ms) { m_commitInterval = qMax(1, ms); }
+    int commitInterval() const { return m_commitInterval.load(); }
+
+    /// 已写入的日志字节数
+    qint64 size() const { return m_size.load(std::memory_order_relaxed); }
+    /// 已记录的帧数
+    quint64 frames() const { return m_frames.load(std::memory_order_relaxed); }
+    /// 已完成的提交次数
+    quint64 commits() const { return m_commits.load(std::memory_order_relaxed); }
+
+signals:
+    void recordError(const QString &error);
+
+private:
+    static constexpr qint64 kCommitBytes = 4 * 1024 * 1024;
+
+    /// 每个连接的分帧状态，只由该连接的 I/O 线程解析。record 全程持有 mutex，
+    /// detach 和析构取得 mutex 即可确认没有正在执行的 record
+    struct Source
+    {
+        QMutex mutex;
+        MavlinkFramer framer;
+        bool attached = true; // 由 mutex 保护，清除后迟到的 record 不再访问记录器
+    };
+
+    /// 在连接的 I/O 线程中调用：锁外分帧，只在写入时持有 m_lock
+    void record(Source *source, const QByteArray &data);
+    /// 等待该连接正在执行的 record 结束，此后的 record 直接返回
+    static void release(Source *source);
+    /// 以下函数调用时持有 m_lock
+    bool append(quint64 timestamp, const mavlink_message_t &message);
+    bool reserve(qint64 size);
+    void fail(const QString &error);
+
+    /// 移除连接的分帧状态并等待其 record 结束
+    void forget(const LinkInterface *link);
+
+    void commitLoop();
+    /// 把 [begin, end) 写到磁盘并同步文件长度等元数据，调用时不持有 m_lock
+    void commitRange(int fd, qint64 begin, qint64 end);
+    /// fdatasync/fsync 文件，失败时发出 recordError
+    void syncFile(int fd);
+
+    QString m_path;
+    QFile m_file;
+    qint64 m_preallocate = kDefaultPreallocate;
+    uchar *m_map = nullptr;  // 预留的地址空间，文件扩展后直接可写
+    qint64 m_mapSize = 0;
+    qint64 m_capacity = 0;   // 当前文件长度
+    qint64 m_committed = 0;  // 已提交到磁盘的长度
+    TlogIndexBuilder m_index;
+
+    QHash<const LinkInterface *, QSharedPointer<Source>> m_sources; // 由 m_lock 保护
+
+    QMutex m_lock; // 保护文件、映射、索引和 m_sources，锁顺序为 Source::mutex 在前
+    QWaitCondition m_commitWake;
+    QThread *m_commitThread = nullptr;
+    bool m_shouldExit = false;
+    std::atomic_bool m_open{false};
+    std::atomic_int m_commitInterval{200};
+
+    std::atomic<qint64> m_size{0};
+    std::atomic<quint64> m_frames{0};
+    std::atomic<quint64> m_commits{0};
+};
@@ -0,0 +1,134 @@
+﻿/**************************************************************************
+ *   文件名	：tilogdecode.cpp
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2021-3-29
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：把 TiLogger 的二进制日志转换为文本日志
+ *   使用说明 ：tilogdecode <输入.bin> [输出.txt]，不指定输出文件时写到标准输出，
+ *             每行格式与文本模式相同：[type: time file line function] msg
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#include "tilogformat.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QString>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+template <typename T>
+bool readStruct(const char* data, qint64 size, qint64& pos, T& value)
+{
+    if (size - pos < qint64(sizeof(T)))
+        return false;
+    memcpy(&value, data + pos, sizeof(T));
+    pos += qint64(sizeof(T));
+    return true;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <input.bin> [output.txt]\n", argv[0]);
+        return 2;
+    }
+
+    QFile input(QString::fromLocal8Bit(argv[1]));
+    if (!input.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "%s: %s\n", argv[1], input.errorString().toLocal8Bit().data());
+        return 1;
+    }
+    const qint64 size = input.size();
+    const uchar* mapped = size > 0 ? input.map(0, size) : nullptr;
+    const QByteArray contents = mapped ? QByteArray() : input.readAll();
+    const char* data = mapped ? reinterpret_cast<const char*>(mapped) : contents.constData();
+
+    FILE* output = stdout;
+    if (argc > 2) {
+        output = fopen(argv[2], "wb");
+        if (output == nullptr) {
+            fprintf(stderr, "%s: %s\n", argv[2], strerror(errno));
+            return 1;
+        }
+    }
+
+    TiLogFormat::Header      header = {};
+    bool                     haveHeader = false;
+    QHash<quint32, QString>  strings;
+    qint64                   second = -1;
+    QString                  secondText;
+    qint64                   records = 0;
+    qint64                   pos = 0;
+    bool                     ok = true;
+    while (pos < size && ok) {
+        const qint64 start = pos;
+        const char   tag   = data[pos++];
+        if (tag == TiLogFormat::kHeaderTag) {
+            ok = readStruct(data, size, pos, header) && header.version == TiLogFormat::kVersion;
+            haveHeader = ok;
+            strings.clear();
+        } else if (tag == TiLogFormat::kStringTag) {
+            TiLogFormat::String string;
+            ok = readStruct(data, size, pos, string) && size - pos >= qint64(string.size);
+            if (ok) {
+                strings.insert(string.id, QString::fromUtf8(data + pos, int(string.size)));
+                pos += string.size;
+            }
+        } else if (tag == TiLogFormat::kRecordTag && haveHeader) {
+            TiLogFormat::Record record;
+            ok = readStruct(data, size, pos, record) && size - pos >= qint64(record.msgSize);
+            if (!ok) {
+                // 不完整的记录，pos 回到记录开头再报告
+                pos = start;
+                break;
+            }
+            const QString msg = QString::fromUtf8(data + pos, int(record.msgSize));
+            pos += record.msgSize;
+
+            // 与 TiLogger 相同的时间格式，同一秒内只格式化一次
+            const qint64 msecs = TiLogFormat::wallMsecs(header, record.monoNsecs);
+            if (msecs / 1000 != second) {
+                second     = msecs / 1000;
+                secondText = QDateTime::fromMSecsSinceEpoch(second * 1000).toString("yyyy-MM-dd hh:mm:ss.");
+            }
+            const QString logTime = secondText + QString("%1").arg(int(msecs % 1000), 3, 10, QChar('0'));
+            const QString line    = QString("[%1: %2 %3 %4 %5] %6\n")
+                                     .arg(QLatin1String(TiLogFormat::levelName(record.level)),
+                                          logTime,
+                                          strings.value(record.fileId),
+                                          QString::number(record.line),
+                                          strings.value(record.functionId),
+                                          msg);
+            const QByteArray utf8 = line.toUtf8();
+            fwrite(utf8.constData(), 1, size_t(utf8.size()), output);
+            ++records;
+        } else {
+            ok = false;
+        }
+        if (!ok)
+            pos = start;
+    }
+
+    if (output != stdout)
+        fclose(output);
+    if (pos < size) {
+        // 异常退出时文件末尾可能只写了半条记录
+        fprintf(stderr, "%s: stopped at offset %lld of %lld after %lld records\n",
+                argv[1], pos, size, records);
+        return 1;
+    }
+    return 0;
+}
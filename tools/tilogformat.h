@@ -0,0 +1,80 @@
+﻿/**************************************************************************
+ *   文件名	：tilogformat.h
+ *   =======================================================================
+ *   创 建 者	：田小帆
+ *   创建日期	：2021-3-29
+ *   邮   箱	：499131808@qq.com
+ *   Q Q		：499131808
+ *   公   司      ：
+ *   功能描述      ：TiLogger 二进制日志格式，写入端与 tilogdecode 共用
+ *   使用说明 ：文件由若干条记录组成，每条以 1 字节标记开头，整数均为小端序：
+ *             'H' 文件头：版本、起始墙上时间（毫秒）、起始单调时间（纳秒），
+ *                 之后的字符串编号重新开始，追加写入同一文件时会再次出现；
+ *             'S' 字符串：编号、长度、UTF-8 内容，用于文件名和函数名；
+ *             'L' 日志：级别、行号、文件编号、函数编号、线程号、单调时间、
+ *                 消息长度和 UTF-8 消息
+ *   ======================================================================
+ *   修改者	：
+ *   修改日期	：
+ *   修改内容	：
+ *   ======================================================================
+ *
+ ***************************************************************************/
+#pragma once
+
+#include <QtGlobal>
+
+namespace TiLogFormat {
+const quint32 kVersion = 1;
+
+const char kHeaderTag = 'H';
+const char kStringTag = 'S';
+const char kRecordTag = 'L';
+
+#pragma pack(push, 1)
+struct Header {
+    quint32 version;
+    qint64  wallMsecs; // 与 monoNsecs 同一时刻的墙上时间
+    qint64  monoNsecs;
+};
+
+struct String {
+    quint32 id;
+    quint32 size;
+};
+
+struct Record {
+    quint8  level; // QtMsgType
+    quint32 line;
+    quint32 fileId;
+    quint32 functionId;
+    quint64 threadId;
+    qint64  monoNsecs;
+    quint32 msgSize; // 消息的字节数
+};
+#pragma pack(pop)
+
+/// 与文本格式相同的级别名称
+inline const char* levelName(int level)
+{
+    switch (level) {
+    case QtDebugMsg:
+        return "debug";
+    case QtInfoMsg:
+        return "info";
+    case QtWarningMsg:
+        return "warning";
+    case QtCriticalMsg:
+        return "critical";
+    case QtFatalMsg:
+        return "fatal";
+    }
+    return "";
+}
+
+/// 由单调时间换算墙上时间
+inline qint64 wallMsecs(const Header& header, qint64 monoNsecs)
+{
+    return header.wallMsecs + (monoNsecs - header.monoNsecs) / 1000000;
+}
+} // namespace TiLogFormat
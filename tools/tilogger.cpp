@@ -16,14 +16,34 @@
  *
  ***************************************************************************/
 #include "tilogger.h"
+#include "tilogformat.h"
 #include <stdio.h>
+#include <string.h>
 
 #include <QDateTime>
 #include <QDir>
 #include <QGlobalStatic>
 
+#include <algorithm>
+#include <chrono>
+
 Q_GLOBAL_STATIC(TiLogger, tiLogger) //注意这个是必须的
 
+namespace {
+const int kWriterIntervalMs = 100; // 后台线程最长的写出间隔
+const int kMinBufferSize    = 16;
+// 同步模式下二进制记录的批量写出条件
+const int    kBinaryFlushBytes = 64 * 1024;
+const qint64 kBinaryFlushNsecs = 1000000000;
+
+qint64 monotonicNsecs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+} // namespace
+
 void outputMessage(QtMsgType type, const QMessageLogContext& context, const QString& msg)
 {
     TiLogger::instance()->writeMsg(type, context, msg);
@@ -31,61 +51,422 @@ void outputMessage(QtMsgType type, const QMessageLogContext& context, const QStr
 
 void TiLogger::writeMsg(QtMsgType type, const QMessageLogContext& context, const QString& msg)
 {
+    if (type != QtFatalMsg) {
+        // 先计数再检查 m_async（均为顺序一致），stopAsync 看到计数归零后，
+        // 之后的调用一定会看到 m_async 为 false
+        m_pushing.fetch_add(1);
+        if (m_async.load()) {
+            ThreadBuffer* buffer = threadBuffer();
+            if (buffer) {
+                push(buffer, type, context, msg);
+                m_pushing.fetch_sub(1, std::memory_order_release);
+                return;
+            }
+            // 本线程正在退出，缓冲区已交给后台线程释放，只能同步写出
+        }
+        m_pushing.fetch_sub(1, std::memory_order_release);
+    }
+    if (type == QtFatalMsg) {
+        // 随后进程会退出，先写出之前排队的日志
+        flush();
+    }
 
-    QMutexLocker l(&m_mutex);
-    //组合自定义数据
-    static QString logType, sendmsg, writemsg;
-    QDateTime      currentTime = QDateTime::currentDateTime();
-    QString        logTime     = currentTime.toString("yyyy-MM-dd hh:mm:ss.zzz");
-    const char*    fileName    = context.file ? context.file : "";
-    const char*    function    = context.function ? context.function : "";
-    QString        line        = QString::number(context.line);
-    switch (type) {
-    case QtDebugMsg:
-        logType = "debug";
-        break;
-    case QtInfoMsg:
-        logType = "info";
-        break;
-    case QtWarningMsg:
-        logType = "warning";
-        break;
-    case QtCriticalMsg:
-        logType = "critical";
-        break;
-    case QtFatalMsg:
-        logType = "fatal";
-        break;
-    }
-    writemsg = QString("[%1: %2 %3 %4 %5] %6").arg(logType, logTime, fileName, line, function, msg);
+    Record record;
+    capture(record, type, context, msg);
 
+    QMutexLocker l(&m_mutex);
+    output(record);
     if (_isFile) {
-        QString newfileName
-            = m_path
-            + QString("%1_log.txt").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd-hh"));
-        if (m_file.fileName() != newfileName) {
-            if (m_file.isOpen())
-                m_file.close();
-            m_file.setFileName(newfileName);
+        // 文本每条都写出；二进制攒够一批再写，省掉每次调用的 write 和 flush
+        if (m_format != BinaryFormat || type == QtFatalMsg || m_binary.size() >= kBinaryFlushBytes
+            || record.monoNsecs - m_binaryFlushedAt >= kBinaryFlushNsecs)
+            flushFile();
+    }
+    if (_isConsole) {
+        fflush(stdout);
+    }
+}
+
+void TiLogger::capture(Record& record, QtMsgType type, const QMessageLogContext& context, const QString& msg)
+{
+    record.msecs     = QDateTime::currentMSecsSinceEpoch();
+    record.monoNsecs = monotonicNsecs();
+    record.threadId  = quint64(quintptr(QThread::currentThreadId()));
+    record.type      = type;
+    record.line      = context.line;
+    record.setLocation(context.file, context.function);
+    record.msg       = msg;
+}
+
+void TiLogger::output(const Record& record)
+{
+    const bool binaryFile = _isFile && m_format == BinaryFormat;
+    if (binaryFile) {
+        openFileFor(record.msecs);
+        writeBinary(record);
+    }
+    // 二进制格式只需要原始数据，文本只在其它输出需要时才格式化
+    const bool textFile = _isFile && !binaryFile;
+    if (!textFile && !_isConsole && !_isSignals) {
+        return;
+    }
+
+    const QString logType = QLatin1String(TiLogFormat::levelName(record.type));
+    const QString logTime = timeText(record.msecs);
+    const QString writemsg = QString("[%1: %2 %3 %4 %5] %6")
+                                 .arg(logType,
+                                      logTime,
+                                      QString::fromUtf8(record.file()),
+                                      QString::number(record.line),
+                                      QString::fromUtf8(record.function()),
+                                      record.msg);
+
+    if (textFile) {
+        openFileFor(record.msecs);
+        m_textStream << writemsg << '\n';
+    }
+
+    if (_isConsole) {
+        fprintf(stdout, "%s\n", writemsg.toLocal8Bit().data());
+    }
+
+    if (_isSignals) {
+        emit sigLogger(QString("[%1: %2] %3").arg(logType, logTime, record.msg));
+    }
+}
+
+void TiLogger::writeBinary(const Record& record)
+{
+    TiLogFormat::Record header;
+    header.level      = quint8(record.type);
+    header.line       = quint32(record.line);
+    header.fileId     = intern(record.file());
+    header.functionId = intern(record.function());
+    header.threadId   = record.threadId;
+    header.monoNsecs  = record.monoNsecs;
+    // 消息按 UTF-8 写出，常见的 ASCII 日志比 UTF-16 小一半
+    const QByteArray msg = record.msg.toUtf8();
+    header.msgSize       = quint32(msg.size());
+
+    m_binary.append(TiLogFormat::kRecordTag);
+    m_binary.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_binary.append(msg);
+}
+
+quint32 TiLogger::intern(const char* text)
+{
+    const QByteArray key = QByteArray::fromRawData(text, int(strlen(text)));
+    QHash<QByteArray, quint32>::const_iterator it = m_strings.constFind(key);
+    if (it != m_strings.constEnd())
+        return it.value();
+
+    TiLogFormat::String string;
+    string.id   = quint32(m_strings.size() + 1);
+    string.size = quint32(key.size());
+    m_strings.insert(QByteArray(text), string.id);
+    m_binary.append(TiLogFormat::kStringTag);
+    m_binary.append(reinterpret_cast<const char*>(&string), sizeof(string));
+    m_binary.append(key);
+    return string.id;
+}
+
+void TiLogger::flushFile()
+{
+    if (m_format == BinaryFormat) {
+        if (!m_binary.isEmpty() && m_file.isOpen()) {
+            m_file.write(m_binary);
+            m_file.flush();
+        }
+        m_binary.resize(0);
+        m_binaryFlushedAt = monotonicNsecs();
+    } else {
+        m_textStream.flush();
+    }
+}
+
+void TiLogger::setFileFormat(FileFormat format)
+{
+    QMutexLocker l(&m_mutex);
+    if (m_format == format)
+        return;
+    flushFile();
+    m_format  = format;
+    m_hourEnd = 0; // 下一条日志按新格式重新打开文件
+}
+
+QString TiLogger::timeText(qint64 msecs)
+{
+    const qint64 second = msecs / 1000;
+    if (second != m_second) {
+        m_second = second;
+        m_secondText = QDateTime::fromMSecsSinceEpoch(second * 1000).toString("yyyy-MM-dd hh:mm:ss.");
+    }
+    return m_secondText + QString("%1").arg(int(msecs % 1000), 3, 10, QChar('0'));
+}
+
+void TiLogger::openFileFor(qint64 msecs)
+{
+    if (msecs >= m_hourBegin && msecs < m_hourEnd) {
+        return;
+    }
+    const QDateTime time = QDateTime::fromMSecsSinceEpoch(msecs);
+    m_hourBegin = QDateTime(time.date(), QTime(time.time().hour(), 0)).toMSecsSinceEpoch();
+    m_hourEnd   = m_hourBegin + 3600 * 1000;
+
+    const bool binary = m_format == BinaryFormat;
+    QString newfileName = m_path
+                          + QString(binary ? "%1_log.bin" : "%1_log.txt")
+                                .arg(time.toString("yyyy-MM-dd-hh"));
+    if (m_file.fileName() != newfileName) {
+        // 之前的内容写到旧文件中，m_binary 里可能有当前这条记录之前的数据
+        if (binary && !m_binary.isEmpty() && m_file.isOpen())
+            m_file.write(m_binary);
+        m_binary.resize(0);
+        m_textStream.flush();
+        m_textStream.setDevice(nullptr);
+        if (m_file.isOpen())
+            m_file.close();
+        m_file.setFileName(newfileName);
+        if (binary) {
+            m_file.open(QIODevice::WriteOnly | QIODevice::Append);
+            // 每次打开都写文件头，追加到已有文件时字符串编号从头开始
+            TiLogFormat::Header header;
+            header.version   = TiLogFormat::kVersion;
+            header.wallMsecs = QDateTime::currentMSecsSinceEpoch();
+            header.monoNsecs = monotonicNsecs();
+            m_strings.clear();
+            m_binary.append(TiLogFormat::kHeaderTag);
+            m_binary.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        } else {
             m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
             m_textStream.setDevice(&m_file);
         }
-        m_textStream << writemsg << Qt::endl;
-        m_textStream.flush();
     }
+}
 
-    if (_isConsole) {
-        fprintf(stdout, "%s\n", writemsg.toLocal8Bit().data());
+void TiLogger::Record::setLocation(const char* file, const char* function)
+{
+    const int capacity = int(sizeof(location));
+    const int fileLen  = file ? qMin(int(strlen(file)), capacity / 2 - 1) : 0;
+    if (fileLen > 0)
+        memcpy(location, file, size_t(fileLen));
+    location[fileLen] = '\0';
+    functionAt        = fileLen + 1;
+    const int functionLen = function ? qMin(int(strlen(function)), capacity - functionAt - 1) : 0;
+    if (functionLen > 0)
+        memcpy(location + functionAt, function, size_t(functionLen));
+    location[functionAt + functionLen] = '\0';
+}
+
+TiLogger::ThreadBuffer::ThreadBuffer(int capacity)
+    : head(0)
+    , tail(0)
+    , abandoned(false)
+{
+    quint32 size = kMinBufferSize;
+    while (size < quint32(capacity)) {
+        size <<= 1;
+    }
+    records.resize(int(size));
+    mask = size - 1;
+}
+
+thread_local TiLogger::ThreadBuffer* TiLogger::t_buffer         = nullptr;
+thread_local bool                   TiLogger::t_bufferReleased = false;
+
+TiLogger::ThreadBufferOwner::~ThreadBufferOwner()
+{
+    // 置位之后缓冲区随时可能被后台线程释放，本线程不能再引用
+    ThreadBuffer* buffer = t_buffer;
+    t_buffer             = nullptr;
+    t_bufferReleased     = true;
+    if (buffer)
+        buffer->abandoned.store(true, std::memory_order_release);
+}
+
+TiLogger::ThreadBuffer* TiLogger::threadBuffer()
+{
+    if (t_buffer == nullptr && !t_bufferReleased) {
+        // 首次使用时构造，析构时机在本线程此前构造的线程局部变量之前
+        static thread_local ThreadBufferOwner owner;
+        Q_UNUSED(owner);
+        t_buffer = new ThreadBuffer(m_bufferSize.load(std::memory_order_relaxed));
+        QMutexLocker l(&m_buffersLock);
+        m_buffers.append(t_buffer);
+    }
+    return t_buffer;
+}
+
+bool TiLogger::push(ThreadBuffer* buffer, QtMsgType type, const QMessageLogContext& context, const QString& msg)
+{
+    const quint32 tail = buffer->tail.load(std::memory_order_relaxed);
+    while (tail - buffer->head.load(std::memory_order_acquire) > buffer->mask) {
+        // 后台线程自己写日志时不能等待自己
+        if (m_policy.load(std::memory_order_relaxed) == DropNewest || !isAsync()
+            || QThread::currentThread() == m_writer.load()) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        // 后台线程修改 head 之后才持锁 wakeAll，持锁检查再等待不会错过唤醒；
+        // 超时用于异步模式被关闭的情况
+        QMutexLocker l(&m_writerLock);
+        m_wake.wakeOne();
+        if (tail - buffer->head.load(std::memory_order_acquire) > buffer->mask)
+            m_flushed.wait(&m_writerLock, kWriterIntervalMs);
+    }
+
+    // 只保存原始数据，QString 为隐式共享，这里不拷贝消息内容
+    capture(buffer->records[int(tail & buffer->mask)], type, context, msg);
+    buffer->tail.store(tail + 1, std::memory_order_release);
+
+    // 缓冲区过半时提前唤醒，其余情况由后台线程定时取
+    if (tail + 1 - buffer->head.load(std::memory_order_relaxed) == (buffer->mask + 1) / 2)
+        m_wake.wakeOne();
+    return true;
+}
+
+int TiLogger::drain()
+{
+    m_batch.resize(0);
+    {
+        QMutexLocker l(&m_buffersLock);
+        for (int i = 0; i < m_buffers.size();) {
+            ThreadBuffer* buffer    = m_buffers[i];
+            // 先读退出标记，之后取到的一定是该线程的全部日志
+            const bool    abandoned = buffer->abandoned.load(std::memory_order_acquire);
+            quint32       head      = buffer->head.load(std::memory_order_relaxed);
+            const quint32 tail      = buffer->tail.load(std::memory_order_acquire);
+            for (; head != tail; ++head) {
+                Record& record = buffer->records[int(head & buffer->mask)];
+                m_batch.append(record);
+                record.msg = QString();
+            }
+            buffer->head.store(head, std::memory_order_release);
+            if (abandoned) {
+                delete buffer;
+                m_buffers.remove(i);
+            } else {
+                ++i;
+            }
+        }
+    }
+    if (m_batch.isEmpty())
+        return 0;
+
+    // 各线程的缓冲区内部有序，合并后按时间排序
+    std::stable_sort(m_batch.begin(), m_batch.end(), [](const Record& a, const Record& b) {
+        return a.msecs < b.msecs;
+    });
+
+    QMutexLocker l(&m_mutex);
+    for (int i = 0; i < m_batch.size(); ++i) {
+        output(m_batch.at(i));
+    }
+    if (_isFile)
+        flushFile();
+    if (_isConsole)
         fflush(stdout);
+    const int count = m_batch.size();
+    m_batch.resize(0);
+    return count;
+}
+
+void TiLogger::writerLoop()
+{
+    QMutexLocker locker(&m_writerLock);
+    for (;;) {
+        const bool    stop    = m_stop;
+        const quint64 request = m_flushRequest;
+        locker.unlock();
+        drain();
+        locker.relock();
+        m_flushDone = request;
+        m_flushed.wakeAll();
+        if (stop)
+            break;
+        if (m_flushRequest == request && !m_stop)
+            m_wake.wait(&m_writerLock, kWriterIntervalMs);
     }
+}
 
-    if (_isSignals) {
-        sendmsg = QString("[%1: %2] %3").arg(logType, logTime, msg);
-        emit sigLogger(sendmsg);
+void TiLogger::setAsync(bool enable, int bufferSize, OverflowPolicy policy)
+{
+    m_bufferSize.store(qMax(kMinBufferSize, bufferSize), std::memory_order_relaxed);
+    m_policy.store(policy, std::memory_order_relaxed);
+    if (enable == isAsync())
+        return;
+
+    if (enable) {
+        {
+            QMutexLocker l(&m_writerLock);
+            m_stop = false;
+        }
+        Writer* writer = new Writer(this);
+        writer->setObjectName("TiLogger");
+        writer->start();
+        m_writer.store(writer);
+        m_async.store(true, std::memory_order_release);
+    } else {
+        stopAsync();
+    }
+}
+
+void TiLogger::stopAsync()
+{
+    m_async.store(false);
+    // 等待已看到 m_async 为 true 的调用放完记录，否则最后一次 drain 之后
+    // 放入的记录既不会写出也不会计入 m_dropped。Block 策略下等待的调用
+    // 最迟在 kWriterIntervalMs 后发现异步已关闭，按丢弃计数返回
+    while (m_pushing.load() != 0)
+        QThread::yieldCurrentThread();
+    stopWriter();
+}
+
+void TiLogger::flush()
+{
+    if (!isAsync()) {
+        QMutexLocker l(&m_mutex);
+        if (_isFile)
+            flushFile();
+        return;
+    }
+    if (QThread::currentThread() == m_writer.load())
+        return;
+    QMutexLocker l(&m_writerLock);
+    const quint64 request = ++m_flushRequest;
+    m_wake.wakeOne();
+    while (m_flushDone < request && m_writer.load())
+        m_flushed.wait(&m_writerLock);
+}
+
+void TiLogger::stopWriter()
+{
+    Writer* writer = m_writer.load();
+    if (writer == nullptr)
+        return;
+    {
+        QMutexLocker l(&m_writerLock);
+        m_stop = true;
+        m_wake.wakeOne();
+    }
+    // 退出前最后一次 drain 会写出剩余日志
+    writer->wait();
+    {
+        // flush 在 m_writerLock 下检查 m_writer，这里同样持锁清空并唤醒
+        QMutexLocker l(&m_writerLock);
+        m_writer.store(nullptr);
+        m_flushed.wakeAll();
     }
+    delete writer;
 }
 
 TiLogger::TiLogger()
+    : m_async(false)
+    , m_bufferSize(4096)
+    , m_policy(DropNewest)
+    , m_dropped(0)
+    , m_pushing(0)
+    , m_writer(nullptr)
 {
     QMutexLocker l(&m_mutex);
     qInstallMessageHandler(outputMessage);
@@ -93,7 +474,10 @@ TiLogger::TiLogger()
 
 TiLogger::~TiLogger()
 {
+    stopAsync();
+    // 仍在运行的线程还持有自己的缓冲区，进程退出时由系统回收
     QMutexLocker l(&m_mutex);
+    flushFile();
     if (m_file.isOpen())
         m_file.close();
 }
@@ -106,6 +490,7 @@ void TiLogger::writeToFile(bool enable, const QString &path)
     _isFile = enable;
     if (!path.isEmpty() && m_path != path) {
         m_path = path;
+        m_hourEnd = 0; // 下一条日志按新目录重新打开文件
         QDir dir;
         if (!dir.exists(m_path))
             dir.mkpath(m_path);
@@ -22,7 +22,12 @@
 #include <QObject>
 #include <QTextStream>
 #include <QDebug>
+#include <QHash>
 #include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
 
 #define TILOGGER TiLogger::instance()
 //重新定义qDebug相关宏
@@ -49,6 +54,18 @@
 class TiLogger : public QObject {
     Q_OBJECT
 public:
+    /// 异步模式下本线程缓冲区满时的处理方式
+    enum OverflowPolicy {
+        DropNewest, // 丢弃新日志并计数，调用线程从不等待
+        Block       // 等待后台线程腾出空间，不丢日志
+    };
+
+    /// 日志文件格式
+    enum FileFormat {
+        TextFormat,  // [type: time file line function] msg
+        BinaryFormat // 见 tilogformat.h，用 tilogdecode 转回文本格式
+    };
+
     TiLogger();
     ~TiLogger();
     static TiLogger* instance();
@@ -63,10 +80,92 @@ public:
     // 是否启用日志输出到控制台
     void writeToConsole(bool enable);
 
+    /// 文件格式，二进制格式不做时间和文本格式化，文件名后缀为 .bin。
+    /// 同步模式下二进制记录攒到 64 KB 或距上次写出满 1 秒才写文件（fatal 立即写出），
+    /// 调用 flush 可立即写出
+    void setFileFormat(FileFormat format);
+
+    /// 异步模式：调用线程只把原始记录放进本线程的无锁缓冲区，格式化、分批写出、
+    /// 按小时切换文件都在后台线程中完成。bufferSize 为每个线程缓冲的记录条数，
+    /// 只对之后新建的缓冲区生效。fatal 日志始终同步写出
+    void setAsync(bool enable, int bufferSize = 4096, OverflowPolicy policy = DropNewest);
+    bool isAsync() const { return m_async.load(std::memory_order_acquire); }
+    /// 等待此前提交的异步日志全部写出；同步模式下写出攒着的二进制记录
+    void flush();
+    /// 异步模式下因缓冲区满丢弃的日志条数
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
     // 用于格式化日志，外部不要调用
     void writeMsg(QtMsgType type, const QMessageLogContext& context, const QString& msg);
 
 private:
+    /// 未格式化的日志。QML 等来源的 file、function 指向临时内存，
+    /// 因此拷贝到定长的 location 中（"file\0function\0"），超长时截断
+    struct Record {
+        qint64    msecs;
+        qint64    monoNsecs;
+        quint64   threadId;
+        QtMsgType type;
+        int       line;
+        int       functionAt; // function 在 location 中的起始位置
+        char      location[192];
+        QString   msg;
+
+        void setLocation(const char* file, const char* function);
+        const char* file() const { return location; }
+        const char* function() const { return location + functionAt; }
+    };
+
+    /// 单生产者单消费者环形缓冲区，生产者为所属线程，消费者为后台线程
+    struct ThreadBuffer {
+        explicit ThreadBuffer(int capacity);
+        QVector<Record>       records;
+        quint32               mask;
+        std::atomic<quint32>  head; // 只由后台线程修改
+        std::atomic<quint32>  tail; // 只由所属线程修改
+        std::atomic<bool>     abandoned; // 线程已退出，取空后由后台线程释放
+    };
+
+    /// 线程局部变量，线程退出时标记所属缓冲区并清空 t_buffer，
+    /// 之后同一线程的日志（其它线程局部变量的析构等）改为同步写出
+    struct ThreadBufferOwner {
+        ~ThreadBufferOwner();
+    };
+    // 平凡析构的线程局部变量在线程结束前一直可用
+    static thread_local ThreadBuffer* t_buffer;
+    static thread_local bool          t_bufferReleased;
+
+    class Writer : public QThread {
+    public:
+        explicit Writer(TiLogger* logger) : m_logger(logger) {}
+    protected:
+        void run() override { m_logger->writerLoop(); }
+    private:
+        TiLogger* m_logger;
+    };
+
+    static void capture(Record& record, QtMsgType type, const QMessageLogContext& context, const QString& msg);
+    /// 本线程的缓冲区，线程退出过程中缓冲区已交还后台线程时返回 nullptr
+    ThreadBuffer* threadBuffer();
+    /// 放入本线程缓冲区，按 DropNewest 丢弃时返回 false
+    bool push(ThreadBuffer* buffer, QtMsgType type, const QMessageLogContext& context, const QString& msg);
+    void writerLoop();
+    /// 取出所有缓冲区中的记录并写出，返回写出的条数
+    int drain();
+    /// 调用时持有 m_mutex，写文件时不 flush，由调用者决定
+    void output(const Record& record);
+    void writeBinary(const Record& record);
+    /// 返回字符串在当前二进制文件中的编号，首次出现时写出定义
+    quint32 intern(const char* text);
+    void flushFile();
+    /// 关闭异步模式：等正在放入缓冲区的调用结束，再停止后台线程，最后一次 drain 写出全部记录
+    void stopAsync();
+    void stopWriter();
+
+    /// 日志头中的时间，同一秒内只格式化一次
+    QString timeText(qint64 msecs);
+    void openFileFor(qint64 msecs);
+
     bool        _isFile    = false;
     bool        _isSignals = false;
     bool        _isConsole = false;
@@ -74,4 +173,32 @@ private:
     QFile       m_file;
     QString     m_path = "./Log/";
     QTextStream m_textStream;
+    FileFormat  m_format = TextFormat;
+    QByteArray  m_binary;              // 待写出的二进制记录
+    QHash<QByteArray, quint32> m_strings; // 当前二进制文件的字符串编号
+
+    // 以下只在持有 m_mutex 或后台线程中访问
+    qint64  m_hourBegin = 0;
+    qint64  m_hourEnd   = 0;
+    qint64  m_second    = -1;
+    QString m_secondText;
+    QVector<Record> m_batch;
+    qint64  m_binaryFlushedAt = 0; // 上次写出二进制记录的单调时间（纳秒）
+
+    std::atomic<bool>    m_async;
+    std::atomic<int>     m_bufferSize;
+    std::atomic<int>     m_policy;
+    std::atomic<quint64> m_dropped;
+    std::atomic<int>     m_pushing; // 已看到 m_async 为 true、尚未放完记录的调用数
+
+    QMutex                 m_buffersLock; // 保护缓冲区列表，只在线程首次写日志和后台取数据时使用
+    QVector<ThreadBuffer*> m_buffers;
+
+    std::atomic<Writer*> m_writer; // 调用线程会读取，只在 setAsync 和 stopWriter 中修改
+    QMutex         m_writerLock;
+    QWaitCondition m_wake;
+    QWaitCondition m_flushed; // 每次取完后唤醒，flush 和 Block 策略在此等待
+    bool           m_stop = false;
+    quint64        m_flushRequest = 0;
+    quint64        m_flushDone    = 0;
 };